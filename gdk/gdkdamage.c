@@ -0,0 +1,225 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "config.h"
+
+#include "gdkdamageprivate.h"
+
+/* GdkDamage accumulates damaged rectangles, but keeps their number
+ * bounded.
+ *
+ * Every rectangle has a cost when painting it, like setting up a
+ * scissor or a draw call, and when passing it on to the compositor.
+ * Merging two rectangles into their bounding box saves that cost, but
+ * paints the pixels in the bounding box that are in neither of them.
+ * So two rectangles are merged whenever that waste is smaller than
+ * the cost of a rectangle. When there are still too many rectangles,
+ * the pair that wastes the least pixels is merged, until there are
+ * few enough.
+ *
+ * The rectangles may overlap, so the region of a GdkDamage can be
+ * made of more rectangles than the GdkDamage itself.
+ * gdk_damage_simplify_region() takes care of that.
+ */
+
+/* The cost of a rectangle, in pixels */
+#define RECT_COST (64 * 64)
+
+static inline gint64
+rect_area (const cairo_rectangle_int_t *rect)
+{
+  return (gint64) rect->width * rect->height;
+}
+
+/* The number of pixels that would be painted in vain if @a and @b
+ * were replaced by their bounding box.
+ */
+static gint64
+merge_cost (const cairo_rectangle_int_t *a,
+            const cairo_rectangle_int_t *b)
+{
+  cairo_rectangle_int_t bounds, overlap;
+  gint64 cost;
+
+  gdk_rectangle_union (a, b, &bounds);
+  cost = rect_area (&bounds) - rect_area (a) - rect_area (b);
+  if (gdk_rectangle_intersect (a, b, &overlap))
+    cost += rect_area (&overlap);
+
+  return cost;
+}
+
+static inline void
+gdk_damage_remove (GdkDamage *self,
+                   guint      i)
+{
+  self->n_rects--;
+  self->rects[i] = self->rects[self->n_rects];
+}
+
+static void
+gdk_damage_merge_cheapest (GdkDamage *self)
+{
+  cairo_rectangle_int_t merged;
+  gint64 cost, best_cost;
+  guint i, j, best_i, best_j;
+
+  best_cost = G_MAXINT64;
+  best_i = 0;
+  best_j = 1;
+
+  for (i = 0; i < self->n_rects; i++)
+    {
+      for (j = i + 1; j < self->n_rects; j++)
+        {
+          cost = merge_cost (&self->rects[i], &self->rects[j]);
+          if (cost < best_cost)
+            {
+              best_cost = cost;
+              best_i = i;
+              best_j = j;
+            }
+        }
+    }
+
+  gdk_rectangle_union (&self->rects[best_i], &self->rects[best_j], &merged);
+
+  /* best_j > best_i, so removing it first keeps best_i valid */
+  gdk_damage_remove (self, best_j);
+  gdk_damage_remove (self, best_i);
+
+  /* The merged rectangle is larger, so it may now be cheap to merge
+   * with others.
+   */
+  gdk_damage_add_rectangle (self, &merged);
+}
+
+void
+gdk_damage_init (GdkDamage *self,
+                 guint      max_rects)
+{
+  self->max_rects = CLAMP (max_rects, 1, GDK_DAMAGE_MAX_RECTS);
+  self->n_rects = 0;
+}
+
+void
+gdk_damage_add_rectangle (GdkDamage                   *self,
+                          const cairo_rectangle_int_t *rect)
+{
+  cairo_rectangle_int_t r;
+  gint64 cost, best_cost;
+  guint i, best;
+
+  if (rect->width <= 0 || rect->height <= 0)
+    return;
+
+  r = *rect;
+
+  while (TRUE)
+    {
+      best = self->n_rects;
+      best_cost = RECT_COST + 1;
+
+      for (i = 0; i < self->n_rects; i++)
+        {
+          cost = merge_cost (&self->rects[i], &r);
+          if (cost < best_cost)
+            {
+              best_cost = cost;
+              best = i;
+            }
+        }
+
+      if (best == self->n_rects)
+        break;
+
+      gdk_rectangle_union (&self->rects[best], &r, &r);
+      gdk_damage_remove (self, best);
+    }
+
+  self->rects[self->n_rects] = r;
+  self->n_rects++;
+
+  if (self->n_rects > self->max_rects)
+    gdk_damage_merge_cheapest (self);
+}
+
+void
+gdk_damage_add_region (GdkDamage            *self,
+                       const cairo_region_t *region)
+{
+  cairo_rectangle_int_t rect;
+  int i, n;
+
+  n = cairo_region_num_rectangles (region);
+  for (i = 0; i < n; i++)
+    {
+      cairo_region_get_rectangle (region, i, &rect);
+      gdk_damage_add_rectangle (self, &rect);
+    }
+}
+
+cairo_region_t *
+gdk_damage_to_region (const GdkDamage *self)
+{
+  return cairo_region_create_rectangles (self->rects, self->n_rects);
+}
+
+/*<private>
+ * gdk_damage_simplify_region:
+ * @region: a `cairo_region_t`
+ * @max_rects: the number of rectangles to reduce @region to
+ *
+ * Grows @region so that it is made of at most @max_rects rectangles,
+ * if it is made of more than that.
+ *
+ * This is meant for damage, where painting a few more pixels is
+ * cheaper than handling many small rectangles.
+ */
+void
+gdk_damage_simplify_region (cairo_region_t *region,
+                            guint           max_rects)
+{
+  cairo_region_t *simplified;
+  GdkDamage damage;
+
+  if ((guint) cairo_region_num_rectangles (region) <= max_rects)
+    return;
+
+  gdk_damage_init (&damage, max_rects);
+  gdk_damage_add_region (&damage, region);
+
+  /* A region stores its rectangles in horizontal bands, so overlapping
+   * rectangles with staggered y ranges are split into many more. Keep
+   * merging until the region itself is small enough.
+   */
+  while (TRUE)
+    {
+      simplified = gdk_damage_to_region (&damage);
+      if (damage.n_rects <= 1 ||
+          (guint) cairo_region_num_rectangles (simplified) <= max_rects)
+        break;
+
+      cairo_region_destroy (simplified);
+      gdk_damage_merge_cheapest (&damage);
+    }
+
+  cairo_region_intersect_rectangle (region, &(cairo_rectangle_int_t) { 0, 0, 0, 0 });
+  cairo_region_union (region, simplified);
+  cairo_region_destroy (simplified);
+}
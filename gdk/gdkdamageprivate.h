@@ -0,0 +1,57 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GDK_DAMAGE_PRIVATE_H__
+#define __GDK_DAMAGE_PRIVATE_H__
+
+#include <gdk/gdk.h>
+#include <cairo.h>
+
+G_BEGIN_DECLS
+
+/* The most rectangles a GdkDamage can hold */
+#define GDK_DAMAGE_MAX_RECTS 32
+
+/* The number of rectangles damage is reduced to by default */
+#define GDK_DAMAGE_DEFAULT_RECTS 16
+
+typedef struct _GdkDamage GdkDamage;
+
+struct _GdkDamage
+{
+  guint max_rects;
+  guint n_rects;
+  /* One more than the maximum, for the rectangle being added */
+  cairo_rectangle_int_t rects[GDK_DAMAGE_MAX_RECTS + 1];
+};
+
+void                    gdk_damage_init                         (GdkDamage                      *self,
+                                                                 guint                           max_rects);
+
+void                    gdk_damage_add_rectangle                (GdkDamage                      *self,
+                                                                 const cairo_rectangle_int_t    *rect);
+void                    gdk_damage_add_region                   (GdkDamage                      *self,
+                                                                 const cairo_region_t           *region);
+
+cairo_region_t *        gdk_damage_to_region                    (const GdkDamage                *self);
+
+void                    gdk_damage_simplify_region              (cairo_region_t                 *region,
+                                                                 guint                           max_rects);
+
+G_END_DECLS
+
+#endif /* __GDK_DAMAGE_PRIVATE_H__ */
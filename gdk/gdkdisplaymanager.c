@@ -39,6 +39,10 @@
 #include "broadway/gdkprivate-broadway.h"
 #endif
 
+#ifdef GDK_WINDOWING_HEADLESS
+#include "headless/gdkprivate-headless.h"
+#endif
+
 #ifdef GDK_WINDOWING_MACOS
 #include "macos/gdkmacosdisplay-private.h"
 #endif
@@ -232,12 +236,15 @@ static const char *allowed_backends;
  * The possible backend names are:
  *
  *   - `broadway`
+ *   - `headless`
  *   - `macos`
  *   - `wayland`.
  *   - `win32`
  *   - `x11`
  *
  * You can also include a `*` in the list to try all remaining backends.
+ * The `headless` backend is never tried for `*`, it has to be named
+ * explicitly.
  *
  * This call must happen prior to functions that open a display, such
  * as [func@Gdk.Display.open], `gtk_init()`, or `gtk_init_check()`
@@ -271,6 +278,9 @@ static GdkBackend gdk_backends[] = {
 #endif
 #ifdef GDK_WINDOWING_BROADWAY
   { "broadway", _gdk_broadway_display_open },
+#endif
+#ifdef GDK_WINDOWING_HEADLESS
+  { "headless", _gdk_headless_display_open },
 #endif
   /* NULL-terminating this array so we can use commas above */
   { NULL, NULL }
@@ -418,6 +428,12 @@ gdk_display_manager_open_display (GdkDisplayManager *manager,
 
       for (j = 0; gdk_backends[j].name != NULL; j++)
         {
+          /* A headless display can be opened anywhere, so only use
+           * it when it is asked for by name.
+           */
+          if (any && g_str_equal (gdk_backends[j].name, "headless"))
+            continue;
+
           if ((any && allow_any) ||
               (any && strstr (allowed_backends, gdk_backends[j].name)) ||
               g_str_equal (backend, gdk_backends[j].name))
@@ -1688,14 +1688,10 @@ gdk_key_event_is_modifier (GdkEvent *event)
 }
 
 static gboolean
-keyval_in_group (GdkKeymap *keymap,
-                 guint      keyval,
-                 int        group)
+keys_in_group (const GdkKeymapKey *keys,
+               guint               n_keys,
+               int                 group)
 {
-  GdkKeymapKey *keys;
-  guint n_keys;
-
-  gdk_keymap_get_cached_entries_for_keyval (keymap, keyval, &keys, &n_keys);
   for (int i = 0; i < n_keys; i++)
     {
       if (keys[i].group == group)
@@ -1801,7 +1797,7 @@ gdk_key_event_matches (GdkEvent        *event,
               keys[i].level == level &&
               /* Only match for group if it's an accel mod */
               (keys[i].group == layout ||
-               (!group_mod_is_accel_mod && !keyval_in_group (keymap, keyval, layout))))
+               (!group_mod_is_accel_mod && !keys_in_group (keys, n_keys, layout))))
             return GDK_KEY_MATCH_PARTIAL;
         }
     }
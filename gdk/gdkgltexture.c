@@ -39,6 +39,10 @@ struct _GdkGLTexture {
   GdkGLContext *context;
   guint id;
 
+  /* owned by the creator, valid until destroy is called */
+  GLsync sync;
+  guint pixel_buffer;
+
   GdkTexture *saved;
 
   GDestroyNotify destroy;
@@ -65,6 +69,8 @@ gdk_gl_texture_dispose (GObject *object)
 
   g_clear_object (&self->context);
   self->id = 0;
+  self->sync = NULL;
+  self->pixel_buffer = 0;
 
   g_clear_object (&self->saved);
 
@@ -215,6 +221,55 @@ gdk_gl_texture_do_download (gpointer texture_,
     }
 }
 
+static void
+gdk_gl_texture_do_read_pixel_buffer (gpointer texture_,
+                                     gpointer result_)
+{
+  GdkGLTexture *self = texture_;
+  GdkTexture *texture = texture_;
+  GdkTexture **result = result_;
+  gsize stride, size;
+  const guchar *pixels;
+
+  stride = texture->width * 4;
+  size = stride * texture->height;
+
+  /* The pixels were read in the context of the creator */
+  if (self->sync)
+    glClientWaitSync (self->sync, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+
+  glBindBuffer (GL_PIXEL_PACK_BUFFER, self->pixel_buffer);
+
+  pixels = glMapBufferRange (GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+  if (pixels)
+    {
+      GBytes *bytes = g_bytes_new (pixels, size);
+
+      *result = gdk_memory_texture_new (texture->width,
+                                        texture->height,
+                                        GDK_MEMORY_R8G8B8A8_PREMULTIPLIED,
+                                        bytes,
+                                        stride);
+
+      g_bytes_unref (bytes);
+      glUnmapBuffer (GL_PIXEL_PACK_BUFFER);
+    }
+
+  glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+}
+
+static void
+gdk_gl_texture_read_pixel_buffer (GdkGLTexture *self)
+{
+  if (self->saved != NULL || self->pixel_buffer == 0)
+    return;
+
+  gdk_gl_texture_run (self, gdk_gl_texture_do_read_pixel_buffer, &self->saved);
+
+  /* If mapping failed, read the texture instead */
+  self->pixel_buffer = 0;
+}
+
 static void
 gdk_gl_texture_download (GdkTexture      *texture,
                          GdkMemoryFormat  format,
@@ -224,6 +279,11 @@ gdk_gl_texture_download (GdkTexture      *texture,
   GdkGLTexture *self = GDK_GL_TEXTURE (texture);
   Download download;
 
+  /* If the creator already started reading back the pixels, we
+   * just need to copy them, and can keep them around for later.
+   */
+  gdk_gl_texture_read_pixel_buffer (self);
+
   if (self->saved)
     {
       gdk_texture_do_download (self->saved, format, data, stride);
@@ -265,6 +325,60 @@ gdk_gl_texture_get_id (GdkGLTexture *self)
   return self->id;
 }
 
+/*<private>
+ * gdk_gl_texture_set_sync:
+ * @self: a `GdkGLTexture`
+ * @sync: (nullable): a GLsync that is signaled when rendering
+ *   to the texture is complete
+ *
+ * Sets a fence that consumers of the texture in other contexts
+ * need to wait for before using it.
+ *
+ * The fence is owned by the creator of the texture and must stay
+ * valid until the destroy notify of @self is called.
+ */
+void
+gdk_gl_texture_set_sync (GdkGLTexture *self,
+                         gpointer      sync)
+{
+  self->sync = sync;
+}
+
+/*<private>
+ * gdk_gl_texture_set_pixel_buffer:
+ * @self: a `GdkGLTexture`
+ * @pixel_buffer: a pixel pack buffer object
+ *
+ * Tells @self that the creator has started an asynchronous
+ * readback of the texture into @pixel_buffer, as tightly packed
+ * GL_RGBA, GL_UNSIGNED_BYTE data, so that downloads can map the
+ * buffer instead of reading the texture.
+ *
+ * The readback must be covered by the fence set with
+ * gdk_gl_texture_set_sync(), and the buffer must stay valid until
+ * the destroy notify of @self is called.
+ */
+void
+gdk_gl_texture_set_pixel_buffer (GdkGLTexture *self,
+                                 guint         pixel_buffer)
+{
+  self->pixel_buffer = pixel_buffer;
+}
+
+/*<private>
+ * gdk_gl_texture_wait:
+ * @self: a `GdkGLTexture`
+ *
+ * Makes the current context wait for the creator of @self to
+ * finish rendering to it, before using the texture.
+ */
+void
+gdk_gl_texture_wait (GdkGLTexture *self)
+{
+  if (self->sync)
+    glWaitSync (self->sync, 0, GL_TIMEOUT_IGNORED);
+}
+
 /**
  * gdk_gl_texture_release:
  * @self: a `GdkTexture` wrapping a GL texture
@@ -281,11 +395,13 @@ gdk_gl_texture_release (GdkGLTexture *self)
   GdkTexture *texture;
 
   g_return_if_fail (GDK_IS_GL_TEXTURE (self));
-  g_return_if_fail (self->saved == NULL);
+  g_return_if_fail (self->context != NULL);
 
   texture = GDK_TEXTURE (self);
-  self->saved = GDK_TEXTURE (gdk_memory_texture_from_texture (texture,
-                                                              gdk_texture_get_format (texture)));
+  gdk_gl_texture_read_pixel_buffer (self);
+  if (self->saved == NULL)
+    self->saved = GDK_TEXTURE (gdk_memory_texture_from_texture (texture,
+                                                                gdk_texture_get_format (texture)));
 
   if (self->destroy)
     {
@@ -296,6 +412,8 @@ gdk_gl_texture_release (GdkGLTexture *self)
 
   g_clear_object (&self->context);
   self->id = 0;
+  self->sync = NULL;
+  self->pixel_buffer = 0;
 }
 
 static void
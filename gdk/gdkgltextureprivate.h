@@ -10,6 +10,12 @@ G_BEGIN_DECLS
 GdkGLContext *          gdk_gl_texture_get_context      (GdkGLTexture           *self);
 guint                   gdk_gl_texture_get_id           (GdkGLTexture           *self);
 
+void                    gdk_gl_texture_set_sync         (GdkGLTexture           *self,
+                                                         gpointer                sync);
+void                    gdk_gl_texture_set_pixel_buffer (GdkGLTexture           *self,
+                                                         guint                   pixel_buffer);
+void                    gdk_gl_texture_wait             (GdkGLTexture           *self);
+
 G_END_DECLS
 
 #endif /* __GDK_GL_TEXTURE_PRIVATE_H__ */
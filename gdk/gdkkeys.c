@@ -91,6 +91,7 @@ gdk_keymap_finalize (GObject *object)
 
   g_array_free (keymap->cached_keys, TRUE);
   g_hash_table_unref (keymap->cache);
+  g_free (keymap->translations);
 
   G_OBJECT_CLASS (gdk_keymap_parent_class)->finalize (object);
 }
@@ -109,6 +110,8 @@ gdk_keymap_keys_changed (GdkKeymap *keymap)
   g_array_append_val (keymap->cached_keys, key);
 
   g_hash_table_remove_all (keymap->cache);
+
+  g_clear_pointer (&keymap->translations, g_free);
 }
 
 static void
@@ -620,16 +623,55 @@ gdk_keymap_translate_keyboard_state (GdkKeymap       *keymap,
                                      int             *level,
                                      GdkModifierType *consumed_modifiers)
 {
+  GdkKeymapTranslation *translation;
+  guint hash;
+
   g_return_val_if_fail (GDK_IS_KEYMAP (keymap), FALSE);
 
-  return GDK_KEYMAP_GET_CLASS (keymap)->translate_keyboard_state (keymap,
-								  hardware_keycode,
-								  state,
-								  group,
-								  keyval,
-								  effective_group,
-								  level,
-								  consumed_modifiers);
+  /* Key events get translated twice, and shortcut and input method
+   * code translate them again, so the same few keys are translated
+   * over and over.
+   */
+  if (keymap->translations == NULL)
+    keymap->translations = g_new0 (GdkKeymapTranslation, GDK_KEYMAP_N_TRANSLATIONS);
+
+  hash = hardware_keycode ^ (state * 0x9e3779b1u) ^ ((guint) group << 7);
+  hash = (hash ^ (hash >> 16)) & (GDK_KEYMAP_N_TRANSLATIONS - 1);
+  translation = &keymap->translations[hash];
+
+  if (!translation->valid ||
+      translation->keycode != hardware_keycode ||
+      translation->state != state ||
+      translation->group != group)
+    {
+      translation->keycode = hardware_keycode;
+      translation->state = state;
+      translation->group = group;
+      translation->keyval = 0;
+      translation->effective_group = 0;
+      translation->level = 0;
+      translation->consumed = 0;
+      translation->found = GDK_KEYMAP_GET_CLASS (keymap)->translate_keyboard_state (keymap,
+                                                                                    hardware_keycode,
+                                                                                    state,
+                                                                                    group,
+                                                                                    &translation->keyval,
+                                                                                    &translation->effective_group,
+                                                                                    &translation->level,
+                                                                                    &translation->consumed);
+      translation->valid = TRUE;
+    }
+
+  if (keyval)
+    *keyval = translation->keyval;
+  if (effective_group)
+    *effective_group = translation->effective_group;
+  if (level)
+    *level = translation->level;
+  if (consumed_modifiers)
+    *consumed_modifiers = translation->consumed;
+
+  return translation->found;
 }
 
 #include "gdkkeynames.c"
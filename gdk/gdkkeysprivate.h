@@ -33,6 +33,7 @@ G_BEGIN_DECLS
 
 typedef struct _GdkKeymap             GdkKeymap;
 typedef struct _GdkKeymapClass GdkKeymapClass;
+typedef struct _GdkKeymapTranslation GdkKeymapTranslation;
 
 struct _GdkKeymapClass
 {
@@ -85,6 +86,31 @@ struct _GdkKeymap
    */
   GArray *cached_keys;
   GHashTable *cache;
+
+  /* A cache of the results of translate_keyboard_state(), indexed
+   * by a hash of keycode, state and group. Entries get replaced
+   * when another translation hashes to the same slot.
+   *
+   * The cache is cleared before ::keys-changed is emitted.
+   */
+  GdkKeymapTranslation *translations;
+};
+
+#define GDK_KEYMAP_N_TRANSLATIONS 512
+
+struct _GdkKeymapTranslation
+{
+  guint keycode;
+  GdkModifierType state;
+  int group;
+
+  guint keyval;
+  int effective_group;
+  int level;
+  GdkModifierType consumed;
+
+  guint valid : 1;
+  guint found : 1;
 };
 
 GType gdk_keymap_get_type (void) G_GNUC_CONST;
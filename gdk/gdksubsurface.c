@@ -0,0 +1,163 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdksubsurfaceprivate.h"
+
+#include "gdksurfaceprivate.h"
+
+/*
+ * GdkSubsurface:
+ *
+ * A `GdkSubsurface` is an area stacked above a `GdkSurface` that a
+ * texture can be shown in without drawing it into the surface.
+ *
+ * Backends that can present buffers directly, such as Wayland with
+ * its subsurfaces, let the compositor or the display hardware put
+ * the texture on screen. This way a video frame can be shown without
+ * redrawing the rest of the surface.
+ *
+ * A subsurface may refuse a texture, for example when it would have
+ * to be scaled. In that case the caller has to draw the texture itself
+ * and detach the subsurface once that is on screen.
+ */
+
+G_DEFINE_ABSTRACT_TYPE (GdkSubsurface, gdk_subsurface, G_TYPE_OBJECT)
+
+static void
+gdk_subsurface_finalize (GObject *object)
+{
+  GdkSubsurface *subsurface = GDK_SUBSURFACE (object);
+
+  g_clear_object (&subsurface->texture);
+  g_clear_object (&subsurface->parent);
+
+  G_OBJECT_CLASS (gdk_subsurface_parent_class)->finalize (object);
+}
+
+static void
+gdk_subsurface_class_init (GdkSubsurfaceClass *class)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (class);
+
+  object_class->finalize = gdk_subsurface_finalize;
+}
+
+static void
+gdk_subsurface_init (GdkSubsurface *subsurface)
+{
+}
+
+GdkSurface *
+gdk_subsurface_get_parent (GdkSubsurface *subsurface)
+{
+  g_return_val_if_fail (GDK_IS_SUBSURFACE (subsurface), NULL);
+
+  return subsurface->parent;
+}
+
+/*
+ * gdk_subsurface_attach:
+ * @subsurface: a `GdkSubsurface`
+ * @texture: the texture to show
+ * @rect: where to show it, in coordinates of the parent surface
+ *
+ * Shows @texture in @subsurface, covering @rect.
+ *
+ * If the subsurface cannot show @texture at @rect, %FALSE is returned
+ * and the caller must draw the texture itself. The subsurface keeps
+ * showing what it showed before, so that the caller can detach it
+ * once the texture has been drawn.
+ *
+ * Returns: %TRUE if the texture is shown by the subsurface
+ */
+gboolean
+gdk_subsurface_attach (GdkSubsurface         *subsurface,
+                       GdkTexture            *texture,
+                       const graphene_rect_t *rect)
+{
+  g_return_val_if_fail (GDK_IS_SUBSURFACE (subsurface), FALSE);
+  g_return_val_if_fail (GDK_IS_TEXTURE (texture), FALSE);
+  g_return_val_if_fail (rect != NULL, FALSE);
+
+  if (subsurface->texture == texture &&
+      graphene_rect_equal (&subsurface->rect, rect))
+    return TRUE;
+
+  if (GDK_SURFACE_DESTROYED (subsurface->parent) ||
+      !GDK_SUBSURFACE_GET_CLASS (subsurface)->attach (subsurface, texture, rect))
+    return FALSE;
+
+  g_set_object (&subsurface->texture, texture);
+  subsurface->rect = *rect;
+
+  return TRUE;
+}
+
+/*
+ * gdk_subsurface_detach:
+ * @subsurface: a `GdkSubsurface`
+ *
+ * Stops showing the texture that was attached to @subsurface,
+ * if any.
+ */
+void
+gdk_subsurface_detach (GdkSubsurface *subsurface)
+{
+  g_return_if_fail (GDK_IS_SUBSURFACE (subsurface));
+
+  if (subsurface->texture == NULL)
+    return;
+
+  if (!GDK_SURFACE_DESTROYED (subsurface->parent))
+    GDK_SUBSURFACE_GET_CLASS (subsurface)->detach (subsurface);
+
+  g_clear_object (&subsurface->texture);
+}
+
+GdkTexture *
+gdk_subsurface_get_texture (GdkSubsurface *subsurface)
+{
+  g_return_val_if_fail (GDK_IS_SUBSURFACE (subsurface), NULL);
+
+  return subsurface->texture;
+}
+
+/*
+ * gdk_subsurface_get_rect:
+ * @subsurface: a `GdkSubsurface`
+ * @rect: (out): return location for the area covered by the texture
+ *
+ * Gets the area of the parent surface that the attached texture
+ * covers.
+ *
+ * Returns: %FALSE if no texture is attached
+ */
+gboolean
+gdk_subsurface_get_rect (GdkSubsurface   *subsurface,
+                         graphene_rect_t *rect)
+{
+  g_return_val_if_fail (GDK_IS_SUBSURFACE (subsurface), FALSE);
+
+  if (subsurface->texture == NULL)
+    return FALSE;
+
+  *rect = subsurface->rect;
+
+  return TRUE;
+}
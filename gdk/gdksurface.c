@@ -31,6 +31,7 @@
 
 #include "gdk-private.h"
 #include "gdkcontentprovider.h"
+#include "gdkdamageprivate.h"
 #include "gdkdeviceprivate.h"
 #include "gdkdisplayprivate.h"
 #include "gdkdragsurfaceprivate.h"
@@ -1208,6 +1209,29 @@ gdk_surface_create_cairo_context (GdkSurface *surface)
                        NULL);
 }
 
+/*
+ * gdk_surface_create_subsurface:
+ * @surface: a `GdkSurface`
+ *
+ * Creates a new `GdkSubsurface` stacked above @surface.
+ *
+ * Returns: (transfer full) (nullable): the newly created `GdkSubsurface`,
+ *   or %NULL if the backend does not support subsurfaces
+ */
+GdkSubsurface *
+gdk_surface_create_subsurface (GdkSurface *surface)
+{
+  GdkSurfaceClass *class;
+
+  g_return_val_if_fail (GDK_IS_SURFACE (surface), NULL);
+
+  class = GDK_SURFACE_GET_CLASS (surface);
+  if (GDK_SURFACE_DESTROYED (surface) || class->create_subsurface == NULL)
+    return NULL;
+
+  return class->create_subsurface (surface);
+}
+
 /**
  * gdk_surface_create_vulkan_context:
  * @surface: a `GdkSurface`
@@ -1477,7 +1501,12 @@ impl_surface_add_update_area (GdkSurface     *impl_surface,
                               cairo_region_t *region)
 {
   if (impl_surface->update_area)
-    cairo_region_union (impl_surface->update_area, region);
+    {
+      cairo_region_union (impl_surface->update_area, region);
+      /* Many scattered invalidations are cheaper to paint as a few
+       * larger rectangles */
+      gdk_damage_simplify_region (impl_surface->update_area, GDK_DAMAGE_DEFAULT_RECTS);
+    }
   else
     {
       gdk_surface_add_update_surface (impl_surface);
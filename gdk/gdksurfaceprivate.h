@@ -22,6 +22,7 @@
 
 #include <gdk-pixbuf/gdk-pixbuf.h>
 #include "gdkenumtypes.h"
+#include "gdksubsurfaceprivate.h"
 #include "gdksurface.h"
 #include "gdktoplevel.h"
 
@@ -160,6 +161,9 @@ struct _GdkSurfaceClass
                                            cairo_region_t *region);
   void         (* request_layout)         (GdkSurface     *surface);
   gboolean     (* compute_size)           (GdkSurface     *surface);
+
+  GdkSubsurface *
+               (* create_subsurface)      (GdkSurface     *surface);
 };
 
 #define GDK_SURFACE_DESTROYED(d) (((GdkSurface *)(d))->destroyed)
@@ -172,6 +176,8 @@ void gdk_surface_set_state (GdkSurface      *surface,
 void gdk_surface_set_is_mapped (GdkSurface *surface,
                                 gboolean    is_mapped);
 
+GdkSubsurface * gdk_surface_create_subsurface (GdkSurface *surface);
+
 GdkMonitor * gdk_surface_get_layout_monitor (GdkSurface      *surface,
                                              GdkPopupLayout  *layout,
                                              void           (*get_bounds) (GdkMonitor   *monitor,
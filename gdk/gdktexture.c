@@ -46,6 +46,8 @@
 #include "gdksnapshot.h"
 
 #include <graphene.h>
+#include <math.h>
+#include <string.h>
 #include "loaders/gdkpngprivate.h"
 #include "loaders/gdktiffprivate.h"
 #include "loaders/gdkjpegprivate.h"
@@ -278,12 +280,20 @@ gdk_texture_get_property (GObject    *gobject,
     }
 }
 
+static void gdk_texture_clear_mipmaps (GdkTexture *self);
+
 static void
 gdk_texture_dispose (GObject *object)
 {
   GdkTexture *self = GDK_TEXTURE (object);
 
   gdk_texture_clear_render_data (self);
+  gdk_texture_clear_mipmaps (self);
+
+  if (self->update_texture)
+    g_object_remove_weak_pointer (G_OBJECT (self->update_texture), (gpointer *) &self->update_texture);
+  self->update_texture = NULL;
+  g_clear_pointer (&self->update_region, cairo_region_destroy);
 
   G_OBJECT_CLASS (gdk_texture_parent_class)->dispose (object);
 }
@@ -830,6 +840,332 @@ gdk_texture_get_render_data (GdkTexture  *self,
   return self->render_data;
 }
 
+/*<private>
+ * gdk_texture_steal_render_data:
+ * @self: a `GdkTexture`
+ * @key: the key the render data was set with
+ *
+ * Removes the render data of @self without calling its notify
+ * function, so that a renderer can move it to another texture.
+ *
+ * Returns: (nullable): the render data, or %NULL if @key does not match
+ */
+gpointer
+gdk_texture_steal_render_data (GdkTexture *self,
+                               gpointer    key)
+{
+  gpointer data;
+
+  if (self->render_key != key)
+    return NULL;
+
+  data = self->render_data;
+
+  self->render_key = NULL;
+  self->render_data = NULL;
+  self->render_notify = NULL;
+
+  return data;
+}
+
+/*<private>
+ * gdk_texture_set_update:
+ * @self: a `GdkTexture`
+ * @previous: (nullable): the texture that @self replaces
+ * @region: the region of @self that differs from @previous
+ *
+ * Records that @self is @previous with only @region changed, so that
+ * renderers that have @previous uploaded can update it in place instead
+ * of uploading all of @self. @previous is not kept alive by this.
+ */
+void
+gdk_texture_set_update (GdkTexture           *self,
+                        GdkTexture           *previous,
+                        const cairo_region_t *region)
+{
+  g_return_if_fail (self->update_texture == NULL);
+
+  if (previous == NULL ||
+      previous->width != self->width ||
+      previous->height != self->height)
+    return;
+
+  self->update_texture = previous;
+  g_object_add_weak_pointer (G_OBJECT (previous), (gpointer *) &self->update_texture);
+  self->update_region = cairo_region_copy (region);
+}
+
+/* Upper limit for the memory used by all mipmaps, we don't want
+ * thumbnailing large images to double the memory they use. When it
+ * is reached, the least recently used mipmaps are dropped.
+ */
+#define MAX_MIPMAP_MEMORY (128 * 1024 * 1024)
+
+struct _GdkTextureMipmap
+{
+  GdkTexture *texture;
+  GdkTexture *owner;
+  guint level;
+  /* in mipmap_lru, most recently used first */
+  GList link;
+};
+
+static gsize mipmap_memory = 0;
+static GQueue mipmap_lru = G_QUEUE_INIT;
+
+/* Textures can be drawn from other threads than the main thread, see
+ * gsk_render_node_render_texture(), so the mipmaps and their memory
+ * accounting are protected by a lock.
+ */
+G_LOCK_DEFINE_STATIC (mipmaps);
+
+static gsize
+gdk_texture_get_mipmap_size (GdkTexture *mipmap)
+{
+  return (gsize) mipmap->width * mipmap->height * 4;
+}
+
+/* Called with the lock held. Returns the texture of the mipmap,
+ * which must be unreffed after dropping the lock.
+ */
+static GdkTexture *
+gdk_texture_mipmap_remove (GdkTextureMipmap *mipmap)
+{
+  GdkTexture *texture = mipmap->texture;
+
+  mipmap->owner->mipmaps[mipmap->level] = NULL;
+  g_queue_unlink (&mipmap_lru, &mipmap->link);
+  mipmap_memory -= gdk_texture_get_mipmap_size (texture);
+  g_slice_free (GdkTextureMipmap, mipmap);
+
+  return texture;
+}
+
+static void
+gdk_texture_clear_mipmaps (GdkTexture *self)
+{
+  GPtrArray *removed;
+  guint i;
+
+  if (self->mipmaps == NULL)
+    return;
+
+  removed = g_ptr_array_new_with_free_func (g_object_unref);
+
+  G_LOCK (mipmaps);
+
+  for (i = 0; i < self->n_mipmaps; i++)
+    {
+      if (self->mipmaps[i])
+        g_ptr_array_add (removed, gdk_texture_mipmap_remove (self->mipmaps[i]));
+    }
+
+  g_clear_pointer (&self->mipmaps, g_free);
+  self->n_mipmaps = 0;
+
+  G_UNLOCK (mipmaps);
+
+  /* Unref outside the lock, finalizing the mipmaps takes it again */
+  g_ptr_array_unref (removed);
+}
+
+/* Halves the size of premultiplied 8-bit RGBA data of any channel order,
+ * averaging each 2x2 block of pixels. The last row and column of odd
+ * sizes are dropped, like they are by GL mipmaps.
+ */
+static guchar *
+gdk_texture_downscale (const guchar *src,
+                       int           width,
+                       int           height,
+                       gsize         src_stride,
+                       int          *out_width,
+                       int          *out_height)
+{
+  int dst_width = MAX (width / 2, 1);
+  int dst_height = MAX (height / 2, 1);
+  guchar *dst;
+  int x, y, c;
+
+  dst = g_malloc_n (dst_height, dst_width * 4);
+
+  for (y = 0; y < dst_height; y++)
+    {
+      const guchar *row0 = src + MIN (2 * y, height - 1) * src_stride;
+      const guchar *row1 = src + MIN (2 * y + 1, height - 1) * src_stride;
+      guchar *d = dst + y * dst_width * 4;
+
+      for (x = 0; x < dst_width; x++)
+        {
+          int x0 = MIN (2 * x, width - 1) * 4;
+          int x1 = MIN (2 * x + 1, width - 1) * 4;
+
+          for (c = 0; c < 4; c++)
+            d[4 * x + c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2;
+        }
+    }
+
+  *out_width = dst_width;
+  *out_height = dst_height;
+
+  return dst;
+}
+
+/*<private>
+ * gdk_texture_get_mipmap:
+ * @self: a `GdkTexture`
+ * @scale: the scale the texture will be drawn at
+ *
+ * Gets a downscaled version of @self that is still at least as
+ * large as @self drawn at @scale, to avoid sampling all of a large
+ * texture when it is drawn much smaller.
+ *
+ * The downscaled textures are created on demand, by halving the
+ * size of @self until the right size is reached, and are cached
+ * until @self goes away or they are the least recently used ones
+ * when the memory limit for them is reached.
+ *
+ * Returns: (transfer full): a texture to draw instead of @self,
+ *   which may be @self itself
+ */
+GdkTexture *
+gdk_texture_get_mipmap (GdkTexture *self,
+                        double      scale)
+{
+  GdkTexture *source, *texture;
+  GdkTextureMipmap *mipmap;
+  GPtrArray *removed;
+  GBytes *bytes;
+  guchar *data;
+  gsize stride, size;
+  int width, height;
+  guint level, source_level, i;
+
+  if (scale >= 0.5 || scale <= 0)
+    return g_object_ref (self);
+
+  level = (guint) MIN (floor (log2 (1.0 / scale)), 30);
+  while (level > 0 && ((self->width >> level) == 0 || (self->height >> level) == 0))
+    level--;
+
+  if (level == 0)
+    return g_object_ref (self);
+
+  size = (gsize) (self->width >> level) * (self->height >> level) * 4;
+  if (size > MAX_MIPMAP_MEMORY)
+    return g_object_ref (self);
+
+  G_LOCK (mipmaps);
+
+  if (level < self->n_mipmaps && self->mipmaps[level])
+    {
+      mipmap = self->mipmaps[level];
+      g_queue_unlink (&mipmap_lru, &mipmap->link);
+      g_queue_push_head_link (&mipmap_lru, &mipmap->link);
+      texture = g_object_ref (mipmap->texture);
+      G_UNLOCK (mipmaps);
+      return texture;
+    }
+
+  /* Start from the closest level we already have */
+  source = self;
+  source_level = 0;
+  for (i = MIN (level, self->n_mipmaps); i > 1; i--)
+    {
+      if (self->mipmaps[i - 1])
+        {
+          source = self->mipmaps[i - 1]->texture;
+          source_level = i - 1;
+          break;
+        }
+    }
+
+  /* The source may be evicted while we downscale it without
+   * holding the lock.
+   */
+  g_object_ref (source);
+
+  G_UNLOCK (mipmaps);
+
+  width = source->width;
+  height = source->height;
+  stride = width * 4;
+  data = g_malloc_n (height, stride);
+  gdk_texture_do_download (source, GDK_MEMORY_DEFAULT, data, stride);
+  g_object_unref (source);
+
+  for (; source_level < level; source_level++)
+    {
+      guchar *scaled = gdk_texture_downscale (data, width, height, stride, &width, &height);
+
+      g_free (data);
+      data = scaled;
+      stride = width * 4;
+    }
+
+  bytes = g_bytes_new_take (data, height * stride);
+  texture = gdk_memory_texture_new (width, height, GDK_MEMORY_DEFAULT, bytes, stride);
+  g_bytes_unref (bytes);
+
+  removed = g_ptr_array_new_with_free_func (g_object_unref);
+
+  G_LOCK (mipmaps);
+
+  if (level >= self->n_mipmaps)
+    {
+      self->mipmaps = g_renew (GdkTextureMipmap *, self->mipmaps, level + 1);
+      memset (self->mipmaps + self->n_mipmaps, 0, sizeof (GdkTextureMipmap *) * (level + 1 - self->n_mipmaps));
+      self->n_mipmaps = level + 1;
+    }
+
+  /* Another thread may have created the same level in the meantime */
+  if (self->mipmaps[level])
+    {
+      g_ptr_array_add (removed, texture);
+      texture = g_object_ref (self->mipmaps[level]->texture);
+    }
+  else
+    {
+      while (mipmap_memory + gdk_texture_get_mipmap_size (texture) > MAX_MIPMAP_MEMORY &&
+             mipmap_lru.tail != NULL)
+        g_ptr_array_add (removed, gdk_texture_mipmap_remove (mipmap_lru.tail->data));
+
+      mipmap = g_slice_new0 (GdkTextureMipmap);
+      mipmap->texture = g_object_ref (texture);
+      mipmap->owner = self;
+      mipmap->level = level;
+      mipmap->link.data = mipmap;
+      g_queue_push_head_link (&mipmap_lru, &mipmap->link);
+      mipmap_memory += gdk_texture_get_mipmap_size (texture);
+
+      self->mipmaps[level] = mipmap;
+    }
+
+  G_UNLOCK (mipmaps);
+
+  /* Unref outside the lock, finalizing the mipmaps takes it again */
+  g_ptr_array_unref (removed);
+
+  return texture;
+}
+
+/*<private>
+ * gdk_texture_get_mipmap_memory:
+ *
+ * Returns: the number of bytes used by all textures created
+ *   by gdk_texture_get_mipmap()
+ */
+gsize
+gdk_texture_get_mipmap_memory (void)
+{
+  gsize result;
+
+  G_LOCK (mipmaps);
+  result = mipmap_memory;
+  G_UNLOCK (mipmaps);
+
+  return result;
+}
+
 /**
  * gdk_texture_save_to_png:
  * @texture: a `GdkTexture`
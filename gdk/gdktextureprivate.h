@@ -11,6 +11,8 @@ G_BEGIN_DECLS
 #define GDK_IS_TEXTURE_CLASS(klass)         (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_TEXTURE))
 #define GDK_TEXTURE_GET_CLASS(obj)          (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_TEXTURE, GdkTextureClass))
 
+typedef struct _GdkTextureMipmap GdkTextureMipmap;
+
 struct _GdkTexture
 {
   GObject parent_instance;
@@ -22,6 +24,14 @@ struct _GdkTexture
   gpointer render_key;
   gpointer render_data;
   GDestroyNotify render_notify;
+
+  /* downscaled copies, indexed by mipmap level */
+  GdkTextureMipmap **mipmaps;
+  guint n_mipmaps;
+
+  /* the texture this one is an update of, and what changed */
+  GdkTexture *update_texture;
+  cairo_region_t *update_region;
 };
 
 struct _GdkTextureClass {
@@ -51,6 +61,16 @@ gboolean                gdk_texture_set_render_data     (GdkTexture
 void                    gdk_texture_clear_render_data   (GdkTexture             *self);
 gpointer                gdk_texture_get_render_data     (GdkTexture             *self,
                                                          gpointer                key);
+gpointer                gdk_texture_steal_render_data   (GdkTexture             *self,
+                                                         gpointer                key);
+
+void                    gdk_texture_set_update          (GdkTexture             *self,
+                                                         GdkTexture             *previous,
+                                                         const cairo_region_t   *region);
+
+GdkTexture *            gdk_texture_get_mipmap          (GdkTexture             *self,
+                                                         double                  scale);
+gsize                   gdk_texture_get_mipmap_memory   (void);
 
 G_END_DECLS
 
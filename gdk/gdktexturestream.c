@@ -0,0 +1,409 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdktexturestream.h"
+
+#include "gdkmemoryformatprivate.h"
+#include "gdkmemorytextureprivate.h"
+#include "gdktextureprivate.h"
+
+#include <string.h>
+
+/**
+ * GdkTextureStream:
+ *
+ * `GdkTextureStream` creates a sequence of memory textures of the same
+ * size and format, like the frames of a video or an animation.
+ *
+ * The memory of the textures is reused once they are no longer used,
+ * and each texture knows which region changed since the previous one,
+ * so renderers can update the texture they already have in place
+ * instead of uploading every frame completely.
+ *
+ * To produce a frame, call [method@Gdk.TextureStream.begin_frame]
+ * to get the memory to draw to. It already contains the contents of
+ * the previous frame, so only the changed region needs to be drawn.
+ * Then call [method@Gdk.TextureStream.end_frame] with that region
+ * to get the texture.
+ *
+ * Since: 4.6
+ */
+
+/* The number of frames we remember the damage for */
+#define MAX_AGE 4
+/* The number of unused buffers we keep around */
+#define MAX_FREE_BUFFERS 3
+
+typedef struct _Pool Pool;
+typedef struct _Buffer Buffer;
+
+/* The pool is shared between the stream and all textures using its
+ * buffers, as textures may outlive the stream or be released in
+ * other threads.
+ */
+struct _Pool
+{
+  gatomicrefcount ref_count;
+  GMutex mutex;
+  gsize size;
+  gboolean closed;
+  GSList *free_buffers;
+  guint n_free_buffers;
+};
+
+struct _Buffer
+{
+  Pool *pool;
+  guchar *data;
+  /* the frame whose contents the buffer holds, or 0 */
+  guint64 frame;
+};
+
+struct _GdkTextureStream
+{
+  GObject parent_instance;
+
+  int width;
+  int height;
+  GdkMemoryFormat format;
+  gsize stride;
+
+  Pool *pool;
+  Buffer *current;
+
+  guint64 frame;
+  GdkTexture *last_texture;
+  /* Kept alive so renderers can still update it to last_texture
+   * after the application dropped it */
+  GdkTexture *previous_texture;
+  const guchar *last_data;
+  cairo_region_t *damage[MAX_AGE];
+};
+
+struct _GdkTextureStreamClass
+{
+  GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (GdkTextureStream, gdk_texture_stream, G_TYPE_OBJECT)
+
+static Pool *
+pool_ref (Pool *pool)
+{
+  g_atomic_ref_count_inc (&pool->ref_count);
+
+  return pool;
+}
+
+static void
+pool_unref (Pool *pool)
+{
+  if (!g_atomic_ref_count_dec (&pool->ref_count))
+    return;
+
+  g_assert (pool->free_buffers == NULL);
+
+  g_mutex_clear (&pool->mutex);
+  g_free (pool);
+}
+
+static void
+buffer_free (Buffer *buffer)
+{
+  g_free (buffer->data);
+  g_free (buffer);
+}
+
+static void
+buffer_release (gpointer data)
+{
+  Buffer *buffer = data;
+  Pool *pool = buffer->pool;
+
+  g_mutex_lock (&pool->mutex);
+
+  if (!pool->closed && pool->n_free_buffers < MAX_FREE_BUFFERS)
+    {
+      pool->free_buffers = g_slist_prepend (pool->free_buffers, buffer);
+      pool->n_free_buffers++;
+      buffer = NULL;
+    }
+
+  g_mutex_unlock (&pool->mutex);
+
+  if (buffer)
+    buffer_free (buffer);
+
+  pool_unref (pool);
+}
+
+static Buffer *
+pool_get_buffer (Pool *pool)
+{
+  Buffer *buffer = NULL;
+
+  g_mutex_lock (&pool->mutex);
+
+  if (pool->free_buffers)
+    {
+      buffer = pool->free_buffers->data;
+      pool->free_buffers = g_slist_delete_link (pool->free_buffers, pool->free_buffers);
+      pool->n_free_buffers--;
+    }
+
+  g_mutex_unlock (&pool->mutex);
+
+  if (buffer == NULL)
+    {
+      buffer = g_new (Buffer, 1);
+      buffer->pool = pool;
+      buffer->data = g_malloc (pool->size);
+      buffer->frame = 0;
+    }
+
+  return buffer;
+}
+
+static void
+gdk_texture_stream_finalize (GObject *object)
+{
+  GdkTextureStream *self = GDK_TEXTURE_STREAM (object);
+  GSList *free_buffers;
+  guint i;
+
+  if (self->current)
+    buffer_free (self->current);
+
+  g_clear_object (&self->last_texture);
+  g_clear_object (&self->previous_texture);
+
+  for (i = 0; i < MAX_AGE; i++)
+    g_clear_pointer (&self->damage[i], cairo_region_destroy);
+
+  g_mutex_lock (&self->pool->mutex);
+  self->pool->closed = TRUE;
+  free_buffers = self->pool->free_buffers;
+  self->pool->free_buffers = NULL;
+  self->pool->n_free_buffers = 0;
+  g_mutex_unlock (&self->pool->mutex);
+
+  g_slist_free_full (free_buffers, (GDestroyNotify) buffer_free);
+  pool_unref (self->pool);
+
+  G_OBJECT_CLASS (gdk_texture_stream_parent_class)->finalize (object);
+}
+
+static void
+gdk_texture_stream_class_init (GdkTextureStreamClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = gdk_texture_stream_finalize;
+}
+
+static void
+gdk_texture_stream_init (GdkTextureStream *self)
+{
+}
+
+/**
+ * gdk_texture_stream_new:
+ * @width: the width of the frames
+ * @height: the height of the frames
+ * @format: the memory format of the frames
+ *
+ * Creates a new `GdkTextureStream` for frames of the given size
+ * and format.
+ *
+ * Returns: a new `GdkTextureStream`
+ *
+ * Since: 4.6
+ */
+GdkTextureStream *
+gdk_texture_stream_new (int             width,
+                        int             height,
+                        GdkMemoryFormat format)
+{
+  GdkTextureStream *self;
+  gsize align;
+
+  g_return_val_if_fail (width > 0, NULL);
+  g_return_val_if_fail (height > 0, NULL);
+  g_return_val_if_fail (format < GDK_MEMORY_N_FORMATS, NULL);
+
+  self = g_object_new (GDK_TYPE_TEXTURE_STREAM, NULL);
+
+  self->width = width;
+  self->height = height;
+  self->format = format;
+
+  align = MAX (gdk_memory_format_alignment (format), 4);
+  self->stride = (width * gdk_memory_format_bytes_per_pixel (format) + align - 1) / align * align;
+
+  self->pool = g_new0 (Pool, 1);
+  g_atomic_ref_count_init (&self->pool->ref_count);
+  g_mutex_init (&self->pool->mutex);
+  self->pool->size = self->stride * height;
+
+  return self;
+}
+
+static void
+gdk_texture_stream_copy_rectangle (GdkTextureStream            *self,
+                                   guchar                      *data,
+                                   const cairo_rectangle_int_t *rect)
+{
+  gsize bpp = gdk_memory_format_bytes_per_pixel (self->format);
+  int y;
+
+  for (y = rect->y; y < rect->y + rect->height; y++)
+    memcpy (data + y * self->stride + rect->x * bpp,
+            self->last_data + y * self->stride + rect->x * bpp,
+            rect->width * bpp);
+}
+
+/* Copies everything that changed since the buffer was last used from
+ * the last frame, so that the buffer contains the last frame.
+ */
+static void
+gdk_texture_stream_update_buffer (GdkTextureStream *self,
+                                  Buffer           *buffer)
+{
+  cairo_region_t *region;
+  guint64 f;
+  int i, n;
+
+  if (self->last_texture == NULL || buffer->frame == self->frame)
+    return;
+
+  if (buffer->frame == 0 || self->frame - buffer->frame > MAX_AGE)
+    {
+      memcpy (buffer->data, self->last_data, self->pool->size);
+      return;
+    }
+
+  region = cairo_region_create ();
+  for (f = buffer->frame + 1; f <= self->frame; f++)
+    cairo_region_union (region, self->damage[f % MAX_AGE]);
+
+  n = cairo_region_num_rectangles (region);
+  for (i = 0; i < n; i++)
+    {
+      cairo_rectangle_int_t rect;
+
+      cairo_region_get_rectangle (region, i, &rect);
+      gdk_texture_stream_copy_rectangle (self, buffer->data, &rect);
+    }
+
+  cairo_region_destroy (region);
+}
+
+/**
+ * gdk_texture_stream_begin_frame:
+ * @self: a `GdkTextureStream`
+ * @out_stride: (out): return location for the rowstride of the memory
+ *
+ * Starts a new frame and returns the memory to draw it to.
+ *
+ * The memory contains the previous frame, if there was one, so only
+ * the parts that change need to be drawn. It is valid until
+ * [method@Gdk.TextureStream.end_frame] is called.
+ *
+ * Returns: (transfer none): the memory for the new frame
+ *
+ * Since: 4.6
+ */
+guchar *
+gdk_texture_stream_begin_frame (GdkTextureStream *self,
+                                gsize            *out_stride)
+{
+  g_return_val_if_fail (GDK_IS_TEXTURE_STREAM (self), NULL);
+  g_return_val_if_fail (self->current == NULL, NULL);
+  g_return_val_if_fail (out_stride != NULL, NULL);
+
+  self->current = pool_get_buffer (self->pool);
+  gdk_texture_stream_update_buffer (self, self->current);
+
+  *out_stride = self->stride;
+
+  return self->current->data;
+}
+
+/**
+ * gdk_texture_stream_end_frame:
+ * @self: a `GdkTextureStream`
+ * @damage: (nullable): the region that changed since the previous
+ *   frame, or %NULL if everything changed
+ *
+ * Finishes the frame started with [method@Gdk.TextureStream.begin_frame]
+ * and returns it as a texture.
+ *
+ * Returns: (transfer full): the texture for the frame
+ *
+ * Since: 4.6
+ */
+GdkTexture *
+gdk_texture_stream_end_frame (GdkTextureStream     *self,
+                              const cairo_region_t *damage)
+{
+  cairo_region_t *region;
+  GdkTexture *texture;
+  GBytes *bytes;
+  Buffer *buffer;
+
+  g_return_val_if_fail (GDK_IS_TEXTURE_STREAM (self), NULL);
+  g_return_val_if_fail (self->current != NULL, NULL);
+
+  buffer = self->current;
+  self->current = NULL;
+
+  if (damage && self->last_texture)
+    {
+      region = cairo_region_copy (damage);
+      cairo_region_intersect_rectangle (region,
+                                        &(cairo_rectangle_int_t) { 0, 0, self->width, self->height });
+    }
+  else
+    {
+      region = cairo_region_create_rectangle (&(cairo_rectangle_int_t) { 0, 0, self->width, self->height });
+    }
+
+  self->frame++;
+  buffer->frame = self->frame;
+  g_clear_pointer (&self->damage[self->frame % MAX_AGE], cairo_region_destroy);
+  self->damage[self->frame % MAX_AGE] = region;
+
+  bytes = g_bytes_new_with_free_func (buffer->data,
+                                      self->pool->size,
+                                      buffer_release,
+                                      buffer);
+  pool_ref (self->pool);
+
+  texture = gdk_memory_texture_new (self->width, self->height, self->format, bytes, self->stride);
+  g_bytes_unref (bytes);
+
+  gdk_texture_set_update (texture, self->last_texture, region);
+
+  g_clear_object (&self->previous_texture);
+  self->previous_texture = self->last_texture;
+  self->last_texture = g_object_ref (texture);
+  self->last_data = buffer->data;
+
+  return texture;
+}
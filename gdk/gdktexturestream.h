@@ -0,0 +1,58 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GDK_TEXTURE_STREAM_H__
+#define __GDK_TEXTURE_STREAM_H__
+
+#if !defined (__GDK_H_INSIDE__) && !defined (GTK_COMPILATION)
+#error "Only <gdk/gdk.h> can be included directly."
+#endif
+
+#include <gdk/gdkenums.h>
+#include <gdk/gdktexture.h>
+
+G_BEGIN_DECLS
+
+#define GDK_TYPE_TEXTURE_STREAM (gdk_texture_stream_get_type ())
+
+#define GDK_TEXTURE_STREAM(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), GDK_TYPE_TEXTURE_STREAM, GdkTextureStream))
+#define GDK_IS_TEXTURE_STREAM(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GDK_TYPE_TEXTURE_STREAM))
+
+typedef struct _GdkTextureStream        GdkTextureStream;
+typedef struct _GdkTextureStreamClass   GdkTextureStreamClass;
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GdkTextureStream, g_object_unref)
+
+
+GDK_AVAILABLE_IN_4_6
+GType                   gdk_texture_stream_get_type         (void) G_GNUC_CONST;
+
+GDK_AVAILABLE_IN_4_6
+GdkTextureStream *      gdk_texture_stream_new              (int                   width,
+                                                             int                   height,
+                                                             GdkMemoryFormat       format);
+
+GDK_AVAILABLE_IN_4_6
+guchar *                gdk_texture_stream_begin_frame      (GdkTextureStream     *self,
+                                                             gsize                *out_stride);
+GDK_AVAILABLE_IN_4_6
+GdkTexture *            gdk_texture_stream_end_frame        (GdkTextureStream     *self,
+                                                             const cairo_region_t *damage);
+
+G_END_DECLS
+
+#endif /* __GDK_TEXTURE_STREAM_H__ */
@@ -0,0 +1,144 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkconfig.h"
+
+#include "gdkcairocontext-headless.h"
+#include "gdkcairo.h"
+#include "gdktextureprivate.h"
+#include "gdkprivate-headless.h"
+
+/* Every frame is drawn into a new image surface, which is handed
+ * out as the texture for the frame once it is done. The pixels of
+ * the previous frame are copied over first, so that only the parts
+ * that changed need to be redrawn.
+ */
+
+G_DEFINE_TYPE (GdkHeadlessCairoContext, gdk_headless_cairo_context, GDK_TYPE_CAIRO_CONTEXT)
+
+static void
+gdk_headless_cairo_context_dispose (GObject *object)
+{
+  GdkHeadlessCairoContext *self = GDK_HEADLESS_CAIRO_CONTEXT (object);
+
+  g_clear_pointer (&self->paint_surface, cairo_surface_destroy);
+  g_clear_pointer (&self->last_surface, cairo_surface_destroy);
+
+  G_OBJECT_CLASS (gdk_headless_cairo_context_parent_class)->dispose (object);
+}
+
+static void
+gdk_headless_cairo_context_begin_frame (GdkDrawContext *draw_context,
+                                        gboolean        prefers_high_depth,
+                                        cairo_region_t *region)
+{
+  GdkHeadlessCairoContext *self = GDK_HEADLESS_CAIRO_CONTEXT (draw_context);
+  GdkSurface *surface = gdk_draw_context_get_surface (draw_context);
+  cairo_t *cr;
+  int width, height, scale;
+
+  width = gdk_surface_get_width (surface);
+  height = gdk_surface_get_height (surface);
+  scale = gdk_surface_get_scale_factor (surface);
+  self->paint_surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                                    width * scale, height * scale);
+  cairo_surface_set_device_scale (self->paint_surface, scale, scale);
+
+  if (self->last_surface &&
+      cairo_image_surface_get_width (self->last_surface) == width * scale &&
+      cairo_image_surface_get_height (self->last_surface) == height * scale)
+    {
+      cr = cairo_create (self->paint_surface);
+      cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
+      cairo_set_source_surface (cr, self->last_surface, 0, 0);
+      cairo_paint (cr);
+
+      /* clear the repaint area */
+      gdk_cairo_region (cr, region);
+      cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+      cairo_fill (cr);
+      cairo_destroy (cr);
+    }
+  else
+    {
+      /* New image surfaces start out cleared, but everything
+       * needs to be drawn.
+       */
+      cairo_region_union_rectangle (region, &(cairo_rectangle_int_t) { 0, 0, width, height });
+    }
+}
+
+static void
+gdk_headless_cairo_context_end_frame (GdkDrawContext *draw_context,
+                                      cairo_region_t *painted)
+{
+  GdkHeadlessCairoContext *self = GDK_HEADLESS_CAIRO_CONTEXT (draw_context);
+  GdkSurface *surface = gdk_draw_context_get_surface (draw_context);
+  GdkTexture *texture;
+
+  cairo_surface_flush (self->paint_surface);
+
+  /* The texture keeps a reference to the surface, which is
+   * not drawn to again after this point.
+   */
+  texture = gdk_texture_new_for_surface (self->paint_surface);
+  gdk_headless_surface_set_last_frame (surface, texture);
+  g_object_unref (texture);
+
+  g_clear_pointer (&self->last_surface, cairo_surface_destroy);
+  self->last_surface = self->paint_surface;
+  self->paint_surface = NULL;
+}
+
+static void
+gdk_headless_cairo_context_surface_resized (GdkDrawContext *draw_context)
+{
+  GdkHeadlessCairoContext *self = GDK_HEADLESS_CAIRO_CONTEXT (draw_context);
+
+  g_clear_pointer (&self->last_surface, cairo_surface_destroy);
+}
+
+static cairo_t *
+gdk_headless_cairo_context_cairo_create (GdkCairoContext *context)
+{
+  GdkHeadlessCairoContext *self = GDK_HEADLESS_CAIRO_CONTEXT (context);
+
+  return cairo_create (self->paint_surface);
+}
+
+static void
+gdk_headless_cairo_context_class_init (GdkHeadlessCairoContextClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GdkDrawContextClass *draw_context_class = GDK_DRAW_CONTEXT_CLASS (klass);
+  GdkCairoContextClass *cairo_context_class = GDK_CAIRO_CONTEXT_CLASS (klass);
+
+  gobject_class->dispose = gdk_headless_cairo_context_dispose;
+
+  draw_context_class->begin_frame = gdk_headless_cairo_context_begin_frame;
+  draw_context_class->end_frame = gdk_headless_cairo_context_end_frame;
+  draw_context_class->surface_resized = gdk_headless_cairo_context_surface_resized;
+
+  cairo_context_class->cairo_create = gdk_headless_cairo_context_cairo_create;
+}
+
+static void
+gdk_headless_cairo_context_init (GdkHeadlessCairoContext *self)
+{
+}
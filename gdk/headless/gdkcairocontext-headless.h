@@ -0,0 +1,56 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GDK_HEADLESS_CAIRO_CONTEXT__
+#define __GDK_HEADLESS_CAIRO_CONTEXT__
+
+#include "gdkconfig.h"
+
+#include "gdkcairocontextprivate.h"
+
+G_BEGIN_DECLS
+
+#define GDK_TYPE_HEADLESS_CAIRO_CONTEXT               (gdk_headless_cairo_context_get_type ())
+#define GDK_HEADLESS_CAIRO_CONTEXT(obj)               (G_TYPE_CHECK_INSTANCE_CAST ((obj), GDK_TYPE_HEADLESS_CAIRO_CONTEXT, GdkHeadlessCairoContext))
+#define GDK_IS_HEADLESS_CAIRO_CONTEXT(obj)            (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GDK_TYPE_HEADLESS_CAIRO_CONTEXT))
+#define GDK_HEADLESS_CAIRO_CONTEXT_CLASS(klass)       (G_TYPE_CHECK_CLASS_CAST ((klass), GDK_TYPE_HEADLESS_CAIRO_CONTEXT, GdkHeadlessCairoContextClass))
+#define GDK_IS_HEADLESS_CAIRO_CONTEXT_CLASS(klass)    (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_HEADLESS_CAIRO_CONTEXT))
+#define GDK_HEADLESS_CAIRO_CONTEXT_GET_CLASS(obj)     (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_HEADLESS_CAIRO_CONTEXT, GdkHeadlessCairoContextClass))
+
+typedef struct _GdkHeadlessCairoContext GdkHeadlessCairoContext;
+typedef struct _GdkHeadlessCairoContextClass GdkHeadlessCairoContextClass;
+
+struct _GdkHeadlessCairoContext
+{
+  GdkCairoContext parent_instance;
+
+  /* The surface being drawn in the current frame */
+  cairo_surface_t *paint_surface;
+  /* The contents of the last frame, shared with its texture */
+  cairo_surface_t *last_surface;
+};
+
+struct _GdkHeadlessCairoContextClass
+{
+  GdkCairoContextClass parent_class;
+};
+
+GType gdk_headless_cairo_context_get_type (void) G_GNUC_CONST;
+
+G_END_DECLS
+
+#endif /* __GDK_HEADLESS_CAIRO_CONTEXT__ */
@@ -0,0 +1,145 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkdevice-headless.h"
+
+#include "gdkdisplayprivate.h"
+#include "gdkprivate-headless.h"
+#include "gdkseat.h"
+#include "gdksurfaceprivate.h"
+
+/* There is no pointer or keyboard behind these devices. They exist
+ * so that seats, grabs and focus work the same way they do on the
+ * other backends.
+ */
+
+G_DEFINE_TYPE (GdkHeadlessDevice, gdk_headless_device, GDK_TYPE_DEVICE)
+
+static void
+gdk_headless_device_set_surface_cursor (GdkDevice  *device,
+                                        GdkSurface *surface,
+                                        GdkCursor  *cursor)
+{
+}
+
+static GdkGrabStatus
+gdk_headless_device_grab (GdkDevice    *device,
+                          GdkSurface   *surface,
+                          gboolean      owner_events,
+                          GdkEventMask  event_mask,
+                          GdkSurface   *confine_to,
+                          GdkCursor    *cursor,
+                          guint32       time_)
+{
+  return GDK_GRAB_SUCCESS;
+}
+
+static void
+gdk_headless_device_ungrab (GdkDevice *device,
+                            guint32    time_)
+{
+}
+
+static GdkSurface *
+gdk_headless_device_surface_at_position (GdkDevice       *device,
+                                         double          *win_x,
+                                         double          *win_y,
+                                         GdkModifierType *mask)
+{
+  if (win_x)
+    *win_x = 0;
+  if (win_y)
+    *win_y = 0;
+  if (mask)
+    *mask = 0;
+
+  return NULL;
+}
+
+static void
+gdk_headless_device_class_init (GdkHeadlessDeviceClass *klass)
+{
+  GdkDeviceClass *device_class = GDK_DEVICE_CLASS (klass);
+
+  device_class->set_surface_cursor = gdk_headless_device_set_surface_cursor;
+  device_class->grab = gdk_headless_device_grab;
+  device_class->ungrab = gdk_headless_device_ungrab;
+  device_class->surface_at_position = gdk_headless_device_surface_at_position;
+}
+
+static void
+gdk_headless_device_init (GdkHeadlessDevice *device_core)
+{
+  GdkDevice *device;
+
+  device = GDK_DEVICE (device_core);
+
+  _gdk_device_add_axis (device, GDK_AXIS_X, 0, 0, 1);
+  _gdk_device_add_axis (device, GDK_AXIS_Y, 0, 0, 1);
+}
+
+void
+_gdk_headless_surface_grab_check_unmap (GdkSurface *surface,
+                                        gulong      serial)
+{
+  GdkDisplay *display = gdk_surface_get_display (surface);
+  GdkSeat *seat;
+  GList *devices, *d;
+
+  seat = gdk_display_get_default_seat (display);
+
+  devices = gdk_seat_get_devices (seat, GDK_SEAT_CAPABILITY_ALL);
+  devices = g_list_prepend (devices, gdk_seat_get_keyboard (seat));
+  devices = g_list_prepend (devices, gdk_seat_get_pointer (seat));
+
+  /* End all grabs on the newly hidden surface */
+  for (d = devices; d; d = d->next)
+    _gdk_display_end_device_grab (display, d->data, serial, surface, TRUE);
+
+  g_list_free (devices);
+}
+
+void
+_gdk_headless_surface_grab_check_destroy (GdkSurface *surface)
+{
+  GdkDisplay *display = gdk_surface_get_display (surface);
+  GdkSeat *seat;
+  GdkDeviceGrabInfo *grab;
+  GList *devices, *d;
+
+  seat = gdk_display_get_default_seat (display);
+
+  devices = NULL;
+  devices = g_list_prepend (devices, gdk_seat_get_keyboard (seat));
+  devices = g_list_prepend (devices, gdk_seat_get_pointer (seat));
+
+  for (d = devices; d; d = d->next)
+    {
+      /* Make sure there is no lasting grab in this surface */
+      grab = _gdk_display_get_last_device_grab (display, d->data);
+
+      if (grab && grab->surface == surface)
+        {
+          grab->serial_end = grab->serial_start;
+          grab->implicit_ungrab = TRUE;
+        }
+    }
+
+  g_list_free (devices);
+}
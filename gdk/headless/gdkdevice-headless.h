@@ -0,0 +1,50 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GDK_DEVICE_HEADLESS_H__
+#define __GDK_DEVICE_HEADLESS_H__
+
+#include <gdk/gdkdeviceprivate.h>
+
+G_BEGIN_DECLS
+
+#define GDK_TYPE_HEADLESS_DEVICE         (gdk_headless_device_get_type ())
+#define GDK_HEADLESS_DEVICE(o)           (G_TYPE_CHECK_INSTANCE_CAST ((o), GDK_TYPE_HEADLESS_DEVICE, GdkHeadlessDevice))
+#define GDK_HEADLESS_DEVICE_CLASS(c)     (G_TYPE_CHECK_CLASS_CAST ((c), GDK_TYPE_HEADLESS_DEVICE, GdkHeadlessDeviceClass))
+#define GDK_IS_HEADLESS_DEVICE(o)        (G_TYPE_CHECK_INSTANCE_TYPE ((o), GDK_TYPE_HEADLESS_DEVICE))
+#define GDK_IS_HEADLESS_DEVICE_CLASS(c)  (G_TYPE_CHECK_CLASS_TYPE ((c), GDK_TYPE_HEADLESS_DEVICE))
+#define GDK_HEADLESS_DEVICE_GET_CLASS(o) (G_TYPE_INSTANCE_GET_CLASS ((o), GDK_TYPE_HEADLESS_DEVICE, GdkHeadlessDeviceClass))
+
+typedef struct _GdkHeadlessDevice GdkHeadlessDevice;
+typedef struct _GdkHeadlessDeviceClass GdkHeadlessDeviceClass;
+
+struct _GdkHeadlessDevice
+{
+  GdkDevice parent_instance;
+};
+
+struct _GdkHeadlessDeviceClass
+{
+  GdkDeviceClass parent_class;
+};
+
+G_GNUC_INTERNAL
+GType gdk_headless_device_get_type (void) G_GNUC_CONST;
+
+G_END_DECLS
+
+#endif /* __GDK_DEVICE_HEADLESS_H__ */
@@ -0,0 +1,366 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkdisplay-headless.h"
+
+#include "gdkcairocontext-headless.h"
+#include "gdkdevice-headless.h"
+#include "gdkdeviceprivate.h"
+#include "gdkmonitor-headless.h"
+#include "gdkprivate-headless.h"
+#include "gdkseatdefaultprivate.h"
+#include "gdk-private.h"
+
+#include <stdio.h>
+
+/**
+ * GdkHeadlessDisplay:
+ *
+ * The display of the headless backend.
+ *
+ * The headless backend does not connect to any windowing system.
+ * Surfaces only exist in memory, and what is drawn to them can be
+ * retrieved with gdk_headless_surface_get_last_frame().
+ * Frames are drawn as fast as the application produces them, without
+ * waiting for a vblank.
+ *
+ * The monitors of the display are described by the display name, or
+ * the `HEADLESS_DISPLAY` environment variable, as a comma-separated
+ * list of sizes with an optional scale, such as `1920x1080@2,1024x768`.
+ * The monitors are placed next to each other, from left to right. They
+ * can be changed later with gdk_headless_display_add_monitor()
+ * and gdk_headless_display_remove_monitor().
+ *
+ * Since: 4.6
+ */
+
+#define DEFAULT_MONITORS "1024x768"
+
+typedef struct {
+  GdkRectangle geometry;
+  int scale;
+} MonitorSpec;
+
+static void   gdk_headless_display_dispose            (GObject            *object);
+static void   gdk_headless_display_finalize           (GObject            *object);
+
+G_DEFINE_TYPE (GdkHeadlessDisplay, gdk_headless_display, GDK_TYPE_DISPLAY)
+
+static void
+gdk_headless_display_init (GdkHeadlessDisplay *display)
+{
+  gdk_display_set_input_shapes (GDK_DISPLAY (display), FALSE);
+
+  display->monitors = g_list_store_new (GDK_TYPE_MONITOR);
+}
+
+static GdkDevice *
+create_device (GdkDisplay     *display,
+               const char     *name,
+               GdkInputSource  source,
+               gboolean        has_cursor)
+{
+  return g_object_new (GDK_TYPE_HEADLESS_DEVICE,
+                       "name", name,
+                       "source", source,
+                       "has-cursor", has_cursor,
+                       "display", display,
+                       NULL);
+}
+
+static GArray *
+parse_monitors (const char *spec)
+{
+  GArray *monitors;
+  char **parts;
+  int x, i;
+
+  monitors = g_array_new (FALSE, FALSE, sizeof (MonitorSpec));
+  parts = g_strsplit (spec, ",", 0);
+
+  x = 0;
+  for (i = 0; parts[i] != NULL; i++)
+    {
+      MonitorSpec monitor = { { x, 0, 0, 0 }, 1 };
+
+      if (sscanf (parts[i], "%dx%d@%d",
+                  &monitor.geometry.width,
+                  &monitor.geometry.height,
+                  &monitor.scale) < 2 ||
+          monitor.geometry.width <= 0 ||
+          monitor.geometry.height <= 0 ||
+          monitor.scale <= 0)
+        {
+          GDK_NOTE (MISC, g_message ("Invalid headless monitor \"%s\"", parts[i]));
+          g_clear_pointer (&monitors, g_array_unref);
+          break;
+        }
+
+      g_array_append_val (monitors, monitor);
+      x += monitor.geometry.width;
+    }
+
+  g_strfreev (parts);
+
+  return monitors;
+}
+
+GdkDisplay *
+_gdk_headless_display_open (const char *display_name)
+{
+  GdkDisplay *display;
+  GdkHeadlessDisplay *headless_display;
+  GArray *monitors;
+  GdkSeat *seat;
+  guint i;
+
+  if (display_name == NULL)
+    display_name = g_getenv ("HEADLESS_DISPLAY");
+  if (display_name == NULL || display_name[0] == '\0')
+    display_name = DEFAULT_MONITORS;
+
+  monitors = parse_monitors (display_name);
+  if (monitors == NULL || monitors->len == 0)
+    {
+      g_clear_pointer (&monitors, g_array_unref);
+      return NULL;
+    }
+
+  display = g_object_new (GDK_TYPE_HEADLESS_DISPLAY, NULL);
+  headless_display = GDK_HEADLESS_DISPLAY (display);
+
+  headless_display->core_pointer = create_device (display, "Core Pointer", GDK_SOURCE_MOUSE, TRUE);
+  headless_display->core_keyboard = create_device (display, "Core Keyboard", GDK_SOURCE_KEYBOARD, FALSE);
+  headless_display->pointer = create_device (display, "Pointer", GDK_SOURCE_MOUSE, TRUE);
+  headless_display->keyboard = create_device (display, "Keyboard", GDK_SOURCE_KEYBOARD, FALSE);
+
+  _gdk_device_set_associated_device (headless_display->core_pointer, headless_display->core_keyboard);
+  _gdk_device_set_associated_device (headless_display->core_keyboard, headless_display->core_pointer);
+  _gdk_device_set_associated_device (headless_display->pointer, headless_display->core_pointer);
+  _gdk_device_set_associated_device (headless_display->keyboard, headless_display->core_keyboard);
+
+  seat = gdk_seat_default_new_for_logical_pair (headless_display->core_pointer,
+                                                headless_display->core_keyboard);
+
+  gdk_display_add_seat (display, seat);
+  gdk_seat_default_add_physical_device (GDK_SEAT_DEFAULT (seat), headless_display->pointer);
+  gdk_seat_default_add_physical_device (GDK_SEAT_DEFAULT (seat), headless_display->keyboard);
+  g_object_unref (seat);
+
+  for (i = 0; i < monitors->len; i++)
+    {
+      MonitorSpec *monitor = &g_array_index (monitors, MonitorSpec, i);
+
+      gdk_headless_display_add_monitor (display, &monitor->geometry, monitor->scale);
+    }
+  g_array_unref (monitors);
+
+  g_signal_emit_by_name (display, "opened");
+
+  return display;
+}
+
+static const char *
+gdk_headless_display_get_name (GdkDisplay *display)
+{
+  return "Headless";
+}
+
+static void
+gdk_headless_display_beep (GdkDisplay *display)
+{
+}
+
+static void
+gdk_headless_display_sync (GdkDisplay *display)
+{
+}
+
+static void
+gdk_headless_display_flush (GdkDisplay *display)
+{
+}
+
+static gboolean
+gdk_headless_display_has_pending (GdkDisplay *display)
+{
+  return FALSE;
+}
+
+static void
+gdk_headless_display_queue_events (GdkDisplay *display)
+{
+}
+
+static void
+gdk_headless_display_dispose (GObject *object)
+{
+  GdkHeadlessDisplay *self = GDK_HEADLESS_DISPLAY (object);
+
+  if (self->monitors)
+    {
+      g_list_store_remove_all (self->monitors);
+      g_clear_object (&self->monitors);
+    }
+
+  G_OBJECT_CLASS (gdk_headless_display_parent_class)->dispose (object);
+}
+
+static void
+gdk_headless_display_finalize (GObject *object)
+{
+  GdkHeadlessDisplay *self = GDK_HEADLESS_DISPLAY (object);
+
+  g_clear_object (&self->keymap);
+
+  G_OBJECT_CLASS (gdk_headless_display_parent_class)->finalize (object);
+}
+
+static void
+gdk_headless_display_notify_startup_complete (GdkDisplay *display,
+                                              const char *startup_id)
+{
+}
+
+static gulong
+gdk_headless_display_get_next_serial (GdkDisplay *display)
+{
+  return ++GDK_HEADLESS_DISPLAY (display)->serial;
+}
+
+static GListModel *
+gdk_headless_display_get_monitors (GdkDisplay *display)
+{
+  GdkHeadlessDisplay *self = GDK_HEADLESS_DISPLAY (display);
+
+  return G_LIST_MODEL (self->monitors);
+}
+
+static gboolean
+gdk_headless_display_get_setting (GdkDisplay *display,
+                                  const char *name,
+                                  GValue     *value)
+{
+  return FALSE;
+}
+
+/**
+ * gdk_headless_display_add_monitor:
+ * @display: (type GdkHeadlessDisplay): the display
+ * @geometry: the geometry of the monitor, in application pixels
+ * @scale: the scale factor of the monitor
+ *
+ * Adds a virtual monitor to the display.
+ *
+ * Returns: (transfer none): the new monitor
+ *
+ * Since: 4.6
+ */
+GdkMonitor *
+gdk_headless_display_add_monitor (GdkDisplay         *display,
+                                  const GdkRectangle *geometry,
+                                  int                 scale)
+{
+  GdkHeadlessDisplay *self;
+  GdkMonitor *monitor;
+  char *connector;
+
+  g_return_val_if_fail (GDK_IS_HEADLESS_DISPLAY (display), NULL);
+  g_return_val_if_fail (geometry != NULL, NULL);
+  g_return_val_if_fail (geometry->width > 0 && geometry->height > 0, NULL);
+  g_return_val_if_fail (scale > 0, NULL);
+
+  self = GDK_HEADLESS_DISPLAY (display);
+
+  monitor = g_object_new (GDK_TYPE_HEADLESS_MONITOR,
+                          "display", display,
+                          NULL);
+
+  connector = g_strdup_printf ("Virtual-%u", ++self->n_monitors_added);
+  gdk_monitor_set_connector (monitor, connector);
+  g_free (connector);
+  gdk_monitor_set_manufacturer (monitor, "headless");
+  gdk_monitor_set_model (monitor, "virtual");
+  gdk_monitor_set_geometry (monitor, geometry);
+  gdk_monitor_set_physical_size (monitor, geometry->width * 25.4 / 96, geometry->height * 25.4 / 96);
+  gdk_monitor_set_scale_factor (monitor, scale);
+  gdk_monitor_set_refresh_rate (monitor, 60000);
+
+  g_list_store_append (self->monitors, monitor);
+  g_object_unref (monitor);
+
+  return monitor;
+}
+
+/**
+ * gdk_headless_display_remove_monitor:
+ * @display: (type GdkHeadlessDisplay): the display
+ * @monitor: a monitor of @display
+ *
+ * Removes a virtual monitor from the display.
+ *
+ * Since: 4.6
+ */
+void
+gdk_headless_display_remove_monitor (GdkDisplay *display,
+                                     GdkMonitor *monitor)
+{
+  GdkHeadlessDisplay *self;
+  guint position;
+
+  g_return_if_fail (GDK_IS_HEADLESS_DISPLAY (display));
+  g_return_if_fail (GDK_IS_HEADLESS_MONITOR (monitor));
+
+  self = GDK_HEADLESS_DISPLAY (display);
+
+  if (!g_list_store_find (self->monitors, monitor, &position))
+    return;
+
+  g_object_ref (monitor);
+  g_list_store_remove (self->monitors, position);
+  gdk_monitor_invalidate (monitor);
+  g_object_unref (monitor);
+}
+
+static void
+gdk_headless_display_class_init (GdkHeadlessDisplayClass *class)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (class);
+  GdkDisplayClass *display_class = GDK_DISPLAY_CLASS (class);
+
+  object_class->dispose = gdk_headless_display_dispose;
+  object_class->finalize = gdk_headless_display_finalize;
+
+  display_class->cairo_context_type = GDK_TYPE_HEADLESS_CAIRO_CONTEXT;
+
+  display_class->get_name = gdk_headless_display_get_name;
+  display_class->beep = gdk_headless_display_beep;
+  display_class->sync = gdk_headless_display_sync;
+  display_class->flush = gdk_headless_display_flush;
+  display_class->has_pending = gdk_headless_display_has_pending;
+  display_class->queue_events = gdk_headless_display_queue_events;
+
+  display_class->get_next_serial = gdk_headless_display_get_next_serial;
+  display_class->notify_startup_complete = gdk_headless_display_notify_startup_complete;
+  display_class->create_surface = _gdk_headless_display_create_surface;
+  display_class->get_keymap = _gdk_headless_display_get_keymap;
+
+  display_class->get_monitors = gdk_headless_display_get_monitors;
+  display_class->get_setting = gdk_headless_display_get_setting;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GDK_HEADLESS_DISPLAY__
+#define __GDK_HEADLESS_DISPLAY__
+
+#include "gdkheadlessdisplay.h"
+
+#include "gdkdisplayprivate.h"
+#include "gdkkeys.h"
+#include "gdksurface.h"
+
+G_BEGIN_DECLS
+
+struct _GdkHeadlessDisplay
+{
+  GdkDisplay parent_instance;
+
+  GdkDevice *core_pointer;
+  GdkDevice *core_keyboard;
+  GdkDevice *pointer;
+  GdkDevice *keyboard;
+
+  GdkKeymap *keymap;
+
+  GListStore *monitors;
+  guint n_monitors_added;
+
+  GdkSurface *focus_surface;
+
+  gulong serial;
+};
+
+struct _GdkHeadlessDisplayClass
+{
+  GdkDisplayClass parent_class;
+};
+
+G_END_DECLS
+
+#endif /* __GDK_HEADLESS_DISPLAY__ */
@@ -0,0 +1,31 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GDK_HEADLESS_H__
+#define __GDK_HEADLESS_H__
+
+#include <gdk/gdk.h>
+
+#define __GDKHEADLESS_H_INSIDE__
+
+#include <gdk/headless/gdkheadlessdisplay.h>
+#include <gdk/headless/gdkheadlesssurface.h>
+#include <gdk/headless/gdkheadlessmonitor.h>
+
+#undef __GDKHEADLESS_H_INSIDE__
+
+#endif /* __GDK_HEADLESS_H__ */
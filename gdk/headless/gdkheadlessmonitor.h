@@ -0,0 +1,41 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GDK_HEADLESS_MONITOR_H__
+#define __GDK_HEADLESS_MONITOR_H__
+
+#if !defined (__GDKHEADLESS_H_INSIDE__) && !defined (GTK_COMPILATION)
+#error "Only <gdk/headless/gdkheadless.h> can be included directly."
+#endif
+
+#include <gdk/gdkmonitor.h>
+
+G_BEGIN_DECLS
+
+#define GDK_TYPE_HEADLESS_MONITOR           (gdk_headless_monitor_get_type ())
+#define GDK_HEADLESS_MONITOR(object)        (G_TYPE_CHECK_INSTANCE_CAST ((object), GDK_TYPE_HEADLESS_MONITOR, GdkHeadlessMonitor))
+#define GDK_IS_HEADLESS_MONITOR(object)     (G_TYPE_CHECK_INSTANCE_TYPE ((object), GDK_TYPE_HEADLESS_MONITOR))
+
+typedef struct _GdkHeadlessMonitor      GdkHeadlessMonitor;
+typedef struct _GdkHeadlessMonitorClass GdkHeadlessMonitorClass;
+
+GDK_AVAILABLE_IN_4_6
+GType             gdk_headless_monitor_get_type            (void) G_GNUC_CONST;
+
+G_END_DECLS
+
+#endif  /* __GDK_HEADLESS_MONITOR_H__ */
@@ -0,0 +1,51 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GDK_HEADLESS_SURFACE_H__
+#define __GDK_HEADLESS_SURFACE_H__
+
+#if !defined (__GDKHEADLESS_H_INSIDE__) && !defined (GTK_COMPILATION)
+#error "Only <gdk/headless/gdkheadless.h> can be included directly."
+#endif
+
+#include <gdk/gdk.h>
+
+G_BEGIN_DECLS
+
+#define GDK_TYPE_HEADLESS_SURFACE              (gdk_headless_surface_get_type ())
+#define GDK_HEADLESS_SURFACE(object)           (G_TYPE_CHECK_INSTANCE_CAST ((object), GDK_TYPE_HEADLESS_SURFACE, GdkHeadlessSurface))
+#define GDK_HEADLESS_SURFACE_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GDK_TYPE_HEADLESS_SURFACE, GdkHeadlessSurfaceClass))
+#define GDK_IS_HEADLESS_SURFACE(object)        (G_TYPE_CHECK_INSTANCE_TYPE ((object), GDK_TYPE_HEADLESS_SURFACE))
+#define GDK_IS_HEADLESS_SURFACE_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GDK_TYPE_HEADLESS_SURFACE))
+#define GDK_HEADLESS_SURFACE_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GDK_TYPE_HEADLESS_SURFACE, GdkHeadlessSurfaceClass))
+
+#ifdef GTK_COMPILATION
+typedef struct _GdkHeadlessSurface GdkHeadlessSurface;
+#else
+typedef GdkSurface GdkHeadlessSurface;
+#endif
+typedef struct _GdkHeadlessSurfaceClass GdkHeadlessSurfaceClass;
+
+GDK_AVAILABLE_IN_4_6
+GType           gdk_headless_surface_get_type           (void);
+
+GDK_AVAILABLE_IN_4_6
+GdkTexture *    gdk_headless_surface_get_last_frame     (GdkSurface *surface);
+
+G_END_DECLS
+
+#endif /* __GDK_HEADLESS_SURFACE_H__ */
@@ -0,0 +1,42 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkmonitor-headless.h"
+
+/**
+ * GdkHeadlessMonitor:
+ *
+ * A virtual monitor of the headless backend.
+ *
+ * Monitors are added and removed with
+ * gdk_headless_display_add_monitor() and
+ * gdk_headless_display_remove_monitor().
+ */
+
+G_DEFINE_TYPE (GdkHeadlessMonitor, gdk_headless_monitor, GDK_TYPE_MONITOR)
+
+static void
+gdk_headless_monitor_init (GdkHeadlessMonitor *monitor)
+{
+}
+
+static void
+gdk_headless_monitor_class_init (GdkHeadlessMonitorClass *class)
+{
+}
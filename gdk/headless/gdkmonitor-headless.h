@@ -0,0 +1,34 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GDK_HEADLESS_MONITOR_PRIVATE_H__
+#define __GDK_HEADLESS_MONITOR_PRIVATE_H__
+
+#include "gdkmonitorprivate.h"
+
+#include "gdkheadlessmonitor.h"
+
+struct _GdkHeadlessMonitor
+{
+  GdkMonitor parent;
+};
+
+struct _GdkHeadlessMonitorClass {
+  GdkMonitorClass parent_class;
+};
+
+#endif
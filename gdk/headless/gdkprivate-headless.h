@@ -0,0 +1,48 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GDK_PRIVATE_HEADLESS_H__
+#define __GDK_PRIVATE_HEADLESS_H__
+
+#include "gdkdisplay-headless.h"
+#include "gdksurface-headless.h"
+
+#include "gdkheadlessdisplay.h"
+#include "gdkheadlesssurface.h"
+
+G_BEGIN_DECLS
+
+GdkDisplay * _gdk_headless_display_open           (const char     *display_name);
+GdkKeymap *  _gdk_headless_display_get_keymap     (GdkDisplay     *display);
+GdkSurface * _gdk_headless_display_create_surface (GdkDisplay     *display,
+                                                   GdkSurfaceType  surface_type,
+                                                   GdkSurface     *parent,
+                                                   int             x,
+                                                   int             y,
+                                                   int             width,
+                                                   int             height);
+
+void     gdk_headless_surface_set_last_frame      (GdkSurface *surface,
+                                                   GdkTexture *texture);
+
+void     _gdk_headless_surface_grab_check_destroy (GdkSurface *surface);
+void     _gdk_headless_surface_grab_check_unmap   (GdkSurface *surface,
+                                                   gulong      serial);
+
+G_END_DECLS
+
+#endif /* __GDK_PRIVATE_HEADLESS_H__ */
@@ -0,0 +1,1011 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdksurface-headless.h"
+
+#include "gdkdisplay-headless.h"
+#include "gdkdragsurfaceprivate.h"
+#include "gdkframeclockidleprivate.h"
+#include "gdkpopupprivate.h"
+#include "gdkprivate-headless.h"
+#include "gdkseatprivate.h"
+#include "gdksurfaceprivate.h"
+#include "gdktoplevelprivate.h"
+#include "gdk-private.h"
+
+/* Surfaces only exist in memory. Nothing ever waits for a frame to
+ * be shown, so a frame is complete as soon as the main loop goes
+ * idle after drawing it. This lets the frame clock run as fast as
+ * the application can draw.
+ */
+
+/* The refresh interval we report, matching the refresh rate of the
+ * virtual monitors. It is not used to pace frames.
+ */
+#define REFRESH_INTERVAL 16667 /* microseconds */
+
+G_DEFINE_TYPE (GdkHeadlessSurface, gdk_headless_surface, GDK_TYPE_SURFACE)
+
+GType gdk_headless_toplevel_get_type (void) G_GNUC_CONST;
+GType gdk_headless_popup_get_type (void) G_GNUC_CONST;
+GType gdk_headless_drag_surface_get_type (void) G_GNUC_CONST;
+
+#define GDK_TYPE_HEADLESS_TOPLEVEL (gdk_headless_toplevel_get_type ())
+#define GDK_TYPE_HEADLESS_POPUP (gdk_headless_popup_get_type ())
+#define GDK_TYPE_HEADLESS_DRAG_SURFACE (gdk_headless_drag_surface_get_type ())
+
+static void
+gdk_headless_surface_init (GdkHeadlessSurface *impl)
+{
+  impl->scale = 1;
+}
+
+static void
+gdk_headless_surface_finalize (GObject *object)
+{
+  GdkHeadlessSurface *impl = GDK_HEADLESS_SURFACE (object);
+
+  g_clear_object (&impl->last_frame);
+
+  G_OBJECT_CLASS (gdk_headless_surface_parent_class)->finalize (object);
+}
+
+static gboolean
+complete_frame_cb (gpointer data)
+{
+  GdkSurface *surface = data;
+  GdkHeadlessSurface *impl = GDK_HEADLESS_SURFACE (surface);
+  GdkFrameClock *clock = gdk_surface_get_frame_clock (surface);
+  GdkFrameTimings *timings;
+
+  impl->complete_frame_id = 0;
+
+  timings = gdk_frame_clock_get_timings (clock, impl->pending_frame_counter);
+  impl->pending_frame_counter = 0;
+
+  if (timings)
+    {
+      timings->refresh_interval = REFRESH_INTERVAL;
+      timings->presentation_time = g_get_monotonic_time ();
+      timings->complete = TRUE;
+
+#ifdef G_ENABLE_DEBUG
+      if ((_gdk_debug_flags & GDK_DEBUG_FRAMES) != 0)
+        _gdk_frame_clock_debug_print_timings (clock, timings);
+
+      if (GDK_PROFILER_IS_RUNNING)
+        _gdk_frame_clock_add_timings_to_profiler (clock, timings);
+#endif
+    }
+
+  gdk_surface_thaw_updates (surface);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+on_frame_clock_after_paint (GdkFrameClock *clock,
+                            GdkSurface    *surface)
+{
+  GdkHeadlessSurface *impl = GDK_HEADLESS_SURFACE (surface);
+
+  if (impl->complete_frame_id != 0)
+    return;
+
+  impl->pending_frame_counter = gdk_frame_clock_get_frame_counter (clock);
+  gdk_surface_freeze_updates (surface);
+
+  impl->complete_frame_id = g_idle_add_full (GDK_PRIORITY_REDRAW + 1,
+                                             complete_frame_cb,
+                                             surface,
+                                             NULL);
+  gdk_source_set_static_name_by_id (impl->complete_frame_id, "[gtk] complete_frame_cb");
+}
+
+static void
+on_frame_clock_before_paint (GdkFrameClock *clock,
+                             GdkSurface    *surface)
+{
+  GdkFrameTimings *timings = gdk_frame_clock_get_current_timings (clock);
+  gint64 presentation_time;
+  gint64 refresh_interval;
+
+  if (surface->update_freeze_count > 0)
+    return;
+
+  gdk_frame_clock_get_refresh_info (clock,
+                                    timings->frame_time,
+                                    &refresh_interval, &presentation_time);
+  if (presentation_time != 0)
+    timings->predicted_presentation_time = presentation_time + refresh_interval;
+  else
+    timings->predicted_presentation_time = timings->frame_time + refresh_interval;
+}
+
+static void
+connect_frame_clock (GdkSurface *surface)
+{
+  GdkFrameClock *frame_clock = gdk_surface_get_frame_clock (surface);
+
+  g_signal_connect (frame_clock, "before-paint",
+                    G_CALLBACK (on_frame_clock_before_paint), surface);
+  g_signal_connect (frame_clock, "after-paint",
+                    G_CALLBACK (on_frame_clock_after_paint), surface);
+}
+
+static void
+disconnect_frame_clock (GdkSurface *surface)
+{
+  GdkFrameClock *frame_clock = gdk_surface_get_frame_clock (surface);
+
+  g_signal_handlers_disconnect_by_func (frame_clock,
+                                        on_frame_clock_before_paint, surface);
+  g_signal_handlers_disconnect_by_func (frame_clock,
+                                        on_frame_clock_after_paint, surface);
+}
+
+GdkSurface *
+_gdk_headless_display_create_surface (GdkDisplay     *display,
+                                      GdkSurfaceType  surface_type,
+                                      GdkSurface     *parent,
+                                      int             x,
+                                      int             y,
+                                      int             width,
+                                      int             height)
+{
+  GdkFrameClock *frame_clock;
+  GdkSurface *surface;
+  GdkHeadlessSurface *impl;
+  GdkMonitor *monitor;
+  GType type;
+
+  if (parent)
+    frame_clock = g_object_ref (gdk_surface_get_frame_clock (parent));
+  else
+    frame_clock = _gdk_frame_clock_idle_new ();
+
+  switch (surface_type)
+    {
+    case GDK_SURFACE_TOPLEVEL:
+      type = GDK_TYPE_HEADLESS_TOPLEVEL;
+      break;
+    case GDK_SURFACE_POPUP:
+      type = GDK_TYPE_HEADLESS_POPUP;
+      break;
+    case GDK_SURFACE_TEMP:
+      type = GDK_TYPE_HEADLESS_DRAG_SURFACE;
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+    }
+
+  surface = g_object_new (type,
+                          "display", display,
+                          "frame-clock", frame_clock,
+                          NULL);
+
+  g_object_unref (frame_clock);
+
+  surface->parent = parent;
+  surface->x = x;
+  surface->y = y;
+  surface->width = width;
+  surface->height = height;
+
+  impl = GDK_HEADLESS_SURFACE (surface);
+  if (parent)
+    {
+      impl->scale = GDK_HEADLESS_SURFACE (parent)->scale;
+    }
+  else
+    {
+      monitor = g_list_model_get_item (gdk_display_get_monitors (display), 0);
+      if (monitor)
+        {
+          impl->scale = gdk_monitor_get_scale_factor (monitor);
+          g_object_unref (monitor);
+        }
+    }
+
+  g_object_ref (surface);
+
+  connect_frame_clock (surface);
+
+  return surface;
+}
+
+/**
+ * gdk_headless_surface_get_last_frame:
+ * @surface: (type GdkHeadlessSurface): a `GdkSurface`
+ *
+ * Gets the contents of the last frame that was drawn to @surface.
+ *
+ * The texture is not changed by later frames, so it can be kept
+ * around and compared with the result of a later frame.
+ *
+ * The size of the texture is the size of the surface, multiplied
+ * by its scale factor.
+ *
+ * Returns: (transfer none) (nullable): the last frame, or %NULL if
+ *   nothing has been drawn to @surface yet
+ *
+ * Since: 4.6
+ */
+GdkTexture *
+gdk_headless_surface_get_last_frame (GdkSurface *surface)
+{
+  g_return_val_if_fail (GDK_IS_HEADLESS_SURFACE (surface), NULL);
+
+  return GDK_HEADLESS_SURFACE (surface)->last_frame;
+}
+
+void
+gdk_headless_surface_set_last_frame (GdkSurface *surface,
+                                     GdkTexture *texture)
+{
+  GdkHeadlessSurface *impl = GDK_HEADLESS_SURFACE (surface);
+
+  g_set_object (&impl->last_frame, texture);
+}
+
+static cairo_surface_t *
+gdk_headless_surface_ref_cairo_surface (GdkSurface *surface)
+{
+  if (GDK_SURFACE_DESTROYED (surface))
+    return NULL;
+
+  return cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 1, 1);
+}
+
+static void
+set_focused (GdkSurface *surface,
+             gboolean    focused)
+{
+  GdkHeadlessDisplay *display = GDK_HEADLESS_DISPLAY (gdk_surface_get_display (surface));
+
+  if (focused)
+    {
+      if (display->focus_surface == surface)
+        return;
+
+      if (display->focus_surface)
+        set_focused (display->focus_surface, FALSE);
+
+      display->focus_surface = surface;
+      gdk_synthesize_surface_state (surface, 0, GDK_TOPLEVEL_STATE_FOCUSED);
+    }
+  else if (display->focus_surface == surface)
+    {
+      display->focus_surface = NULL;
+      gdk_synthesize_surface_state (surface, GDK_TOPLEVEL_STATE_FOCUSED, 0);
+    }
+}
+
+static void
+gdk_headless_surface_destroy (GdkSurface *surface,
+                              gboolean    foreign_destroy)
+{
+  GdkHeadlessSurface *impl = GDK_HEADLESS_SURFACE (surface);
+
+  set_focused (surface, FALSE);
+
+  if (impl->complete_frame_id != 0)
+    {
+      g_clear_handle_id (&impl->complete_frame_id, g_source_remove);
+      gdk_surface_thaw_updates (surface);
+    }
+
+  disconnect_frame_clock (surface);
+
+  _gdk_headless_surface_grab_check_destroy (surface);
+}
+
+static void
+gdk_headless_surface_destroy_notify (GdkSurface *surface)
+{
+  if (!GDK_SURFACE_DESTROYED (surface))
+    _gdk_surface_destroy (surface, TRUE);
+
+  g_object_unref (surface);
+}
+
+static void
+gdk_headless_surface_hide (GdkSurface *surface)
+{
+  set_focused (surface, FALSE);
+
+  _gdk_headless_surface_grab_check_unmap (surface,
+                                          _gdk_display_get_next_serial (gdk_surface_get_display (surface)));
+
+  _gdk_surface_clear_update_area (surface);
+}
+
+static int
+gdk_headless_surface_get_scale_factor (GdkSurface *surface)
+{
+  if (GDK_SURFACE_DESTROYED (surface))
+    return 1;
+
+  return GDK_HEADLESS_SURFACE (surface)->scale;
+}
+
+static void
+gdk_headless_surface_set_scale (GdkSurface *surface,
+                                int         scale)
+{
+  GdkHeadlessSurface *impl = GDK_HEADLESS_SURFACE (surface);
+  GList *l;
+
+  if (impl->scale == scale)
+    return;
+
+  impl->scale = scale;
+
+  for (l = surface->children; l; l = l->next)
+    gdk_headless_surface_set_scale (l->data, scale);
+
+  _gdk_surface_update_size (surface);
+  g_object_notify (G_OBJECT (surface), "scale-factor");
+}
+
+static void
+gdk_headless_surface_move_resize (GdkSurface *surface,
+                                  gboolean    with_move,
+                                  int         x,
+                                  int         y,
+                                  int         width,
+                                  int         height)
+{
+  if (with_move)
+    {
+      surface->x = x;
+      surface->y = y;
+    }
+
+  width = MAX (width, 1);
+  height = MAX (height, 1);
+
+  if (width != surface->width ||
+      height != surface->height)
+    {
+      surface->width = width;
+      surface->height = height;
+
+      _gdk_surface_update_size (surface);
+      gdk_surface_invalidate_rect (surface, NULL);
+      gdk_surface_request_layout (surface);
+    }
+}
+
+static void
+gdk_headless_surface_get_geometry (GdkSurface *surface,
+                                   int        *x,
+                                   int        *y,
+                                   int        *width,
+                                   int        *height)
+{
+  if (x)
+    *x = surface->x;
+  if (y)
+    *y = surface->y;
+  if (width)
+    *width = surface->width;
+  if (height)
+    *height = surface->height;
+}
+
+static void
+gdk_headless_surface_get_root_coords (GdkSurface *surface,
+                                      int         x,
+                                      int         y,
+                                      int        *root_x,
+                                      int        *root_y)
+{
+  GdkSurface *s;
+
+  for (s = surface; s; s = s->parent)
+    {
+      x += s->x;
+      y += s->y;
+    }
+
+  if (root_x)
+    *root_x = x;
+  if (root_y)
+    *root_y = y;
+}
+
+static gboolean
+gdk_headless_surface_get_device_state (GdkSurface      *surface,
+                                       GdkDevice       *device,
+                                       double          *x,
+                                       double          *y,
+                                       GdkModifierType *mask)
+{
+  *x = 0;
+  *y = 0;
+  *mask = 0;
+
+  return FALSE;
+}
+
+static void
+gdk_headless_surface_set_input_region (GdkSurface     *surface,
+                                       cairo_region_t *shape_region)
+{
+}
+
+static gboolean
+gdk_headless_surface_beep (GdkSurface *surface)
+{
+  return FALSE;
+}
+
+static GdkDrag *
+gdk_headless_surface_drag_begin (GdkSurface         *surface,
+                                 GdkDevice          *device,
+                                 GdkContentProvider *content,
+                                 GdkDragAction       actions,
+                                 double              dx,
+                                 double              dy)
+{
+  /* There is nothing to drop on */
+  return NULL;
+}
+
+static void
+gdk_headless_surface_class_init (GdkHeadlessSurfaceClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GdkSurfaceClass *impl_class = GDK_SURFACE_CLASS (klass);
+
+  object_class->finalize = gdk_headless_surface_finalize;
+
+  impl_class->ref_cairo_surface = gdk_headless_surface_ref_cairo_surface;
+  impl_class->hide = gdk_headless_surface_hide;
+  impl_class->get_geometry = gdk_headless_surface_get_geometry;
+  impl_class->get_root_coords = gdk_headless_surface_get_root_coords;
+  impl_class->get_device_state = gdk_headless_surface_get_device_state;
+  impl_class->set_input_region = gdk_headless_surface_set_input_region;
+  impl_class->destroy = gdk_headless_surface_destroy;
+  impl_class->beep = gdk_headless_surface_beep;
+  impl_class->destroy_notify = gdk_headless_surface_destroy_notify;
+  impl_class->drag_begin = gdk_headless_surface_drag_begin;
+  impl_class->get_scale_factor = gdk_headless_surface_get_scale_factor;
+}
+
+static void
+show_surface (GdkSurface *surface)
+{
+  if (surface->destroyed)
+    return;
+
+  if (!GDK_SURFACE_IS_MAPPED (surface))
+    {
+      gdk_surface_set_is_mapped (surface, TRUE);
+      gdk_surface_invalidate_rect (surface, NULL);
+      gdk_surface_request_layout (surface);
+    }
+}
+
+#define LAST_PROP 1
+
+typedef struct
+{
+  GdkHeadlessSurface parent_instance;
+} GdkHeadlessPopup;
+
+typedef struct
+{
+  GdkHeadlessSurfaceClass parent_class;
+} GdkHeadlessPopupClass;
+
+static void gdk_headless_popup_iface_init (GdkPopupInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GdkHeadlessPopup, gdk_headless_popup, GDK_TYPE_HEADLESS_SURFACE,
+                         G_IMPLEMENT_INTERFACE (GDK_TYPE_POPUP,
+                                                gdk_headless_popup_iface_init))
+
+static void
+gdk_headless_popup_init (GdkHeadlessPopup *popup)
+{
+}
+
+static void
+gdk_headless_popup_get_property (GObject    *object,
+                                 guint       prop_id,
+                                 GValue     *value,
+                                 GParamSpec *pspec)
+{
+  GdkSurface *surface = GDK_SURFACE (object);
+
+  switch (prop_id)
+    {
+    case LAST_PROP + GDK_POPUP_PROP_PARENT:
+      g_value_set_object (value, surface->parent);
+      break;
+
+    case LAST_PROP + GDK_POPUP_PROP_AUTOHIDE:
+      g_value_set_boolean (value, surface->autohide);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+gdk_headless_popup_set_property (GObject      *object,
+                                 guint         prop_id,
+                                 const GValue *value,
+                                 GParamSpec   *pspec)
+{
+  GdkSurface *surface = GDK_SURFACE (object);
+
+  switch (prop_id)
+    {
+    case LAST_PROP + GDK_POPUP_PROP_PARENT:
+      surface->parent = g_value_dup_object (value);
+      if (surface->parent != NULL)
+        surface->parent->children = g_list_prepend (surface->parent->children, surface);
+      break;
+
+    case LAST_PROP + GDK_POPUP_PROP_AUTOHIDE:
+      surface->autohide = g_value_get_boolean (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+gdk_headless_popup_class_init (GdkHeadlessPopupClass *class)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (class);
+
+  object_class->get_property = gdk_headless_popup_get_property;
+  object_class->set_property = gdk_headless_popup_set_property;
+
+  gdk_popup_install_properties (object_class, 1);
+}
+
+static void
+show_grabbing_popup (GdkSeat    *seat,
+                     GdkSurface *surface,
+                     gpointer    user_data)
+{
+  show_surface (surface);
+}
+
+static gboolean
+gdk_headless_popup_present (GdkPopup       *popup,
+                            int             width,
+                            int             height,
+                            GdkPopupLayout *layout)
+{
+  GdkSurface *surface = GDK_SURFACE (popup);
+  GdkHeadlessSurface *impl = GDK_HEADLESS_SURFACE (surface);
+  GdkMonitor *monitor;
+  GdkRectangle bounds;
+  GdkRectangle final_rect;
+
+  monitor = gdk_surface_get_layout_monitor (surface, layout,
+                                            gdk_monitor_get_geometry);
+  gdk_monitor_get_geometry (monitor, &bounds);
+
+  gdk_surface_layout_popup_helper (surface,
+                                   width,
+                                   height,
+                                   impl->shadow_left,
+                                   impl->shadow_right,
+                                   impl->shadow_top,
+                                   impl->shadow_bottom,
+                                   monitor,
+                                   &bounds,
+                                   layout,
+                                   &final_rect);
+
+  gdk_headless_surface_move_resize (surface, TRUE,
+                                    final_rect.x, final_rect.y,
+                                    final_rect.width, final_rect.height);
+
+  if (GDK_SURFACE_IS_MAPPED (surface))
+    return TRUE;
+
+  if (surface->autohide)
+    {
+      gdk_seat_grab (gdk_display_get_default_seat (surface->display),
+                     surface,
+                     GDK_SEAT_CAPABILITY_ALL,
+                     TRUE,
+                     NULL, NULL,
+                     show_grabbing_popup, NULL);
+    }
+  else
+    {
+      show_surface (surface);
+    }
+
+  return GDK_SURFACE_IS_MAPPED (surface);
+}
+
+static GdkGravity
+gdk_headless_popup_get_surface_anchor (GdkPopup *popup)
+{
+  return GDK_SURFACE (popup)->popup.surface_anchor;
+}
+
+static GdkGravity
+gdk_headless_popup_get_rect_anchor (GdkPopup *popup)
+{
+  return GDK_SURFACE (popup)->popup.rect_anchor;
+}
+
+static int
+gdk_headless_popup_get_position_x (GdkPopup *popup)
+{
+  return GDK_SURFACE (popup)->x;
+}
+
+static int
+gdk_headless_popup_get_position_y (GdkPopup *popup)
+{
+  return GDK_SURFACE (popup)->y;
+}
+
+static void
+gdk_headless_popup_iface_init (GdkPopupInterface *iface)
+{
+  iface->present = gdk_headless_popup_present;
+  iface->get_surface_anchor = gdk_headless_popup_get_surface_anchor;
+  iface->get_rect_anchor = gdk_headless_popup_get_rect_anchor;
+  iface->get_position_x = gdk_headless_popup_get_position_x;
+  iface->get_position_y = gdk_headless_popup_get_position_y;
+}
+
+typedef struct
+{
+  GdkHeadlessSurface parent_instance;
+} GdkHeadlessToplevel;
+
+typedef struct
+{
+  GdkHeadlessSurfaceClass parent_class;
+} GdkHeadlessToplevelClass;
+
+static void gdk_headless_toplevel_iface_init (GdkToplevelInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GdkHeadlessToplevel, gdk_headless_toplevel, GDK_TYPE_HEADLESS_SURFACE,
+                         G_IMPLEMENT_INTERFACE (GDK_TYPE_TOPLEVEL,
+                                                gdk_headless_toplevel_iface_init))
+
+static void
+gdk_headless_toplevel_init (GdkHeadlessToplevel *toplevel)
+{
+}
+
+static void
+gdk_headless_toplevel_set_property (GObject      *object,
+                                    guint         prop_id,
+                                    const GValue *value,
+                                    GParamSpec   *pspec)
+{
+  GdkSurface *surface = GDK_SURFACE (object);
+
+  switch (prop_id)
+    {
+    case LAST_PROP + GDK_TOPLEVEL_PROP_TITLE:
+    case LAST_PROP + GDK_TOPLEVEL_PROP_STARTUP_ID:
+      g_object_notify_by_pspec (G_OBJECT (surface), pspec);
+      break;
+
+    case LAST_PROP + GDK_TOPLEVEL_PROP_TRANSIENT_FOR:
+      g_set_object (&surface->transient_for, g_value_get_object (value));
+      g_object_notify_by_pspec (G_OBJECT (surface), pspec);
+      break;
+
+    case LAST_PROP + GDK_TOPLEVEL_PROP_MODAL:
+      break;
+
+    case LAST_PROP + GDK_TOPLEVEL_PROP_ICON_LIST:
+      break;
+
+    case LAST_PROP + GDK_TOPLEVEL_PROP_DECORATED:
+      break;
+
+    case LAST_PROP + GDK_TOPLEVEL_PROP_DELETABLE:
+      break;
+
+    case LAST_PROP + GDK_TOPLEVEL_PROP_SHORTCUTS_INHIBITED:
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+gdk_headless_toplevel_get_property (GObject    *object,
+                                    guint       prop_id,
+                                    GValue     *value,
+                                    GParamSpec *pspec)
+{
+  GdkSurface *surface = GDK_SURFACE (object);
+
+  switch (prop_id)
+    {
+    case LAST_PROP + GDK_TOPLEVEL_PROP_STATE:
+      g_value_set_flags (value, surface->state);
+      break;
+
+    case LAST_PROP + GDK_TOPLEVEL_PROP_TITLE:
+      g_value_set_string (value, "");
+      break;
+
+    case LAST_PROP + GDK_TOPLEVEL_PROP_STARTUP_ID:
+      g_value_set_string (value, "");
+      break;
+
+    case LAST_PROP + GDK_TOPLEVEL_PROP_TRANSIENT_FOR:
+      g_value_set_object (value, surface->transient_for);
+      break;
+
+    case LAST_PROP + GDK_TOPLEVEL_PROP_ICON_LIST:
+      g_value_set_pointer (value, NULL);
+      break;
+
+    case LAST_PROP + GDK_TOPLEVEL_PROP_DECORATED:
+      break;
+
+    case LAST_PROP + GDK_TOPLEVEL_PROP_DELETABLE:
+      break;
+
+    case LAST_PROP + GDK_TOPLEVEL_PROP_SHORTCUTS_INHIBITED:
+      g_value_set_boolean (value, surface->shortcuts_inhibited);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+gdk_headless_toplevel_finalize (GObject *object)
+{
+  GdkSurface *surface = GDK_SURFACE (object);
+
+  g_clear_object (&surface->transient_for);
+
+  G_OBJECT_CLASS (gdk_headless_toplevel_parent_class)->finalize (object);
+}
+
+static void
+gdk_headless_toplevel_class_init (GdkHeadlessToplevelClass *class)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (class);
+
+  object_class->finalize = gdk_headless_toplevel_finalize;
+  object_class->get_property = gdk_headless_toplevel_get_property;
+  object_class->set_property = gdk_headless_toplevel_set_property;
+
+  gdk_toplevel_install_properties (object_class, 1);
+}
+
+static void
+gdk_headless_toplevel_present (GdkToplevel       *toplevel,
+                               GdkToplevelLayout *layout)
+{
+  GdkSurface *surface = GDK_SURFACE (toplevel);
+  GdkHeadlessSurface *impl = GDK_HEADLESS_SURFACE (surface);
+  GdkDisplay *display = gdk_surface_get_display (surface);
+  GdkMonitor *monitor;
+  GdkRectangle monitor_geometry;
+  GdkToplevelSize size;
+  int width, height;
+  GdkGeometry geometry;
+  GdkSurfaceHints mask;
+  gboolean maximize, fullscreen;
+  GdkToplevelState state;
+
+  monitor = gdk_display_get_monitor_at_surface (display, surface);
+  if (monitor)
+    {
+      gdk_monitor_get_geometry (monitor, &monitor_geometry);
+      gdk_headless_surface_set_scale (surface, gdk_monitor_get_scale_factor (monitor));
+    }
+  else
+    {
+      monitor_geometry = (GdkRectangle) { 0, 0, G_MAXINT, G_MAXINT };
+    }
+
+  gdk_toplevel_size_init (&size, monitor_geometry.width, monitor_geometry.height);
+  gdk_toplevel_notify_compute_size (toplevel, &size);
+  g_warn_if_fail (size.width > 0);
+  g_warn_if_fail (size.height > 0);
+  width = size.width;
+  height = size.height;
+
+  if (gdk_toplevel_layout_get_resizable (layout))
+    {
+      geometry.min_width = size.min_width;
+      geometry.min_height = size.min_height;
+      mask = GDK_HINT_MIN_SIZE;
+    }
+  else
+    {
+      geometry.max_width = geometry.min_width = width;
+      geometry.max_height = geometry.min_height = height;
+      mask = GDK_HINT_MIN_SIZE | GDK_HINT_MAX_SIZE;
+    }
+  impl->geometry_hints = geometry;
+  impl->geometry_hints_mask = mask;
+  gdk_surface_constrain_size (&geometry, mask, width, height, &width, &height);
+
+  if (size.shadow.is_valid)
+    {
+      impl->shadow_left = size.shadow.left;
+      impl->shadow_right = size.shadow.right;
+      impl->shadow_top = size.shadow.top;
+      impl->shadow_bottom = size.shadow.bottom;
+    }
+
+  state = surface->state & (GDK_TOPLEVEL_STATE_MAXIMIZED | GDK_TOPLEVEL_STATE_FULLSCREEN);
+  if (gdk_toplevel_layout_get_maximized (layout, &maximize))
+    {
+      if (maximize)
+        state |= GDK_TOPLEVEL_STATE_MAXIMIZED;
+      else
+        state &= ~GDK_TOPLEVEL_STATE_MAXIMIZED;
+    }
+  if (gdk_toplevel_layout_get_fullscreen (layout, &fullscreen))
+    {
+      if (fullscreen)
+        state |= GDK_TOPLEVEL_STATE_FULLSCREEN;
+      else
+        state &= ~GDK_TOPLEVEL_STATE_FULLSCREEN;
+    }
+
+  gdk_synthesize_surface_state (surface,
+                                (GDK_TOPLEVEL_STATE_MAXIMIZED | GDK_TOPLEVEL_STATE_FULLSCREEN) & ~state,
+                                state);
+
+  if (state && monitor)
+    gdk_headless_surface_move_resize (surface, TRUE,
+                                      monitor_geometry.x, monitor_geometry.y,
+                                      monitor_geometry.width, monitor_geometry.height);
+  else
+    gdk_headless_surface_move_resize (surface, FALSE, 0, 0, width, height);
+
+  show_surface (surface);
+}
+
+static gboolean
+gdk_headless_toplevel_minimize (GdkToplevel *toplevel)
+{
+  return FALSE;
+}
+
+static gboolean
+gdk_headless_toplevel_lower (GdkToplevel *toplevel)
+{
+  return FALSE;
+}
+
+static void
+gdk_headless_toplevel_focus (GdkToplevel *toplevel,
+                             guint32      timestamp)
+{
+  GdkSurface *surface = GDK_SURFACE (toplevel);
+
+  if (GDK_SURFACE_DESTROYED (surface))
+    return;
+
+  set_focused (surface, TRUE);
+}
+
+static gboolean
+gdk_headless_toplevel_show_window_menu (GdkToplevel *toplevel,
+                                        GdkEvent    *event)
+{
+  return FALSE;
+}
+
+static void
+gdk_headless_toplevel_begin_resize (GdkToplevel    *toplevel,
+                                    GdkSurfaceEdge  edge,
+                                    GdkDevice      *device,
+                                    int             button,
+                                    double          x,
+                                    double          y,
+                                    guint32         timestamp)
+{
+}
+
+static void
+gdk_headless_toplevel_begin_move (GdkToplevel *toplevel,
+                                  GdkDevice   *device,
+                                  int          button,
+                                  double       x,
+                                  double       y,
+                                  guint32      timestamp)
+{
+}
+
+static void
+gdk_headless_toplevel_iface_init (GdkToplevelInterface *iface)
+{
+  iface->present = gdk_headless_toplevel_present;
+  iface->minimize = gdk_headless_toplevel_minimize;
+  iface->lower = gdk_headless_toplevel_lower;
+  iface->focus = gdk_headless_toplevel_focus;
+  iface->show_window_menu = gdk_headless_toplevel_show_window_menu;
+  iface->begin_resize = gdk_headless_toplevel_begin_resize;
+  iface->begin_move = gdk_headless_toplevel_begin_move;
+}
+
+typedef struct
+{
+  GdkHeadlessSurface parent_instance;
+} GdkHeadlessDragSurface;
+
+typedef struct
+{
+  GdkHeadlessSurfaceClass parent_class;
+} GdkHeadlessDragSurfaceClass;
+
+static void gdk_headless_drag_surface_iface_init (GdkDragSurfaceInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GdkHeadlessDragSurface, gdk_headless_drag_surface, GDK_TYPE_HEADLESS_SURFACE,
+                         G_IMPLEMENT_INTERFACE (GDK_TYPE_DRAG_SURFACE,
+                                                gdk_headless_drag_surface_iface_init))
+
+static void
+gdk_headless_drag_surface_init (GdkHeadlessDragSurface *surface)
+{
+}
+
+static void
+gdk_headless_drag_surface_class_init (GdkHeadlessDragSurfaceClass *class)
+{
+}
+
+static gboolean
+gdk_headless_drag_surface_present (GdkDragSurface *drag_surface,
+                                   int             width,
+                                   int             height)
+{
+  GdkSurface *surface = GDK_SURFACE (drag_surface);
+
+  gdk_headless_surface_move_resize (surface, FALSE, 0, 0, width, height);
+  show_surface (surface);
+
+  return TRUE;
+}
+
+static void
+gdk_headless_drag_surface_iface_init (GdkDragSurfaceInterface *iface)
+{
+  iface->present = gdk_headless_drag_surface_present;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GDK_SURFACE_HEADLESS_H__
+#define __GDK_SURFACE_HEADLESS_H__
+
+#include <gdk/gdksurfaceprivate.h>
+#include "gdkheadlesssurface.h"
+
+G_BEGIN_DECLS
+
+struct _GdkHeadlessSurface
+{
+  GdkSurface parent_instance;
+
+  int scale;
+
+  GdkGeometry geometry_hints;
+  GdkSurfaceHints geometry_hints_mask;
+
+  int shadow_left;
+  int shadow_right;
+  int shadow_top;
+  int shadow_bottom;
+
+  gint64 pending_frame_counter;
+  guint complete_frame_id;
+
+  GdkTexture *last_frame;
+};
+
+struct _GdkHeadlessSurfaceClass
+{
+  GdkSurfaceClass parent_class;
+};
+
+G_END_DECLS
+
+#endif /* __GDK_SURFACE_HEADLESS_H__ */
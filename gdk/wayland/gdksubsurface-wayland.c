@@ -0,0 +1,295 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdksubsurface-wayland.h"
+
+#include "gdkdisplay-wayland.h"
+#include "gdkprivate-wayland.h"
+#include "gdkprofilerprivate.h"
+#include "gdksurfaceprivate.h"
+
+/* The number of released buffers we keep around for the next frames */
+#define MAX_FREE_BUFFERS 2
+
+static const cairo_user_data_key_t gdk_wayland_subsurface_key;
+
+G_DEFINE_TYPE (GdkWaylandSubsurface, gdk_wayland_subsurface, GDK_TYPE_SUBSURFACE)
+
+static void
+gdk_wayland_subsurface_remove_buffer (GdkWaylandSubsurface *self,
+                                      cairo_surface_t      *cairo_surface)
+{
+  self->buffers = g_slist_remove (self->buffers, cairo_surface);
+  cairo_surface_set_user_data (cairo_surface, &gdk_wayland_subsurface_key, NULL, NULL);
+  cairo_surface_destroy (cairo_surface);
+}
+
+static void
+gdk_wayland_subsurface_buffer_release (void             *_data,
+                                       struct wl_buffer *wl_buffer)
+{
+  cairo_surface_t *cairo_surface = _data;
+  GdkWaylandSubsurface *self;
+
+  self = cairo_surface_get_user_data (cairo_surface, &gdk_wayland_subsurface_key);
+
+  /* The subsurface was destroyed before the compositor released
+   * this buffer, otherwise keep it for reuse if it still fits.
+   */
+  if (self != NULL)
+    {
+      if (cairo_image_surface_get_width (cairo_surface) == self->buffer_width &&
+          cairo_image_surface_get_height (cairo_surface) == self->buffer_height &&
+          g_slist_length (self->free_buffers) < MAX_FREE_BUFFERS)
+        self->free_buffers = g_slist_prepend (self->free_buffers, cairo_surface);
+      else
+        gdk_wayland_subsurface_remove_buffer (self, cairo_surface);
+    }
+
+  /* Release the reference the compositor held to this surface */
+  cairo_surface_destroy (cairo_surface);
+}
+
+static const struct wl_buffer_listener buffer_listener = {
+  gdk_wayland_subsurface_buffer_release
+};
+
+static void
+gdk_wayland_subsurface_clear_free_buffers (GdkWaylandSubsurface *self)
+{
+  GSList *l;
+
+  for (l = self->free_buffers; l; l = l->next)
+    gdk_wayland_subsurface_remove_buffer (self, l->data);
+
+  g_clear_pointer (&self->free_buffers, g_slist_free);
+}
+
+/* Returns a buffer that the compositor is not using. It is owned
+ * by the subsurface.
+ */
+static cairo_surface_t *
+gdk_wayland_subsurface_get_buffer (GdkWaylandSubsurface *self,
+                                   int                   width,
+                                   int                   height,
+                                   int                   scale)
+{
+  GdkWaylandDisplay *display_wayland = GDK_WAYLAND_DISPLAY (gdk_surface_get_display (GDK_SUBSURFACE (self)->parent));
+  cairo_surface_t *cairo_surface;
+  struct wl_buffer *buffer;
+
+  if (self->buffer_width != width * scale ||
+      self->buffer_height != height * scale)
+    {
+      gdk_wayland_subsurface_clear_free_buffers (self);
+      self->buffer_width = width * scale;
+      self->buffer_height = height * scale;
+    }
+
+  if (self->free_buffers)
+    {
+      cairo_surface = self->free_buffers->data;
+      self->free_buffers = g_slist_delete_link (self->free_buffers, self->free_buffers);
+      return cairo_surface;
+    }
+
+  cairo_surface = _gdk_wayland_display_create_shm_surface (display_wayland,
+                                                           width, height,
+                                                           scale);
+  buffer = _gdk_wayland_shm_surface_get_wl_buffer (cairo_surface);
+  wl_buffer_add_listener (buffer, &buffer_listener, cairo_surface);
+  cairo_surface_set_user_data (cairo_surface, &gdk_wayland_subsurface_key, self, NULL);
+  self->buffers = g_slist_prepend (self->buffers, cairo_surface);
+
+  return cairo_surface;
+}
+
+static gboolean
+gdk_wayland_subsurface_ensure (GdkWaylandSubsurface *self)
+{
+  GdkSurface *parent = GDK_SUBSURFACE (self)->parent;
+  GdkWaylandDisplay *display_wayland = GDK_WAYLAND_DISPLAY (gdk_surface_get_display (parent));
+  struct wl_surface *parent_surface;
+  struct wl_region *region;
+
+  if (self->subsurface)
+    return TRUE;
+
+  parent_surface = gdk_wayland_surface_get_wl_surface (parent);
+  if (parent_surface == NULL || display_wayland->subcompositor == NULL)
+    return FALSE;
+
+  self->surface = wl_compositor_create_surface (display_wayland->compositor);
+  self->subsurface = wl_subcompositor_get_subsurface (display_wayland->subcompositor,
+                                                      self->surface,
+                                                      parent_surface);
+  wl_subsurface_place_above (self->subsurface, parent_surface);
+  /* Commits to the subsurface show up right away, so a new texture
+   * does not need a commit of the parent surface.
+   */
+  wl_subsurface_set_desync (self->subsurface);
+
+  /* Let input go to the parent surface */
+  region = wl_compositor_create_region (display_wayland->compositor);
+  wl_surface_set_input_region (self->surface, region);
+  wl_region_destroy (region);
+
+  return TRUE;
+}
+
+static gboolean
+gdk_wayland_subsurface_attach (GdkSubsurface         *subsurface,
+                               GdkTexture            *texture,
+                               const graphene_rect_t *rect)
+{
+  GdkWaylandSubsurface *self = GDK_WAYLAND_SUBSURFACE (subsurface);
+  GdkWaylandDisplay *display_wayland = GDK_WAYLAND_DISPLAY (gdk_surface_get_display (subsurface->parent));
+  G_GNUC_UNUSED gint64 start_time = GDK_PROFILER_CURRENT_TIME;
+  cairo_surface_t *cairo_surface;
+  int scale, x, y, width, height;
+
+  /* Reading a GL texture back every frame is much slower than
+   * compositing it, so those need a dmabuf path first.
+   */
+  if (GDK_IS_GL_TEXTURE (texture))
+    return FALSE;
+
+  x = rect->origin.x;
+  y = rect->origin.y;
+  width = rect->size.width;
+  height = rect->size.height;
+  scale = gdk_surface_get_scale_factor (subsurface->parent);
+
+  /* Without wp_viewporter the compositor can only show buffers
+   * at the surface scale, so anything else is left to the renderer.
+   */
+  if (x != rect->origin.x || y != rect->origin.y ||
+      width != rect->size.width || height != rect->size.height ||
+      width <= 0 || height <= 0 ||
+      gdk_texture_get_width (texture) != width * scale ||
+      gdk_texture_get_height (texture) != height * scale)
+    return FALSE;
+
+  if (!gdk_wayland_subsurface_ensure (self))
+    return FALSE;
+
+  if (subsurface->texture != texture)
+    {
+      cairo_surface = gdk_wayland_subsurface_get_buffer (self, width, height, scale);
+      cairo_surface_flush (cairo_surface);
+      gdk_texture_download (texture,
+                            cairo_image_surface_get_data (cairo_surface),
+                            cairo_image_surface_get_stride (cairo_surface));
+      cairo_surface_mark_dirty (cairo_surface);
+
+      /* The compositor holds a reference until it releases the buffer */
+      cairo_surface_reference (cairo_surface);
+      wl_surface_attach (self->surface, _gdk_wayland_shm_surface_get_wl_buffer (cairo_surface), 0, 0);
+      wl_surface_damage (self->surface, 0, 0, width, height);
+    }
+
+  if (display_wayland->compositor_version >= WL_SURFACE_HAS_BUFFER_SCALE)
+    wl_surface_set_buffer_scale (self->surface, scale);
+
+  /* The position is applied with the next commit of the parent,
+   * which happens when the frame that stopped drawing the texture
+   * is presented.
+   */
+  wl_subsurface_set_position (self->subsurface, x, y);
+  wl_surface_commit (self->surface);
+
+  gdk_profiler_end_mark (start_time, "attach subsurface", NULL);
+
+  return TRUE;
+}
+
+static void
+gdk_wayland_subsurface_detach (GdkSubsurface *subsurface)
+{
+  GdkWaylandSubsurface *self = GDK_WAYLAND_SUBSURFACE (subsurface);
+
+  if (self->surface == NULL)
+    return;
+
+  wl_surface_attach (self->surface, NULL, 0, 0);
+  wl_surface_commit (self->surface);
+}
+
+static void
+gdk_wayland_subsurface_finalize (GObject *object)
+{
+  GdkWaylandSubsurface *self = GDK_WAYLAND_SUBSURFACE (object);
+
+  g_clear_pointer (&self->subsurface, wl_subsurface_destroy);
+  g_clear_pointer (&self->surface, wl_surface_destroy);
+
+  /* Buffers still used by the compositor are freed when it releases them */
+  g_clear_pointer (&self->free_buffers, g_slist_free);
+  while (self->buffers)
+    gdk_wayland_subsurface_remove_buffer (self, self->buffers->data);
+
+  G_OBJECT_CLASS (gdk_wayland_subsurface_parent_class)->finalize (object);
+}
+
+static void
+gdk_wayland_subsurface_class_init (GdkWaylandSubsurfaceClass *class)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (class);
+  GdkSubsurfaceClass *subsurface_class = GDK_SUBSURFACE_CLASS (class);
+
+  object_class->finalize = gdk_wayland_subsurface_finalize;
+
+  subsurface_class->attach = gdk_wayland_subsurface_attach;
+  subsurface_class->detach = gdk_wayland_subsurface_detach;
+}
+
+static void
+gdk_wayland_subsurface_init (GdkWaylandSubsurface *self)
+{
+}
+
+GdkSubsurface *
+gdk_wayland_subsurface_new (GdkSurface *parent)
+{
+  GdkSubsurface *subsurface;
+
+  subsurface = g_object_new (GDK_TYPE_WAYLAND_SUBSURFACE, NULL);
+  subsurface->parent = g_object_ref (parent);
+
+  return subsurface;
+}
+
+/*
+ * gdk_wayland_subsurface_unmap:
+ * @self: a `GdkWaylandSubsurface`
+ *
+ * Called when the wl_surface of the parent is about to be destroyed,
+ * because it was hidden. The subsurface is created again for the
+ * new wl_surface the next time a texture is attached.
+ */
+void
+gdk_wayland_subsurface_unmap (GdkWaylandSubsurface *self)
+{
+  GdkSubsurface *subsurface = GDK_SUBSURFACE (self);
+
+  g_clear_pointer (&self->subsurface, wl_subsurface_destroy);
+  g_clear_pointer (&self->surface, wl_surface_destroy);
+
+  g_clear_object (&subsurface->texture);
+}
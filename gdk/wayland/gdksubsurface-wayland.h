@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GDK_WAYLAND_SUBSURFACE__
+#define __GDK_WAYLAND_SUBSURFACE__
+
+#include "gdksubsurfaceprivate.h"
+
+#include <wayland-client.h>
+
+G_BEGIN_DECLS
+
+#define GDK_TYPE_WAYLAND_SUBSURFACE             (gdk_wayland_subsurface_get_type ())
+#define GDK_WAYLAND_SUBSURFACE(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), GDK_TYPE_WAYLAND_SUBSURFACE, GdkWaylandSubsurface))
+#define GDK_IS_WAYLAND_SUBSURFACE(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GDK_TYPE_WAYLAND_SUBSURFACE))
+
+typedef struct _GdkWaylandSubsurface GdkWaylandSubsurface;
+typedef struct _GdkWaylandSubsurfaceClass GdkWaylandSubsurfaceClass;
+
+struct _GdkWaylandSubsurface
+{
+  GdkSubsurface parent_instance;
+
+  struct wl_surface *surface;
+  struct wl_subsurface *subsurface;
+
+  /* All shm buffers we created and still own, and those of them
+   * that the compositor has released and that can be drawn to.
+   */
+  GSList *buffers;
+  GSList *free_buffers;
+  /* The size in pixels of the buffers we reuse */
+  int buffer_width;
+  int buffer_height;
+};
+
+struct _GdkWaylandSubsurfaceClass
+{
+  GdkSubsurfaceClass parent_class;
+};
+
+GType                   gdk_wayland_subsurface_get_type         (void) G_GNUC_CONST;
+
+GdkSubsurface *         gdk_wayland_subsurface_new              (GdkSurface             *parent);
+void                    gdk_wayland_subsurface_unmap            (GdkWaylandSubsurface   *self);
+
+G_END_DECLS
+
+#endif /* __GDK_WAYLAND_SUBSURFACE__ */
@@ -30,6 +30,7 @@
 #include "gdkprivate-wayland.h"
 #include "gdkprivate-wayland.h"
 #include "gdkseat-wayland.h"
+#include "gdksubsurface-wayland.h"
 #include "gdksurfaceprivate.h"
 #include "gdktoplevelprivate.h"
 #include "gdkdevice-wayland-private.h"
@@ -108,6 +109,9 @@ struct _GdkWaylandSurface
 
   struct wl_event_queue *event_queue;
 
+  /* Not owned, the subsurfaces keep a reference to us */
+  GSList *subsurfaces;
+
   uint32_t reposition_token;
   uint32_t received_reposition_token;
 
@@ -2992,6 +2996,8 @@ gdk_wayland_surface_hide_surface (GdkSurface *surface)
           impl->application.was_set = FALSE;
         }
 
+      g_slist_foreach (impl->subsurfaces, (GFunc) gdk_wayland_subsurface_unmap, NULL);
+
       wl_surface_destroy (impl->display_server.wl_surface);
       impl->display_server.wl_surface = NULL;
 
@@ -4257,6 +4263,32 @@ gdk_wayland_surface_supports_edge_constraints (GdkSurface *surface)
   return gtk_surface1_get_version (gtk_surface) >= GTK_SURFACE1_CONFIGURE_EDGES_SINCE_VERSION;
 }
 
+static void
+subsurface_finalized (gpointer  data,
+                      GObject  *where_the_object_was)
+{
+  GdkWaylandSurface *impl = data;
+
+  impl->subsurfaces = g_slist_remove (impl->subsurfaces, where_the_object_was);
+}
+
+static GdkSubsurface *
+gdk_wayland_surface_create_subsurface (GdkSurface *surface)
+{
+  GdkWaylandSurface *impl = GDK_WAYLAND_SURFACE (surface);
+  GdkWaylandDisplay *display_wayland = GDK_WAYLAND_DISPLAY (gdk_surface_get_display (surface));
+  GdkSubsurface *subsurface;
+
+  if (display_wayland->subcompositor == NULL)
+    return NULL;
+
+  subsurface = gdk_wayland_subsurface_new (surface);
+  g_object_weak_ref (G_OBJECT (subsurface), subsurface_finalized, impl);
+  impl->subsurfaces = g_slist_prepend (impl->subsurfaces, subsurface);
+
+  return subsurface;
+}
+
 static void
 gdk_wayland_surface_class_init (GdkWaylandSurfaceClass *klass)
 {
@@ -4281,6 +4313,7 @@ gdk_wayland_surface_class_init (GdkWaylandSurfaceClass *klass)
   impl_class->set_opaque_region = gdk_wayland_surface_set_opaque_region;
   impl_class->request_layout = gdk_wayland_surface_request_layout;
   impl_class->compute_size = gdk_wayland_surface_compute_size;
+  impl_class->create_subsurface = gdk_wayland_surface_create_subsurface;
 }
 
 void
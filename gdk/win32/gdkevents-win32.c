@@ -1886,6 +1886,7 @@ gdk_event_translate (MSG *msg,
 		     buf, sizeof (buf));
       _gdk_input_codepage = atoi (buf);
       _gdk_keymap_serial++;
+      g_signal_emit_by_name (_gdk_win32_display_get_keymap (_gdk_display), "keys-changed");
       GDK_NOTE (EVENTS,
 		g_print (" cs:%lu hkl:%p%s cp:%d",
 			 (gulong) msg->wParam,
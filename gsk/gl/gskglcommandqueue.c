@@ -387,6 +387,32 @@ snapshots_equal (GskGLCommandQueue *self,
   return TRUE;
 }
 
+static inline const GskGLSharedUniforms *
+get_shared_block (GskGLCommandQueue *self,
+                  int                block)
+{
+  return (const GskGLSharedUniforms *)(self->shared_uniforms.buffer + block * self->shared_uniforms.element_size);
+}
+
+static inline gboolean
+shared_blocks_equal (GskGLCommandQueue *self,
+                     guint              first,
+                     guint              second)
+{
+  int first_block = self->batch_blocks.items[first];
+  int second_block = self->batch_blocks.items[second];
+
+  if (first_block == second_block)
+    return TRUE;
+
+  if (first_block < 0 || second_block < 0)
+    return FALSE;
+
+  return memcmp (get_shared_block (self, first_block),
+                 get_shared_block (self, second_block),
+                 sizeof (GskGLSharedUniforms)) == 0;
+}
+
 static void
 gsk_gl_command_queue_dispose (GObject *object)
 {
@@ -403,8 +429,10 @@ gsk_gl_command_queue_dispose (GObject *object)
   gsk_gl_command_batches_clear (&self->batches);
   gsk_gl_command_binds_clear (&self->batch_binds);
   gsk_gl_command_uniforms_clear (&self->batch_uniforms);
+  gsk_gl_command_blocks_clear (&self->batch_blocks);
 
   gsk_gl_buffer_destroy (&self->vertices);
+  gsk_gl_buffer_destroy (&self->shared_uniforms);
 
   G_OBJECT_CLASS (gsk_gl_command_queue_parent_class)->dispose (object);
 }
@@ -425,8 +453,11 @@ gsk_gl_command_queue_init (GskGLCommandQueue *self)
   gsk_gl_command_batches_init (&self->batches, 128);
   gsk_gl_command_binds_init (&self->batch_binds, 1024);
   gsk_gl_command_uniforms_init (&self->batch_uniforms, 2048);
+  gsk_gl_command_blocks_init (&self->batch_blocks, 128);
 
   gsk_gl_buffer_init (&self->vertices, GL_ARRAY_BUFFER, sizeof (GskGLDrawVertex));
+
+  self->shared_block = -1;
 }
 
 GskGLCommandQueue *
@@ -451,6 +482,29 @@ gsk_gl_command_queue_new (GdkGLContext      *context,
   gdk_gl_context_make_current (context);
   glGetIntegerv (GL_MAX_TEXTURE_SIZE, &self->max_texture_size);
 
+  /* Uniform blocks need GLSL 1.40, so only the GL 3.2 core shaders
+   * can use them. Everything else sets the shared uniforms per program.
+   */
+  self->has_shared_uniforms = !gdk_gl_context_get_use_es (context) &&
+                              !gdk_gl_context_is_legacy (context) &&
+                              !GSK_DEBUG_CHECK (GL_NO_UBO);
+
+  if (self->has_shared_uniforms)
+    {
+      int alignment = 0;
+      guint stride;
+
+      glGetIntegerv (GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+      alignment = MAX (alignment, 16);
+      stride = (sizeof (GskGLSharedUniforms) + alignment - 1) / alignment * alignment;
+
+      gsk_gl_buffer_init (&self->shared_uniforms, GL_UNIFORM_BUFFER, stride);
+    }
+  else
+    {
+      gsk_gl_buffer_init (&self->shared_uniforms, GL_UNIFORM_BUFFER, sizeof (GskGLSharedUniforms));
+    }
+
   return g_steal_pointer (&self);
 }
 
@@ -478,6 +532,9 @@ begin_next_batch (GskGLCommandQueue *self)
   batch->any.next_batch_index = -1;
   batch->any.prev_batch_index = self->tail_batch_index;
 
+  if (self->has_shared_uniforms)
+    *gsk_gl_command_blocks_append (&self->batch_blocks) = -1;
+
   return batch;
 }
 
@@ -518,6 +575,9 @@ discard_batch (GskGLCommandQueue *self)
   g_assert (self->batches.len > 0);
 
   self->batches.len--;
+
+  if (self->has_shared_uniforms)
+    self->batch_blocks.len--;
 }
 
 void
@@ -595,6 +655,12 @@ gsk_gl_command_queue_end_draw (GskGLCommandQueue *self)
   batch->draw.uniform_offset = self->batch_uniforms.len;
   batch->draw.uniform_count = snapshot_uniforms (self->uniforms, self->program_info, &self->batch_uniforms);
 
+  /* The shared uniforms are not part of the program's uniforms if
+   * they come from a uniform buffer, so remember which block to bind.
+   */
+  if (self->has_shared_uniforms)
+    *gsk_gl_command_blocks_tail (&self->batch_blocks) = self->shared_block;
+
   /* Track the bind attachments that changed */
   if (self->program_info->has_attachments)
     {
@@ -621,6 +687,7 @@ gsk_gl_command_queue_end_draw (GskGLCommandQueue *self)
       last_batch->draw.framebuffer == batch->draw.framebuffer &&
       last_batch->draw.vbo_offset + last_batch->draw.vbo_count == batch->draw.vbo_offset &&
       last_batch->draw.vbo_count + batch->draw.vbo_count <= 0xffff &&
+      (!self->has_shared_uniforms || shared_blocks_equal (self, self->batches.len - 2, self->batches.len - 1)) &&
       snapshots_equal (self, last_batch, batch))
     {
       last_batch->draw.vbo_count += batch->draw.vbo_count;
@@ -674,6 +741,39 @@ gsk_gl_command_queue_split_draw (GskGLCommandQueue *self)
   gsk_gl_command_queue_begin_draw (self, program, width, height);
 }
 
+/**
+ * gsk_gl_command_queue_set_shared_uniforms:
+ * @self: a `GskGLCommandQueue`
+ * @uniforms: the values of the shared uniforms
+ *
+ * Sets the shared uniforms for the following draws. This must only be
+ * used if the queue has_shared_uniforms, in which case the shaders get
+ * the shared uniforms from a uniform buffer rather than from the
+ * program's uniforms.
+ *
+ * A new block is only added to the buffer if @uniforms differs from
+ * the last block that was set.
+ *
+ * Returns: the index of the block
+ */
+int
+gsk_gl_command_queue_set_shared_uniforms (GskGLCommandQueue         *self,
+                                          const GskGLSharedUniforms *uniforms)
+{
+  g_assert (GSK_IS_GL_COMMAND_QUEUE (self));
+  g_assert (self->has_shared_uniforms);
+  g_assert (uniforms != NULL);
+
+  if (self->shared_block < 0 ||
+      memcmp (get_shared_block (self, self->shared_block), uniforms, sizeof *uniforms) != 0)
+    {
+      memcpy (gsk_gl_buffer_advance (&self->shared_uniforms, 1), uniforms, sizeof *uniforms);
+      self->shared_block = self->shared_uniforms.count - 1;
+    }
+
+  return self->shared_block;
+}
+
 void
 gsk_gl_command_queue_clear (GskGLCommandQueue    *self,
                              guint                  clear_bits,
@@ -955,9 +1055,12 @@ gsk_gl_command_queue_execute (GskGLCommandQueue    *self,
   guint n_binds = 0;
   guint n_fbos = 0;
   guint n_uniforms = 0;
+  guint n_uniform_blocks = 0;
   guint n_programs = 0;
   guint vao_id;
   guint vbo_id;
+  guint ubo_id = 0;
+  int block = -1;
   int textures[4];
   int framebuffer = -1;
   int next_batch_index;
@@ -994,6 +1097,12 @@ gsk_gl_command_queue_execute (GskGLCommandQueue    *self,
 
   vbo_id = gsk_gl_buffer_submit (&self->vertices);
 
+  /* All shared uniform blocks of the frame go up in one upload, draws
+   * only bind the range of their block.
+   */
+  if (self->has_shared_uniforms)
+    ubo_id = gsk_gl_buffer_submit (&self->shared_uniforms);
+
   /* 0 = position location */
   glEnableVertexAttribArray (0);
   glVertexAttribPointer (0, 2, GL_FLOAT, GL_FALSE,
@@ -1116,6 +1225,19 @@ gsk_gl_command_queue_execute (GskGLCommandQueue    *self,
               n_uniforms += batch->draw.uniform_count;
             }
 
+          if (self->has_shared_uniforms &&
+              self->batch_blocks.items[next_batch_index] != block &&
+              self->batch_blocks.items[next_batch_index] >= 0)
+            {
+              block = self->batch_blocks.items[next_batch_index];
+              glBindBufferRange (GL_UNIFORM_BUFFER,
+                                 GSK_GL_SHARED_UNIFORMS_BINDING,
+                                 ubo_id,
+                                 block * self->shared_uniforms.element_size,
+                                 sizeof (GskGLSharedUniforms));
+              n_uniform_blocks++;
+            }
+
           glDrawArrays (GL_TRIANGLES, batch->draw.vbo_offset, batch->draw.vbo_count);
 
         break;
@@ -1148,11 +1270,20 @@ gsk_gl_command_queue_execute (GskGLCommandQueue    *self,
   glDeleteBuffers (1, &vbo_id);
   glDeleteVertexArrays (1, &vao_id);
 
+  if (ubo_id != 0)
+    {
+      glBindBufferBase (GL_UNIFORM_BUFFER, GSK_GL_SHARED_UNIFORMS_BINDING, 0);
+      glDeleteBuffers (1, &ubo_id);
+    }
+
   gdk_profiler_set_int_counter (self->metrics.n_binds, n_binds);
   gdk_profiler_set_int_counter (self->metrics.n_uniforms, n_uniforms);
+  gdk_profiler_set_int_counter (self->metrics.n_uniform_blocks, n_uniform_blocks);
   gdk_profiler_set_int_counter (self->metrics.n_fbos, n_fbos);
   gdk_profiler_set_int_counter (self->metrics.n_programs, n_programs);
   gdk_profiler_set_int_counter (self->metrics.n_uploads, self->n_uploads);
+  gdk_profiler_set_int_counter (self->metrics.n_fallbacks, self->n_fallbacks);
+  gdk_profiler_set_int_counter (self->metrics.n_upload_bytes, self->n_upload_bytes);
   gdk_profiler_set_int_counter (self->metrics.queue_depth, self->batches.len);
 
 #ifdef G_ENABLE_DEBUG
@@ -1223,7 +1354,16 @@ gsk_gl_command_queue_end_frame (GskGLCommandQueue *self)
   self->batches.len = 0;
   self->batch_binds.len = 0;
   self->batch_uniforms.len = 0;
+  self->batch_blocks.len = 0;
   self->n_uploads = 0;
+  self->n_fallbacks = 0;
+  self->n_upload_bytes = 0;
+
+  /* Usually already done when the buffer was submitted */
+  self->shared_uniforms.buffer_pos = 0;
+  self->shared_uniforms.count = 0;
+  self->shared_block = -1;
+
   self->tail_batch_index = -1;
   self->in_frame = FALSE;
 }
@@ -1310,6 +1450,9 @@ gsk_gl_command_queue_create_texture (GskGLCommandQueue *self,
     case GL_RGBA32F:
       glTexImage2D (GL_TEXTURE_2D, 0, format, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
       break;
+    case GL_R8:
+      glTexImage2D (GL_TEXTURE_2D, 0, format, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
+      break;
     default:
       /* If you add new formats, make sure to set the correct format and type here
        * so that GLES doesn't barf invalid operations at you.
@@ -1339,33 +1482,27 @@ gsk_gl_command_queue_create_framebuffer (GskGLCommandQueue *self)
   return fbo_id;
 }
 
-static void
-gsk_gl_command_queue_do_upload_texture (GskGLCommandQueue *self,
-                                        GdkTexture        *texture)
+/* Picks the format to upload @texture in, converting it if GL
+ * can't take its own format
+ */
+static GdkMemoryFormat
+gsk_gl_command_queue_get_upload_format (GdkGLContext *context,
+                                        GdkTexture   *texture,
+                                        GLenum       *gl_internalformat,
+                                        GLenum       *gl_format,
+                                        GLenum       *gl_type)
 {
-  GdkGLContext *context;
-  const guchar *data;
-  gsize stride;
-  GdkMemoryTexture *memtex;
   GdkMemoryFormat data_format;
-  int width, height;
-  GLenum gl_internalformat;
-  GLenum gl_format;
-  GLenum gl_type;
-  gsize bpp;
   gboolean use_es;
 
-  context = gdk_gl_context_get_current ();
   use_es = gdk_gl_context_get_use_es (context);
   data_format = gdk_texture_get_format (texture);
-  width = gdk_texture_get_width (texture);
-  height = gdk_texture_get_height (texture);
 
   if (!gdk_memory_format_gl_format (data_format,
                                     use_es,
-                                    &gl_internalformat,
-                                    &gl_format,
-                                    &gl_type))
+                                    gl_internalformat,
+                                    gl_format,
+                                    gl_type))
     {
       if (gdk_memory_format_prefers_high_depth (data_format))
         data_format = GDK_MEMORY_R32G32B32A32_FLOAT_PREMULTIPLIED;
@@ -1373,19 +1510,50 @@ gsk_gl_command_queue_do_upload_texture (GskGLCommandQueue *self,
         data_format = GDK_MEMORY_R8G8B8A8_PREMULTIPLIED;
       if (!gdk_memory_format_gl_format (data_format,
                                         use_es,
-                                        &gl_internalformat,
-                                        &gl_format,
-                                        &gl_type))
+                                        gl_internalformat,
+                                        gl_format,
+                                        gl_type))
         {
           g_assert_not_reached ();
         }
     }
 
+  return data_format;
+}
+
+static void
+gsk_gl_command_queue_do_upload_texture (GskGLCommandQueue *self,
+                                        GdkTexture        *texture)
+{
+  GdkGLContext *context;
+  const guchar *data;
+  gsize stride;
+  GdkMemoryTexture *memtex;
+  GdkMemoryFormat data_format;
+  int width, height;
+  GLenum gl_internalformat;
+  GLenum gl_format;
+  GLenum gl_type;
+  gsize bpp;
+  gboolean use_es;
+
+  context = gdk_gl_context_get_current ();
+  use_es = gdk_gl_context_get_use_es (context);
+  width = gdk_texture_get_width (texture);
+  height = gdk_texture_get_height (texture);
+  data_format = gsk_gl_command_queue_get_upload_format (context,
+                                                        texture,
+                                                        &gl_internalformat,
+                                                        &gl_format,
+                                                        &gl_type);
+
   memtex = gdk_memory_texture_from_texture (texture, data_format);
   data = gdk_memory_texture_get_data (memtex);
   stride = gdk_memory_texture_get_stride (memtex);
   bpp = gdk_memory_format_bytes_per_pixel (data_format);
 
+  self->n_upload_bytes += (gsize) width * height * bpp;
+
   glPixelStorei (GL_UNPACK_ALIGNMENT, gdk_memory_format_alignment (data_format));
 
   /* GL_UNPACK_ROW_LENGTH is available on desktop GL, OpenGL ES >= 3.0, or if
@@ -1469,6 +1637,106 @@ gsk_gl_command_queue_upload_texture (GskGLCommandQueue *self,
   return texture_id;
 }
 
+/**
+ * gsk_gl_command_queue_update_texture:
+ * @self: a `GskGLCommandQueue`
+ * @texture_id: the GL texture to update
+ * @texture: a `GdkTexture` of the same size and format as the
+ *   contents of @texture_id
+ * @region: the region of @texture that needs to be updated
+ *
+ * Uploads @region of @texture into the existing GL texture
+ * @texture_id, leaving the rest of it as it is.
+ */
+void
+gsk_gl_command_queue_update_texture (GskGLCommandQueue    *self,
+                                     guint                 texture_id,
+                                     GdkTexture           *texture,
+                                     const cairo_region_t *region)
+{
+  G_GNUC_UNUSED gint64 start_time = GDK_PROFILER_CURRENT_TIME;
+  GdkGLContext *context;
+  GdkMemoryTexture *memtex;
+  GdkMemoryFormat data_format;
+  const guchar *data;
+  GLenum gl_internalformat;
+  GLenum gl_format;
+  GLenum gl_type;
+  gboolean use_row_length;
+  gsize stride, bpp;
+  int i, n;
+
+  g_assert (GSK_IS_GL_COMMAND_QUEUE (self));
+  g_assert (!GDK_IS_GL_TEXTURE (texture));
+
+  context = gdk_gl_context_get_current ();
+  data_format = gsk_gl_command_queue_get_upload_format (context,
+                                                        texture,
+                                                        &gl_internalformat,
+                                                        &gl_format,
+                                                        &gl_type);
+
+  memtex = gdk_memory_texture_from_texture (texture, data_format);
+  data = gdk_memory_texture_get_data (memtex);
+  stride = gdk_memory_texture_get_stride (memtex);
+  bpp = gdk_memory_format_bytes_per_pixel (data_format);
+  use_row_length = stride % bpp == 0 &&
+                   (!gdk_gl_context_get_use_es (context) ||
+                    gdk_gl_context_check_version (context, 3, 0) ||
+                    gdk_gl_context_has_unpack_subimage (context));
+
+  self->n_uploads++;
+
+  glActiveTexture (GL_TEXTURE0);
+  glBindTexture (GL_TEXTURE_2D, texture_id);
+
+  glPixelStorei (GL_UNPACK_ALIGNMENT, gdk_memory_format_alignment (data_format));
+  if (use_row_length)
+    glPixelStorei (GL_UNPACK_ROW_LENGTH, stride / bpp);
+
+  n = cairo_region_num_rectangles (region);
+  for (i = 0; i < n; i++)
+    {
+      cairo_rectangle_int_t rect;
+      const guchar *rect_data;
+
+      cairo_region_get_rectangle (region, i, &rect);
+      rect_data = data + rect.y * stride + rect.x * bpp;
+
+      self->n_upload_bytes += (gsize) rect.width * rect.height * bpp;
+
+      if (use_row_length)
+        {
+          glTexSubImage2D (GL_TEXTURE_2D, 0, rect.x, rect.y, rect.width, rect.height,
+                           gl_format, gl_type, rect_data);
+        }
+      else
+        {
+          int y;
+
+          for (y = 0; y < rect.height; y++)
+            glTexSubImage2D (GL_TEXTURE_2D, 0, rect.x, rect.y + y, rect.width, 1,
+                             gl_format, gl_type, rect_data + y * stride);
+        }
+    }
+
+  if (use_row_length)
+    glPixelStorei (GL_UNPACK_ROW_LENGTH, 0);
+  glPixelStorei (GL_UNPACK_ALIGNMENT, 4);
+
+  /* Restore previous texture state if any */
+  if (self->attachments->textures[0].id > 0)
+    glBindTexture (self->attachments->textures[0].target,
+                   self->attachments->textures[0].id);
+
+  g_object_unref (memtex);
+
+  if (gdk_profiler_is_running ())
+    gdk_profiler_add_markf (start_time, GDK_PROFILER_CURRENT_TIME-start_time,
+                            "Update Texture",
+                            "%d rectangles", n);
+}
+
 void
 gsk_gl_command_queue_set_profiler (GskGLCommandQueue *self,
                                    GskProfiler       *profiler)
@@ -1488,7 +1756,10 @@ gsk_gl_command_queue_set_profiler (GskGLCommandQueue *self,
       self->metrics.n_binds = gdk_profiler_define_int_counter ("attachments", "Number of texture attachments");
       self->metrics.n_fbos = gdk_profiler_define_int_counter ("fbos", "Number of framebuffers attached");
       self->metrics.n_uniforms = gdk_profiler_define_int_counter ("uniforms", "Number of uniforms changed");
+      self->metrics.n_uniform_blocks = gdk_profiler_define_int_counter ("uniform-blocks", "Number of shared uniform blocks bound");
       self->metrics.n_uploads = gdk_profiler_define_int_counter ("uploads", "Number of texture uploads");
+      self->metrics.n_fallbacks = gdk_profiler_define_int_counter ("fallbacks", "Number of nodes rendered with cairo");
+      self->metrics.n_upload_bytes = gdk_profiler_define_int_counter ("upload-bytes", "Number of bytes of texture data uploaded");
       self->metrics.n_programs = gdk_profiler_define_int_counter ("programs", "Number of program changes");
       self->metrics.queue_depth = gdk_profiler_define_int_counter ("gl-queue-depth", "Depth of GL command batches");
     }
@@ -167,9 +167,30 @@ typedef union _GskGLCommandBatch
 
 G_STATIC_ASSERT (sizeof (GskGLCommandBatch) == 32);
 
+/* The uniforms every program uses, laid out as the GskSharedUniforms
+ * block of the shaders (std140). Where uniform buffers are supported,
+ * these are collected into a single buffer that is uploaded once per
+ * frame, and each draw batch binds the block it was recorded with.
+ */
+typedef struct _GskGLSharedUniforms
+{
+  float projection[16];
+  float modelview[16];
+  float viewport[4];
+  float clip_rect[12];
+  float alpha;
+  float padding[3];
+} GskGLSharedUniforms;
+
+G_STATIC_ASSERT (sizeof (GskGLSharedUniforms) == 208);
+
+/* The uniform buffer binding point of the GskSharedUniforms block */
+#define GSK_GL_SHARED_UNIFORMS_BINDING 0
+
 DEFINE_INLINE_ARRAY (GskGLCommandBatches, gsk_gl_command_batches, GskGLCommandBatch)
 DEFINE_INLINE_ARRAY (GskGLCommandBinds, gsk_gl_command_binds, GskGLCommandBind)
 DEFINE_INLINE_ARRAY (GskGLCommandUniforms, gsk_gl_command_uniforms, GskGLCommandUniform)
+DEFINE_INLINE_ARRAY (GskGLCommandBlocks, gsk_gl_command_blocks, int)
 
 struct _GskGLCommandQueue
 {
@@ -225,6 +246,20 @@ struct _GskGLCommandQueue
    */
   GskGLCommandUniforms batch_uniforms;
 
+  /* The shared uniform blocks of the frame, uploaded as a single uniform
+   * buffer before executing the batches. Each element is padded to the
+   * offset alignment required for glBindBufferRange().
+   */
+  GskGLBuffer shared_uniforms;
+
+  /* The index within @shared_uniforms of the block each batch uses. This
+   * is indexed like @batches, as GskGLCommandDraw has no room left for it.
+   */
+  GskGLCommandBlocks batch_blocks;
+
+  /* The index of the block last added to @shared_uniforms, or -1 */
+  int shared_block;
+
   /* Discovered max texture size when loading the command queue so that we
    * can either scale down or slice textures to fit within this size. Assumed
    * to be both height and width.
@@ -249,7 +284,10 @@ struct _GskGLCommandQueue
     guint n_binds;
     guint n_fbos;
     guint n_uniforms;
+    guint n_uniform_blocks;
     guint n_uploads;
+    guint n_fallbacks;
+    guint n_upload_bytes;
     guint n_programs;
     guint queue_depth;
   } metrics;
@@ -257,6 +295,12 @@ struct _GskGLCommandQueue
   /* Counter for uploads on the frame */
   guint n_uploads;
 
+  /* Counter for nodes rendered with cairo on the frame */
+  guint n_fallbacks;
+
+  /* Counter for bytes of pixel data uploaded on the frame */
+  gsize n_upload_bytes;
+
   /* If we're inside a begin/end_frame pair */
   guint in_frame : 1;
 
@@ -265,6 +309,11 @@ struct _GskGLCommandQueue
 
   /* If we've warned about truncating batches */
   guint have_truncated : 1;
+
+  /* If the shared uniforms come from @shared_uniforms instead of being
+   * set for every program with the other uniforms.
+   */
+  guint has_shared_uniforms : 1;
 };
 
 GskGLCommandQueue *gsk_gl_command_queue_new                   (GdkGLContext         *context,
@@ -283,6 +332,10 @@ int                 gsk_gl_command_queue_upload_texture       (GskGLCommandQueue
                                                                GdkTexture           *texture,
                                                                int                   min_filter,
                                                                int                   mag_filter);
+void                gsk_gl_command_queue_update_texture       (GskGLCommandQueue    *self,
+                                                               guint                 texture_id,
+                                                               GdkTexture           *texture,
+                                                               const cairo_region_t *region);
 int                 gsk_gl_command_queue_create_texture       (GskGLCommandQueue    *self,
                                                                int                   width,
                                                                int                   height,
@@ -309,6 +362,8 @@ void                gsk_gl_command_queue_begin_draw           (GskGLCommandQueue
                                                                guint                 height);
 void                gsk_gl_command_queue_end_draw             (GskGLCommandQueue    *self);
 void                gsk_gl_command_queue_split_draw           (GskGLCommandQueue    *self);
+int                 gsk_gl_command_queue_set_shared_uniforms  (GskGLCommandQueue    *self,
+                                                               const GskGLSharedUniforms *uniforms);
 
 static inline GskGLCommandBatch *
 gsk_gl_command_queue_get_batch (GskGLCommandQueue *self)
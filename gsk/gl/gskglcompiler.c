@@ -54,6 +54,7 @@ struct _GskGLCompiler
   guint gl3 : 1;
   guint gles : 1;
   guint legacy : 1;
+  guint shared_uniforms : 1;
   guint debug_shaders : 1;
 };
 
@@ -147,6 +148,7 @@ gsk_gl_compiler_new (GskGLDriver *driver,
     {
       self->glsl_version = SHADER_VERSION_GL3;
       self->gl3 = TRUE;
+      self->shared_uniforms = self->driver->shared_command_queue->has_shared_uniforms;
     }
 
   gsk_gl_command_queue_make_current (self->driver->shared_command_queue);
@@ -531,6 +533,7 @@ gsk_gl_compiler_compile (GskGLCompiler  *self,
   const char *legacy = "";
   const char *gl3 = "";
   const char *gles = "";
+  const char *shared = "";
   int program_id;
   int vertex_id;
   int fragment_id;
@@ -560,11 +563,14 @@ gsk_gl_compiler_compile (GskGLCompiler  *self,
   if (self->gl3)
     gl3 = "#define GSK_GL3 1\n";
 
+  if (self->shared_uniforms)
+    shared = "#define GSK_SHARED_UNIFORMS 1\n";
+
   vertex_id = glCreateShader (GL_VERTEX_SHADER);
   glShaderSource (vertex_id,
-                  10,
+                  11,
                   (const char *[]) {
-                    version, debug, legacy, gl3, gles,
+                    version, debug, legacy, gl3, gles, shared,
                     clip,
                     get_shader_string (self->all_preamble),
                     get_shader_string (self->vertex_preamble),
@@ -577,6 +583,7 @@ gsk_gl_compiler_compile (GskGLCompiler  *self,
                     strlen (legacy),
                     strlen (gl3),
                     strlen (gles),
+                    strlen (shared),
                     strlen (clip),
                     g_bytes_get_size (self->all_preamble),
                     g_bytes_get_size (self->vertex_preamble),
@@ -595,9 +602,9 @@ gsk_gl_compiler_compile (GskGLCompiler  *self,
 
   fragment_id = glCreateShader (GL_FRAGMENT_SHADER);
   glShaderSource (fragment_id,
-                  10,
+                  11,
                   (const char *[]) {
-                    version, debug, legacy, gl3, gles,
+                    version, debug, legacy, gl3, gles, shared,
                     clip,
                     get_shader_string (self->all_preamble),
                     get_shader_string (self->fragment_preamble),
@@ -610,6 +617,7 @@ gsk_gl_compiler_compile (GskGLCompiler  *self,
                     strlen (legacy),
                     strlen (gl3),
                     strlen (gles),
+                    strlen (shared),
                     strlen (clip),
                     g_bytes_get_size (self->all_preamble),
                     g_bytes_get_size (self->fragment_preamble),
@@ -643,6 +651,14 @@ gsk_gl_compiler_compile (GskGLCompiler  *self,
 
   glGetProgramiv (program_id, GL_LINK_STATUS, &status);
 
+  if (status == GL_TRUE && self->shared_uniforms)
+    {
+      GLuint block_index = glGetUniformBlockIndex (program_id, "GskSharedUniforms");
+
+      if (block_index != GL_INVALID_INDEX)
+        glUniformBlockBinding (program_id, block_index, GSK_GL_SHARED_UNIFORMS_BINDING);
+    }
+
   glDetachShader (program_id, vertex_id);
   glDeleteShader (vertex_id);
 
@@ -32,8 +32,10 @@
 #include "gskglcommandqueueprivate.h"
 #include "gskglcompilerprivate.h"
 #include "gskglglyphlibraryprivate.h"
+#include "gskglgradientlibraryprivate.h"
 #include "gskgliconlibraryprivate.h"
 #include "gskglprogramprivate.h"
+#include "gskglsdfglyphlibraryprivate.h"
 #include "gskglshadowlibraryprivate.h"
 #include "gskgltextureprivate.h"
 #include "fp16private.h"
@@ -170,7 +172,8 @@ gsk_gl_texture_atlas_free (GskGLTextureAtlas *atlas)
 }
 
 GskGLTextureAtlas *
-gsk_gl_driver_create_atlas (GskGLDriver *self)
+gsk_gl_driver_create_atlas (GskGLDriver *self,
+                            int          format)
 {
   GskGLTextureAtlas *atlas;
 
@@ -179,6 +182,7 @@ gsk_gl_driver_create_atlas (GskGLDriver *self)
   atlas = g_slice_new0 (GskGLTextureAtlas);
   atlas->width = ATLAS_SIZE;
   atlas->height = ATLAS_SIZE;
+  atlas->format = format;
   /* TODO: We might want to change the strategy about the amount of
    *       nodes here? stb_rect_pack.h says width is optimal. */
   atlas->nodes = g_malloc0_n (atlas->width, sizeof (struct stbrp_node));
@@ -186,7 +190,7 @@ gsk_gl_driver_create_atlas (GskGLDriver *self)
   atlas->texture_id = gsk_gl_command_queue_create_texture (self->command_queue,
                                                            atlas->width,
                                                            atlas->height,
-                                                           GL_RGBA8,
+                                                           format,
                                                            GL_LINEAR,
                                                            GL_LINEAR);
 
@@ -290,8 +294,10 @@ gsk_gl_driver_dispose (GObject *object)
   g_assert (!self->key_to_texture_id|| g_hash_table_size (self->key_to_texture_id) == 0);
 
   g_clear_object (&self->glyphs);
+  g_clear_object (&self->sdf_glyphs);
   g_clear_object (&self->icons);
   g_clear_object (&self->shadows);
+  g_clear_object (&self->gradients);
 
   g_clear_pointer (&self->atlases, g_ptr_array_unref);
   g_clear_pointer (&self->autorelease_framebuffers, g_array_unref);
@@ -457,8 +463,10 @@ gsk_gl_driver_new (GskGLCommandQueue  *command_queue,
     }
 
   self->glyphs = gsk_gl_glyph_library_new (self);
+  self->sdf_glyphs = gsk_gl_sdf_glyph_library_new (self);
   self->icons = gsk_gl_icon_library_new (self);
   self->shadows = gsk_gl_shadow_library_new (self);
+  self->gradients = gsk_gl_gradient_library_new (self);
 
   gdk_profiler_end_mark (before, "create GskGLDriver", NULL);
 
@@ -590,6 +598,12 @@ gsk_gl_driver_begin_frame (GskGLDriver       *self,
   gsk_gl_texture_library_begin_frame (GSK_GL_TEXTURE_LIBRARY (self->glyphs),
                                        self->current_frame_id,
                                        removed);
+  gsk_gl_texture_library_begin_frame (GSK_GL_TEXTURE_LIBRARY (self->sdf_glyphs),
+                                       self->current_frame_id,
+                                       removed);
+  gsk_gl_texture_library_begin_frame (GSK_GL_TEXTURE_LIBRARY (self->gradients),
+                                       self->current_frame_id,
+                                       removed);
 
   /* Cleanup old shadows */
   gsk_gl_shadow_library_begin_frame (self->shadows);
@@ -719,6 +733,51 @@ gsk_gl_driver_cache_texture (GskGLDriver         *self,
   g_hash_table_insert (self->texture_id_to_key, GUINT_TO_POINTER (texture_id), k);
 }
 
+/* If @texture is an update of a texture we uploaded earlier, takes
+ * over the GL texture of that one and uploads only what changed,
+ * unless the old contents are still needed for the current frame.
+ */
+static GskGLTexture *
+gsk_gl_driver_update_texture (GskGLDriver *self,
+                              GdkTexture  *texture,
+                              int          min_filter,
+                              int          mag_filter)
+{
+  GdkTexture *previous = texture->update_texture;
+  GskGLTexture *t;
+
+  if (previous == NULL ||
+      gdk_texture_get_format (previous) != gdk_texture_get_format (texture))
+    return NULL;
+
+  t = gdk_texture_get_render_data (previous, self);
+  if (t == NULL ||
+      t->slices != NULL ||
+      t->min_filter != min_filter ||
+      t->mag_filter != mag_filter ||
+      t->width != texture->width ||
+      t->height != texture->height ||
+      t->last_used_in_frame == self->current_frame_id)
+    return NULL;
+
+  gdk_gl_context_make_current (self->command_queue->context);
+
+  if (!gdk_texture_set_render_data (texture, self, t, gsk_gl_texture_destroyed))
+    return NULL;
+
+  gdk_texture_steal_render_data (previous, self);
+
+  gsk_gl_command_queue_update_texture (self->command_queue,
+                                       t->texture_id,
+                                       texture,
+                                       texture->update_region);
+
+  t->user = texture;
+  t->last_used_in_frame = self->current_frame_id;
+
+  return t;
+}
+
 /**
  * gsk_gl_driver_load_texture:
  * @self: a `GdkTexture`
@@ -771,7 +830,10 @@ gsk_gl_driver_load_texture (GskGLDriver *self,
 
       if (gdk_gl_context_is_shared (context, texture_context))
         {
-          /* A GL texture from the same GL context is a simple task... */
+          /* A GL texture from the same GL context is a simple task,
+           * we just need to make sure it is done rendering...
+           */
+          gdk_gl_texture_wait (gl_texture);
           return gdk_gl_texture_get_id (gl_texture);
         }
       else
@@ -786,6 +848,10 @@ gsk_gl_driver_load_texture (GskGLDriver *self,
           if (t->min_filter == min_filter && t->mag_filter == mag_filter)
             return t->texture_id;
         }
+      else if ((t = gsk_gl_driver_update_texture (self, texture, min_filter, mag_filter)))
+        {
+          return t->texture_id;
+        }
 
       downloaded_texture = gdk_memory_texture_from_texture (texture, gdk_texture_get_format (texture));
     }
@@ -101,8 +101,10 @@ struct _GskGLDriver
   GskGLCommandQueue *command_queue;
 
   GskGLGlyphLibrary *glyphs;
+  GskGLSdfGlyphLibrary *sdf_glyphs;
   GskGLIconLibrary *icons;
   GskGLShadowLibrary *shadows;
+  GskGLGradientLibrary *gradients;
 
   GArray *texture_pool;
   GHashTable *textures;
@@ -184,7 +186,8 @@ void                gsk_gl_driver_add_texture_slices     (GskGLDriver         *s
 GskGLProgram      * gsk_gl_driver_lookup_shader          (GskGLDriver         *self,
                                                           GskGLShader         *shader,
                                                           GError             **error);
-GskGLTextureAtlas * gsk_gl_driver_create_atlas           (GskGLDriver         *self);
+GskGLTextureAtlas * gsk_gl_driver_create_atlas           (GskGLDriver         *self,
+                                                          int                  format);
 
 #ifdef G_ENABLE_DEBUG
 void                gsk_gl_driver_save_atlases_to_png    (GskGLDriver         *self,
@@ -258,6 +258,7 @@ gsk_gl_glyph_library_upload_glyph (GskGLGlyphLibrary     *self,
   gdk_gl_context_pop_debug_group (gdk_gl_context_get_current ());
 
   tl->driver->command_queue->n_uploads++;
+  tl->driver->command_queue->n_upload_bytes += (gsize) width * height * 4;
 
   if (gdk_profiler_is_running ())
     {
@@ -0,0 +1,286 @@
+/* gskglgradientlibrary.c
+ *
+ * Copyright 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <gdk/gdkglcontextprivate.h>
+#include <gdk/gdkprofilerprivate.h>
+
+#include "gskglcommandqueueprivate.h"
+#include "gskgldriverprivate.h"
+#include "gskglgradientlibraryprivate.h"
+
+/* Gradients with too many color stops for the uniforms of the
+ * gradient programs are drawn by sampling a ramp with linear
+ * filtering. Ramps have at least MIN_RAMP_SIZE texels, so that small
+ * gradients share them, and otherwise one texel per pixel of the
+ * drawn gradient, so that the ramp does not blur hard stops or band
+ * smooth ones any more than drawing into the framebuffer does.
+ * Ramps longer than MIN_RAMP_SIZE get a texture of their own.
+ */
+#define MIN_RAMP_SIZE 256
+
+struct _GskGLGradientLibrary
+{
+  GskGLTextureLibrary parent_instance;
+};
+
+G_DEFINE_TYPE (GskGLGradientLibrary, gsk_gl_gradient_library, GSK_TYPE_GL_TEXTURE_LIBRARY)
+
+GskGLGradientLibrary *
+gsk_gl_gradient_library_new (GskGLDriver *driver)
+{
+  g_return_val_if_fail (GSK_IS_GL_DRIVER (driver), NULL);
+
+  return g_object_new (GSK_TYPE_GL_GRADIENT_LIBRARY,
+                       "driver", driver,
+                       NULL);
+}
+
+static guint
+gsk_gl_gradient_key_hash (gconstpointer data)
+{
+  const GskGLGradientKey *key = data;
+  const guint32 *words = (const guint32 *)key->stops;
+  gsize n_words = key->n_stops * sizeof (GskColorStop) / sizeof (guint32);
+  guint hash = 5381 + key->size;
+
+  for (gsize i = 0; i < n_words; i++)
+    hash = (hash << 5) + hash + words[i];
+
+  return hash;
+}
+
+static gboolean
+gsk_gl_gradient_key_equal (gconstpointer v1,
+                           gconstpointer v2)
+{
+  const GskGLGradientKey *k1 = v1;
+  const GskGLGradientKey *k2 = v2;
+
+  return k1->size == k2->size &&
+         k1->n_stops == k2->n_stops &&
+         memcmp (k1->stops, k2->stops, sizeof (GskColorStop) * k1->n_stops) == 0;
+}
+
+static void
+gsk_gl_gradient_key_free (gpointer data)
+{
+  GskGLGradientKey *key = data;
+
+  g_free ((gpointer)key->stops);
+  g_slice_free (GskGLGradientKey, key);
+}
+
+static void
+gsk_gl_gradient_value_free (gpointer data)
+{
+  g_slice_free (GskGLGradientValue, data);
+}
+
+static void
+gsk_gl_gradient_library_class_init (GskGLGradientLibraryClass *klass)
+{
+}
+
+static void
+gsk_gl_gradient_library_init (GskGLGradientLibrary *self)
+{
+  GskGLTextureLibrary *tl = (GskGLTextureLibrary *)self;
+
+  tl->max_entry_size = MIN_RAMP_SIZE;
+  gsk_gl_texture_library_set_funcs (tl,
+                                    gsk_gl_gradient_key_hash,
+                                    gsk_gl_gradient_key_equal,
+                                    gsk_gl_gradient_key_free,
+                                    gsk_gl_gradient_value_free);
+}
+
+static inline void
+premultiply (const GdkRGBA *color,
+             float          out[4])
+{
+  out[0] = color->red * color->alpha;
+  out[1] = color->green * color->alpha;
+  out[2] = color->blue * color->alpha;
+  out[3] = color->alpha;
+}
+
+static inline guint8
+to_byte (float value)
+{
+  return (guint8) (CLAMP (value, 0.f, 1.f) * 255.f + .5f);
+}
+
+/* Fills @texels with @size premultiplied RGBA texels, using the
+ * same interpolation as the gradient programs do for their uniforms:
+ * offsets before the first and after the last stop take the colors
+ * of those stops, and a stop at the offset of its predecessor starts
+ * a hard edge.
+ */
+static void
+gsk_gl_gradient_library_fill_ramp (const GskColorStop *stops,
+                                   gsize               n_stops,
+                                   guint               size,
+                                   guint8             *texels)
+{
+  gsize j = 0;
+
+  for (guint i = 0; i < size; i++)
+    {
+      float offset = i / (float)(size - 1);
+      float color[4];
+
+      if (offset < stops[0].offset)
+        {
+          premultiply (&stops[0].color, color);
+        }
+      else if (offset >= stops[n_stops - 1].offset)
+        {
+          premultiply (&stops[n_stops - 1].color, color);
+        }
+      else
+        {
+          float curr[4], next[4];
+          float f;
+
+          while (offset >= stops[j + 1].offset)
+            j++;
+
+          premultiply (&stops[j].color, curr);
+          premultiply (&stops[j + 1].color, next);
+          f = (offset - stops[j].offset) / (stops[j + 1].offset - stops[j].offset);
+
+          for (guint c = 0; c < 4; c++)
+            color[c] = curr[c] + (next[c] - curr[c]) * f;
+        }
+
+      for (guint c = 0; c < 4; c++)
+        texels[4 * i + c] = to_byte (color[c]);
+    }
+}
+
+/**
+ * gsk_gl_gradient_library_get_ramp_size:
+ * @self: a `GskGLGradientLibrary`
+ * @length: the length in pixels that the ramp is stretched over
+ *   when drawing the gradient
+ *
+ * Returns the number of texels to use for the ramp of a gradient.
+ * This is @length rounded up to a power of two, so that gradients
+ * of similar lengths share ramps, but at least the minimum ramp size
+ * and at most what fits into a texture.
+ */
+guint
+gsk_gl_gradient_library_get_ramp_size (GskGLGradientLibrary *self,
+                                       float                 length)
+{
+  GskGLTextureLibrary *tl = (GskGLTextureLibrary *)self;
+  guint max_size = tl->driver->command_queue->max_texture_size - 2;
+  guint size = MIN_RAMP_SIZE;
+
+  while (size < length && size < max_size)
+    size *= 2;
+
+  return MIN (size, max_size);
+}
+
+void
+gsk_gl_gradient_library_add (GskGLGradientLibrary      *self,
+                             const GskColorStop        *stops,
+                             gsize                      n_stops,
+                             guint                      size,
+                             const GskGLGradientValue **out_value)
+{
+  GskGLTextureLibrary *tl = (GskGLTextureLibrary *)self;
+  G_GNUC_UNUSED gint64 start_time = GDK_PROFILER_CURRENT_TIME;
+  GskGLGradientValue *value;
+  GskGLGradientKey *key;
+  guint8 *pixel_data;
+  gsize row_size;
+  guint8 *row;
+  guint packed_x;
+  guint packed_y;
+  float texel_width;
+
+  g_assert (GSK_IS_GL_GRADIENT_LIBRARY (self));
+  g_assert (stops != NULL);
+  g_assert (n_stops > 0);
+  g_assert (size > 1);
+  g_assert (out_value != NULL);
+
+  key = g_slice_new (GskGLGradientKey);
+  key->stops = g_new (GskColorStop, n_stops);
+  memcpy ((gpointer)key->stops, stops, sizeof (GskColorStop) * n_stops);
+  key->n_stops = n_stops;
+  key->size = size;
+
+  value = gsk_gl_texture_library_pack (tl,
+                                       key,
+                                       sizeof (GskGLGradientValue),
+                                       size, 1, 1,
+                                       &packed_x, &packed_y);
+
+  /* The ramp is padded by repeating its first and last texel and
+   * the whole row, so that linear filtering never picks up texels
+   * of neighbouring atlas entries.
+   */
+  row_size = 4 * (size + 2);
+  pixel_data = g_malloc (row_size * 3);
+  row = pixel_data + row_size;
+  gsk_gl_gradient_library_fill_ramp (stops, n_stops, size, row + 4);
+  memcpy (row, row + 4, 4);
+  memcpy (row + 4 * (size + 1), row + 4 * size, 4);
+  memcpy (pixel_data, row, row_size);
+  memcpy (row + row_size, row, row_size);
+
+  gdk_gl_context_push_debug_group_printf (gdk_gl_context_get_current (),
+                                          "Uploading gradient ramp");
+
+  glBindTexture (GL_TEXTURE_2D, GSK_GL_TEXTURE_ATLAS_ENTRY_TEXTURE (value));
+  glTexSubImage2D (GL_TEXTURE_2D, 0,
+                   packed_x, packed_y,
+                   size + 2, 3,
+                   GL_RGBA, GL_UNSIGNED_BYTE,
+                   pixel_data);
+
+  gdk_gl_context_pop_debug_group (gdk_gl_context_get_current ());
+
+  g_free (pixel_data);
+
+  texel_width = (value->entry.area.x2 - value->entry.area.x) / size;
+  value->ramp[0] = value->entry.area.x + texel_width / 2;
+  value->ramp[1] = texel_width * (size - 1);
+  value->ramp[2] = (value->entry.area.y + value->entry.area.y2) / 2;
+
+  *out_value = value;
+
+  tl->driver->command_queue->n_uploads++;
+  tl->driver->command_queue->n_upload_bytes += row_size * 3;
+
+  if (gdk_profiler_is_running ())
+    {
+      char message[64];
+      g_snprintf (message, sizeof message, "%" G_GSIZE_FORMAT " stops, %u texels", n_stops, size);
+      gdk_profiler_add_mark (start_time, GDK_PROFILER_CURRENT_TIME-start_time, "Upload Gradient", message);
+    }
+}
@@ -0,0 +1,85 @@
+/* gskglgradientlibraryprivate.h
+ *
+ * Copyright 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef __GSK_GL_GRADIENT_LIBRARY_PRIVATE_H__
+#define __GSK_GL_GRADIENT_LIBRARY_PRIVATE_H__
+
+#include "gskgltexturelibraryprivate.h"
+
+G_BEGIN_DECLS
+
+#define GSK_TYPE_GL_GRADIENT_LIBRARY (gsk_gl_gradient_library_get_type())
+
+/* The key points to the color stops of the node when looking up a
+ * ramp, and to a copy owned by the library once the ramp is cached.
+ * The same stops can have ramps of several sizes.
+ */
+typedef struct _GskGLGradientKey
+{
+  const GskColorStop *stops;
+  gsize n_stops;
+  guint size;
+} GskGLGradientKey;
+
+typedef struct _GskGLGradientValue
+{
+  GskGLTextureAtlasEntry entry;
+
+  /* Texture coordinates of the center of the first texel, the
+   * distance to the center of the last texel, and the center of
+   * the row, as used by the u_ramp uniform of the gradient programs.
+   */
+  float ramp[3];
+} GskGLGradientValue;
+
+G_DECLARE_FINAL_TYPE (GskGLGradientLibrary, gsk_gl_gradient_library, GSK, GL_GRADIENT_LIBRARY, GskGLTextureLibrary)
+
+GskGLGradientLibrary *gsk_gl_gradient_library_new           (GskGLDriver               *driver);
+guint                 gsk_gl_gradient_library_get_ramp_size (GskGLGradientLibrary      *self,
+                                                             float                      length);
+void                  gsk_gl_gradient_library_add           (GskGLGradientLibrary      *self,
+                                                             const GskColorStop        *stops,
+                                                             gsize                      n_stops,
+                                                             guint                      size,
+                                                             const GskGLGradientValue **out_value);
+
+static inline guint
+gsk_gl_gradient_library_lookup_or_add (GskGLGradientLibrary      *self,
+                                       const GskColorStop        *stops,
+                                       gsize                      n_stops,
+                                       float                      length,
+                                       const GskGLGradientValue **out_value)
+{
+  GskGLTextureAtlasEntry *entry;
+  GskGLGradientKey lookup = { stops, n_stops };
+
+  lookup.size = gsk_gl_gradient_library_get_ramp_size (self, length);
+
+  if G_LIKELY (gsk_gl_texture_library_lookup ((GskGLTextureLibrary *)self, &lookup, &entry))
+    *out_value = (GskGLGradientValue *)entry;
+  else
+    gsk_gl_gradient_library_add (self, stops, n_stops, lookup.size, out_value);
+
+  return GSK_GL_TEXTURE_ATLAS_ENTRY_TEXTURE (*out_value);
+}
+
+G_END_DECLS
+
+#endif /* __GSK_GL_GRADIENT_LIBRARY_PRIVATE_H__ */
@@ -206,6 +206,7 @@ gsk_gl_icon_library_add (GskGLIconLibrary     *self,
   g_free (free_data);
 
   tl->driver->command_queue->n_uploads++;
+  tl->driver->command_queue->n_upload_bytes += (gsize) (width + 2) * (height + 2) * 4;
 
   if (gdk_profiler_is_running ())
     {
@@ -62,6 +62,11 @@ struct _GskGLRenderer
    * caches through various helpers.
    */
   GskGLDriver *driver;
+
+  /* The rasterizations of cairo nodes. Unlike the driver, this is not
+   * shared, so other windows don't age out our entries.
+   */
+  GskFallbackCache *fallbacks;
 };
 
 G_DEFINE_TYPE (GskGLRenderer, gsk_gl_renderer, GSK_TYPE_RENDERER)
@@ -126,6 +131,7 @@ gsk_gl_renderer_realize (GskRenderer  *renderer,
   self->command_queue = gsk_gl_driver_create_command_queue (driver, context);
   self->context = g_steal_pointer (&context);
   self->driver = g_steal_pointer (&driver);
+  self->fallbacks = gsk_fallback_cache_new ();
 
   gsk_gl_command_queue_set_profiler (self->command_queue,
                                      gsk_renderer_get_profiler (renderer));
@@ -150,6 +156,7 @@ gsk_gl_renderer_unrealize (GskRenderer *renderer)
 
   gdk_gl_context_make_current (self->context);
 
+  g_clear_pointer (&self->fallbacks, gsk_fallback_cache_free);
   g_clear_object (&self->driver);
   g_clear_object (&self->command_queue);
   g_clear_object (&self->context);
@@ -221,7 +228,9 @@ gsk_gl_renderer_render (GskRenderer          *renderer,
   render_region = get_render_region (surface, self->context);
 
   gsk_gl_driver_begin_frame (self->driver, self->command_queue);
+  gsk_fallback_cache_begin_frame (self->fallbacks);
   job = gsk_gl_render_job_new (self->driver, &viewport, scale_factor, render_region, 0);
+  gsk_gl_render_job_set_fallback_cache (job, self->fallbacks);
 #ifdef G_ENABLE_DEBUG
   if (GSK_RENDERER_DEBUG_CHECK (GSK_RENDERER (self), FALLBACK))
     gsk_gl_render_job_set_debug_fallback (job, TRUE);
@@ -268,7 +277,9 @@ gsk_gl_renderer_render_texture (GskRenderer           *renderer,
                                           &render_target))
     {
       gsk_gl_driver_begin_frame (self->driver, self->command_queue);
+      gsk_fallback_cache_begin_frame (self->fallbacks);
       job = gsk_gl_render_job_new (self->driver, viewport, 1, NULL, render_target->framebuffer_id);
+      gsk_gl_render_job_set_fallback_cache (job, self->fallbacks);
 #ifdef G_ENABLE_DEBUG
       if (GSK_RENDERER_DEBUG_CHECK (GSK_RENDERER (self), FALLBACK))
         gsk_gl_render_job_set_debug_fallback (job, TRUE);
@@ -37,9 +37,11 @@
 #include "gskglcommandqueueprivate.h"
 #include "gskgldriverprivate.h"
 #include "gskglglyphlibraryprivate.h"
+#include "gskglgradientlibraryprivate.h"
 #include "gskgliconlibraryprivate.h"
 #include "gskglprogramprivate.h"
 #include "gskglrenderjobprivate.h"
+#include "gskglsdfglyphlibraryprivate.h"
 #include "gskglshadowlibraryprivate.h"
 
 #include "ninesliceprivate.h"
@@ -160,6 +162,15 @@ struct _GskGLRenderJob
   const GskGLRenderModelview *current_modelview;
   GskGLProgram *current_program;
 
+  /* The driver stamps of the shared uniforms in the block last set
+   * on the command queue, and the index of that block.
+   */
+  guint shared_stamps[UNIFORM_SHARED_LAST];
+  int shared_block;
+
+  /* The rasterizations of cairo nodes of the renderer, or %NULL */
+  GskFallbackCache *fallbacks;
+
   /* If we should be rendering red zones over fallback nodes */
   guint debug_fallback : 1;
 
@@ -1067,6 +1078,31 @@ gsk_gl_render_job_draw_offscreen_rect (GskGLRenderJob        *job,
                                  color);
 }
 
+static void
+gsk_gl_render_job_update_shared_uniforms (GskGLRenderJob *job)
+{
+  GskGLSharedUniforms uniforms;
+
+  /* The stamps change whenever one of the shared uniforms does, so
+   * there is nothing to do if the block from the last draw is still
+   * the current one.
+   */
+  if (job->shared_block >= 0 &&
+      job->shared_block == job->command_queue->shared_block &&
+      memcmp (job->shared_stamps, job->driver->stamps, sizeof job->shared_stamps) == 0)
+    return;
+
+  graphene_matrix_to_float (&job->projection, uniforms.projection);
+  graphene_matrix_to_float (&job->current_modelview->matrix, uniforms.modelview);
+  memcpy (uniforms.viewport, &job->viewport, sizeof uniforms.viewport);
+  memcpy (uniforms.clip_rect, &job->current_clip->rect, sizeof uniforms.clip_rect);
+  uniforms.alpha = job->alpha;
+  memset (uniforms.padding, 0, sizeof uniforms.padding);
+
+  job->shared_block = gsk_gl_command_queue_set_shared_uniforms (job->command_queue, &uniforms);
+  memcpy (job->shared_stamps, job->driver->stamps, sizeof job->shared_stamps);
+}
+
 static inline void
 gsk_gl_render_job_begin_draw (GskGLRenderJob *job,
                               GskGLProgram   *program)
@@ -1078,6 +1114,12 @@ gsk_gl_render_job_begin_draw (GskGLRenderJob *job,
                                    job->viewport.size.width,
                                    job->viewport.size.height);
 
+  if (job->command_queue->has_shared_uniforms)
+    {
+      gsk_gl_render_job_update_shared_uniforms (job);
+      return;
+    }
+
   gsk_gl_uniform_state_set4fv (program->uniforms,
                                program->program_info,
                                UNIFORM_SHARED_VIEWPORT,
@@ -1169,6 +1211,8 @@ gsk_gl_render_job_visit_as_fallback (GskGLRenderJob      *job,
       return;
     }
 
+  job->command_queue->n_fallbacks++;
+
   /* We first draw the recording surface on an image surface,
    * just because the scaleY(-1) later otherwise screws up the
    * rendering... */
@@ -1474,6 +1518,55 @@ gsk_gl_render_job_visit_color_node (GskGLRenderJob      *job,
     }
 }
 
+/* Gradients with more color stops than fit into the uniforms of the
+ * gradient programs are drawn from a ramp texture of the gradient
+ * library, which the programs use when there are no color stops.
+ * @length is the length in device pixels that the offsets from 0 to
+ * 1 are stretched over, which the size of the ramp is chosen for.
+ */
+static inline void
+gsk_gl_render_job_set_color_stops (GskGLRenderJob     *job,
+                                   const GskColorStop *stops,
+                                   int                 n_color_stops,
+                                   float               length,
+                                   guint               num_color_stops_key,
+                                   guint               color_stops_key,
+                                   guint               ramp_key)
+{
+  if (n_color_stops < MAX_GRADIENT_STOPS)
+    {
+      gsk_gl_program_set_uniform1i (job->current_program,
+                                    num_color_stops_key, 0,
+                                    n_color_stops);
+      gsk_gl_program_set_uniform1fv (job->current_program,
+                                     color_stops_key, 0,
+                                     n_color_stops * 5,
+                                     (const float *)stops);
+    }
+  else
+    {
+      const GskGLGradientValue *ramp;
+      guint texture_id;
+
+      texture_id = gsk_gl_gradient_library_lookup_or_add (job->driver->gradients,
+                                                          stops, n_color_stops,
+                                                          length,
+                                                          &ramp);
+
+      gsk_gl_program_set_uniform1i (job->current_program,
+                                    num_color_stops_key, 0,
+                                    0);
+      gsk_gl_program_set_uniform_texture (job->current_program,
+                                          UNIFORM_SHARED_SOURCE, 0,
+                                          GL_TEXTURE_2D,
+                                          GL_TEXTURE0,
+                                          texture_id);
+      gsk_gl_program_set_uniform3f (job->current_program,
+                                    ramp_key, 0,
+                                    ramp->ramp[0], ramp->ramp[1], ramp->ramp[2]);
+    }
+}
+
 static inline void
 gsk_gl_render_job_visit_linear_gradient_node (GskGLRenderJob      *job,
                                               const GskRenderNode *node)
@@ -1487,17 +1580,13 @@ gsk_gl_render_job_visit_linear_gradient_node (GskGLRenderJob      *job,
   float x2 = job->offset_x + end->x;
   float y1 = job->offset_y + start->y;
   float y2 = job->offset_y + end->y;
-
-  g_assert (n_color_stops < MAX_GRADIENT_STOPS);
+  float length = hypotf ((x2 - x1) * job->scale_x, (y2 - y1) * job->scale_y);
 
   gsk_gl_render_job_begin_draw (job, CHOOSE_PROGRAM (job, linear_gradient));
-  gsk_gl_program_set_uniform1i (job->current_program,
-                                UNIFORM_LINEAR_GRADIENT_NUM_COLOR_STOPS, 0,
-                                n_color_stops);
-  gsk_gl_program_set_uniform1fv (job->current_program,
-                                 UNIFORM_LINEAR_GRADIENT_COLOR_STOPS, 0,
-                                 n_color_stops * 5,
-                                 (const float *)stops);
+  gsk_gl_render_job_set_color_stops (job, stops, n_color_stops, length,
+                                     UNIFORM_LINEAR_GRADIENT_NUM_COLOR_STOPS,
+                                     UNIFORM_LINEAR_GRADIENT_COLOR_STOPS,
+                                     UNIFORM_LINEAR_GRADIENT_RAMP);
   gsk_gl_program_set_uniform4f (job->current_program,
                                 UNIFORM_LINEAR_GRADIENT_POINTS, 0,
                                 x1, y1, x2 - x1, y2 - y1);
@@ -1519,17 +1608,22 @@ gsk_gl_render_job_visit_conic_gradient_node (GskGLRenderJob      *job,
   int n_color_stops = gsk_conic_gradient_node_get_n_color_stops (node);
   float angle = gsk_conic_gradient_node_get_angle (node);
   float bias = angle * scale + 2.0f;
+  float dx, dy, length;
 
-  g_assert (n_color_stops < MAX_GRADIENT_STOPS);
+  /* The ramp goes around the circle through the corner of the
+   * bounds that is farthest from the center
+   */
+  dx = MAX (fabsf (node->bounds.origin.x - center->x),
+            fabsf (node->bounds.origin.x + node->bounds.size.width - center->x));
+  dy = MAX (fabsf (node->bounds.origin.y - center->y),
+            fabsf (node->bounds.origin.y + node->bounds.size.height - center->y));
+  length = 2 * G_PI * hypotf (dx * job->scale_x, dy * job->scale_y);
 
   gsk_gl_render_job_begin_draw (job, CHOOSE_PROGRAM (job, conic_gradient));
-  gsk_gl_program_set_uniform1i (job->current_program,
-                                UNIFORM_CONIC_GRADIENT_NUM_COLOR_STOPS, 0,
-                                n_color_stops);
-  gsk_gl_program_set_uniform1fv (job->current_program,
-                                 UNIFORM_CONIC_GRADIENT_COLOR_STOPS, 0,
-                                 n_color_stops * 5,
-                                 (const float *)stops);
+  gsk_gl_render_job_set_color_stops (job, stops, n_color_stops, length,
+                                     UNIFORM_CONIC_GRADIENT_NUM_COLOR_STOPS,
+                                     UNIFORM_CONIC_GRADIENT_COLOR_STOPS,
+                                     UNIFORM_CONIC_GRADIENT_RAMP);
   gsk_gl_program_set_uniform4f (job->current_program,
                                 UNIFORM_CONIC_GRADIENT_GEOMETRY, 0,
                                 job->offset_x + center->x,
@@ -1554,17 +1648,13 @@ gsk_gl_render_job_visit_radial_gradient_node (GskGLRenderJob      *job,
   gboolean repeat = gsk_render_node_get_node_type (node) == GSK_REPEATING_RADIAL_GRADIENT_NODE;
   float scale = 1.0f / (end - start);
   float bias = -start * scale;
-
-  g_assert (n_color_stops < MAX_GRADIENT_STOPS);
+  float length = (end - start) * MAX (hradius * job->scale_x, vradius * job->scale_y);
 
   gsk_gl_render_job_begin_draw (job, CHOOSE_PROGRAM (job, radial_gradient));
-  gsk_gl_program_set_uniform1i (job->current_program,
-                                UNIFORM_RADIAL_GRADIENT_NUM_COLOR_STOPS, 0,
-                                n_color_stops);
-  gsk_gl_program_set_uniform1fv (job->current_program,
-                                 UNIFORM_RADIAL_GRADIENT_COLOR_STOPS, 0,
-                                 n_color_stops * 5,
-                                 (const float *)stops);
+  gsk_gl_render_job_set_color_stops (job, stops, n_color_stops, length,
+                                     UNIFORM_RADIAL_GRADIENT_NUM_COLOR_STOPS,
+                                     UNIFORM_RADIAL_GRADIENT_COLOR_STOPS,
+                                     UNIFORM_RADIAL_GRADIENT_RAMP);
   gsk_gl_program_set_uniform1i (job->current_program,
                                 UNIFORM_RADIAL_GRADIENT_REPEAT, 0,
                                 repeat);
@@ -2926,6 +3016,135 @@ compute_phase_and_pos (float value, float *pos)
     }
 }
 
+/* Draws the text with the distance fields of the glyphs, at any scale
+ * and without snapping to the pixel grid. Returns %FALSE if the text
+ * should be drawn with bitmap glyphs, which is also the case while
+ * the distance fields of some glyphs are still being computed.
+ */
+static gboolean
+gsk_gl_render_job_visit_sdf_text_node (GskGLRenderJob      *job,
+                                       const GskRenderNode *node,
+                                       const GdkRGBA       *color,
+                                       gboolean             force_color)
+{
+  const PangoGlyphInfo *glyphs = gsk_text_node_get_glyphs (node, NULL);
+  const graphene_point_t *offset = gsk_text_node_get_offset (node);
+  float text_scale = MAX (job->scale_x, job->scale_y);
+  guint num_glyphs = gsk_text_node_get_num_glyphs (node);
+  float x = offset->x + job->offset_x;
+  float y = offset->y + job->offset_y;
+  GskGLSdfGlyphLibrary *library = job->driver->sdf_glyphs;
+  const GskGLSdfGlyphValue *glyph;
+  GskGLCommandBatch *batch;
+  GskGLDrawVertex *vertices;
+  GskGLSdfGlyphKey lookup;
+  PangoFont *font;
+  float font_size;
+  gboolean ready = TRUE;
+  guint last_texture = 0;
+  int x_position = 0;
+  guint used = 0;
+  guint16 c[4];
+  const PangoGlyphInfo *gi;
+  guint i;
+
+  if (!force_color && gsk_text_node_has_color_glyphs (node))
+    return FALSE;
+
+  font = (PangoFont *)gsk_text_node_get_font (node);
+
+  if (!gsk_gl_sdf_glyph_library_should_use (library,
+                                            font,
+                                            text_scale,
+                                            node->bounds.size.height))
+    return FALSE;
+
+  lookup.desc = (PangoFontDescription *)gsk_gl_sdf_glyph_library_describe_font (library, font, &font_size);
+
+  /* Request all missing glyphs at once, instead of one per frame */
+  for (i = 0, gi = glyphs; i < num_glyphs; i++, gi++)
+    {
+      lookup.glyph = gi->glyph;
+      if (!gsk_gl_sdf_glyph_library_lookup_or_add (library, font, &lookup, &glyph))
+        ready = FALSE;
+    }
+
+  if (!ready)
+    return FALSE;
+
+  rgba_to_half (color, c);
+
+  gsk_gl_render_job_begin_draw (job, CHOOSE_PROGRAM (job, sdf_coloring));
+
+  batch = gsk_gl_command_queue_get_batch (job->command_queue);
+  vertices = gsk_gl_command_queue_add_n_vertices (job->command_queue, num_glyphs);
+
+  for (i = 0, gi = glyphs; i < num_glyphs; i++, gi++)
+    {
+      float glyph_x, glyph_y, glyph_x2, glyph_y2;
+      float tx, ty, tx2, ty2;
+      guint texture_id;
+
+      lookup.glyph = gi->glyph;
+      gsk_gl_sdf_glyph_library_lookup_or_add (library, font, &lookup, &glyph);
+
+      glyph_x = x + (float)(x_position + gi->geometry.x_offset) / PANGO_SCALE + glyph->bounds.origin.x * font_size;
+      glyph_y = y + (float)(gi->geometry.y_offset) / PANGO_SCALE + glyph->bounds.origin.y * font_size;
+
+      x_position += gi->geometry.width;
+
+      texture_id = GSK_GL_TEXTURE_ATLAS_ENTRY_TEXTURE (glyph);
+      if G_UNLIKELY (texture_id == 0)
+        continue;
+
+      if G_UNLIKELY (last_texture != texture_id || batch->draw.vbo_count + GSK_GL_N_VERTICES > 0xffff)
+        {
+          if G_LIKELY (last_texture != 0)
+            {
+              guint vbo_offset = batch->draw.vbo_offset + batch->draw.vbo_count;
+
+              /* See gsk_gl_render_job_visit_text_node() */
+              gsk_gl_render_job_split_draw (job);
+              batch = gsk_gl_command_queue_get_batch (job->command_queue);
+              batch->draw.vbo_offset = vbo_offset;
+            }
+
+          gsk_gl_program_set_uniform_texture (job->current_program,
+                                              UNIFORM_SHARED_SOURCE, 0,
+                                              GL_TEXTURE_2D,
+                                              GL_TEXTURE0,
+                                              texture_id);
+          last_texture = texture_id;
+        }
+
+      tx = glyph->entry.area.x;
+      ty = glyph->entry.area.y;
+      tx2 = glyph->entry.area.x2;
+      ty2 = glyph->entry.area.y2;
+
+      glyph_x2 = glyph_x + glyph->bounds.size.width * font_size;
+      glyph_y2 = glyph_y + glyph->bounds.size.height * font_size;
+
+      *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x,  glyph_y  }, .uv = { tx,  ty  }, .color = { c[0], c[1], c[2], c[3] } };
+      *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x,  glyph_y2 }, .uv = { tx,  ty2 }, .color = { c[0], c[1], c[2], c[3] } };
+      *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x2, glyph_y  }, .uv = { tx2, ty  }, .color = { c[0], c[1], c[2], c[3] } };
+
+      *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x2, glyph_y2 }, .uv = { tx2, ty2 }, .color = { c[0], c[1], c[2], c[3] } };
+      *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x,  glyph_y2 }, .uv = { tx,  ty2 }, .color = { c[0], c[1], c[2], c[3] } };
+      *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x2, glyph_y  }, .uv = { tx2, ty  }, .color = { c[0], c[1], c[2], c[3] } };
+
+      batch->draw.vbo_count += GSK_GL_N_VERTICES;
+      used++;
+    }
+
+  if (used != num_glyphs)
+    gsk_gl_command_queue_retract_n_vertices (job->command_queue, num_glyphs - used);
+
+  gsk_gl_render_job_end_draw (job);
+
+  return TRUE;
+}
+
 static inline void
 gsk_gl_render_job_visit_text_node (GskGLRenderJob      *job,
                                    const GskRenderNode *node,
@@ -2961,6 +3180,9 @@ gsk_gl_render_job_visit_text_node (GskGLRenderJob      *job,
       RGBA_IS_CLEAR (color))
     return;
 
+  if (gsk_gl_render_job_visit_sdf_text_node (job, node, color, force_color))
+    return;
+
   rgba_to_half (color, cc);
 
   lookup.font = (PangoFont *)font;
@@ -3467,6 +3689,16 @@ gsk_gl_render_job_visit_texture_node (GskGLRenderJob      *job,
   GdkTexture *texture = gsk_texture_node_get_texture (node);
   int max_texture_size = job->command_queue->max_texture_size;
 
+  /* Upload a smaller version of textures that are drawn much smaller,
+   * GL textures are used as they are.
+   */
+  if (!GDK_IS_GL_TEXTURE (texture))
+    texture = gdk_texture_get_mipmap (texture,
+                                      MAX (node->bounds.size.width * job->scale_x / texture->width,
+                                           node->bounds.size.height * job->scale_y / texture->height));
+  else
+    g_object_ref (texture);
+
   if G_LIKELY (texture->width <= max_texture_size &&
                texture->height <= max_texture_size)
     {
@@ -3530,6 +3762,59 @@ gsk_gl_render_job_visit_texture_node (GskGLRenderJob      *job,
 
       gsk_gl_render_job_end_draw (job);
     }
+
+  g_object_unref (texture);
+}
+
+static inline void
+gsk_gl_render_job_visit_cairo_node (GskGLRenderJob      *job,
+                                    const GskRenderNode *node)
+{
+  int max_texture_size = job->command_queue->max_texture_size;
+  GskGLRenderOffscreen offscreen = {0};
+  GdkTexture *texture;
+  gboolean rasterized;
+
+  if (gsk_cairo_node_get_surface ((GskRenderNode *)node) == NULL)
+    return;
+
+  /* Keep the debug overlay of fallbacks, and leave nodes too large for
+   * a single texture to the uncached path.
+   */
+  if (job->fallbacks == NULL ||
+      job->debug_fallback ||
+      ceilf (node->bounds.size.width * job->scale_x) > max_texture_size ||
+      ceilf (node->bounds.size.height * job->scale_y) > max_texture_size)
+    {
+      gsk_gl_render_job_visit_as_fallback (job, node);
+      return;
+    }
+
+  /* The rasterization is kept across frames, and when the node replaces
+   * one with the same bounds, only the tiles that differ are uploaded.
+   */
+  texture = gsk_fallback_cache_get_texture (job->fallbacks,
+                                            (GskRenderNode *)node,
+                                            job->scale_x,
+                                            job->scale_y,
+                                            &rasterized);
+  if (texture == NULL)
+    return;
+
+  if (rasterized)
+    job->command_queue->n_fallbacks++;
+
+  offscreen.texture_id = gsk_gl_driver_load_texture (job->driver, texture, GL_NEAREST, GL_NEAREST);
+  init_full_texture_region (&offscreen);
+
+  gsk_gl_render_job_begin_draw (job, CHOOSE_PROGRAM (job, blit));
+  gsk_gl_program_set_uniform_texture (job->current_program,
+                                      UNIFORM_SHARED_SOURCE, 0,
+                                      GL_TEXTURE_2D,
+                                      GL_TEXTURE0,
+                                      offscreen.texture_id);
+  gsk_gl_render_job_draw_offscreen (job, &node->bounds, &offscreen);
+  gsk_gl_render_job_end_draw (job);
 }
 
 static inline void
@@ -3638,10 +3923,7 @@ gsk_gl_render_job_visit_node (GskGLRenderJob      *job,
     break;
 
     case GSK_CONIC_GRADIENT_NODE:
-      if (gsk_conic_gradient_node_get_n_color_stops (node) < MAX_GRADIENT_STOPS)
-        gsk_gl_render_job_visit_conic_gradient_node (job, node);
-      else
-        gsk_gl_render_job_visit_as_fallback (job, node);
+      gsk_gl_render_job_visit_conic_gradient_node (job, node);
     break;
 
     case GSK_CONTAINER_NODE:
@@ -3711,10 +3993,7 @@ gsk_gl_render_job_visit_node (GskGLRenderJob      *job,
 
     case GSK_LINEAR_GRADIENT_NODE:
     case GSK_REPEATING_LINEAR_GRADIENT_NODE:
-      if (gsk_linear_gradient_node_get_n_color_stops (node) < MAX_GRADIENT_STOPS)
-        gsk_gl_render_job_visit_linear_gradient_node (job, node);
-      else
-        gsk_gl_render_job_visit_as_fallback (job, node);
+      gsk_gl_render_job_visit_linear_gradient_node (job, node);
     break;
 
     case GSK_OPACITY_NODE:
@@ -3730,10 +4009,7 @@ gsk_gl_render_job_visit_node (GskGLRenderJob      *job,
 
     case GSK_RADIAL_GRADIENT_NODE:
     case GSK_REPEATING_RADIAL_GRADIENT_NODE:
-      if (gsk_radial_gradient_node_get_n_color_stops (node) < MAX_GRADIENT_STOPS)
-        gsk_gl_render_job_visit_radial_gradient_node (job, node);
-      else
-        gsk_gl_render_job_visit_as_fallback (job, node);
+      gsk_gl_render_job_visit_radial_gradient_node (job, node);
     break;
 
     case GSK_REPEAT_NODE:
@@ -3764,7 +4040,7 @@ gsk_gl_render_job_visit_node (GskGLRenderJob      *job,
     break;
 
     case GSK_CAIRO_NODE:
-      gsk_gl_render_job_visit_as_fallback (job, node);
+      gsk_gl_render_job_visit_cairo_node (job, node);
     break;
 
     case GSK_NOT_A_RENDER_NODE:
@@ -4065,6 +4341,15 @@ gsk_gl_render_job_set_debug_fallback (GskGLRenderJob *job,
   job->debug_fallback = !!debug_fallback;
 }
 
+void
+gsk_gl_render_job_set_fallback_cache (GskGLRenderJob   *job,
+                                      GskFallbackCache *fallbacks)
+{
+  g_return_if_fail (job != NULL);
+
+  job->fallbacks = fallbacks;
+}
+
 static int
 get_framebuffer_format (guint framebuffer)
 {
@@ -4111,6 +4396,7 @@ gsk_gl_render_job_new (GskGLDriver           *driver,
   job->scale_y = scale_factor;
   job->viewport = *viewport;
   job->target_format = get_framebuffer_format (framebuffer);
+  job->shared_block = -1;
 
   gsk_gl_render_job_set_alpha (job, 1.0f);
   gsk_gl_render_job_set_projection_from_rect (job, viewport, NULL);
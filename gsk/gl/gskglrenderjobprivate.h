@@ -23,6 +23,8 @@
 
 #include "gskgltypesprivate.h"
 
+#include <gsk/gskfallbackcacheprivate.h>
+
 GskGLRenderJob *gsk_gl_render_job_new                (GskGLDriver           *driver,
                                                       const graphene_rect_t *viewport,
                                                       float                  scale_factor,
@@ -35,5 +37,7 @@ void            gsk_gl_render_job_render_flipped     (GskGLRenderJob        *job
                                                       GskRenderNode         *root);
 void            gsk_gl_render_job_set_debug_fallback (GskGLRenderJob        *job,
                                                       gboolean               debug_fallback);
+void            gsk_gl_render_job_set_fallback_cache (GskGLRenderJob        *job,
+                                                      GskFallbackCache      *fallbacks);
 
 #endif /* __GSK_GL_RENDER_JOB_H__ */
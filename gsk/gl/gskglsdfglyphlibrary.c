@@ -0,0 +1,720 @@
+/* gskglsdfglyphlibrary.c
+ *
+ * Copyright 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "config.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <gdk/gdkglcontextprivate.h>
+#include <gdk/gdkprofilerprivate.h>
+#include <gsk/gskdebugprivate.h>
+
+#include "gskglcommandqueueprivate.h"
+#include "gskgldriverprivate.h"
+#include "gskglsdfglyphlibraryprivate.h"
+
+/*
+ * The bitmap glyph cache has an entry for every size and subpixel
+ * position of a glyph, so text that is zoomed or scaled in an animation
+ * rasterizes and uploads new glyphs on every frame.
+ *
+ * This library keeps a signed distance field of each glyph instead,
+ * which the sdf_coloring program turns into coverage at any scale. The
+ * distance fields are computed on worker threads. Until the fields for
+ * all glyphs of a text node are available, the node is drawn with the
+ * bitmap glyphs, so nothing ever waits for them.
+ *
+ * Distance fields lose sharp corners and fine detail compared to the
+ * hinted bitmap glyphs, so they are only used for text that is large,
+ * or whose scale changed in the last frames.
+ *
+ * A distance field does not depend on the size it is drawn at, so the
+ * glyphs are keyed on the description of the font without its size,
+ * and their bounds are kept in multiples of the font size. Zooming
+ * text through different font sizes reuses the same fields.
+ *
+ * The distance fields are kept in their own single channel atlases.
+ *
+ * Which glyphs are drawn from distance fields depends on the frame
+ * history and on the worker threads, so the compare tests in
+ * testsuite/gsk set GSK_DEBUG=gl-sdf-glyphs, which computes them right
+ * away for all text, and allow for the softer corners of the glyphs.
+ */
+
+/* Size of the largest side of the glyph in the distance field */
+#define SDF_GLYPH_SIZE 64
+
+/* Distance in texels covered by the field on either side of the outline */
+#define SDF_SPREAD 8
+
+/* Text taller than this in device pixels is drawn with distance fields */
+#define SDF_MIN_HEIGHT 128
+
+/* A font whose scale changed in at least SDF_MIN_CHANGES frames, with no
+ * more than SDF_MAX_GAP frames between the changes, is considered to be
+ * animated, until its scale stayed the same for SDF_SETTLE_FRAMES frames.
+ */
+#define SDF_MIN_CHANGES 3
+#define SDF_MAX_GAP 4
+#define SDF_SETTLE_FRAMES 30
+
+#define SDF_INF 1e20f
+
+typedef struct _SdfJob
+{
+  GskGLSdfGlyphKey *key;
+  PangoFont *font;
+  graphene_rect_t bounds;
+  int width;
+  int height;
+  int stride;
+
+  /* A8 rendering of the glyph, replaced with the distance
+   * field, one byte per texel, once the job is done.
+   */
+  guint8 *pixels;
+  guint8 *field;
+} SdfJob;
+
+typedef struct _FontScale
+{
+  /* The description of the font without its size, and the size */
+  PangoFontDescription *desc;
+  float size;
+
+  float scale;
+  gint64 last_change;
+  gint64 last_used;
+  guint n_changes;
+} FontScale;
+
+struct _GskGLSdfGlyphLibrary
+{
+  GskGLTextureLibrary parent_instance;
+
+  /* Keys of glyphs whose distance field is being computed */
+  GHashTable *pending;
+
+  GThreadPool *pool;
+  GAsyncQueue *done;
+
+  /* PangoFont → FontScale, to tell animated text */
+  GHashTable *font_scales;
+
+  gint64 frame_id;
+
+  guint n_generated;
+  guint generated_counter;
+
+  guint supported : 1;
+};
+
+G_DEFINE_TYPE (GskGLSdfGlyphLibrary, gsk_gl_sdf_glyph_library, GSK_TYPE_GL_TEXTURE_LIBRARY)
+
+GskGLSdfGlyphLibrary *
+gsk_gl_sdf_glyph_library_new (GskGLDriver *driver)
+{
+  g_return_val_if_fail (GSK_IS_GL_DRIVER (driver), NULL);
+
+  return g_object_new (GSK_TYPE_GL_SDF_GLYPH_LIBRARY,
+                       "driver", driver,
+                       NULL);
+}
+
+static guint
+gsk_gl_sdf_glyph_key_hash (gconstpointer data)
+{
+  const GskGLSdfGlyphKey *key = data;
+
+  return pango_font_description_hash (key->desc) ^ key->glyph;
+}
+
+static gboolean
+gsk_gl_sdf_glyph_key_equal (gconstpointer v1,
+                            gconstpointer v2)
+{
+  const GskGLSdfGlyphKey *k1 = v1;
+  const GskGLSdfGlyphKey *k2 = v2;
+
+  return k1->glyph == k2->glyph &&
+         pango_font_description_equal (k1->desc, k2->desc);
+}
+
+static void
+gsk_gl_sdf_glyph_key_free (gpointer data)
+{
+  GskGLSdfGlyphKey *key = data;
+
+  g_clear_pointer (&key->desc, pango_font_description_free);
+  g_slice_free (GskGLSdfGlyphKey, key);
+}
+
+static void
+gsk_gl_sdf_glyph_value_free (gpointer data)
+{
+  g_slice_free (GskGLSdfGlyphValue, data);
+}
+
+static void
+font_scale_free (gpointer data)
+{
+  FontScale *font_scale = data;
+
+  pango_font_description_free (font_scale->desc);
+  g_free (font_scale);
+}
+
+static void
+sdf_job_free (SdfJob *job)
+{
+  if (job->key)
+    gsk_gl_sdf_glyph_key_free (job->key);
+  g_clear_object (&job->font);
+  g_free (job->pixels);
+  g_free (job->field);
+  g_slice_free (SdfJob, job);
+}
+
+/* One-dimensional squared Euclidean distance transform of sampled
+ * functions, from Felzenszwalb and Huttenlocher.
+ */
+static void
+edt_1d (float *f,
+        int    offset,
+        int    step,
+        int    n,
+        float *d,
+        int   *v,
+        float *z)
+{
+  int k = 0;
+
+  v[0] = 0;
+  z[0] = -SDF_INF;
+  z[1] = SDF_INF;
+
+  for (int q = 1; q < n; q++)
+    {
+      float fq = f[offset + q * step] + q * q;
+      float s;
+
+      do
+        {
+          int r = v[k];
+
+          s = (fq - f[offset + r * step] - r * r) / (2 * q - 2 * r);
+        }
+      while (s <= z[k] && --k > -1);
+
+      k++;
+      v[k] = q;
+      z[k] = s;
+      z[k + 1] = SDF_INF;
+    }
+
+  k = 0;
+  for (int q = 0; q < n; q++)
+    {
+      while (z[k + 1] < q)
+        k++;
+
+      d[q] = (q - v[k]) * (q - v[k]) + f[offset + v[k] * step];
+    }
+
+  for (int q = 0; q < n; q++)
+    f[offset + q * step] = d[q];
+}
+
+static void
+edt_2d (float *grid,
+        int    width,
+        int    height)
+{
+  int n = MAX (width, height);
+  float *d = g_new (float, n);
+  int *v = g_new (int, n);
+  float *z = g_new (float, n + 1);
+
+  for (int x = 0; x < width; x++)
+    edt_1d (grid, x, width, height, d, v, z);
+
+  for (int y = 0; y < height; y++)
+    edt_1d (grid, y * width, 1, width, d, v, z);
+
+  g_free (z);
+  g_free (v);
+  g_free (d);
+}
+
+/* Computes the distance field from the antialiased glyph, using the
+ * coverage of edge pixels for the distance within the pixel.
+ */
+static void
+sdf_job_run (gpointer data,
+             gpointer user_data)
+{
+  SdfJob *job = data;
+  GAsyncQueue *done = user_data;
+  int n = job->width * job->height;
+  float *outer = g_new (float, n);
+  float *inner = g_new (float, n);
+
+  for (int y = 0; y < job->height; y++)
+    {
+      for (int x = 0; x < job->width; x++)
+        {
+          float a = job->pixels[y * job->stride + x] / 255.f;
+          int i = y * job->width + x;
+
+          if (a >= 1.f)
+            {
+              outer[i] = 0;
+              inner[i] = SDF_INF;
+            }
+          else if (a <= 0.f)
+            {
+              outer[i] = SDF_INF;
+              inner[i] = 0;
+            }
+          else
+            {
+              outer[i] = MAX (0.f, 0.5f - a) * MAX (0.f, 0.5f - a);
+              inner[i] = MAX (0.f, a - 0.5f) * MAX (0.f, a - 0.5f);
+            }
+        }
+    }
+
+  edt_2d (outer, job->width, job->height);
+  edt_2d (inner, job->width, job->height);
+
+  job->field = g_malloc (n);
+
+  for (int i = 0; i < n; i++)
+    {
+      float distance = sqrtf (outer[i]) - sqrtf (inner[i]);
+      float value = CLAMP (0.5f - distance / (2 * SDF_SPREAD), 0.f, 1.f);
+
+      job->field[i] = (guint8) roundf (value * 255.f);
+    }
+
+  g_free (inner);
+  g_free (outer);
+  g_clear_pointer (&job->pixels, g_free);
+
+  if (done)
+    g_async_queue_push (done, job);
+}
+
+/* Renders the glyph for the distance field. This uses the font, so it
+ * happens on the thread of the renderer, only the distance transform
+ * is done by the workers.
+ */
+static SdfJob *
+sdf_job_new (GskGLSdfGlyphKey     *key,
+             PangoFont            *font,
+             float                 size,
+             const PangoRectangle *ink_rect)
+{
+  PangoGlyphString glyph_string;
+  PangoGlyphInfo glyph_info;
+  cairo_surface_t *surface;
+  cairo_t *cr;
+  SdfJob *job;
+  float scale;
+
+  scale = SDF_GLYPH_SIZE / (MAX (ink_rect->width, ink_rect->height) / (float) PANGO_SCALE);
+
+  job = g_slice_new0 (SdfJob);
+  job->key = key;
+  job->font = g_object_ref (font);
+  job->width = ceilf (ink_rect->width / (float) PANGO_SCALE * scale) + 2 * SDF_SPREAD;
+  job->height = ceilf (ink_rect->height / (float) PANGO_SCALE * scale) + 2 * SDF_SPREAD;
+  job->stride = cairo_format_stride_for_width (CAIRO_FORMAT_A8, job->width);
+  job->pixels = g_malloc0 (job->stride * job->height);
+
+  graphene_rect_init (&job->bounds,
+                      ink_rect->x / (float) PANGO_SCALE - SDF_SPREAD / scale,
+                      ink_rect->y / (float) PANGO_SCALE - SDF_SPREAD / scale,
+                      job->width / scale,
+                      job->height / scale);
+
+  surface = cairo_image_surface_create_for_data (job->pixels,
+                                                 CAIRO_FORMAT_A8,
+                                                 job->width, job->height,
+                                                 job->stride);
+  cr = cairo_create (surface);
+  cairo_scale (cr, scale, scale);
+  cairo_translate (cr, - job->bounds.origin.x, - job->bounds.origin.y);
+
+  glyph_info.glyph = key->glyph;
+  glyph_info.geometry.width = 0;
+  glyph_info.geometry.x_offset = 0;
+  glyph_info.geometry.y_offset = 0;
+
+  glyph_string.num_glyphs = 1;
+  glyph_string.glyphs = &glyph_info;
+
+  pango_cairo_show_glyph_string (cr, font, &glyph_string);
+
+  cairo_destroy (cr);
+  cairo_surface_finish (surface);
+  cairo_surface_destroy (surface);
+
+  /* The rendering is in the units of the font, the bounds are kept
+   * in multiples of its size so they apply to every size.
+   */
+  graphene_rect_scale (&job->bounds, 1 / size, 1 / size, &job->bounds);
+
+  return job;
+}
+
+static void
+gsk_gl_sdf_glyph_library_upload (GskGLSdfGlyphLibrary *self,
+                                 SdfJob               *job)
+{
+  GskGLTextureLibrary *tl = (GskGLTextureLibrary *)self;
+  G_GNUC_UNUSED gint64 start_time = GDK_PROFILER_CURRENT_TIME;
+  GskGLSdfGlyphValue *value;
+  guint packed_x;
+  guint packed_y;
+
+  value = gsk_gl_texture_library_pack (tl,
+                                       job->key,
+                                       sizeof *value,
+                                       job->width,
+                                       job->height,
+                                       1,
+                                       &packed_x, &packed_y);
+  value->bounds = job->bounds;
+
+  /* The hash table owns the key now */
+  job->key = NULL;
+
+  gdk_gl_context_push_debug_group (gdk_gl_context_get_current (), "Uploading glyph distance field");
+
+  glBindTexture (GL_TEXTURE_2D, GSK_GL_TEXTURE_ATLAS_ENTRY_TEXTURE (value));
+  glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+  glTexSubImage2D (GL_TEXTURE_2D, 0,
+                   packed_x + 1, packed_y + 1,
+                   job->width, job->height,
+                   GL_RED, GL_UNSIGNED_BYTE,
+                   job->field);
+  glPixelStorei (GL_UNPACK_ALIGNMENT, 4);
+
+  gdk_gl_context_pop_debug_group (gdk_gl_context_get_current ());
+
+  tl->driver->command_queue->n_uploads++;
+  tl->driver->command_queue->n_upload_bytes += (gsize) job->width * job->height;
+  self->n_generated++;
+
+  gdk_profiler_add_markf (start_time, GDK_PROFILER_CURRENT_TIME-start_time,
+                          "Upload Glyph Distance Field", "Size %dx%d", job->width, job->height);
+}
+
+static void
+gsk_gl_sdf_glyph_library_begin_frame (GskGLTextureLibrary *library,
+                                      gint64               frame_id,
+                                      GPtrArray           *removed_atlases)
+{
+  GskGLSdfGlyphLibrary *self = (GskGLSdfGlyphLibrary *)library;
+  GHashTableIter iter;
+  FontScale *font_scale;
+  SdfJob *job;
+
+  if (GDK_PROFILER_IS_RUNNING)
+    gdk_profiler_set_int_counter (self->generated_counter, self->n_generated);
+
+  self->frame_id = frame_id;
+  self->n_generated = 0;
+
+  /* Distance fields that were finished since the last frame */
+  while ((job = g_async_queue_try_pop (self->done)))
+    {
+      g_hash_table_remove (self->pending, job->key);
+      gsk_gl_sdf_glyph_library_upload (self, job);
+      sdf_job_free (job);
+    }
+
+  g_hash_table_iter_init (&iter, self->font_scales);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&font_scale))
+    {
+      if (frame_id - font_scale->last_used > SDF_SETTLE_FRAMES)
+        g_hash_table_iter_remove (&iter);
+    }
+}
+
+static void
+gsk_gl_sdf_glyph_library_constructed (GObject *object)
+{
+  GskGLSdfGlyphLibrary *self = (GskGLSdfGlyphLibrary *)object;
+  GskGLTextureLibrary *tl = (GskGLTextureLibrary *)object;
+  GdkGLContext *context;
+
+  G_OBJECT_CLASS (gsk_gl_sdf_glyph_library_parent_class)->constructed (object);
+
+  /* The sdf_coloring program needs derivatives, which GLSL ES 1.0
+   * only has as an extension, and the single channel atlases need
+   * GL 3.
+   */
+  context = gsk_gl_command_queue_get_context (tl->driver->shared_command_queue);
+  self->supported = !gdk_gl_context_get_use_es (context) &&
+                    !gdk_gl_context_is_legacy (context);
+}
+
+static void
+gsk_gl_sdf_glyph_library_finalize (GObject *object)
+{
+  GskGLSdfGlyphLibrary *self = (GskGLSdfGlyphLibrary *)object;
+  SdfJob *job;
+
+  /* Let the queued jobs run too instead of dropping them, so that
+   * all of them end up in @done and are freed below.
+   */
+  g_thread_pool_free (self->pool, FALSE, TRUE);
+
+  while ((job = g_async_queue_try_pop (self->done)))
+    sdf_job_free (job);
+
+  g_async_queue_unref (self->done);
+  g_hash_table_unref (self->pending);
+  g_hash_table_unref (self->font_scales);
+
+  G_OBJECT_CLASS (gsk_gl_sdf_glyph_library_parent_class)->finalize (object);
+}
+
+static void
+gsk_gl_sdf_glyph_library_class_init (GskGLSdfGlyphLibraryClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GskGLTextureLibraryClass *library_class = GSK_GL_TEXTURE_LIBRARY_CLASS (klass);
+
+  object_class->constructed = gsk_gl_sdf_glyph_library_constructed;
+  object_class->finalize = gsk_gl_sdf_glyph_library_finalize;
+
+  library_class->begin_frame = gsk_gl_sdf_glyph_library_begin_frame;
+}
+
+static void
+gsk_gl_sdf_glyph_library_init (GskGLSdfGlyphLibrary *self)
+{
+  GskGLTextureLibrary *tl = (GskGLTextureLibrary *)self;
+
+  tl->max_entry_size = SDF_GLYPH_SIZE + 2 * SDF_SPREAD;
+  tl->format = GL_R8;
+  gsk_gl_texture_library_set_funcs (tl,
+                                    gsk_gl_sdf_glyph_key_hash,
+                                    gsk_gl_sdf_glyph_key_equal,
+                                    gsk_gl_sdf_glyph_key_free,
+                                    gsk_gl_sdf_glyph_value_free);
+
+  /* The keys are owned by the jobs */
+  self->pending = g_hash_table_new (gsk_gl_sdf_glyph_key_hash, gsk_gl_sdf_glyph_key_equal);
+  self->font_scales = g_hash_table_new_full (NULL, NULL, g_object_unref, font_scale_free);
+
+  self->done = g_async_queue_new ();
+  self->pool = g_thread_pool_new (sdf_job_run,
+                                  self->done,
+                                  MAX (1, (int) g_get_num_processors () - 1),
+                                  FALSE,
+                                  NULL);
+
+  self->generated_counter = gdk_profiler_define_int_counter ("sdf-glyphs", "Number of glyph distance fields uploaded");
+}
+
+static FontScale *
+gsk_gl_sdf_glyph_library_ensure_font (GskGLSdfGlyphLibrary *self,
+                                      PangoFont            *font,
+                                      float                 scale)
+{
+  FontScale *font_scale;
+
+  font_scale = g_hash_table_lookup (self->font_scales, font);
+  if (font_scale == NULL)
+    {
+      font_scale = g_new0 (FontScale, 1);
+      font_scale->desc = pango_font_describe_with_absolute_size (font);
+      font_scale->size = pango_font_description_get_size (font_scale->desc) / (float) PANGO_SCALE;
+      pango_font_description_unset_fields (font_scale->desc, PANGO_FONT_MASK_SIZE);
+      font_scale->scale = scale;
+      font_scale->last_change = self->frame_id;
+      font_scale->last_used = self->frame_id;
+      g_hash_table_insert (self->font_scales, g_object_ref (font), font_scale);
+    }
+
+  return font_scale;
+}
+
+/*<private>
+ * gsk_gl_sdf_glyph_library_should_use:
+ * @self: a `GskGLSdfGlyphLibrary`
+ * @font: the font of the text
+ * @scale: the scale the text is drawn at
+ * @height: the height of the text, in the units of the font
+ *
+ * Decides if text should be drawn with distance fields, which is
+ * the case for large text and for text whose scale is animated.
+ *
+ * This must be called once per text node, as it also tracks the
+ * changes in scale of @font.
+ *
+ * Returns: %TRUE if the text should be drawn with distance fields
+ */
+gboolean
+gsk_gl_sdf_glyph_library_should_use (GskGLSdfGlyphLibrary *self,
+                                     PangoFont            *font,
+                                     float                 scale,
+                                     float                 height)
+{
+  FontScale *font_scale;
+
+  g_assert (GSK_IS_GL_SDF_GLYPH_LIBRARY (self));
+
+  if (!self->supported || GSK_DEBUG_CHECK (GL_NO_SDF_GLYPHS))
+    return FALSE;
+
+  if (GSK_DEBUG_CHECK (GL_SDF_GLYPHS))
+    return TRUE;
+
+  font_scale = gsk_gl_sdf_glyph_library_ensure_font (self, font, scale);
+
+  if (font_scale->scale != scale && font_scale->last_change != self->frame_id)
+    {
+      if (self->frame_id - font_scale->last_change <= SDF_MAX_GAP)
+        font_scale->n_changes++;
+      else
+        font_scale->n_changes = 1;
+
+      font_scale->scale = scale;
+      font_scale->last_change = self->frame_id;
+    }
+
+  font_scale->last_used = self->frame_id;
+
+  if (height * scale >= SDF_MIN_HEIGHT)
+    return TRUE;
+
+  return font_scale->n_changes >= SDF_MIN_CHANGES &&
+         self->frame_id - font_scale->last_change <= SDF_SETTLE_FRAMES;
+}
+
+/*<private>
+ * gsk_gl_sdf_glyph_library_describe_font:
+ * @self: a `GskGLSdfGlyphLibrary`
+ * @font: a font
+ * @size: (out): return location for the size of @font, in pixels
+ *
+ * Gets the description of @font without its size, for use in
+ * a `GskGLSdfGlyphKey`. The bounds of the glyphs are multiplied
+ * with @size to draw them with @font.
+ *
+ * Returns: (transfer none): the description of @font, which is
+ *   valid for the current frame
+ */
+const PangoFontDescription *
+gsk_gl_sdf_glyph_library_describe_font (GskGLSdfGlyphLibrary *self,
+                                        PangoFont            *font,
+                                        float                *size)
+{
+  FontScale *font_scale;
+
+  g_assert (GSK_IS_GL_SDF_GLYPH_LIBRARY (self));
+
+  font_scale = gsk_gl_sdf_glyph_library_ensure_font (self, font, 1);
+  font_scale->last_used = self->frame_id;
+
+  *size = font_scale->size;
+
+  return font_scale->desc;
+}
+
+/*<private>
+ * gsk_gl_sdf_glyph_library_lookup_or_add:
+ * @self: a `GskGLSdfGlyphLibrary`
+ * @font: the font to render the glyph with, if it is missing
+ * @key: the glyph to look up
+ * @out_value: (out): return location for the distance field
+ *
+ * Looks up the distance field of a glyph, and starts computing
+ * it if it is not available yet. Glyphs without ink have a value
+ * with no texture.
+ *
+ * With GSK_DEBUG=gl-sdf-glyphs, the distance field is computed
+ * right away.
+ *
+ * Returns: %TRUE if @out_value was set, %FALSE if the distance
+ *   field is still being computed
+ */
+gboolean
+gsk_gl_sdf_glyph_library_lookup_or_add (GskGLSdfGlyphLibrary      *self,
+                                        PangoFont                 *font,
+                                        const GskGLSdfGlyphKey    *key,
+                                        const GskGLSdfGlyphValue **out_value)
+{
+  GskGLTextureLibrary *tl = (GskGLTextureLibrary *)self;
+  GskGLTextureAtlasEntry *entry;
+  PangoRectangle ink_rect;
+  GskGLSdfGlyphKey *k;
+  SdfJob *job;
+  float size;
+
+  if G_LIKELY (gsk_gl_texture_library_lookup (tl, key, &entry))
+    {
+      *out_value = (const GskGLSdfGlyphValue *)entry;
+      return TRUE;
+    }
+
+  if (g_hash_table_contains (self->pending, key))
+    return FALSE;
+
+  gsk_gl_sdf_glyph_library_describe_font (self, font, &size);
+  pango_font_get_glyph_extents (font, key->glyph, &ink_rect, NULL);
+
+  k = g_slice_copy (sizeof *key, key);
+  k->desc = pango_font_description_copy (key->desc);
+
+  if (ink_rect.width <= 0 || ink_rect.height <= 0 || size <= 0)
+    {
+      guint packed_x, packed_y;
+      GskGLSdfGlyphValue *value;
+
+      value = gsk_gl_texture_library_pack (tl, k, sizeof *value, 0, 0, 0, &packed_x, &packed_y);
+      graphene_rect_init (&value->bounds, 0, 0, 0, 0);
+      *out_value = value;
+
+      return TRUE;
+    }
+
+  job = sdf_job_new (k, font, size, &ink_rect);
+
+  if (GSK_DEBUG_CHECK (GL_SDF_GLYPHS))
+    {
+      sdf_job_run (job, NULL);
+      gsk_gl_sdf_glyph_library_upload (self, job);
+      sdf_job_free (job);
+
+      return gsk_gl_sdf_glyph_library_lookup_or_add (self, font, key, out_value);
+    }
+
+  g_hash_table_add (self->pending, k);
+  g_thread_pool_push (self->pool, job, NULL);
+
+  return FALSE;
+}
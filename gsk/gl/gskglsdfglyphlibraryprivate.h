@@ -0,0 +1,70 @@
+/* gskglsdfglyphlibraryprivate.h
+ *
+ * Copyright 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef __GSK_GL_SDF_GLYPH_LIBRARY_PRIVATE_H__
+#define __GSK_GL_SDF_GLYPH_LIBRARY_PRIVATE_H__
+
+#include <pango/pango.h>
+
+#include "gskgltexturelibraryprivate.h"
+
+G_BEGIN_DECLS
+
+#define GSK_TYPE_GL_SDF_GLYPH_LIBRARY (gsk_gl_sdf_glyph_library_get_type())
+
+/* Unlike GskGLGlyphKey, there is no scale or subpixel shift here, and
+ * the font is described without its size, so that the distance field
+ * of a glyph is shared by all sizes of a font.
+ */
+typedef struct _GskGLSdfGlyphKey
+{
+  PangoFontDescription *desc;
+  PangoGlyph glyph;
+} GskGLSdfGlyphKey;
+
+typedef struct _GskGLSdfGlyphValue
+{
+  GskGLTextureAtlasEntry entry;
+
+  /* The area covered by the distance field, relative to the origin
+   * of the glyph, in multiples of the font size.
+   */
+  graphene_rect_t bounds;
+} GskGLSdfGlyphValue;
+
+G_DECLARE_FINAL_TYPE (GskGLSdfGlyphLibrary, gsk_gl_sdf_glyph_library, GSK, GL_SDF_GLYPH_LIBRARY, GskGLTextureLibrary)
+
+GskGLSdfGlyphLibrary *gsk_gl_sdf_glyph_library_new           (GskGLDriver                *driver);
+gboolean              gsk_gl_sdf_glyph_library_should_use    (GskGLSdfGlyphLibrary       *self,
+                                                              PangoFont                  *font,
+                                                              float                       scale,
+                                                              float                       height);
+const PangoFontDescription *
+                      gsk_gl_sdf_glyph_library_describe_font (GskGLSdfGlyphLibrary       *self,
+                                                              PangoFont                  *font,
+                                                              float                      *size);
+gboolean              gsk_gl_sdf_glyph_library_lookup_or_add (GskGLSdfGlyphLibrary       *self,
+                                                              PangoFont                  *font,
+                                                              const GskGLSdfGlyphKey     *key,
+                                                              const GskGLSdfGlyphValue  **out_value);
+
+G_END_DECLS
+
+#endif /* __GSK_GL_SDF_GLYPH_LIBRARY_PRIVATE_H__ */
@@ -118,6 +118,7 @@ gsk_gl_texture_library_class_init (GskGLTextureLibraryClass *klass)
 static void
 gsk_gl_texture_library_init (GskGLTextureLibrary *self)
 {
+  self->format = GL_RGBA8;
 }
 
 void
@@ -228,7 +229,7 @@ gsk_gl_texture_library_pack_one (GskGLTextureLibrary *self,
       height = MIN (height, self->driver->command_queue->max_texture_size);
     }
 
-  texture = gsk_gl_driver_create_texture (self->driver, width, height, GL_RGBA8, GL_LINEAR, GL_LINEAR);
+  texture = gsk_gl_driver_create_texture (self->driver, width, height, self->format, GL_LINEAR, GL_LINEAR);
   texture->permanent = TRUE;
 
   return texture;
@@ -278,7 +279,13 @@ gsk_gl_texture_atlas_initialize (GskGLDriver       *driver,
 
   memset (pixel_data, 255, sizeof pixel_data);
 
-  if (gdk_gl_context_get_use_es (gdk_gl_context_get_current ()))
+  if (atlas->format == GL_R8)
+    {
+      gl_format = GL_RED;
+      gl_type = GL_UNSIGNED_BYTE;
+      glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+    }
+  else if (gdk_gl_context_get_use_es (gdk_gl_context_get_current ()))
     {
       gl_format = GL_RGBA;
       gl_type = GL_UNSIGNED_BYTE;
@@ -297,13 +304,18 @@ gsk_gl_texture_atlas_initialize (GskGLDriver       *driver,
                    gl_format, gl_type,
                    pixel_data);
 
+  if (atlas->format == GL_R8)
+    glPixelStorei (GL_UNPACK_ALIGNMENT, 4);
+
   gdk_gl_context_pop_debug_group (gdk_gl_context_get_current ());
 
   driver->command_queue->n_uploads++;
+  driver->command_queue->n_upload_bytes += atlas->format == GL_R8 ? 3 * 3 : sizeof pixel_data;
 }
 
 static void
 gsk_gl_texture_atlases_pack (GskGLDriver        *driver,
+                             int                 format,
                              int                 width,
                              int                 height,
                              GskGLTextureAtlas **out_atlas,
@@ -317,7 +329,8 @@ gsk_gl_texture_atlases_pack (GskGLDriver        *driver,
     {
       atlas = g_ptr_array_index (driver->atlases, i);
 
-      if (gsk_gl_texture_atlas_pack (atlas, width, height, &x, &y))
+      if (atlas->format == format &&
+          gsk_gl_texture_atlas_pack (atlas, width, height, &x, &y))
         break;
 
       atlas = NULL;
@@ -326,7 +339,7 @@ gsk_gl_texture_atlases_pack (GskGLDriver        *driver,
   if (atlas == NULL)
     {
       /* No atlas has enough space, so create a new one... */
-      atlas = gsk_gl_driver_create_atlas (driver);
+      atlas = gsk_gl_driver_create_atlas (driver, format);
 
       gsk_gl_texture_atlas_initialize (driver, atlas);
 
@@ -386,6 +399,7 @@ gsk_gl_texture_library_pack (GskGLTextureLibrary *self,
       int packed_y;
 
       gsk_gl_texture_atlases_pack (self->driver,
+                                   self->format,
                                    padding + width + padding,
                                    padding + height + padding,
                                    &atlas,
@@ -43,6 +43,9 @@ typedef struct _GskGLTextureAtlas
   int width;
   int height;
 
+  /* GL_RGBA8, or GL_R8 for single channel atlases */
+  int format;
+
   guint texture_id;
 
   /* Pixels of rects that have been used at some point,
@@ -93,6 +96,7 @@ typedef struct _GskGLTextureLibrary
   GskGLDriver *driver;
   GHashTable    *hash_table;
   guint          max_entry_size;
+  int            format;
 } GskGLTextureLibrary;
 
 typedef struct _GskGLTextureLibraryClass
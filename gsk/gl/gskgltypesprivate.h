@@ -37,9 +37,11 @@ typedef struct _GskGLCompiler GskGLCompiler;
 typedef struct _GskGLDrawVertex GskGLDrawVertex;
 typedef struct _GskGLRenderTarget GskGLRenderTarget;
 typedef struct _GskGLGlyphLibrary GskGLGlyphLibrary;
+typedef struct _GskGLGradientLibrary GskGLGradientLibrary;
 typedef struct _GskGLIconLibrary GskGLIconLibrary;
 typedef struct _GskGLProgram GskGLProgram;
 typedef struct _GskGLRenderJob GskGLRenderJob;
+typedef struct _GskGLSdfGlyphLibrary GskGLSdfGlyphLibrary;
 typedef struct _GskGLShadowLibrary GskGLShadowLibrary;
 typedef struct _GskGLTexture GskGLTexture;
 typedef struct _GskGLTextureSlice GskGLTextureSlice;
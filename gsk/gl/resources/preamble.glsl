@@ -14,6 +14,19 @@ precision highp float;
 #define _GSK_ROUNDED_RECT_UNIFORM_ GskRoundedRect
 #endif
 
+#if defined(GSK_SHARED_UNIFORMS)
+// Same layout as GskGLSharedUniforms, bound once per batch
+// from a uniform buffer instead of being set per program.
+layout(std140) uniform GskSharedUniforms
+{
+  mat4 u_projection;
+  mat4 u_modelview;
+  vec4 u_viewport;
+  vec4 u_clip_rect[3];
+  float u_alpha;
+};
+#endif
+
 
 struct GskRoundedRect
 {
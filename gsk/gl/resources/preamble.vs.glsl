@@ -1,6 +1,8 @@
+#if !defined(GSK_SHARED_UNIFORMS)
 uniform mat4 u_projection;
 uniform mat4 u_modelview;
 uniform float u_alpha;
+#endif
 
 #if defined(GSK_GLES) || defined(GSK_LEGACY)
 attribute vec2 aPosition;
@@ -31,6 +31,7 @@ uniform highp int u_num_color_stops;
 uniform bool u_repeat;
 uniform vec2 u_range;
 uniform float u_color_stops[MAX_COLOR_STOPS * 5];
+uniform vec3 u_ramp;
 
 _NOPERSPECTIVE_ _IN_ vec2 coord;
 
@@ -60,6 +61,13 @@ void main() {
     offset = fract(offset);
   }
 
+  if (u_num_color_stops == 0) {
+    // Too many color stops for the uniforms, use the gradient ramp
+    vec2 pos = vec2(u_ramp.x + clamp(offset, 0.0, 1.0) * u_ramp.y, u_ramp.z);
+    gskSetScaledOutputColor(GskTexture(u_source, pos), u_alpha);
+    return;
+  }
+
   next_offset = get_offset(0);
   if (offset < next_offset) {
     gskSetOutputColor(gsk_scaled_premultiply(get_color(0), u_alpha));
@@ -0,0 +1,35 @@
+// VERTEX_SHADER:
+// sdf_coloring.glsl
+
+_OUT_ vec4 final_color;
+
+void main() {
+  gl_Position = u_projection * u_modelview * vec4(aPosition, 0.0, 1.0);
+
+  vUv = vec2(aUv.x, aUv.y);
+
+  final_color = gsk_scaled_premultiply(aColor, u_alpha);
+}
+
+// FRAGMENT_SHADER:
+// sdf_coloring.glsl
+
+_IN_ vec4 final_color;
+
+void main() {
+  // The outline of the glyph is at 0.5, and the field changes
+  // by 0.5 / spread per texel of the distance field.
+  float distance = GskTexture(u_source, vUv).r;
+
+#if defined(GSK_GLES)
+  // No derivatives without OES_standard_derivatives. The renderer
+  // does not use this program on GLES, but it has to compile.
+  float width = 0.05;
+#else
+  float width = fwidth(distance);
+#endif
+
+  float coverage = clamp((distance - 0.5) / max(width, 0.0001) + 0.5, 0.0, 1.0);
+
+  gskSetOutputColor(final_color * coverage);
+}
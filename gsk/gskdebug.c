@@ -10,11 +10,16 @@ static const GdkDebugKey gsk_debug_keys[] = {
   { "surface", GSK_DEBUG_SURFACE, "Information about surfaces" },
   { "fallback", GSK_DEBUG_FALLBACK, "Information about fallbacks" },
   { "glyphcache", GSK_DEBUG_GLYPH_CACHE, "Information about glyph caching" },
+  { "offload", GSK_DEBUG_OFFLOAD, "Information about offloading textures to subsurfaces" },
   { "geometry", GSK_DEBUG_GEOMETRY, "Show borders (when using cairo)" },
   { "full-redraw", GSK_DEBUG_FULL_REDRAW, "Force full redraws" },
   { "sync", GSK_DEBUG_SYNC, "Sync after each frame" },
   { "vulkan-staging-image", GSK_DEBUG_VULKAN_STAGING_IMAGE, "Use a staging image for Vulkan texture upload" },
-  { "vulkan-staging-buffer", GSK_DEBUG_VULKAN_STAGING_BUFFER, "Use a staging buffer for Vulkan texture upload" }
+  { "vulkan-staging-buffer", GSK_DEBUG_VULKAN_STAGING_BUFFER, "Use a staging buffer for Vulkan texture upload" },
+  { "gl-no-ubo", GSK_DEBUG_GL_NO_UBO, "Don't use uniform buffers for shared uniforms in the GL renderer" },
+  { "gl-sdf-glyphs", GSK_DEBUG_GL_SDF_GLYPHS, "Use distance field glyphs for all text in the GL renderer" },
+  { "gl-no-sdf-glyphs", GSK_DEBUG_GL_NO_SDF_GLYPHS, "Don't use distance field glyphs in the GL renderer" },
+  { "offload-textures", GSK_DEBUG_OFFLOAD_TEXTURES, "Offload textures to subsurfaces" }
 };
 
 static guint gsk_debug_flags;
@@ -0,0 +1,552 @@
+/* gskfallbackcache.c
+ *
+ * Copyright 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "config.h"
+
+#include "gskfallbackcacheprivate.h"
+
+#include "gskrendernodeprivate.h"
+
+#include "gdk/gdktextureprivate.h"
+
+#include <math.h>
+#include <string.h>
+
+/* Rasterizations that have not been drawn for this many frames
+ * are dropped, together with the reference to their node.
+ */
+#define MAX_UNUSED_FRAMES 60
+
+/* The most memory the rasterizations may use, in bytes. When there
+ * is more, the least recently drawn ones are dropped.
+ */
+#define MAX_CACHE_BYTES (32 * 1024 * 1024)
+
+/* Size of the tiles that are compared to find the part of a
+ * rasterization that changed when a node is replaced. Only tiles in
+ * the area that the diff of the nodes reports are redrawn and
+ * compared.
+ */
+#define TILE_SIZE 32
+
+typedef struct _GskFallbackEntry GskFallbackEntry;
+
+struct _GskFallbackEntry
+{
+  GskRenderNode *node;
+  float scale_x;
+  float scale_y;
+
+  cairo_surface_t *surface;
+  GdkTexture *texture;
+  gsize size;
+  gint64 last_used;
+
+  /* in the LRU list of the cache, most recently used first */
+  GList lru_link;
+};
+
+struct _GskFallbackCache
+{
+  /* The entries by node. There is only one entry per node, the
+   * rasterizations at other scales are dropped.
+   */
+  GHashTable *entries;
+  /* The entries by the bounds of their node, as arrays of entries */
+  GHashTable *bounds;
+  GQueue lru;
+  gsize size;
+
+  /* Entries for nodes that were replaced during this frame. Their
+   * textures are kept alive until the next frame so renderers can
+   * update them in place for the nodes that replaced them.
+   */
+  GPtrArray *retired;
+
+  gint64 frame;
+};
+
+static guint
+bounds_hash (gconstpointer data)
+{
+  const graphene_rect_t *bounds = data;
+
+  return (guint) bounds->origin.x ^
+         ((guint) bounds->origin.y << 8) ^
+         ((guint) bounds->size.width << 16) ^
+         ((guint) bounds->size.height << 24);
+}
+
+static gboolean
+bounds_equal (gconstpointer a,
+              gconstpointer b)
+{
+  const graphene_rect_t *bounds_a = a;
+  const graphene_rect_t *bounds_b = b;
+
+  return bounds_a->origin.x == bounds_b->origin.x &&
+         bounds_a->origin.y == bounds_b->origin.y &&
+         bounds_a->size.width == bounds_b->size.width &&
+         bounds_a->size.height == bounds_b->size.height;
+}
+
+static void
+gsk_fallback_entry_free (gpointer data)
+{
+  GskFallbackEntry *entry = data;
+
+  gsk_render_node_unref (entry->node);
+  g_object_unref (entry->texture);
+  cairo_surface_destroy (entry->surface);
+  g_slice_free (GskFallbackEntry, entry);
+}
+
+GskFallbackCache *
+gsk_fallback_cache_new (void)
+{
+  GskFallbackCache *self;
+
+  self = g_slice_new0 (GskFallbackCache);
+  self->entries = g_hash_table_new_full (g_direct_hash,
+                                         g_direct_equal,
+                                         NULL,
+                                         gsk_fallback_entry_free);
+  self->bounds = g_hash_table_new_full (bounds_hash,
+                                        bounds_equal,
+                                        (GDestroyNotify) graphene_rect_free,
+                                        (GDestroyNotify) g_ptr_array_unref);
+  g_queue_init (&self->lru);
+  self->retired = g_ptr_array_new_with_free_func (gsk_fallback_entry_free);
+
+  return self;
+}
+
+void
+gsk_fallback_cache_free (GskFallbackCache *self)
+{
+  g_hash_table_unref (self->bounds);
+  g_hash_table_unref (self->entries);
+  g_ptr_array_unref (self->retired);
+  g_slice_free (GskFallbackCache, self);
+}
+
+static void
+gsk_fallback_cache_add (GskFallbackCache *self,
+                        GskFallbackEntry *entry)
+{
+  GPtrArray *array;
+
+  g_hash_table_insert (self->entries, entry->node, entry);
+
+  array = g_hash_table_lookup (self->bounds, &entry->node->bounds);
+  if (array == NULL)
+    {
+      array = g_ptr_array_new ();
+      g_hash_table_insert (self->bounds,
+                           graphene_rect_init_from_rect (graphene_rect_alloc (), &entry->node->bounds),
+                           array);
+    }
+  g_ptr_array_add (array, entry);
+
+  entry->lru_link.data = entry;
+  g_queue_push_head_link (&self->lru, &entry->lru_link);
+  self->size += entry->size;
+}
+
+/* Removes @entry from the cache without freeing it */
+static void
+gsk_fallback_cache_steal (GskFallbackCache *self,
+                          GskFallbackEntry *entry)
+{
+  GPtrArray *array;
+
+  array = g_hash_table_lookup (self->bounds, &entry->node->bounds);
+  g_ptr_array_remove_fast (array, entry);
+  if (array->len == 0)
+    g_hash_table_remove (self->bounds, &entry->node->bounds);
+
+  g_queue_unlink (&self->lru, &entry->lru_link);
+  self->size -= entry->size;
+
+  g_hash_table_steal (self->entries, entry->node);
+}
+
+static void
+gsk_fallback_cache_remove (GskFallbackCache *self,
+                           GskFallbackEntry *entry)
+{
+  gsk_fallback_cache_steal (self, entry);
+  gsk_fallback_entry_free (entry);
+}
+
+/* Drops the least recently used entries until the cache fits its
+ * budget. Entries drawn in this frame are kept, as their textures
+ * are in use.
+ */
+static void
+gsk_fallback_cache_shrink (GskFallbackCache *self)
+{
+  GskFallbackEntry *entry;
+
+  while (self->size > MAX_CACHE_BYTES && self->lru.tail)
+    {
+      entry = self->lru.tail->data;
+      if (entry->last_used == self->frame)
+        break;
+
+      gsk_fallback_cache_remove (self, entry);
+    }
+}
+
+void
+gsk_fallback_cache_begin_frame (GskFallbackCache *self)
+{
+  GskFallbackEntry *entry;
+
+  self->frame++;
+
+  g_ptr_array_set_size (self->retired, 0);
+
+  while (self->lru.tail)
+    {
+      entry = self->lru.tail->data;
+      if (entry->last_used >= self->frame - MAX_UNUSED_FRAMES)
+        break;
+
+      gsk_fallback_cache_remove (self, entry);
+    }
+}
+
+/* Finds the rasterization of a node that was not drawn in this
+ * frame yet and has the same bounds, which is what we get when a
+ * widget creates a new node for unchanged or partially changed
+ * drawing.
+ */
+static GskFallbackEntry *
+gsk_fallback_cache_find_replaced (GskFallbackCache *self,
+                                  GskRenderNode    *node,
+                                  float             scale_x,
+                                  float             scale_y)
+{
+  GskFallbackEntry *entry;
+  GPtrArray *array;
+  guint i;
+
+  array = g_hash_table_lookup (self->bounds, &node->bounds);
+  if (array == NULL)
+    return NULL;
+
+  for (i = 0; i < array->len; i++)
+    {
+      entry = g_ptr_array_index (array, i);
+
+      if (entry->last_used < self->frame &&
+          entry->scale_x == scale_x &&
+          entry->scale_y == scale_y &&
+          gsk_render_node_get_node_type (entry->node) == gsk_render_node_get_node_type (node))
+        return entry;
+    }
+
+  return NULL;
+}
+
+/* Converts the diff of two nodes with the given bounds to the
+ * pixels of their rasterizations at the given scale
+ */
+static cairo_region_t *
+diff_to_pixels (const cairo_region_t  *diff,
+                const graphene_rect_t *bounds,
+                float                  scale_x,
+                float                  scale_y,
+                int                    width,
+                int                    height)
+{
+  cairo_region_t *region;
+  cairo_rectangle_int_t rect;
+  int i, x0, y0, x1, y1;
+
+  region = cairo_region_create ();
+
+  for (i = 0; i < cairo_region_num_rectangles (diff); i++)
+    {
+      cairo_region_get_rectangle (diff, i, &rect);
+
+      x0 = floorf ((rect.x - bounds->origin.x) * scale_x);
+      y0 = floorf ((rect.y - bounds->origin.y) * scale_y);
+      x1 = ceilf ((rect.x + rect.width - bounds->origin.x) * scale_x);
+      y1 = ceilf ((rect.y + rect.height - bounds->origin.y) * scale_y);
+
+      x0 = CLAMP (x0, 0, width);
+      y0 = CLAMP (y0, 0, height);
+      x1 = CLAMP (x1, 0, width);
+      y1 = CLAMP (y1, 0, height);
+
+      if (x1 > x0 && y1 > y0)
+        cairo_region_union_rectangle (region,
+                                      &(cairo_rectangle_int_t) {
+                                        x0, y0, x1 - x0, y1 - y0
+                                      });
+    }
+
+  return region;
+}
+
+/* Returns the tiles inside @redrawn where the pixels of the surfaces
+ * differ. Outside of @redrawn, they are the same.
+ */
+static cairo_region_t *
+compute_damage (cairo_surface_t      *old_surface,
+                cairo_surface_t      *new_surface,
+                const cairo_region_t *redrawn)
+{
+  cairo_region_t *region;
+  const guchar *old_data, *new_data;
+  int width, height, stride;
+  int x, y, row;
+
+  cairo_surface_flush (old_surface);
+  cairo_surface_flush (new_surface);
+
+  old_data = cairo_image_surface_get_data (old_surface);
+  new_data = cairo_image_surface_get_data (new_surface);
+  width = cairo_image_surface_get_width (new_surface);
+  height = cairo_image_surface_get_height (new_surface);
+  stride = cairo_image_surface_get_stride (new_surface);
+
+  g_assert (stride == cairo_image_surface_get_stride (old_surface));
+
+  region = cairo_region_create ();
+
+  for (y = 0; y < height; y += TILE_SIZE)
+    {
+      int tile_height = MIN (TILE_SIZE, height - y);
+
+      for (x = 0; x < width; x += TILE_SIZE)
+        {
+          int tile_width = MIN (TILE_SIZE, width - x);
+
+          if (cairo_region_contains_rectangle (redrawn,
+                                               &(cairo_rectangle_int_t) {
+                                                 x, y, tile_width, tile_height
+                                               }) == CAIRO_REGION_OVERLAP_OUT)
+            continue;
+
+          for (row = y; row < y + tile_height; row++)
+            {
+              gsize offset = row * stride + x * 4;
+
+              if (memcmp (old_data + offset, new_data + offset, tile_width * 4) != 0)
+                {
+                  cairo_region_union_rectangle (region,
+                                                &(cairo_rectangle_int_t) {
+                                                  x, y, tile_width, tile_height
+                                                });
+                  break;
+                }
+            }
+        }
+    }
+
+  return region;
+}
+
+/**
+ * gsk_fallback_cache_get_texture:
+ * @self: a `GskFallbackCache`
+ * @node: the node to rasterize
+ * @scale_x: the horizontal scale to rasterize at
+ * @scale_y: the vertical scale to rasterize at
+ * @out_rasterized: (out) (optional): return location for whether
+ *   @node had to be drawn with cairo
+ *
+ * Returns a texture with the contents of @node drawn with cairo at
+ * the given scale, covering the bounds of @node.
+ *
+ * The texture is reused for as long as @node is drawn at that scale.
+ * When @node replaces a node with the same bounds that was drawn
+ * before, only the area where the nodes differ is drawn again, on
+ * top of a copy of the previous rasterization, and the texture is
+ * recorded as an update of the previous texture with only the tiles
+ * that differ. If nothing changed, the previous texture is used as
+ * is.
+ *
+ * Only the rasterization at the latest scale is kept for every node.
+ * When the rasterizations use more memory than the cache allows, the
+ * ones drawn least recently are dropped.
+ *
+ * Returns: (transfer none) (nullable): the texture, or %NULL if
+ *   @node covers no pixels
+ */
+GdkTexture *
+gsk_fallback_cache_get_texture (GskFallbackCache *self,
+                                GskRenderNode    *node,
+                                float             scale_x,
+                                float             scale_y,
+                                gboolean         *out_rasterized)
+{
+  GskFallbackEntry *entry, *replaced;
+  cairo_surface_t *surface;
+  cairo_region_t *redrawn;
+  gboolean keep_entry;
+  cairo_t *cr;
+  int width, height;
+
+  if (out_rasterized)
+    *out_rasterized = FALSE;
+
+  width = ceilf (node->bounds.size.width * scale_x);
+  height = ceilf (node->bounds.size.height * scale_y);
+  if (width <= 0 || height <= 0)
+    return NULL;
+
+  keep_entry = TRUE;
+  entry = g_hash_table_lookup (self->entries, node);
+  if (entry)
+    {
+      if (entry->scale_x == scale_x && entry->scale_y == scale_y)
+        {
+          entry->last_used = self->frame;
+          g_queue_unlink (&self->lru, &entry->lru_link);
+          g_queue_push_head_link (&self->lru, &entry->lru_link);
+          return entry->texture;
+        }
+
+      /* A node changing scale is usually being zoomed, so the old
+       * scale will not be needed again. If the node is drawn at
+       * both scales in this frame, only the first one is kept.
+       */
+      if (entry->last_used < self->frame)
+        gsk_fallback_cache_remove (self, entry);
+      else
+        keep_entry = FALSE;
+    }
+
+  entry = g_slice_new0 (GskFallbackEntry);
+  entry->node = gsk_render_node_ref (node);
+  entry->scale_x = scale_x;
+  entry->scale_y = scale_y;
+  entry->last_used = self->frame;
+
+  replaced = keep_entry ? gsk_fallback_cache_find_replaced (self, node, scale_x, scale_y) : NULL;
+  if (replaced)
+    {
+      cairo_region_t *diff = cairo_region_create ();
+
+      gsk_render_node_diff (replaced->node, node, diff);
+      redrawn = diff_to_pixels (diff, &node->bounds, scale_x, scale_y, width, height);
+      cairo_region_destroy (diff);
+    }
+  else
+    {
+      redrawn = cairo_region_create_rectangle (&(cairo_rectangle_int_t) { 0, 0, width, height });
+    }
+
+  if (replaced && cairo_region_is_empty (redrawn))
+    {
+      entry->surface = cairo_surface_reference (replaced->surface);
+      entry->texture = g_object_ref (replaced->texture);
+    }
+  else
+    {
+      surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, height);
+      cairo_surface_set_device_scale (surface, scale_x, scale_y);
+
+      if (replaced)
+        {
+          /* Start from the previous rasterization and only draw
+           * the pixels where the nodes differ again
+           */
+          cairo_surface_flush (replaced->surface);
+          g_assert (cairo_image_surface_get_stride (replaced->surface) == cairo_image_surface_get_stride (surface));
+          memcpy (cairo_image_surface_get_data (surface),
+                  cairo_image_surface_get_data (replaced->surface),
+                  (gsize) cairo_image_surface_get_stride (surface) * height);
+          cairo_surface_mark_dirty (surface);
+        }
+
+      cr = cairo_create (surface);
+
+      if (replaced)
+        {
+          /* The region is in pixels */
+          cairo_scale (cr, 1 / scale_x, 1 / scale_y);
+          gdk_cairo_region (cr, redrawn);
+          cairo_clip (cr);
+          cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+          cairo_paint (cr);
+          cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
+          cairo_identity_matrix (cr);
+        }
+
+      cairo_translate (cr, - node->bounds.origin.x, - node->bounds.origin.y);
+      gsk_render_node_draw (node, cr);
+      cairo_destroy (cr);
+
+      if (out_rasterized)
+        *out_rasterized = TRUE;
+
+      entry->surface = cairo_surface_reference (surface);
+      entry->texture = gdk_texture_new_for_surface (surface);
+
+      if (replaced)
+        {
+          cairo_region_t *damage = compute_damage (replaced->surface, surface, redrawn);
+
+          if (cairo_region_is_empty (damage))
+            {
+              /* The diff was conservative and the pixels did not change */
+              cairo_surface_destroy (entry->surface);
+              g_object_unref (entry->texture);
+              entry->surface = cairo_surface_reference (replaced->surface);
+              entry->texture = g_object_ref (replaced->texture);
+            }
+          else
+            {
+              gdk_texture_set_update (entry->texture, replaced->texture, damage);
+            }
+
+          cairo_region_destroy (damage);
+        }
+
+      cairo_surface_destroy (surface);
+    }
+
+  entry->size = (gsize) cairo_image_surface_get_stride (entry->surface) * height;
+  cairo_region_destroy (redrawn);
+
+  if (replaced)
+    {
+      gsk_fallback_cache_steal (self, replaced);
+      g_ptr_array_add (self->retired, replaced);
+    }
+
+  if (keep_entry)
+    {
+      gsk_fallback_cache_add (self, entry);
+      gsk_fallback_cache_shrink (self);
+    }
+  else
+    {
+      /* Keep the texture alive until the next frame */
+      g_ptr_array_add (self->retired, entry);
+    }
+
+  return entry->texture;
+}
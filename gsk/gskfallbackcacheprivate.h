@@ -0,0 +1,22 @@
+#ifndef __GSK_FALLBACK_CACHE_PRIVATE_H__
+#define __GSK_FALLBACK_CACHE_PRIVATE_H__
+
+#include <gsk/gskrendernode.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GskFallbackCache GskFallbackCache;
+
+GskFallbackCache *      gsk_fallback_cache_new          (void);
+void                    gsk_fallback_cache_free         (GskFallbackCache *self);
+
+void                    gsk_fallback_cache_begin_frame  (GskFallbackCache *self);
+GdkTexture *            gsk_fallback_cache_get_texture  (GskFallbackCache *self,
+                                                         GskRenderNode    *node,
+                                                         float             scale_x,
+                                                         float             scale_y,
+                                                         gboolean         *out_rasterized);
+
+G_END_DECLS
+
+#endif /* __GSK_FALLBACK_CACHE_PRIVATE_H__ */
@@ -41,6 +41,9 @@
 #include "gl/gskglrenderer.h"
 #include "gskprofilerprivate.h"
 #include "gskrendernodeprivate.h"
+#include "gsktransformprivate.h"
+#include "gdk/gdkdamageprivate.h"
+#include "gdk/gdksurfaceprivate.h"
 
 #include "gskenumtypes.h"
 
@@ -79,11 +82,19 @@ typedef struct
   GskRenderNode *prev_node;
   GskRenderNode *root_node;
 
+  /* Shows the topmost texture of the scene, if possible */
+  GdkSubsurface *subsurface;
+
   GskProfiler *profiler;
+  GQuark damage_rects;
+  GQuark clip_rects;
+  GQuark clip_pixels;
+  GQuark offloaded_textures;
 
   GskDebugFlags debug_flags;
 
   gboolean is_realized : 1;
+  gboolean subsurface_unsupported : 1;
 } GskRendererPrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GskRenderer, gsk_renderer, G_TYPE_OBJECT)
@@ -219,6 +230,10 @@ gsk_renderer_init (GskRenderer *self)
   GskRendererPrivate *priv = gsk_renderer_get_instance_private (self);
 
   priv->profiler = gsk_profiler_new ();
+  priv->damage_rects = gsk_profiler_add_counter (priv->profiler, "damage-rects", "Damage rectangles before merging", TRUE);
+  priv->clip_rects = gsk_profiler_add_counter (priv->profiler, "clip-rects", "Rectangles to render", TRUE);
+  priv->clip_pixels = gsk_profiler_add_counter (priv->profiler, "clip-pixels", "Pixels to render", TRUE);
+  priv->offloaded_textures = gsk_profiler_add_counter (priv->profiler, "offloaded-textures", "Textures shown in a subsurface", TRUE);
   priv->debug_flags = gsk_get_debug_flags ();
 }
 
@@ -334,6 +349,8 @@ gsk_renderer_unrealize (GskRenderer *renderer)
   GSK_RENDERER_GET_CLASS (renderer)->unrealize (renderer);
 
   g_clear_pointer (&priv->prev_node, gsk_render_node_unref);
+  g_clear_object (&priv->subsurface);
+  priv->subsurface_unsupported = FALSE;
 
   priv->is_realized = FALSE;
 }
@@ -401,6 +418,229 @@ gsk_renderer_render_texture (GskRenderer           *renderer,
   return texture;
 }
 
+static gint64
+region_get_pixels (const cairo_region_t *region)
+{
+  cairo_rectangle_int_t rect;
+  gint64 pixels = 0;
+  int i, n;
+
+  n = cairo_region_num_rectangles (region);
+  for (i = 0; i < n; i++)
+    {
+      cairo_region_get_rectangle (region, i, &rect);
+      pixels += (gint64) rect.width * rect.height;
+    }
+
+  return pixels;
+}
+
+/* Looks for a texture node that nothing else is drawn on top of,
+ * so that it can be shown in a subsurface instead of being drawn.
+ *
+ * Only nodes that do not change how their child looks are descended
+ * into. The nodes from the texture node up to @node are added to
+ * @path and the bounds of the texture node are returned in the
+ * coordinate system of @node.
+ */
+static gboolean
+find_offload_node (GskRenderNode   *node,
+                   GPtrArray       *path,
+                   graphene_rect_t *rect)
+{
+  guint len = path->len;
+  gboolean found;
+
+  switch (gsk_render_node_get_node_type (node))
+    {
+    case GSK_TEXTURE_NODE:
+      *rect = node->bounds;
+      found = TRUE;
+      break;
+
+    case GSK_CONTAINER_NODE:
+      {
+        guint i, j, n;
+
+        found = FALSE;
+        n = gsk_container_node_get_n_children (node);
+        for (i = n; i > 0 && !found; i--)
+          {
+            if (!find_offload_node (gsk_container_node_get_child (node, i - 1), path, rect))
+              continue;
+
+            found = TRUE;
+            for (j = i; j < n; j++)
+              {
+                if (graphene_rect_intersection (&gsk_container_node_get_child (node, j)->bounds, rect, NULL))
+                  {
+                    g_ptr_array_set_size (path, len);
+                    found = FALSE;
+                    break;
+                  }
+              }
+          }
+      }
+      break;
+
+    case GSK_TRANSFORM_NODE:
+      {
+        GskTransform *transform = gsk_transform_node_get_transform (node);
+        float dx, dy;
+
+        found = gsk_transform_get_category (transform) >= GSK_TRANSFORM_CATEGORY_2D_TRANSLATE &&
+                find_offload_node (gsk_transform_node_get_child (node), path, rect);
+        if (found)
+          {
+            gsk_transform_to_translate (transform, &dx, &dy);
+            graphene_rect_offset (rect, dx, dy);
+          }
+      }
+      break;
+
+    case GSK_CLIP_NODE:
+      found = find_offload_node (gsk_clip_node_get_child (node), path, rect) &&
+              graphene_rect_contains_rect (gsk_clip_node_get_clip (node), rect);
+      break;
+
+    case GSK_DEBUG_NODE:
+      found = find_offload_node (gsk_debug_node_get_child (node), path, rect);
+      break;
+
+    default:
+      found = FALSE;
+      break;
+    }
+
+  if (found)
+    g_ptr_array_add (path, node);
+  else
+    g_ptr_array_set_size (path, len);
+
+  return found;
+}
+
+/* Rebuilds the nodes in @path with an empty container in place
+ * of the texture node. All other nodes are reused, so diffing
+ * against the previous frame only finds real changes.
+ */
+static GskRenderNode *
+remove_offload_node (GPtrArray *path)
+{
+  GskRenderNode *replacement, *child, *node;
+  guint i;
+
+  replacement = gsk_container_node_new (NULL, 0);
+
+  for (i = 1; i < path->len; i++)
+    {
+      child = g_ptr_array_index (path, i - 1);
+      node = g_ptr_array_index (path, i);
+
+      switch (gsk_render_node_get_node_type (node))
+        {
+        case GSK_CONTAINER_NODE:
+          {
+            GskRenderNode **children;
+            guint j, n;
+
+            n = gsk_container_node_get_n_children (node);
+            children = g_new (GskRenderNode *, n);
+            for (j = 0; j < n; j++)
+              children[j] = gsk_container_node_get_child (node, j);
+            /* The texture was found in the last child it could be in */
+            for (j = n; j > 0; j--)
+              {
+                if (children[j - 1] == child)
+                  {
+                    children[j - 1] = replacement;
+                    break;
+                  }
+              }
+            node = gsk_container_node_new (children, n);
+            g_free (children);
+          }
+          break;
+
+        case GSK_TRANSFORM_NODE:
+          node = gsk_transform_node_new (replacement, gsk_transform_node_get_transform (node));
+          break;
+
+        case GSK_CLIP_NODE:
+          node = gsk_clip_node_new (replacement, gsk_clip_node_get_clip (node));
+          break;
+
+        case GSK_DEBUG_NODE:
+          node = gsk_debug_node_new (replacement, g_strdup (gsk_debug_node_get_message (node)));
+          break;
+
+        default:
+          g_assert_not_reached ();
+          return replacement;
+        }
+
+      gsk_render_node_unref (replacement);
+      replacement = node;
+    }
+
+  return replacement;
+}
+
+/* Shows the topmost texture of @root in the subsurface if it can
+ * and returns the node to render instead of @root.
+ */
+static GskRenderNode *
+gsk_renderer_offload (GskRenderer   *renderer,
+                      GskRenderNode *root)
+{
+  GskRendererPrivate *priv = gsk_renderer_get_instance_private (renderer);
+  GskRenderNode *node;
+  graphene_rect_t rect;
+  GPtrArray *path;
+
+  /* Until there is a dmabuf path, every new texture is copied into
+   * a shm buffer and GL textures are never offloaded, so this is
+   * only done when asked for.
+   */
+  if (priv->subsurface_unsupported || !GSK_RENDERER_DEBUG_CHECK (renderer, OFFLOAD_TEXTURES))
+    return gsk_render_node_ref (root);
+
+  path = g_ptr_array_new ();
+
+  if (!find_offload_node (root, path, &rect) ||
+      !graphene_rect_contains_rect (&GRAPHENE_RECT_INIT (0, 0,
+                                                         gdk_surface_get_width (priv->surface),
+                                                         gdk_surface_get_height (priv->surface)),
+                                    &rect))
+    {
+      g_ptr_array_unref (path);
+      return gsk_render_node_ref (root);
+    }
+
+  if (priv->subsurface == NULL)
+    {
+      priv->subsurface = gdk_surface_create_subsurface (priv->surface);
+      if (priv->subsurface == NULL)
+        {
+          GSK_RENDERER_NOTE (renderer, OFFLOAD, g_message ("Surface does not support subsurfaces, not offloading"));
+          priv->subsurface_unsupported = TRUE;
+          g_ptr_array_unref (path);
+          return gsk_render_node_ref (root);
+        }
+    }
+
+  if (gdk_subsurface_attach (priv->subsurface,
+                             gsk_texture_node_get_texture (g_ptr_array_index (path, 0)),
+                             &rect))
+    node = remove_offload_node (path);
+  else
+    node = gsk_render_node_ref (root);
+
+  g_ptr_array_unref (path);
+
+  return node;
+}
+
 /**
  * gsk_renderer_render:
  * @renderer: a realized `GskRenderer`
@@ -427,7 +667,10 @@ gsk_renderer_render (GskRenderer          *renderer,
                      const cairo_region_t *region)
 {
   GskRendererPrivate *priv = gsk_renderer_get_instance_private (renderer);
+  graphene_rect_t old_rect, new_rect;
+  gboolean was_offloaded, offloaded;
   cairo_region_t *clip;
+  GskRenderNode *node;
 
   g_return_if_fail (GSK_IS_RENDERER (renderer));
   g_return_if_fail (priv->is_realized);
@@ -437,6 +680,16 @@ gsk_renderer_render (GskRenderer          *renderer,
   if (priv->surface == NULL)
     return;
 
+  was_offloaded = priv->subsurface && gdk_subsurface_get_rect (priv->subsurface, &old_rect);
+
+  /* The offloaded texture is left out of the node that is rendered,
+   * so a new frame of a video does not cause any damage.
+   */
+  node = gsk_renderer_offload (renderer, root);
+  offloaded = node != root;
+  if (offloaded)
+    gdk_subsurface_get_rect (priv->subsurface, &new_rect);
+
   if (region == NULL || priv->prev_node == NULL || GSK_RENDERER_DEBUG_CHECK (renderer, FULL_REDRAW))
     {
       clip = cairo_region_create_rectangle (&(GdkRectangle) {
@@ -448,18 +701,61 @@ gsk_renderer_render (GskRenderer          *renderer,
   else
     {
       clip = cairo_region_copy (region);
-      gsk_render_node_diff (priv->prev_node, root, clip);
+      gsk_render_node_diff (priv->prev_node, node, clip);
+
+      /* The position of the subsurface only changes when the
+       * surface is committed, so make sure that happens.
+       */
+      if (offloaded && (!was_offloaded || !graphene_rect_equal (&old_rect, &new_rect)))
+        {
+          cairo_region_union_rectangle (clip, &(cairo_rectangle_int_t) {
+                                                  new_rect.origin.x, new_rect.origin.y,
+                                                  new_rect.size.width, new_rect.size.height
+                                              });
+          if (was_offloaded)
+            cairo_region_union_rectangle (clip, &(cairo_rectangle_int_t) {
+                                                    old_rect.origin.x, old_rect.origin.y,
+                                                    old_rect.size.width, old_rect.size.height
+                                                });
+        }
 
       if (cairo_region_is_empty (clip))
         {
+          gsk_profiler_counter_set (priv->profiler, priv->clip_pixels, 0);
+          gsk_profiler_counter_set (priv->profiler, priv->offloaded_textures, offloaded ? 1 : 0);
+          GSK_RENDERER_NOTE (renderer, OFFLOAD,
+                             if (offloaded)
+                               g_message ("Offloaded %gx%g texture at %g,%g, nothing redrawn",
+                                          new_rect.size.width, new_rect.size.height,
+                                          new_rect.origin.x, new_rect.origin.y));
           cairo_region_destroy (clip);
+          gsk_render_node_unref (node);
           return;
         }
     }
 
-  priv->root_node = gsk_render_node_ref (root);
+  gsk_profiler_counter_set (priv->profiler, priv->damage_rects, cairo_region_num_rectangles (clip));
+  gdk_damage_simplify_region (clip, GDK_DAMAGE_DEFAULT_RECTS);
+  gsk_profiler_counter_set (priv->profiler, priv->clip_rects, cairo_region_num_rectangles (clip));
+  gsk_profiler_counter_set (priv->profiler, priv->clip_pixels, region_get_pixels (clip));
+  gsk_profiler_counter_set (priv->profiler, priv->offloaded_textures, offloaded ? 1 : 0);
 
-  GSK_RENDERER_GET_CLASS (renderer)->render (renderer, root, clip);
+  GSK_RENDERER_NOTE (renderer, OFFLOAD,
+                     if (offloaded)
+                       g_message ("Offloaded %gx%g texture at %g,%g, redrawing %" G_GINT64_FORMAT " pixels",
+                                  new_rect.size.width, new_rect.size.height,
+                                  new_rect.origin.x, new_rect.origin.y,
+                                  region_get_pixels (clip)));
+
+  priv->root_node = node;
+
+  GSK_RENDERER_GET_CLASS (renderer)->render (renderer, node, clip);
+
+  /* Only stop showing the texture in the subsurface once the
+   * surface has been drawn with it.
+   */
+  if (!offloaded && priv->subsurface)
+    gdk_subsurface_detach (priv->subsurface);
 
 #ifdef G_ENABLE_DEBUG
   if (GSK_RENDERER_DEBUG_CHECK (renderer, RENDERER))
@@ -41,6 +41,7 @@
 #include "gskdebugprivate.h"
 #include "gskrendererprivate.h"
 #include "gskrendernodeparserprivate.h"
+#include "gdk/gdktextureprivate.h"
 
 #include <graphene-gobject.h>
 
@@ -467,6 +468,72 @@ gsk_render_node_draw (GskRenderNode *node,
     }
 }
 
+/**
+ * gsk_render_node_render_texture:
+ * @node: a `GskRenderNode`
+ * @viewport: (nullable): the section to draw or %NULL to use @node's bounds
+ *
+ * Renders @node to a `GdkTexture` using Cairo.
+ *
+ * Unlike [method@Gsk.Renderer.render_texture], this function does not
+ * need a realized renderer and may be called from any thread, including
+ * from multiple threads at the same time, with the same or different
+ * nodes. This makes it suitable to create thumbnails or to export images
+ * of render node trees in worker threads.
+ *
+ * Text nodes are the exception: a `PangoFont` is shared with everything
+ * else that uses it and is not thread-safe, so text nodes are drawn one
+ * at a time. Their fonts must also not be used to lay out or draw text
+ * in another thread while they are drawn. Text in nodes that are rendered
+ * in worker threads should therefore use fonts from a font map of its
+ * own, not from the font map GTK uses for widgets.
+ *
+ * Textures in @node that are backed by GL, such as those created with
+ * [ctor@Gdk.GLTexture.new], can only be downloaded in the thread that
+ * owns their GL context, so such nodes must not be rendered with this
+ * function from other threads.
+ *
+ * If you want to apply any transformations to @node, you should put it
+ * into a transform node and pass that node instead.
+ *
+ * Returns: (transfer full): a `GdkTexture` with the rendered contents of @node.
+ *
+ * Since: 4.6
+ */
+GdkTexture *
+gsk_render_node_render_texture (GskRenderNode         *node,
+                                const graphene_rect_t *viewport)
+{
+  graphene_rect_t real_viewport;
+  cairo_surface_t *surface;
+  GdkTexture *texture;
+  cairo_t *cr;
+
+  g_return_val_if_fail (GSK_IS_RENDER_NODE (node), NULL);
+
+  if (viewport == NULL)
+    {
+      gsk_render_node_get_bounds (node, &real_viewport);
+      viewport = &real_viewport;
+    }
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                        MAX (1, ceil (viewport->size.width)),
+                                        MAX (1, ceil (viewport->size.height)));
+  cr = cairo_create (surface);
+
+  cairo_translate (cr, - viewport->origin.x, - viewport->origin.y);
+
+  gsk_render_node_draw (node, cr);
+
+  cairo_destroy (cr);
+
+  texture = gdk_texture_new_for_surface (surface);
+  cairo_surface_destroy (surface);
+
+  return texture;
+}
+
 /*
  * gsk_render_node_can_diff:
  * @node1: a `GskRenderNode`
@@ -127,6 +127,9 @@ void                    gsk_render_node_get_bounds              (GskRenderNode
 GDK_AVAILABLE_IN_ALL
 void                    gsk_render_node_draw                    (GskRenderNode *node,
                                                                  cairo_t       *cr);
+GDK_AVAILABLE_IN_4_6
+GdkTexture *            gsk_render_node_render_texture          (GskRenderNode         *node,
+                                                                 const graphene_rect_t *viewport);
 
 GDK_AVAILABLE_IN_ALL
 GBytes *                gsk_render_node_serialize               (GskRenderNode *node);
@@ -32,6 +32,7 @@
 #include "gdk/gdk-private.h"
 
 #include <hb-ot.h>
+#include <math.h>
 
 static inline void
 gsk_cairo_rectangle (cairo_t               *cr,
@@ -1480,17 +1481,34 @@ gsk_texture_node_draw (GskRenderNode *node,
                        cairo_t       *cr)
 {
   GskTextureNode *self = (GskTextureNode *) node;
+  GdkTexture *texture;
   cairo_surface_t *surface;
   cairo_pattern_t *pattern;
   cairo_matrix_t matrix;
-
-  surface = gdk_texture_download_surface (self->texture);
+  double width, height, zero;
+
+  /* Use a smaller version of the texture when drawing it much smaller */
+  width = node->bounds.size.width;
+  zero = 0;
+  cairo_user_to_device_distance (cr, &width, &zero);
+  width = hypot (width, zero);
+  height = node->bounds.size.height;
+  zero = 0;
+  cairo_user_to_device_distance (cr, &zero, &height);
+  height = hypot (zero, height);
+
+  texture = gdk_texture_get_mipmap (self->texture,
+                                    MAX (width / gdk_texture_get_width (self->texture),
+                                         height / gdk_texture_get_height (self->texture)));
+
+  surface = gdk_texture_download_surface (texture);
   pattern = cairo_pattern_create_for_surface (surface);
   cairo_pattern_set_extend (pattern, CAIRO_EXTEND_PAD);
 
   cairo_matrix_init_scale (&matrix,
-                           gdk_texture_get_width (self->texture) / node->bounds.size.width,
-                           gdk_texture_get_height (self->texture) / node->bounds.size.height);
+                           gdk_texture_get_width (texture) / node->bounds.size.width,
+                           gdk_texture_get_height (texture) / node->bounds.size.height);
+  g_object_unref (texture);
   cairo_matrix_translate (&matrix,
                           -node->bounds.origin.x,
                           -node->bounds.origin.y);
@@ -1626,6 +1644,10 @@ typedef struct {
   graphene_size_t corner;
 } CornerMask;
 
+/* Nodes may be drawn from multiple threads at once */
+static GHashTable *corner_mask_cache = NULL;
+G_LOCK_DEFINE_STATIC (corner_mask_cache);
+
 typedef enum {
   TOP,
   RIGHT,
@@ -1665,11 +1687,10 @@ draw_shadow_corner (cairo_t               *cr,
   int x1, x2, x3, y1, y2, y3, x, y;
   GskRoundedRect corner_box;
   cairo_t *mask_cr;
-  cairo_surface_t *mask;
+  cairo_surface_t *mask, *mask_surface;
   cairo_pattern_t *pattern;
   cairo_matrix_t matrix;
   float sx, sy;
-  static GHashTable *corner_mask_cache = NULL;
   float max_other;
   CornerMask key;
   gboolean overlapped;
@@ -1757,14 +1778,16 @@ draw_shadow_corner (cairo_t               *cr,
    * mask, so we cache rendered masks based on the blur radius and the
    * corner radius.
    */
+  key.radius = radius;
+  key.corner = box->corner[corner];
+
+  G_LOCK (corner_mask_cache);
+
   if (corner_mask_cache == NULL)
     corner_mask_cache = g_hash_table_new_full ((GHashFunc)corner_mask_hash,
                                                (GEqualFunc)corner_mask_equal,
                                                g_free, (GDestroyNotify)cairo_surface_destroy);
 
-  key.radius = radius;
-  key.corner = box->corner[corner];
-
   mask = g_hash_table_lookup (corner_mask_cache, &key);
   if (mask == NULL)
     {
@@ -1778,17 +1801,35 @@ draw_shadow_corner (cairo_t               *cr,
       cairo_fill (mask_cr);
       gsk_cairo_blur_surface (mask, radius, GSK_BLUR_X | GSK_BLUR_Y);
       cairo_destroy (mask_cr);
+      cairo_surface_flush (mask);
       g_hash_table_insert (corner_mask_cache, g_memdup2 (&key, sizeof (key)), mask);
     }
 
+  cairo_surface_reference (mask);
+
+  G_UNLOCK (corner_mask_cache);
+
+  /* cairo surfaces can't be used as a source from multiple threads at
+   * once, but their pixels can. So draw with a surface of our own for
+   * the cached pixels, which are never modified.
+   */
+  mask_surface = cairo_image_surface_create_for_data (cairo_image_surface_get_data (mask),
+                                                      CAIRO_FORMAT_A8,
+                                                      cairo_image_surface_get_width (mask),
+                                                      cairo_image_surface_get_height (mask),
+                                                      cairo_image_surface_get_stride (mask));
+
   gdk_cairo_set_source_rgba (cr, color);
-  pattern = cairo_pattern_create_for_surface (mask);
+  pattern = cairo_pattern_create_for_surface (mask_surface);
   cairo_matrix_init_identity (&matrix);
   cairo_matrix_scale (&matrix, sx, sy);
   cairo_matrix_translate (&matrix, -x, -y);
   cairo_pattern_set_matrix (pattern, &matrix);
   cairo_mask (cr, pattern);
   cairo_pattern_destroy (pattern);
+
+  cairo_surface_destroy (mask_surface);
+  cairo_surface_destroy (mask);
 }
 
 static void
@@ -2438,6 +2479,10 @@ struct _GskCairoNode
   GskRenderNode render_node;
 
   cairo_surface_t *surface;
+  /* Replaying a recording surface updates its internal state, so
+   * drawing the node must not happen in two threads at the same time.
+   */
+  GMutex replay_lock;
 };
 
 static void
@@ -2449,6 +2494,8 @@ gsk_cairo_node_finalize (GskRenderNode *node)
   if (self->surface)
     cairo_surface_destroy (self->surface);
 
+  g_mutex_clear (&self->replay_lock);
+
   parent_class->finalize (node);
 }
 
@@ -2461,8 +2508,34 @@ gsk_cairo_node_draw (GskRenderNode *node,
   if (self->surface == NULL)
     return;
 
+  g_mutex_lock (&self->replay_lock);
   cairo_set_source_surface (cr, self->surface, 0, 0);
   cairo_paint (cr);
+  g_mutex_unlock (&self->replay_lock);
+}
+
+/*<private>
+ * gsk_cairo_node_lock:
+ * @node: (type GskCairoNode): a `GskRenderNode` for a Cairo surface
+ *
+ * Locks the surface of @node against being replayed in other threads,
+ * for code other than gsk_render_node_draw() that reads the surface
+ * off the main thread, like the serializer.
+ */
+void
+gsk_cairo_node_lock (GskRenderNode *node)
+{
+  GskCairoNode *self = (GskCairoNode *) node;
+
+  g_mutex_lock (&self->replay_lock);
+}
+
+void
+gsk_cairo_node_unlock (GskRenderNode *node)
+{
+  GskCairoNode *self = (GskCairoNode *) node;
+
+  g_mutex_unlock (&self->replay_lock);
 }
 
 /**
@@ -2506,6 +2579,7 @@ gsk_cairo_node_new (const graphene_rect_t *bounds)
   node = (GskRenderNode *) self;
 
   graphene_rect_init_from_rect (&node->bounds, bounds);
+  g_mutex_init (&self->replay_lock);
 
   return node;
 }
@@ -4380,6 +4454,12 @@ gsk_text_node_finalize (GskRenderNode *node)
   parent_class->finalize (node);
 }
 
+/* PangoCairo fonts create their scaled font and fill their glyph
+ * caches on first use, without locking. Fonts are shared between
+ * all nodes, so only one text node is drawn at a time.
+ */
+G_LOCK_DEFINE_STATIC (text_draw);
+
 static void
 gsk_text_node_draw (GskRenderNode *node,
                     cairo_t       *cr)
@@ -4395,7 +4475,10 @@ gsk_text_node_draw (GskRenderNode *node,
 
   gdk_cairo_set_source_rgba (cr, &self->color);
   cairo_translate (cr, self->offset.x, self->offset.y);
+
+  G_LOCK (text_draw);
   pango_cairo_show_glyph_string (cr, self->font, &glyphs);
+  G_UNLOCK (text_draw);
 
   cairo_restore (cr);
 }
@@ -2951,6 +2951,8 @@ render_node_print (Printer       *p,
 
         if (surface != NULL)
           {
+            gsk_cairo_node_lock (node);
+
             array = g_byte_array_new ();
             cairo_surface_write_to_png_stream (surface, cairo_write_array, array);
 
@@ -2992,6 +2994,8 @@ render_node_print (Printer       *p,
                 cairo_device_destroy (script);
               }
 #endif
+
+            gsk_cairo_node_unlock (node);
           }
 
         end_node (p);
@@ -105,6 +105,9 @@ bool            gsk_border_node_get_uniform_color       (const GskRenderNode
 void            gsk_text_node_serialize_glyphs          (GskRenderNode               *self,
                                                          GString                     *str);
 
+void            gsk_cairo_node_lock                     (GskRenderNode               *node);
+void            gsk_cairo_node_unlock                   (GskRenderNode               *node);
+
 GskRenderNode ** gsk_container_node_get_children        (const GskRenderNode *node,
                                                          guint               *n_children);
 
@@ -15,6 +15,7 @@ typedef struct _GskVulkanBlendModePipelineLayout GskVulkanBlendModePipelineLayou
 G_DECLARE_FINAL_TYPE (GskVulkanBlendModePipeline, gsk_vulkan_blend_mode_pipeline, GSK, VULKAN_BLEND_MODE_PIPELINE, GskVulkanPipeline)
 
 GskVulkanPipeline * gsk_vulkan_blend_mode_pipeline_new                 (GdkVulkanContext           *context,
+                                                                        VkPipelineCache             pipeline_cache,
                                                                         VkPipelineLayout            layout,
                                                                         const char                 *shader_name,
                                                                         VkRenderPass                render_pass);
@@ -84,11 +84,12 @@ gsk_vulkan_blur_pipeline_init (GskVulkanBlurPipeline *self)
 
 GskVulkanPipeline *
 gsk_vulkan_blur_pipeline_new (GdkVulkanContext        *context,
+                              VkPipelineCache          pipeline_cache,
                               VkPipelineLayout         layout,
                               const char              *shader_name,
                               VkRenderPass             render_pass)
 {
-  return gsk_vulkan_pipeline_new (GSK_TYPE_VULKAN_BLUR_PIPELINE, context, layout, shader_name, render_pass);
+  return gsk_vulkan_pipeline_new (GSK_TYPE_VULKAN_BLUR_PIPELINE, context, pipeline_cache, layout, shader_name, render_pass);
 }
 
 gsize
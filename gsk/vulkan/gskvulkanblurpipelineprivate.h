@@ -14,6 +14,7 @@ typedef struct _GskVulkanBlurPipelineLayout GskVulkanBlurPipelineLayout;
 G_DECLARE_FINAL_TYPE (GskVulkanBlurPipeline, gsk_vulkan_blur_pipeline, GSK, VULKAN_BLUR_PIPELINE, GskVulkanPipeline)
 
 GskVulkanPipeline *     gsk_vulkan_blur_pipeline_new                   (GdkVulkanContext        *context,
+                                                                        VkPipelineCache          pipeline_cache,
                                                                         VkPipelineLayout         layout,
                                                                         const char              *shader_name,
                                                                         VkRenderPass             render_pass);
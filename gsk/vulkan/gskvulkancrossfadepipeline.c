@@ -91,11 +91,12 @@ gsk_vulkan_cross_fade_pipeline_init (GskVulkanCrossFadePipeline *self)
 
 GskVulkanPipeline *
 gsk_vulkan_cross_fade_pipeline_new (GdkVulkanContext        *context,
+                                    VkPipelineCache          pipeline_cache,
                                     VkPipelineLayout         layout,
                                     const char              *shader_name,
                                     VkRenderPass             render_pass)
 {
-  return gsk_vulkan_pipeline_new (GSK_TYPE_VULKAN_CROSS_FADE_PIPELINE, context, layout, shader_name, render_pass);
+  return gsk_vulkan_pipeline_new (GSK_TYPE_VULKAN_CROSS_FADE_PIPELINE, context, pipeline_cache, layout, shader_name, render_pass);
 }
 
 gsize
@@ -5,6 +5,8 @@
 #include "gskvulkanpushconstantsprivate.h"
 #include "gskvulkanshaderprivate.h"
 
+#include "gdk/gdkprofilerprivate.h"
+
 #include <graphene.h>
 
 typedef struct _GskVulkanPipelinePrivate GskVulkanPipelinePrivate;
@@ -56,11 +58,12 @@ gsk_vulkan_pipeline_init (GskVulkanPipeline *self)
 GskVulkanPipeline *
 gsk_vulkan_pipeline_new (GType                    pipeline_type,
                          GdkVulkanContext        *context,
+                         VkPipelineCache          pipeline_cache,
                          VkPipelineLayout         layout,
                          const char              *shader_name,
                          VkRenderPass             render_pass)
 {
-  return gsk_vulkan_pipeline_new_full (pipeline_type, context, layout, shader_name, render_pass,
+  return gsk_vulkan_pipeline_new_full (pipeline_type, context, pipeline_cache, layout, shader_name, render_pass,
                                        VK_BLEND_FACTOR_ONE,
                                        VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA);
 }
@@ -68,6 +71,7 @@ gsk_vulkan_pipeline_new (GType                    pipeline_type,
 GskVulkanPipeline *
 gsk_vulkan_pipeline_new_full (GType                    pipeline_type,
                               GdkVulkanContext        *context,
+                              VkPipelineCache          pipeline_cache,
                               VkPipelineLayout         layout,
                               const char              *shader_name,
                               VkRenderPass             render_pass,
@@ -77,6 +81,7 @@ gsk_vulkan_pipeline_new_full (GType                    pipeline_type,
   GskVulkanPipelinePrivate *priv;
   GskVulkanPipeline *self;
   VkDevice device;
+  G_GNUC_UNUSED gint64 start_time = GDK_PROFILER_CURRENT_TIME;
 
   g_return_val_if_fail (g_type_is_a (pipeline_type, GSK_TYPE_VULKAN_PIPELINE), NULL);
   g_return_val_if_fail (layout != VK_NULL_HANDLE, NULL);
@@ -96,7 +101,7 @@ gsk_vulkan_pipeline_new_full (GType                    pipeline_type,
   priv->fragment_shader = gsk_vulkan_shader_new_from_resource (context, GSK_VULKAN_SHADER_FRAGMENT, shader_name, NULL);
 
   GSK_VK_CHECK (vkCreateGraphicsPipelines, device,
-                                           VK_NULL_HANDLE,
+                                           pipeline_cache,
                                            1,
                                            &(VkGraphicsPipelineCreateInfo) {
                                                .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
@@ -169,6 +174,8 @@ gsk_vulkan_pipeline_new_full (GType                    pipeline_type,
                                            NULL,
                                            &priv->pipeline);
 
+  gdk_profiler_end_mark (start_time, "create Vulkan pipeline", shader_name);
+
   return self;
 }
 
@@ -5,6 +5,7 @@
 #include "gskvulkanrenderprivate.h"
 
 #include "gskrendererprivate.h"
+#include "gskvulkanrendererprivate.h"
 #include "gskvulkanbufferprivate.h"
 #include "gskvulkancommandpoolprivate.h"
 #include "gskvulkanpipelineprivate.h"
@@ -380,7 +381,7 @@ gsk_vulkan_render_get_pipeline (GskVulkanRender       *self,
   static const struct {
     const char *name;
     guint num_textures;
-    GskVulkanPipeline * (* create_func) (GdkVulkanContext *context, VkPipelineLayout layout, const char *name, VkRenderPass render_pass);
+    GskVulkanPipeline * (* create_func) (GdkVulkanContext *context, VkPipelineCache pipeline_cache, VkPipelineLayout layout, const char *name, VkRenderPass render_pass);
   } pipeline_info[GSK_VULKAN_N_PIPELINES] = {
     { "texture",                    1, gsk_vulkan_texture_pipeline_new },
     { "texture-clip",               1, gsk_vulkan_texture_pipeline_new },
@@ -424,6 +425,7 @@ gsk_vulkan_render_get_pipeline (GskVulkanRender       *self,
 
   if (self->pipelines[type] == NULL)
     self->pipelines[type] = pipeline_info[type].create_func (self->vulkan,
+                                                             gsk_vulkan_renderer_get_pipeline_cache (GSK_VULKAN_RENDERER (self->renderer)),
                                                              self->pipeline_layout[pipeline_info[type].num_textures],
                                                              pipeline_info[type].name,
                                                              self->render_pass);
@@ -3,6 +3,7 @@
 #include "gskvulkanrendererprivate.h"
 
 #include "gskdebugprivate.h"
+#include "gskfallbackcacheprivate.h"
 #include "gskprivate.h"
 #include "gskrendererprivate.h"
 #include "gskrendernodeprivate.h"
@@ -31,6 +32,7 @@ typedef struct {
   GQuark render_passes;
   GQuark fallback_pixels;
   GQuark texture_pixels;
+  GQuark upload_bytes;
 } ProfileCounters;
 
 typedef struct {
@@ -40,6 +42,7 @@ typedef struct {
 
 static guint texture_pixels_counter;
 static guint fallback_pixels_counter;
+static guint upload_bytes_counter;
 #endif
 
 struct _GskVulkanRenderer
@@ -57,6 +60,11 @@ struct _GskVulkanRenderer
 
   GskVulkanGlyphCache *glyph_cache;
 
+  GskFallbackCache *fallbacks;
+
+  VkPipelineCache pipeline_cache;
+  gsize pipeline_cache_size;
+
 #ifdef G_ENABLE_DEBUG
   ProfileCounters profile_counters;
   ProfileTimers profile_timers;
@@ -112,12 +120,138 @@ gsk_vulkan_renderer_update_images_cb (GdkVulkanContext  *context,
     }
 }
 
+/* The pipeline cache UUID identifies the device and the build of its
+ * driver that can use the cached data, and the driver version changes
+ * with driver updates, so caches of different GPUs and drivers never
+ * overwrite each other.
+ */
+static char *
+gsk_vulkan_renderer_get_pipeline_cache_path (GskVulkanRenderer *self)
+{
+  VkPhysicalDeviceProperties properties;
+  GString *basename;
+  char *dir, *path;
+  guint i;
+
+  vkGetPhysicalDeviceProperties (gdk_vulkan_context_get_physical_device (self->vulkan), &properties);
+
+  basename = g_string_new (NULL);
+  for (i = 0; i < VK_UUID_SIZE; i++)
+    g_string_append_printf (basename, "%02x", properties.pipelineCacheUUID[i]);
+  g_string_append_printf (basename, "-%08x.cache", properties.driverVersion);
+
+  dir = g_build_filename (g_get_user_cache_dir (), "gtk-4.0", "vulkan-pipelines", NULL);
+  path = g_build_filename (dir, basename->str, NULL);
+
+  g_string_free (basename, TRUE);
+  g_free (dir);
+
+  return path;
+}
+
+static void
+gsk_vulkan_renderer_load_pipeline_cache (GskVulkanRenderer *self)
+{
+  VkResult res;
+  char *path;
+  char *data = NULL;
+  gsize size = 0;
+
+  path = gsk_vulkan_renderer_get_pipeline_cache_path (self);
+
+  /* A missing or unusable file just means we start with an empty cache,
+   * the driver checks the header of the data and ignores it if it
+   * doesn't match.
+   */
+  if (g_file_get_contents (path, &data, &size, NULL))
+    GSK_RENDERER_NOTE (GSK_RENDERER (self), VULKAN, g_message ("Loaded %" G_GSIZE_FORMAT " bytes of pipeline cache from %s", size, path));
+
+  /* Not GSK_VK_CHECK(), a stale or corrupt cache file is expected
+   * and reported below, not as a failed call.
+   */
+  res = vkCreatePipelineCache (gdk_vulkan_context_get_device (self->vulkan),
+                               &(VkPipelineCacheCreateInfo) {
+                                   .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+                                   .initialDataSize = size,
+                                   .pInitialData = data,
+                               },
+                               NULL,
+                               &self->pipeline_cache);
+  if (res != VK_SUCCESS)
+    {
+      GSK_RENDERER_NOTE (GSK_RENDERER (self), VULKAN, g_message ("Could not use pipeline cache from %s: %s", path, gdk_vulkan_strerror (res)));
+
+      /* Retry without the data, in case that was the problem */
+      GSK_VK_CHECK (vkCreatePipelineCache, gdk_vulkan_context_get_device (self->vulkan),
+                                           &(VkPipelineCacheCreateInfo) {
+                                               .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+                                           },
+                                           NULL,
+                                           &self->pipeline_cache);
+      size = 0;
+    }
+
+  self->pipeline_cache_size = size;
+
+  g_free (data);
+  g_free (path);
+}
+
+static void
+gsk_vulkan_renderer_save_pipeline_cache (GskVulkanRenderer *self)
+{
+  VkDevice device = gdk_vulkan_context_get_device (self->vulkan);
+  GError *error = NULL;
+  char *path, *dir;
+  size_t size;
+  char *data;
+
+  if (self->pipeline_cache == VK_NULL_HANDLE)
+    return;
+
+  if (GSK_VK_CHECK (vkGetPipelineCacheData, device, self->pipeline_cache, &size, NULL) != VK_SUCCESS)
+    return;
+
+  /* Nothing new was compiled */
+  if (size == 0 || size == self->pipeline_cache_size)
+    return;
+
+  data = g_malloc (size);
+  if (GSK_VK_CHECK (vkGetPipelineCacheData, device, self->pipeline_cache, &size, data) != VK_SUCCESS)
+    {
+      g_free (data);
+      return;
+    }
+
+  path = gsk_vulkan_renderer_get_pipeline_cache_path (self);
+  dir = g_path_get_dirname (path);
+
+  if (g_mkdir_with_parents (dir, 0755) != 0)
+    {
+      GSK_RENDERER_NOTE (GSK_RENDERER (self), VULKAN, g_message ("Failed to create %s", dir));
+    }
+  else if (!g_file_set_contents (path, data, size, &error))
+    {
+      GSK_RENDERER_NOTE (GSK_RENDERER (self), VULKAN, g_message ("Failed to save pipeline cache: %s", error->message));
+      g_error_free (error);
+    }
+  else
+    {
+      GSK_RENDERER_NOTE (GSK_RENDERER (self), VULKAN, g_message ("Saved %" G_GSIZE_FORMAT " bytes of pipeline cache to %s", size, path));
+    }
+
+  g_free (dir);
+  g_free (path);
+  g_free (data);
+}
+
 static gboolean
 gsk_vulkan_renderer_realize (GskRenderer  *renderer,
                              GdkSurface   *surface,
                              GError      **error)
 {
   GskVulkanRenderer *self = GSK_VULKAN_RENDERER (renderer);
+  G_GNUC_UNUSED gint64 start_time = GDK_PROFILER_CURRENT_TIME;
 
   if (surface == NULL)
     {
@@ -136,10 +270,16 @@ gsk_vulkan_renderer_realize (GskRenderer  *renderer,
                     self);
   gsk_vulkan_renderer_update_images_cb (self->vulkan, self);
 
+  gsk_vulkan_renderer_load_pipeline_cache (self);
+
   self->render = gsk_vulkan_render_new (renderer, self->vulkan);
 
   self->glyph_cache = gsk_vulkan_glyph_cache_new (renderer, self->vulkan);
 
+  self->fallbacks = gsk_fallback_cache_new ();
+
+  gdk_profiler_end_mark (start_time, "realize GskVulkanRenderer", NULL);
+
   return TRUE;
 }
 
@@ -151,6 +291,8 @@ gsk_vulkan_renderer_unrealize (GskRenderer *renderer)
 
   g_clear_object (&self->glyph_cache);
 
+  g_clear_pointer (&self->fallbacks, gsk_fallback_cache_free);
+
   for (l = self->textures; l; l = l->next)
     {
       GskVulkanTextureData *data = l->data;
@@ -162,6 +304,10 @@ gsk_vulkan_renderer_unrealize (GskRenderer *renderer)
 
   g_clear_pointer (&self->render, gsk_vulkan_render_free);
 
+  gsk_vulkan_renderer_save_pipeline_cache (self);
+  vkDestroyPipelineCache (gdk_vulkan_context_get_device (self->vulkan), self->pipeline_cache, NULL);
+  self->pipeline_cache = VK_NULL_HANDLE;
+
   gsk_vulkan_renderer_free_targets (self);
   g_signal_handlers_disconnect_by_func(self->vulkan,
                                        gsk_vulkan_renderer_update_images_cb,
@@ -189,10 +335,13 @@ gsk_vulkan_renderer_render_texture (GskRenderer           *renderer,
   profiler = gsk_renderer_get_profiler (renderer);
   gsk_profiler_counter_set (profiler, self->profile_counters.fallback_pixels, 0);
   gsk_profiler_counter_set (profiler, self->profile_counters.texture_pixels, 0);
+  gsk_profiler_counter_set (profiler, self->profile_counters.upload_bytes, 0);
   gsk_profiler_counter_set (profiler, self->profile_counters.render_passes, 0);
   gsk_profiler_timer_begin (profiler, self->profile_timers.cpu_time);
 #endif
 
+  gsk_fallback_cache_begin_frame (self->fallbacks);
+
   render = gsk_vulkan_render_new (renderer, self->vulkan);
 
   image = gsk_vulkan_image_new_for_framebuffer (self->vulkan,
@@ -226,6 +375,8 @@ gsk_vulkan_renderer_render_texture (GskRenderer           *renderer,
                                     gsk_profiler_counter_get (profiler, self->profile_counters.texture_pixels));
       gdk_profiler_set_int_counter (fallback_pixels_counter,
                                     gsk_profiler_counter_get (profiler, self->profile_counters.fallback_pixels));
+      gdk_profiler_set_int_counter (upload_bytes_counter,
+                                    gsk_profiler_counter_get (profiler, self->profile_counters.upload_bytes));
     }
 #endif
 
@@ -249,10 +400,13 @@ gsk_vulkan_renderer_render (GskRenderer          *renderer,
   profiler = gsk_renderer_get_profiler (renderer);
   gsk_profiler_counter_set (profiler, self->profile_counters.fallback_pixels, 0);
   gsk_profiler_counter_set (profiler, self->profile_counters.texture_pixels, 0);
+  gsk_profiler_counter_set (profiler, self->profile_counters.upload_bytes, 0);
   gsk_profiler_counter_set (profiler, self->profile_counters.render_passes, 0);
   gsk_profiler_timer_begin (profiler, self->profile_timers.cpu_time);
 #endif
 
+  gsk_fallback_cache_begin_frame (self->fallbacks);
+
   gdk_draw_context_begin_frame (GDK_DRAW_CONTEXT (self->vulkan), region);
   render = self->render;
 
@@ -302,6 +456,7 @@ gsk_vulkan_renderer_init (GskVulkanRenderer *self)
   self->profile_counters.render_passes = gsk_profiler_add_counter (profiler, "render-passes", "Render passes", FALSE);
   self->profile_counters.fallback_pixels = gsk_profiler_add_counter (profiler, "fallback-pixels", "Fallback pixels", TRUE);
   self->profile_counters.texture_pixels = gsk_profiler_add_counter (profiler, "texture-pixels", "Texture pixels", TRUE);
+  self->profile_counters.upload_bytes = gsk_profiler_add_counter (profiler, "upload-bytes", "Uploaded bytes", TRUE);
 
   self->profile_timers.cpu_time = gsk_profiler_add_timer (profiler, "cpu-time", "CPU time", FALSE, TRUE);
   if (GSK_RENDERER_DEBUG_CHECK (GSK_RENDERER (self), SYNC))
@@ -311,11 +466,18 @@ gsk_vulkan_renderer_init (GskVulkanRenderer *self)
     {
       texture_pixels_counter = gdk_profiler_define_int_counter ("texture-pixels", "Texture Pixels");
       fallback_pixels_counter = gdk_profiler_define_int_counter ("fallback-pixels", "Fallback Pixels");
+      upload_bytes_counter = gdk_profiler_define_int_counter ("upload-bytes", "Uploaded Bytes");
     }
 
 #endif
 }
 
+VkPipelineCache
+gsk_vulkan_renderer_get_pipeline_cache (GskVulkanRenderer *self)
+{
+  return self->pipeline_cache;
+}
+
 static void
 gsk_vulkan_renderer_clear_texture (gpointer p)
 {
@@ -348,6 +510,11 @@ gsk_vulkan_renderer_ref_texture_image (GskVulkanRenderer *self,
                                           cairo_image_surface_get_width (surface),
                                           cairo_image_surface_get_height (surface),
                                           cairo_image_surface_get_stride (surface));
+#ifdef G_ENABLE_DEBUG
+  gsk_profiler_counter_add (gsk_renderer_get_profiler (GSK_RENDERER (self)),
+                            self->profile_counters.upload_bytes,
+                            cairo_image_surface_get_stride (surface) * cairo_image_surface_get_height (surface));
+#endif
   cairo_surface_destroy (surface);
 
   data = g_slice_new0 (GskVulkanTextureData);
@@ -368,6 +535,32 @@ gsk_vulkan_renderer_ref_texture_image (GskVulkanRenderer *self,
   return image;
 }
 
+GskVulkanImage *
+gsk_vulkan_renderer_ref_cairo_image (GskVulkanRenderer *self,
+                                     GskRenderNode     *node,
+                                     int                scale_factor,
+                                     GskVulkanUploader *uploader)
+{
+  GdkTexture *texture;
+  gboolean rasterized;
+
+  texture = gsk_fallback_cache_get_texture (self->fallbacks,
+                                            node,
+                                            scale_factor,
+                                            scale_factor,
+                                            &rasterized);
+  g_assert (texture != NULL);
+
+#ifdef G_ENABLE_DEBUG
+  if (rasterized)
+    gsk_profiler_counter_add (gsk_renderer_get_profiler (GSK_RENDERER (self)),
+                              self->profile_counters.fallback_pixels,
+                              texture->width * texture->height);
+#endif
+
+  return gsk_vulkan_renderer_ref_texture_image (self, texture, uploader);
+}
+
 GskVulkanImage *
 gsk_vulkan_renderer_ref_glyph_image (GskVulkanRenderer  *self,
                                      GskVulkanUploader  *uploader,
@@ -6,9 +6,15 @@
 
 G_BEGIN_DECLS
 
+VkPipelineCache         gsk_vulkan_renderer_get_pipeline_cache          (GskVulkanRenderer      *self);
+
 GskVulkanImage *        gsk_vulkan_renderer_ref_texture_image           (GskVulkanRenderer      *self,
                                                                          GdkTexture             *texture,
                                                                          GskVulkanUploader      *uploader);
+GskVulkanImage *        gsk_vulkan_renderer_ref_cairo_image             (GskVulkanRenderer      *self,
+                                                                         GskRenderNode          *node,
+                                                                         int                     scale_factor,
+                                                                         GskVulkanUploader      *uploader);
 
 typedef struct
 {
@@ -126,6 +126,7 @@ struct _GskVulkanRenderPass
 
   GQuark fallback_pixels;
   GQuark texture_pixels;
+  GQuark upload_bytes;
 };
 
 GskVulkanRenderPass *
@@ -207,6 +208,7 @@ gsk_vulkan_render_pass_new (GdkVulkanContext  *context,
 #ifdef G_ENABLE_DEBUG
   self->fallback_pixels = g_quark_from_static_string ("fallback-pixels");
   self->texture_pixels = g_quark_from_static_string ("texture-pixels");
+  self->upload_bytes = g_quark_from_static_string ("upload-bytes");
 #endif
 
   return self;
@@ -338,13 +340,28 @@ gsk_vulkan_render_pass_add_node (GskVulkanRenderPass           *self,
       return;
 
     case GSK_CAIRO_NODE:
-      if (gsk_cairo_node_get_surface (node) == NULL)
+      if (gsk_cairo_node_get_surface (node) == NULL ||
+          node->bounds.size.width <= 0 || node->bounds.size.height <= 0)
         return;
       /* We're using recording surfaces, so drawing them to an image
-       * surface and uploading them is the right thing.
-       * But that's exactly what the fallback code does.
+       * surface and uploading them is the right thing. The renderer
+       * keeps that image around for as long as the node is drawn,
+       * so it is drawn like a texture.
        */
-      goto fallback;
+      if (GSK_RENDERER_DEBUG_CHECK (gsk_vulkan_render_get_renderer (render), FALLBACK))
+        goto fallback;
+      if (gsk_vulkan_clip_contains_rect (&constants->clip, &node->bounds))
+        pipeline_type = GSK_VULKAN_PIPELINE_TEXTURE;
+      else if (constants->clip.type == GSK_VULKAN_CLIP_RECT)
+        pipeline_type = GSK_VULKAN_PIPELINE_TEXTURE_CLIP;
+      else if (constants->clip.type == GSK_VULKAN_CLIP_ROUNDED_CIRCULAR)
+        pipeline_type = GSK_VULKAN_PIPELINE_TEXTURE_CLIP_ROUNDED;
+      else
+        goto fallback;
+      op.type = GSK_VULKAN_OP_TEXTURE;
+      op.render.pipeline = gsk_vulkan_render_get_pipeline (render, pipeline_type);
+      g_array_append_val (self->render_ops, op);
+      return;
 
     case GSK_TEXT_NODE:
       {
@@ -880,6 +897,15 @@ gsk_vulkan_render_pass_upload_fallback (GskVulkanRenderPass  *self,
 
   cairo_destroy (cr);
 
+#ifdef G_ENABLE_DEBUG
+  {
+    GskProfiler *profiler = gsk_renderer_get_profiler (gsk_vulkan_render_get_renderer (render));
+    gsk_profiler_counter_add (profiler,
+                              self->upload_bytes,
+                              cairo_image_surface_get_stride (surface) * cairo_image_surface_get_height (surface));
+  }
+#endif
+
   op->source = gsk_vulkan_image_new_from_data (uploader,
                                                cairo_image_surface_get_data (surface),
                                                cairo_image_surface_get_width (surface),
@@ -926,9 +952,15 @@ gsk_vulkan_render_pass_upload (GskVulkanRenderPass  *self,
 
         case GSK_VULKAN_OP_TEXTURE:
           {
-            op->render.source = gsk_vulkan_renderer_ref_texture_image (GSK_VULKAN_RENDERER (gsk_vulkan_render_get_renderer (render)),
-                                                                       gsk_texture_node_get_texture (op->render.node),
+            if (gsk_render_node_get_node_type (op->render.node) == GSK_CAIRO_NODE)
+              op->render.source = gsk_vulkan_renderer_ref_cairo_image (GSK_VULKAN_RENDERER (gsk_vulkan_render_get_renderer (render)),
+                                                                       op->render.node,
+                                                                       self->scale_factor,
                                                                        uploader);
+            else
+              op->render.source = gsk_vulkan_renderer_ref_texture_image (GSK_VULKAN_RENDERER (gsk_vulkan_render_get_renderer (render)),
+                                                                         gsk_texture_node_get_texture (op->render.node),
+                                                                         uploader);
             op->render.source_rect = GRAPHENE_RECT_INIT(0, 0, 1, 1);
             gsk_vulkan_render_add_cleanup_image (render, op->render.source);
           }
@@ -84,11 +84,12 @@ gsk_vulkan_text_pipeline_init (GskVulkanTextPipeline *self)
 
 GskVulkanPipeline *
 gsk_vulkan_text_pipeline_new (GdkVulkanContext        *context,
+                              VkPipelineCache          pipeline_cache,
                               VkPipelineLayout         layout,
                               const char              *shader_name,
                               VkRenderPass             render_pass)
 {
-  return gsk_vulkan_pipeline_new_full (GSK_TYPE_VULKAN_TEXT_PIPELINE, context, layout, shader_name, render_pass,
+  return gsk_vulkan_pipeline_new_full (GSK_TYPE_VULKAN_TEXT_PIPELINE, context, pipeline_cache, layout, shader_name, render_pass,
                                        VK_BLEND_FACTOR_SRC_ALPHA, VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA);
 }
 
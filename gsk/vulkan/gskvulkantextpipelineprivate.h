@@ -15,6 +15,7 @@ typedef struct _GskVulkanTextPipelineLayout GskVulkanTextPipelineLayout;
 G_DECLARE_FINAL_TYPE (GskVulkanTextPipeline, gsk_vulkan_text_pipeline, GSK, VULKAN_TEXT_PIPELINE, GskVulkanPipeline)
 
 GskVulkanPipeline *     gsk_vulkan_text_pipeline_new                   (GdkVulkanContext              *context,
+                                                                        VkPipelineCache                pipeline_cache,
                                                                         VkPipelineLayout               layout,
                                                                         const char                    *shader_name,
                                                                         VkRenderPass                   render_pass);
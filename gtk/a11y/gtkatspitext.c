@@ -40,6 +40,7 @@
 #include "gtktextview.h"
 
 #include <gio/gio.h>
+#include <string.h>
 
 /* {{{ GtkLabel */
 
@@ -108,7 +109,7 @@ label_handle_method (GDBusConnection       *connection,
     }
   else if (g_strcmp0 (method_name, "GetTextBeforeOffset") == 0)
     {
-      PangoLayout *layout = gtk_label_get_layout (GTK_LABEL (widget));
+      PangoLayout *layout = _gtk_label_peek_layout (GTK_LABEL (widget));
       int offset;
       AtspiTextBoundaryType boundary_type;
       char *string;
@@ -123,7 +124,7 @@ label_handle_method (GDBusConnection       *connection,
     }
   else if (g_strcmp0 (method_name, "GetTextAtOffset") == 0)
     {
-      PangoLayout *layout = gtk_label_get_layout (GTK_LABEL (widget));
+      PangoLayout *layout = _gtk_label_peek_layout (GTK_LABEL (widget));
       int offset;
       AtspiTextBoundaryType boundary_type;
       char *string;
@@ -138,7 +139,7 @@ label_handle_method (GDBusConnection       *connection,
     }
   else if (g_strcmp0 (method_name, "GetTextAfterOffset") == 0)
     {
-      PangoLayout *layout = gtk_label_get_layout (GTK_LABEL (widget));
+      PangoLayout *layout = _gtk_label_peek_layout (GTK_LABEL (widget));
       int offset;
       AtspiTextBoundaryType boundary_type;
       char *string;
@@ -168,7 +169,7 @@ label_handle_method (GDBusConnection       *connection,
     }
   else if (g_strcmp0 (method_name, "GetStringAtOffset") == 0)
     {
-      PangoLayout *layout = gtk_label_get_layout (GTK_LABEL (widget));
+      PangoLayout *layout = _gtk_label_peek_layout (GTK_LABEL (widget));
       int offset;
       AtspiTextGranularity granularity;
       char *string;
@@ -183,7 +184,7 @@ label_handle_method (GDBusConnection       *connection,
     }
   else if (g_strcmp0 (method_name, "GetAttributes") == 0)
     {
-      PangoLayout *layout = gtk_label_get_layout (GTK_LABEL (widget));
+      PangoLayout *layout = _gtk_label_peek_layout (GTK_LABEL (widget));
       GVariantBuilder builder = G_VARIANT_BUILDER_INIT (G_VARIANT_TYPE ("a{ss}"));
       int offset;
       int start, end;
@@ -196,7 +197,7 @@ label_handle_method (GDBusConnection       *connection,
     }
   else if (g_strcmp0 (method_name, "GetAttributeValue") == 0)
     {
-      PangoLayout *layout = gtk_label_get_layout (GTK_LABEL (widget));
+      PangoLayout *layout = _gtk_label_peek_layout (GTK_LABEL (widget));
       GVariantBuilder builder = G_VARIANT_BUILDER_INIT (G_VARIANT_TYPE ("a{ss}"));
       int offset;
       const char *name;
@@ -217,7 +218,7 @@ label_handle_method (GDBusConnection       *connection,
     }
   else if (g_strcmp0 (method_name, "GetAttributeRun") == 0)
     {
-      PangoLayout *layout = gtk_label_get_layout (GTK_LABEL (widget));
+      PangoLayout *layout = _gtk_label_peek_layout (GTK_LABEL (widget));
       GVariantBuilder builder = G_VARIANT_BUILDER_INIT (G_VARIANT_TYPE ("a{ss}"));
       int offset;
       gboolean include_defaults;
@@ -235,7 +236,7 @@ label_handle_method (GDBusConnection       *connection,
   else if (g_strcmp0 (method_name, "GetDefaultAttributes") == 0 ||
            g_strcmp0 (method_name, "GetDefaultAttributeSet") == 0)
     {
-      PangoLayout *layout = gtk_label_get_layout (GTK_LABEL (widget));
+      PangoLayout *layout = _gtk_label_peek_layout (GTK_LABEL (widget));
       GVariantBuilder builder = G_VARIANT_BUILDER_INIT (G_VARIANT_TYPE ("a{ss}"));
 
       gtk_pango_get_default_attributes (layout, &builder);
@@ -836,8 +837,8 @@ text_view_handle_method (GDBusConnection       *connection,
 
       g_variant_get (parameters, "(ii)", &start, &end);
 
-      gtk_text_buffer_get_iter_at_offset (buffer, &start_iter, start);
-      gtk_text_buffer_get_iter_at_offset (buffer, &end_iter, end);
+      gtk_text_buffer_get_iter_at_offset_cached (buffer, &start_iter, start);
+      gtk_text_buffer_get_iter_at_offset_cached (buffer, &end_iter, end);
 
       string = gtk_text_buffer_get_text (buffer, &start_iter, &end_iter, FALSE);
 
@@ -898,7 +899,7 @@ text_view_handle_method (GDBusConnection       *connection,
         {
           GtkTextIter start, end;
           char *string;
-          gtk_text_buffer_get_iter_at_offset (buffer, &start, offset);
+          gtk_text_buffer_get_iter_at_offset_cached (buffer, &start, offset);
           end = start;
           gtk_text_iter_forward_char (&end);
           string = gtk_text_buffer_get_slice (buffer, &start, &end, FALSE);
@@ -1284,40 +1285,134 @@ typedef struct {
   GtkTextBuffer *buffer;
   int cursor_position;
   int selection_bound;
+
+  /* A text change that has not been sent yet, see queue_text_changed() */
+  const char *pending_kind;
+  int pending_start;
+  int pending_length;
+  GString *pending_text;
+  guint pending_caret_moved : 1;
+  guint pending_selection_changed : 1;
+  guint flush_id;
 } TextChanged;
 
-/* {{{ GtkEditable notification */
+/* {{{ Text change notification */
+
+/* Text change events carry the text that was inserted or deleted,
+ * but only up to this many characters. The length of the change is
+ * always correct, so ATs can ask for the rest of the text if they
+ * need it.
+ */
+#define MAX_CHANGED_TEXT_LENGTH 1024
+
+/* Returns the length in bytes of the first @n_chars characters of @text */
+static gsize
+utf8_prefix_length (const char *text,
+                    gsize       len,
+                    int         n_chars)
+{
+  const char *p = text;
+  int i;
+
+  for (i = 0; i < n_chars && p < text + len; i++)
+    p = g_utf8_next_char (p);
+
+  return MIN (p - text, len);
+}
 
 static void
-insert_text_cb (GtkEditable *editable,
-                char        *new_text,
-                int          new_text_length,
-                int         *position,
-                TextChanged *changed)
+flush_text_changed (TextChanged *changed)
 {
-  int length;
+  g_clear_handle_id (&changed->flush_id, g_source_remove);
 
-  if (new_text_length == 0)
-    return;
+  if (changed->pending_kind)
+    {
+      changed->text_changed (changed->data,
+                             changed->pending_kind,
+                             changed->pending_start,
+                             changed->pending_length,
+                             changed->pending_text->str);
 
-  length = g_utf8_strlen (new_text, new_text_length);
-  changed->text_changed (changed->data, "insert", *position - length, length, new_text);
+      changed->pending_kind = NULL;
+      g_string_truncate (changed->pending_text, 0);
+    }
+
+  if (changed->pending_caret_moved)
+    changed->selection_changed (changed->data, "text-caret-moved", changed->cursor_position);
+
+  if (changed->pending_selection_changed)
+    changed->selection_changed (changed->data, "text-selection-changed", 0);
+
+  changed->pending_caret_moved = FALSE;
+  changed->pending_selection_changed = FALSE;
 }
 
+static gboolean
+flush_text_changed_cb (gpointer data)
+{
+  TextChanged *changed = data;
+
+  changed->flush_id = 0;
+  flush_text_changed (changed);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Text is often changed in many small steps, like a log that gets
+ * one line appended at a time. Changes that continue the previous
+ * one are merged into a single event, which is sent once per frame,
+ * together with the caret and selection changes that came with it.
+ * A change that does not continue the pending one sends it first,
+ * so that the events are still in order.
+ */
 static void
-delete_text_cb (GtkEditable *editable,
-                int          start,
-                int          end,
-                TextChanged *changed)
+queue_text_changed (TextChanged *changed,
+                    const char  *kind,
+                    int          start,
+                    int          length,
+                    const char  *text,
+                    gsize        text_len)
 {
-  char *text;
+  gboolean continues;
 
-  if (start == end)
-    return;
+  if (g_strcmp0 (changed->pending_kind, kind) != 0)
+    continues = FALSE;
+  else if (strcmp (kind, "insert") == 0)
+    continues = start == changed->pending_start + changed->pending_length;
+  else
+    continues = start == changed->pending_start;
 
-  text = gtk_editable_get_chars (editable, start, end);
-  changed->text_changed (changed->data, "delete", start, end - start, text);
-  g_free (text);
+  if (!continues)
+    flush_text_changed (changed);
+
+  if (changed->pending_text == NULL)
+    changed->pending_text = g_string_new (NULL);
+
+  if (changed->pending_kind == NULL)
+    {
+      changed->pending_kind = kind;
+      changed->pending_start = start;
+      changed->pending_length = 0;
+    }
+
+  if (changed->pending_length < MAX_CHANGED_TEXT_LENGTH)
+    {
+      int n_chars = MAX_CHANGED_TEXT_LENGTH - changed->pending_length;
+
+      g_string_append_len (changed->pending_text, text,
+                           utf8_prefix_length (text, text_len, n_chars));
+    }
+
+  changed->pending_length += length;
+
+  if (changed->flush_id == 0)
+    {
+      changed->flush_id = g_idle_add_full (GDK_PRIORITY_REDRAW + 10,
+                                           flush_text_changed_cb,
+                                           changed,
+                                           NULL);
+      g_source_set_name_by_id (changed->flush_id, "[gtk] flush_text_changed_cb");
+    }
 }
 
 static void
@@ -1339,6 +1434,14 @@ update_selection (TextChanged *changed,
   changed->cursor_position = cursor_position;
   changed->selection_bound = selection_bound;
 
+  /* Sent after the text change that moved the caret */
+  if (changed->pending_kind)
+    {
+      changed->pending_caret_moved |= caret_moved;
+      changed->pending_selection_changed |= had_selection || has_selection;
+      return;
+    }
+
   if (caret_moved)
     changed->selection_changed (changed->data, "text-caret-moved", changed->cursor_position);
 
@@ -1346,6 +1449,55 @@ update_selection (TextChanged *changed,
     changed->selection_changed (changed->data, "text-selection-changed", 0);
 }
 
+static void
+text_changed_free (gpointer data)
+{
+  TextChanged *changed = data;
+
+  g_clear_handle_id (&changed->flush_id, g_source_remove);
+  if (changed->pending_text)
+    g_string_free (changed->pending_text, TRUE);
+  g_free (changed);
+}
+
+/* }}} */
+/* {{{ GtkEditable notification */
+
+static void
+insert_text_cb (GtkEditable *editable,
+                char        *new_text,
+                int          new_text_length,
+                int         *position,
+                TextChanged *changed)
+{
+  int length;
+
+  if (new_text_length == 0)
+    return;
+
+  if (new_text_length < 0)
+    new_text_length = strlen (new_text);
+
+  length = g_utf8_strlen (new_text, new_text_length);
+  queue_text_changed (changed, "insert", *position - length, length, new_text, new_text_length);
+}
+
+static void
+delete_text_cb (GtkEditable *editable,
+                int          start,
+                int          end,
+                TextChanged *changed)
+{
+  char *text;
+
+  if (start == end)
+    return;
+
+  text = gtk_editable_get_chars (editable, start, MIN (end, start + MAX_CHANGED_TEXT_LENGTH));
+  queue_text_changed (changed, "delete", start, end - start, text, strlen (text));
+  g_free (text);
+}
+
 static void
 notify_cb (GObject     *object,
            GParamSpec  *pspec,
@@ -1391,10 +1543,14 @@ insert_range_cb (GtkTextBuffer *buffer,
   int position;
   int length;
 
+  if (len < 0)
+    len = strlen (text);
+
   position = gtk_text_iter_get_offset (iter);
   length = g_utf8_strlen (text, len);
 
-  changed->text_changed (changed->data, "insert", position - length, length, text);
+  /* We run before the text is inserted, so the iter is still at the start */
+  queue_text_changed (changed, "insert", position, length, text, len);
 
   update_cursor (buffer, changed);
 }
@@ -1405,15 +1561,19 @@ delete_range_cb (GtkTextBuffer *buffer,
                  GtkTextIter   *end,
                  TextChanged   *changed)
 {
+  GtkTextIter slice_end;
   int offset, length;
   char *text;
 
-  text = gtk_text_buffer_get_slice (buffer, start, end, FALSE);
-
   offset = gtk_text_iter_get_offset (start);
   length = gtk_text_iter_get_offset (end) - offset;
 
-  changed->text_changed (changed->data, "delete", offset, length, text);
+  /* Don't copy what we are not going to send */
+  slice_end = *start;
+  gtk_text_iter_forward_chars (&slice_end, MIN (length, MAX_CHANGED_TEXT_LENGTH));
+  text = gtk_text_buffer_get_slice (buffer, start, &slice_end, FALSE);
+
+  queue_text_changed (changed, "delete", offset, length, text, strlen (text));
 
   g_free (text);
 }
@@ -1449,6 +1609,8 @@ buffer_changed (GtkWidget   *widget,
 
   buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (widget));
 
+  flush_text_changed (changed);
+
   if (changed->buffer)
     {
       g_signal_handlers_disconnect_by_func (changed->buffer, insert_range_cb, changed);
@@ -1456,7 +1618,8 @@ buffer_changed (GtkWidget   *widget,
       g_signal_handlers_disconnect_by_func (changed->buffer, delete_range_after_cb, changed);
       g_signal_handlers_disconnect_by_func (changed->buffer, mark_set_cb, changed);
 
-      gtk_text_buffer_get_bounds (changed->buffer, &start, &end);
+      gtk_text_buffer_get_start_iter (changed->buffer, &start);
+      gtk_text_buffer_get_iter_at_offset (changed->buffer, &end, MAX_CHANGED_TEXT_LENGTH);
       text = gtk_text_buffer_get_slice (changed->buffer, &start, &end, FALSE);
       changed->text_changed (changed->data, "delete", 0, gtk_text_buffer_get_char_count (changed->buffer), text);
       g_free (text);
@@ -1476,7 +1639,8 @@ buffer_changed (GtkWidget   *widget,
       g_signal_connect_after (changed->buffer, "delete-range", G_CALLBACK (delete_range_after_cb), changed);
       g_signal_connect_after (changed->buffer, "mark-set", G_CALLBACK (mark_set_cb), changed);
 
-      gtk_text_buffer_get_bounds (changed->buffer, &start, &end);
+      gtk_text_buffer_get_start_iter (changed->buffer, &start);
+      gtk_text_buffer_get_iter_at_offset (changed->buffer, &end, MAX_CHANGED_TEXT_LENGTH);
       text = gtk_text_buffer_get_slice (changed->buffer, &start, &end, FALSE);
       changed->text_changed (changed->data, "insert", 0, gtk_text_buffer_get_char_count (changed->buffer), text);
       g_free (text);
@@ -1504,7 +1668,7 @@ gtk_atspi_connect_text_signals (GtkAccessible *accessible,
   changed->selection_changed = selection_changed;
   changed->data = data;
 
-  g_object_set_data_full (G_OBJECT (accessible), "accessible-text-data", changed, g_free);
+  g_object_set_data_full (G_OBJECT (accessible), "accessible-text-data", changed, text_changed_free);
 
   if (GTK_IS_EDITABLE (accessible))
     {
@@ -1539,6 +1703,8 @@ gtk_atspi_disconnect_text_signals (GtkAccessible *accessible)
   if (changed == NULL)
     return;
 
+  flush_text_changed (changed);
+
   if (GTK_IS_EDITABLE (accessible))
     {
       GtkText *text = gtk_editable_get_text_widget (GTK_WIDGET (accessible));
@@ -20,6 +20,8 @@
 #include "gtkatspitextbufferprivate.h"
 #include "gtkatspipangoprivate.h"
 #include "gtktextviewprivate.h"
+#include "gtktextbufferprivate.h"
+#include "gtktextbtree.h"
 
 static const char *
 gtk_justification_to_string (GtkJustification just)
@@ -140,6 +142,110 @@ gtk_text_view_add_default_attributes (GtkTextView     *view,
   gtk_text_attributes_unref (text_attrs);
 }
 
+/* Screen readers ask about offsets close to each other, like the
+ * characters or words around the caret. Iters that close to the last
+ * one are found by moving from it, instead of from the start of the
+ * buffer. The cached iter is only valid until the text changes.
+ */
+#define MAX_CACHED_DISTANCE 128
+
+typedef struct
+{
+  guint stamp;
+  int offset;
+  GtkTextIter iter;
+} OffsetCache;
+
+void
+gtk_text_buffer_get_iter_at_offset_cached (GtkTextBuffer *buffer,
+                                           GtkTextIter   *iter,
+                                           int            offset)
+{
+  static GQuark quark;
+  OffsetCache *cache;
+  guint stamp;
+
+  if (G_UNLIKELY (quark == 0))
+    quark = g_quark_from_static_string ("gtk-atspi-offset-cache");
+
+  stamp = _gtk_text_btree_get_chars_changed_stamp (_gtk_text_buffer_get_btree (buffer));
+  cache = g_object_get_qdata (G_OBJECT (buffer), quark);
+
+  if (cache && cache->stamp == stamp &&
+      offset >= 0 && ABS (offset - cache->offset) <= MAX_CACHED_DISTANCE)
+    {
+      *iter = cache->iter;
+      if (offset > cache->offset)
+        gtk_text_iter_forward_chars (iter, offset - cache->offset);
+      else if (offset < cache->offset)
+        gtk_text_iter_backward_chars (iter, cache->offset - offset);
+    }
+  else
+    gtk_text_buffer_get_iter_at_offset (buffer, iter, offset);
+
+  if (cache == NULL)
+    {
+      cache = g_new (OffsetCache, 1);
+      g_object_set_qdata_full (G_OBJECT (buffer), quark, cache, g_free);
+    }
+
+  cache->stamp = stamp;
+  cache->offset = gtk_text_iter_get_offset (iter);
+  cache->iter = *iter;
+}
+
+typedef struct
+{
+  GtkTextIter start;
+  GtkTextIter end;
+  const GtkTextIter *iter;
+} RunBounds;
+
+static void
+narrow_run_bounds (GtkTextTag *tag,
+                   gpointer    data)
+{
+  RunBounds *bounds = data;
+  GtkTextIter toggle;
+
+  toggle = *bounds->iter;
+  if (gtk_text_iter_forward_to_tag_toggle (&toggle, tag) &&
+      gtk_text_iter_compare (&toggle, &bounds->end) < 0)
+    bounds->end = toggle;
+
+  /* A run starts at a toggle right at @iter */
+  toggle = *bounds->iter;
+  if ((gtk_text_iter_toggles_tag (&toggle, tag) ||
+       gtk_text_iter_backward_to_tag_toggle (&toggle, tag)) &&
+      gtk_text_iter_compare (&toggle, &bounds->start) > 0)
+    bounds->start = toggle;
+}
+
+/* Finds the run of text with the same tags around @iter.
+ *
+ * Searching for toggles of any tag at once has to look at every line,
+ * while the search for toggles of a single tag skips parts of the buffer
+ * without it, so this does one search per tag.
+ */
+static void
+get_run_bounds (GtkTextBuffer     *buffer,
+                const GtkTextIter *iter,
+                int               *start_offset,
+                int               *end_offset)
+{
+  RunBounds bounds;
+
+  gtk_text_buffer_get_bounds (buffer, &bounds.start, &bounds.end);
+  bounds.iter = iter;
+
+  gtk_text_tag_table_foreach (gtk_text_buffer_get_tag_table (buffer),
+                              narrow_run_bounds,
+                              &bounds);
+
+  *start_offset = gtk_text_iter_get_offset (&bounds.start);
+  *end_offset = gtk_text_iter_get_offset (&bounds.end);
+}
+
 void
 gtk_text_buffer_get_run_attributes (GtkTextBuffer   *buffer,
                                     GVariantBuilder *builder,
@@ -152,15 +258,9 @@ gtk_text_buffer_get_run_attributes (GtkTextBuffer   *buffer,
   double scale = 1;
   gboolean val_set = FALSE;
 
-  gtk_text_buffer_get_iter_at_offset (buffer, &iter, offset);
-
-  gtk_text_iter_forward_to_tag_toggle (&iter, NULL);
-  *end_offset = gtk_text_iter_get_offset (&iter);
-
-  gtk_text_iter_backward_to_tag_toggle (&iter, NULL);
-  *start_offset = gtk_text_iter_get_offset (&iter);
+  gtk_text_buffer_get_iter_at_offset_cached (buffer, &iter, offset);
 
-  gtk_text_buffer_get_iter_at_offset (buffer, &iter, offset);
+  get_run_bounds (buffer, &iter, start_offset, end_offset);
 
   tags = gtk_text_iter_get_tags (&iter);
   tags = g_slist_reverse (tags);
@@ -649,7 +749,7 @@ gtk_text_view_get_text_before (GtkTextView           *view,
   GtkTextIter pos, start, end;
 
   buffer = gtk_text_view_get_buffer (view);
-  gtk_text_buffer_get_iter_at_offset (buffer, &pos, offset);
+  gtk_text_buffer_get_iter_at_offset_cached (buffer, &pos, offset);
   start = end = pos;
 
   switch (boundary_type)
@@ -755,7 +855,7 @@ gtk_text_view_get_text_at (GtkTextView           *view,
   GtkTextIter pos, start, end;
 
   buffer = gtk_text_view_get_buffer (view);
-  gtk_text_buffer_get_iter_at_offset (buffer, &pos, offset);
+  gtk_text_buffer_get_iter_at_offset_cached (buffer, &pos, offset);
   start = end = pos;
 
   switch (boundary_type)
@@ -848,7 +948,7 @@ gtk_text_view_get_text_after (GtkTextView           *view,
   GtkTextIter pos, start, end;
 
   buffer = gtk_text_view_get_buffer (view);
-  gtk_text_buffer_get_iter_at_offset (buffer, &pos, offset);
+  gtk_text_buffer_get_iter_at_offset_cached (buffer, &pos, offset);
   start = end = pos;
 
   switch (boundary_type)
@@ -946,7 +1046,7 @@ gtk_text_view_get_string_at (GtkTextView           *view,
   GtkTextIter pos, start, end;
 
   buffer = gtk_text_view_get_buffer (view);
-  gtk_text_buffer_get_iter_at_offset (buffer, &pos, offset);
+  gtk_text_buffer_get_iter_at_offset_cached (buffer, &pos, offset);
   start = end = pos;
 
   if (granularity == ATSPI_TEXT_GRANULARITY_CHAR)
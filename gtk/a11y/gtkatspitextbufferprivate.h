@@ -25,6 +25,10 @@ G_BEGIN_DECLS
 
 void gtk_text_view_add_default_attributes (GtkTextView     *view,
                                            GVariantBuilder *builder);
+void gtk_text_buffer_get_iter_at_offset_cached (GtkTextBuffer *buffer,
+                                                GtkTextIter   *iter,
+                                                int            offset);
+
 void gtk_text_buffer_get_run_attributes   (GtkTextBuffer   *buffer,
                                            GVariantBuilder *builder,
                                            int              offset,
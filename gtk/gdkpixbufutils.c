@@ -22,6 +22,10 @@
 
 #include "gdk/gdktextureprivate.h"
 
+#include <glib/gstdio.h>
+#include <errno.h>
+#include <string.h>
+
 static GdkPixbuf *
 load_from_stream (GdkPixbufLoader  *loader,
                   GInputStream     *stream,
@@ -277,42 +281,6 @@ load_symbolic_svg (const char     *escaped_file_data,
   return pixbuf;
 }
 
-static void
-extract_plane (GdkPixbuf *src,
-               GdkPixbuf *dst,
-               int        from_plane,
-               int        to_plane)
-{
-  guchar *src_data, *dst_data;
-  int width, height, src_stride, dst_stride;
-  guchar *src_row, *dst_row;
-  int x, y;
-
-  width = gdk_pixbuf_get_width (src);
-  height = gdk_pixbuf_get_height (src);
-
-  g_assert (width <= gdk_pixbuf_get_width (dst));
-  g_assert (height <= gdk_pixbuf_get_height (dst));
-
-  src_stride = gdk_pixbuf_get_rowstride (src);
-  src_data = gdk_pixbuf_get_pixels (src);
-
-  dst_data = gdk_pixbuf_get_pixels (dst);
-  dst_stride = gdk_pixbuf_get_rowstride (dst);
-
-  for (y = 0; y < height; y++)
-    {
-      src_row = src_data + src_stride * y;
-      dst_row = dst_data + dst_stride * y;
-      for (x = 0; x < width; x++)
-        {
-          dst_row[to_plane] = src_row[from_plane];
-          src_row += 4;
-          dst_row += 4;
-        }
-    }
-}
-
 GdkPixbuf *
 gtk_make_symbolic_pixbuf_from_data (const char  *file_data,
                                     gsize        file_len,
@@ -323,13 +291,9 @@ gtk_make_symbolic_pixbuf_from_data (const char  *file_data,
                                     GError     **error)
 
 {
-  const char *r_string = "rgb(255,0,0)";
-  const char *g_string = "rgb(0,255,0)";
   char *icon_width_str;
   char *icon_height_str;
-  GdkPixbuf *loaded;
-  GdkPixbuf *pixbuf = NULL;
-  int plane;
+  GdkPixbuf *pixbuf;
   int icon_width, icon_height;
   char *escaped_file_data;
 
@@ -357,66 +321,395 @@ gtk_make_symbolic_pixbuf_from_data (const char  *file_data,
   if (height == 0)
     height = icon_height * scale;
 
-  for (plane = 0; plane < 3; plane++)
+  /* Here we render the svg with all colors solid, this should
+   * always make the alpha channel the same and it should match
+   * the final alpha channel for all possible renderings. We
+   * Just use it as-is for final alpha.
+   *
+   * The fg color is rendered as black and the 3 non-fg colors
+   * as pure red, green and blue. As the colors don't share any
+   * channel, each of the rgb channels then describes the amount
+   * of one of the colors in the opaque part of the color, with
+   * the color of the fg being implicitly the "rest", as all color
+   * fractions should add up to 1. That is exactly what we store,
+   * so a single rendering is all we need.
+   */
+  pixbuf = load_symbolic_svg (escaped_file_data, width, height,
+                              icon_width_str,
+                              icon_height_str,
+                              "rgb(0,0,0)",
+                              "rgb(255,0,0)",
+                              "rgb(0,255,0)",
+                              "rgb(0,0,255)",
+                              error);
+
+  if (pixbuf && debug_output_basename)
+    {
+      char *filename;
+
+      filename = g_strdup_printf ("%s.debug.png", debug_output_basename);
+      g_print ("Writing %s\n", filename);
+      gdk_pixbuf_save (pixbuf, filename, "png", NULL, NULL);
+      g_free (filename);
+    }
+
+  g_free (escaped_file_data);
+  g_free (icon_width_str);
+  g_free (icon_height_str);
+
+  return pixbuf;
+}
+
+/* Rendering symbolic icons needs to parse and render SVG, which is
+ * slow enough to be noticeable when a window with many icons first
+ * appears. So we keep the rendered icons in a per-user cache on disk,
+ * one file per icon, size and scale, which we just map on later loads.
+ *
+ * A cache file consists of a header and the unpadded pixels.
+ *
+ * Nothing tells us when an icon is not needed anymore, so the first
+ * time a process adds an entry, it prunes the cache in a thread:
+ * entries older than SYMBOLIC_CACHE_MAX_AGE are removed, and then the
+ * oldest ones until the cache is below SYMBOLIC_CACHE_MAX_SIZE.
+ * Entries that are still in use are created again when they are
+ * needed next.
+ */
+#define SYMBOLIC_CACHE_MAGIC "GTKSYM01"
+#define SYMBOLIC_CACHE_MAX_AGE (30 * 24 * 60 * 60)
+#define SYMBOLIC_CACHE_MAX_SIZE (32 * 1024 * 1024)
+
+typedef struct
+{
+  char magic[8];
+  guint32 width;
+  guint32 height;
+} SymbolicCacheHeader;
+
+static char *
+symbolic_cache_get_dir (void)
+{
+  return g_build_filename (g_get_user_cache_dir (), "gtk-4.0", "symbolic", NULL);
+}
+
+static char *
+symbolic_cache_get_path (const char *key,
+                         int         width,
+                         int         height,
+                         double      scale)
+{
+  GChecksum *checksum;
+  char *size_str;
+  char *basename;
+  char *dir;
+  char *path;
+
+  size_str = g_strdup_printf ("%d %d %g", width, height, scale);
+  checksum = g_checksum_new (G_CHECKSUM_SHA1);
+  g_checksum_update (checksum, (const guchar *) key, -1);
+  g_checksum_update (checksum, (const guchar *) size_str, -1);
+  basename = g_strconcat (g_checksum_get_string (checksum), ".cache", NULL);
+  dir = symbolic_cache_get_dir ();
+  path = g_build_filename (dir, basename, NULL);
+
+  g_free (dir);
+  g_free (basename);
+  g_checksum_free (checksum);
+  g_free (size_str);
+
+  return path;
+}
+
+static GdkPixbuf *
+symbolic_cache_load (const char *path)
+{
+  SymbolicCacheHeader header;
+  GMappedFile *file;
+  GBytes *bytes, *pixels;
+  GdkPixbuf *pixbuf;
+  gsize size;
+  int width, height;
+
+  file = g_mapped_file_new (path, FALSE, NULL);
+  if (file == NULL)
+    return NULL;
+
+  bytes = g_mapped_file_get_bytes (file);
+  g_mapped_file_unref (file);
+
+  size = g_bytes_get_size (bytes);
+  if (size < sizeof (header))
+    {
+      g_bytes_unref (bytes);
+      return NULL;
+    }
+
+  memcpy (&header, g_bytes_get_data (bytes, NULL), sizeof (header));
+  width = GUINT32_FROM_LE (header.width);
+  height = GUINT32_FROM_LE (header.height);
+
+  if (memcmp (header.magic, SYMBOLIC_CACHE_MAGIC, sizeof (header.magic)) != 0 ||
+      width <= 0 || height <= 0 || width > G_MAXINT / 4 ||
+      size - sizeof (header) != (gsize) width * height * 4)
+    {
+      g_bytes_unref (bytes);
+      return NULL;
+    }
+
+  pixels = g_bytes_new_from_bytes (bytes, sizeof (header), size - sizeof (header));
+  pixbuf = gdk_pixbuf_new_from_bytes (pixels, GDK_COLORSPACE_RGB, TRUE, 8,
+                                      width, height, width * 4);
+
+  g_bytes_unref (pixels);
+  g_bytes_unref (bytes);
+
+  return pixbuf;
+}
+
+typedef struct
+{
+  char *path;
+  gint64 mtime;
+  gsize size;
+} SymbolicCacheEntry;
+
+static int
+compare_entry_mtime (gconstpointer a,
+                     gconstpointer b)
+{
+  const SymbolicCacheEntry *ea = a;
+  const SymbolicCacheEntry *eb = b;
+
+  if (ea->mtime < eb->mtime)
+    return -1;
+  else if (ea->mtime > eb->mtime)
+    return 1;
+  else
+    return 0;
+}
+
+static void
+clear_entry (gpointer data)
+{
+  SymbolicCacheEntry *entry = data;
+
+  g_free (entry->path);
+}
+
+/*<private>
+ * gtk_symbolic_cache_prune:
+ * @max_age: the age in seconds after which entries are removed
+ * @max_size: the size in bytes that the cache is trimmed to
+ *
+ * Removes the entries of the symbolic icon cache that were written
+ * more than @max_age seconds ago, and then the oldest entries until
+ * the files in the cache use at most @max_size bytes.
+ */
+void
+gtk_symbolic_cache_prune (gint64 max_age,
+                          gsize  max_size)
+{
+  GArray *entries;
+  const char *name;
+  char *dir_path;
+  GDir *dir;
+  gint64 now;
+  gsize total_size;
+  guint i;
+
+  dir_path = symbolic_cache_get_dir ();
+  dir = g_dir_open (dir_path, 0, NULL);
+  if (dir == NULL)
+    {
+      g_free (dir_path);
+      return;
+    }
+
+  entries = g_array_new (FALSE, FALSE, sizeof (SymbolicCacheEntry));
+  g_array_set_clear_func (entries, clear_entry);
+  now = g_get_real_time () / G_USEC_PER_SEC;
+  total_size = 0;
+
+  while ((name = g_dir_read_name (dir)) != NULL)
     {
-      /* Here we render the svg with all colors solid, this should
-       * always make the alpha channel the same and it should match
-       * the final alpha channel for all possible renderings. We
-       * Just use it as-is for final alpha.
-       *
-       * For the 3 non-fg colors, we render once each with that
-       * color as red, and every other color as green. The resulting
-       * red will describe the amount of that color is in the
-       * opaque part of the color. We store these as the rgb
-       * channels, with the color of the fg being implicitly
-       * the "rest", as all color fractions should add up to 1.
-       */
-      loaded = load_symbolic_svg (escaped_file_data, width, height,
-                                  icon_width_str,
-                                  icon_height_str,
-                                  g_string,
-                                  plane == 0 ? r_string : g_string,
-                                  plane == 1 ? r_string : g_string,
-                                  plane == 2 ? r_string : g_string,
-                                  error);
-      if (loaded == NULL)
-        goto out;
-
-      if (debug_output_basename)
+      SymbolicCacheEntry entry;
+      GStatBuf buf;
+
+      if (!g_str_has_suffix (name, ".cache"))
+        continue;
+
+      entry.path = g_build_filename (dir_path, name, NULL);
+      if (g_stat (entry.path, &buf) != 0)
         {
-          char *filename;
+          g_free (entry.path);
+          continue;
+        }
 
-          filename = g_strdup_printf ("%s.debug%d.png", debug_output_basename, plane);
-          g_print ("Writing %s\n", filename);
-          gdk_pixbuf_save (loaded, filename, "png", NULL, NULL);
-          g_free (filename);
+      if (now - (gint64) buf.st_mtime > max_age)
+        {
+          g_remove (entry.path);
+          g_free (entry.path);
+          continue;
         }
 
-      if (pixbuf == NULL)
+      entry.mtime = buf.st_mtime;
+      entry.size = buf.st_size;
+      total_size += entry.size;
+      g_array_append_val (entries, entry);
+    }
+
+  if (total_size > max_size)
+    {
+      g_array_sort (entries, compare_entry_mtime);
+
+      for (i = 0; i < entries->len && total_size > max_size; i++)
         {
-          pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8,
-                                   gdk_pixbuf_get_width (loaded),
-                                   gdk_pixbuf_get_height (loaded));
-          gdk_pixbuf_fill (pixbuf, 0);
+          SymbolicCacheEntry *entry = &g_array_index (entries, SymbolicCacheEntry, i);
+
+          if (g_remove (entry->path) == 0)
+            total_size -= entry->size;
         }
+    }
+
+  g_array_unref (entries);
+  g_dir_close (dir);
+  g_free (dir_path);
+}
+
+static void
+symbolic_cache_prune_thread (GTask        *task,
+                             gpointer      source_object,
+                             gpointer      task_data,
+                             GCancellable *cancellable)
+{
+  gtk_symbolic_cache_prune (SYMBOLIC_CACHE_MAX_AGE, SYMBOLIC_CACHE_MAX_SIZE);
+}
 
-      if (plane == 0)
-        extract_plane (loaded, pixbuf, 3, 3);
+static void
+symbolic_cache_maybe_prune (void)
+{
+  static gsize pruned = 0;
 
-      extract_plane (loaded, pixbuf, 0, plane);
+  if (g_once_init_enter (&pruned))
+    {
+      GTask *task;
 
-      g_object_unref (loaded);
+      task = g_task_new (NULL, NULL, NULL, NULL);
+      g_task_set_source_tag (task, symbolic_cache_maybe_prune);
+      g_task_run_in_thread (task, symbolic_cache_prune_thread);
+      g_object_unref (task);
+
+      g_once_init_leave (&pruned, 1);
     }
+}
 
-  g_free (escaped_file_data);
+static void
+symbolic_cache_save (const char *path,
+                     GdkPixbuf  *pixbuf)
+{
+  SymbolicCacheHeader header;
+  const guchar *pixels;
+  char *contents, *p;
+  char *dir;
+  gsize size, row_size;
+  int width, height, stride, y;
+
+  width = gdk_pixbuf_get_width (pixbuf);
+  height = gdk_pixbuf_get_height (pixbuf);
+  stride = gdk_pixbuf_get_rowstride (pixbuf);
+  pixels = gdk_pixbuf_read_pixels (pixbuf);
+  row_size = (gsize) width * 4;
+
+  g_assert (gdk_pixbuf_get_n_channels (pixbuf) == 4);
+
+  memcpy (header.magic, SYMBOLIC_CACHE_MAGIC, sizeof (header.magic));
+  header.width = GUINT32_TO_LE (width);
+  header.height = GUINT32_TO_LE (height);
+
+  size = sizeof (header) + row_size * height;
+  p = contents = g_malloc (size);
+
+  memcpy (p, &header, sizeof (header));
+  p += sizeof (header);
+  for (y = 0; y < height; y++)
+    {
+      memcpy (p, pixels + y * stride, row_size);
+      p += row_size;
+    }
 
-out:
-  g_free (icon_width_str);
-  g_free (icon_height_str);
+  dir = g_path_get_dirname (path);
+
+  /* Other processes may load the file while we write it, but
+   * g_file_set_contents() replaces it atomically.
+   */
+  if (g_mkdir_with_parents (dir, 0755) == 0 &&
+      g_file_set_contents (path, contents, size, NULL))
+    symbolic_cache_maybe_prune ();
+
+  g_free (dir);
+  g_free (contents);
+}
+
+/* Like gtk_make_symbolic_pixbuf_from_data(), but uses the cache entry
+ * for @key if there is one, and creates it otherwise. The icon data is
+ * only needed in that case, so it is only then obtained from @get_data.
+ */
+static GdkPixbuf *
+make_symbolic_pixbuf_cached (const char  *key,
+                             int          width,
+                             int          height,
+                             double       scale,
+                             GBytes     *(* get_data) (gpointer, GError **),
+                             gpointer     get_data_arg,
+                             GError     **error)
+{
+  GdkPixbuf *pixbuf;
+  GBytes *bytes;
+  char *path;
+
+  path = symbolic_cache_get_path (key, width, height, scale);
+
+  pixbuf = symbolic_cache_load (path);
+  if (pixbuf == NULL)
+    {
+      bytes = get_data (get_data_arg, error);
+      if (bytes)
+        {
+          gsize size;
+          const char *data = g_bytes_get_data (bytes, &size);
+
+          pixbuf = gtk_make_symbolic_pixbuf_from_data (data, size, width, height, scale, NULL, error);
+          if (pixbuf)
+            symbolic_cache_save (path, pixbuf);
+
+          g_bytes_unref (bytes);
+        }
+    }
+
+  g_free (path);
 
   return pixbuf;
 }
 
+static GBytes *
+get_resource_data (gpointer   data,
+                   GError   **error)
+{
+  return g_resources_lookup_data (data, G_RESOURCE_LOOKUP_FLAGS_NONE, error);
+}
+
+static GBytes *
+get_path_data (gpointer   data,
+               GError   **error)
+{
+  char *contents;
+  gsize size;
+
+  if (!g_file_get_contents (data, &contents, &size, error))
+    return NULL;
+
+  return g_bytes_new_take (contents, size);
+}
+
 GdkPixbuf *
 gtk_make_symbolic_pixbuf_from_resource (const char  *path,
                                         int          width,
@@ -424,20 +717,25 @@ gtk_make_symbolic_pixbuf_from_resource (const char  *path,
                                         double       scale,
                                         GError     **error)
 {
-  GBytes *bytes;
-  const char *data;
   gsize size;
+  char *key;
   GdkPixbuf *pixbuf;
 
-  bytes = g_resources_lookup_data (path, G_RESOURCE_LOOKUP_FLAGS_NONE, error);
-  if (bytes == NULL)
+  if (!g_resources_get_info (path, G_RESOURCE_LOOKUP_FLAGS_NONE, &size, NULL, error))
     return NULL;
 
-  data = g_bytes_get_data (bytes, &size);
+  /* Resources have no mtime, so we key on their path and size, like
+   * files, and only look at the data when the icon isn't cached. An
+   * icon that changes without changing its size is picked up once its
+   * entry is pruned.
+   */
+  key = g_strdup_printf ("resource://%s\n%" G_GSIZE_FORMAT, path, size);
 
-  pixbuf = gtk_make_symbolic_pixbuf_from_data (data, size, width, height, scale, NULL, error);
+  pixbuf = make_symbolic_pixbuf_cached (key, width, height, scale,
+                                        get_resource_data, (gpointer) path,
+                                        error);
 
-  g_bytes_unref (bytes);
+  g_free (key);
 
   return pixbuf;
 }
@@ -449,16 +747,31 @@ gtk_make_symbolic_pixbuf_from_path (const char  *path,
                                     double       scale,
                                     GError     **error)
 {
-  char *data;
-  gsize size;
+  GStatBuf buf;
+  char *key;
   GdkPixbuf *pixbuf;
 
-  if (!g_file_get_contents (path, &data, &size, error))
-    return NULL;
+  /* Files are keyed on their path, size and mtime, so we don't
+   * even need to read them when they are in the cache.
+   */
+  if (g_stat (path, &buf) != 0)
+    {
+      int errsv = errno;
 
-  pixbuf = gtk_make_symbolic_pixbuf_from_data (data, size, width, height, scale, NULL, error);
+      g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errsv),
+                   "Failed to get attributes of file “%s”: %s",
+                   path, g_strerror (errsv));
+      return NULL;
+    }
 
-  g_free (data);
+  key = g_strdup_printf ("%s\n%" G_GINT64_FORMAT "\n%" G_GINT64_FORMAT,
+                         path, (gint64) buf.st_mtime, (gint64) buf.st_size);
+
+  pixbuf = make_symbolic_pixbuf_cached (key, width, height, scale,
+                                        get_path_data, (gpointer) path,
+                                        error);
+
+  g_free (key);
 
   return pixbuf;
 }
@@ -472,8 +785,17 @@ gtk_make_symbolic_pixbuf_from_file (GFile       *file,
 {
   char *data;
   gsize size;
+  char *path;
   GdkPixbuf *pixbuf;
 
+  path = g_file_get_path (file);
+  if (path)
+    {
+      pixbuf = gtk_make_symbolic_pixbuf_from_path (path, width, height, scale, error);
+      g_free (path);
+      return pixbuf;
+    }
+
   if (!g_file_load_contents (file, NULL, &data, &size, NULL, error))
     return NULL;
 
@@ -68,6 +68,8 @@ GdkPixbuf *gtk_make_symbolic_pixbuf_from_resource   (const char    *path,
                                                      int            height,
                                                      double         scale,
                                                      GError       **error);
+void        gtk_symbolic_cache_prune                (gint64         max_age,
+                                                     gsize          max_size);
 GdkTexture *gtk_load_symbolic_texture_from_file     (GFile         *file);
 GdkTexture *gtk_make_symbolic_texture_from_file     (GFile         *file,
                                                      int            width,
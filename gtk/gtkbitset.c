@@ -964,3 +964,85 @@ gtk_bitset_iter_is_valid (const GtkBitsetIter *iter)
 
   return riter->has_value;
 }
+
+/**
+ * gtk_bitset_iter_read_values:
+ * @iter: a pointer to a valid `GtkBitsetIter`
+ * @values: (out caller-allocates) (array length=n_values): array
+ *   to store the values in
+ * @n_values: the size of @values
+ *
+ * Stores up to @n_values values of the set in @values, starting
+ * with the current value of @iter, and moves @iter to the value
+ * after the last one stored.
+ *
+ * This is faster than calling [method@Gtk.BitsetIter.next]
+ * for every value.
+ *
+ * If fewer than @n_values values are stored, the end of the set
+ * was reached and @iter is invalidated.
+ *
+ * Returns: the number of values stored in @values
+ *
+ * Since: 4.6
+ */
+guint
+gtk_bitset_iter_read_values (GtkBitsetIter *iter,
+                             guint         *values,
+                             guint          n_values)
+{
+  roaring_uint32_iterator_t *riter = (roaring_uint32_iterator_t *) iter;
+
+  g_return_val_if_fail (iter != NULL, 0);
+  g_return_val_if_fail (values != NULL || n_values == 0, 0);
+
+  return roaring_read_uint32_iterator (riter, (uint32_t *) values, n_values);
+}
+
+/**
+ * gtk_bitset_iter_read_range_closed:
+ * @iter: a pointer to a `GtkBitsetIter`
+ * @first: (out) (optional): Set to the current value of @iter
+ * @last: (out) (optional): Set to the last value of the range
+ *
+ * Finds the range of consecutive values in the set that starts
+ * at the current value of @iter and moves @iter to the first value
+ * after that range.
+ *
+ * Both @first and @last are part of the range. Iterating over
+ * ranges is much faster than iterating over single values for
+ * sets that contain large ranges.
+ *
+ * If @iter is not valid, %FALSE is returned. If the range was
+ * the last one in the set, @iter is invalidated.
+ *
+ * Returns: %TRUE if a range was found
+ *
+ * Since: 4.6
+ */
+gboolean
+gtk_bitset_iter_read_range_closed (GtkBitsetIter *iter,
+                                   guint         *first,
+                                   guint         *last)
+{
+  roaring_uint32_iterator_t *riter = (roaring_uint32_iterator_t *) iter;
+  uint32_t range_first, range_last;
+
+  g_return_val_if_fail (iter != NULL, FALSE);
+
+  if (!roaring_read_range_uint32_iterator (riter, &range_first, &range_last))
+    {
+      if (first)
+        *first = 0;
+      if (last)
+        *last = 0;
+      return FALSE;
+    }
+
+  if (first)
+    *first = range_first;
+  if (last)
+    *last = range_last;
+
+  return TRUE;
+}
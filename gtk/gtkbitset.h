@@ -171,6 +171,14 @@ GDK_AVAILABLE_IN_ALL
 guint                   gtk_bitset_iter_get_value               (const GtkBitsetIter    *iter);
 GDK_AVAILABLE_IN_ALL
 gboolean                gtk_bitset_iter_is_valid                (const GtkBitsetIter    *iter);
+GDK_AVAILABLE_IN_4_6
+guint                   gtk_bitset_iter_read_values             (GtkBitsetIter          *iter,
+                                                                 guint                  *values,
+                                                                 guint                   n_values);
+GDK_AVAILABLE_IN_4_6
+gboolean                gtk_bitset_iter_read_range_closed       (GtkBitsetIter          *iter,
+                                                                 guint                  *first,
+                                                                 guint                  *last);
        
 
 
@@ -0,0 +1,338 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkcssimagecacheprivate.h"
+
+#include "gtkdebug.h"
+#include "gdkprofilerprivate.h"
+
+/*
+ * The image cache keeps the textures loaded for url() and
+ * -gtk-recolor() images around, so that reloading a theme, or
+ * switching between the light and dark variant of one, doesn't load
+ * and decode all of its images again. Parsing a style sheet creates
+ * new image objects, and those used to load their files anew.
+ *
+ * Recolored images share the texture loaded for their file, the colors
+ * of the palette are applied when drawing them, so the palette is not
+ * part of the key.
+ *
+ * Textures from resources never change. For native files, the
+ * modification time is kept, and checked the first time the file is
+ * used after a style sheet is loaded, so that edited images show up
+ * when the style sheet is reloaded without a stat for every image
+ * that is loaded. Other files are not cached.
+ *
+ * The cache is bounded by the size of the textures in it, with the
+ * least recently used entries being dropped first. When the theme
+ * changes, the entries that were not used by the last two themes are
+ * dropped too.
+ */
+
+#define MAX_CACHE_SIZE (32 * 1024 * 1024)
+
+/* Number of themes whose images are kept when the theme changes */
+#define MAX_THEMES 2
+
+typedef struct
+{
+  GFile *file;
+  GtkCssImageCacheKind kind;
+} CacheKey;
+
+typedef struct
+{
+  CacheKey key;
+  guint64 mtime;
+  guint validated;
+  guint theme;
+  GdkTexture *texture;
+  gsize size;
+  GList link;
+} CacheEntry;
+
+static GHashTable *cache;
+static GQueue lru = G_QUEUE_INIT;
+static gsize cache_size;
+
+/* Bumped when a style sheet is loaded and when the theme changes */
+static guint validation = 1;
+static guint theme = 1;
+
+static guint frame_hits, frame_loads;
+static guint hits_counter, loads_counter;
+
+static guint
+cache_key_hash (gconstpointer data)
+{
+  const CacheKey *key = data;
+
+  return g_file_hash (key->file) * 31 + key->kind;
+}
+
+static gboolean
+cache_key_equal (gconstpointer a,
+                 gconstpointer b)
+{
+  const CacheKey *ka = a;
+  const CacheKey *kb = b;
+
+  return ka->kind == kb->kind &&
+         g_file_equal (ka->file, kb->file);
+}
+
+static void
+cache_entry_free (gpointer data)
+{
+  CacheEntry *entry = data;
+
+  cache_size -= entry->size;
+
+  g_object_unref (entry->key.file);
+  g_object_unref (entry->texture);
+  g_free (entry);
+}
+
+static void
+ensure_cache (void)
+{
+  if (cache)
+    return;
+
+  cache = g_hash_table_new_full (cache_key_hash, cache_key_equal, NULL, cache_entry_free);
+
+  hits_counter = gdk_profiler_define_int_counter ("css-image-cache-hits", "CSS image texture cache hits");
+  loads_counter = gdk_profiler_define_int_counter ("css-image-loads", "CSS image textures loaded");
+}
+
+/* Returns FALSE if the file can't be cached */
+static gboolean
+can_cache (GFile *file)
+{
+  return g_file_has_uri_scheme (file, "resource") ||
+         g_file_is_native (file);
+}
+
+/* Returns FALSE if the modification time can't be found */
+static gboolean
+get_mtime (GFile   *file,
+           guint64 *mtime)
+{
+  GFileInfo *info;
+
+  if (g_file_has_uri_scheme (file, "resource"))
+    {
+      *mtime = 0;
+      return TRUE;
+    }
+
+  info = g_file_query_info (file,
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+                            G_FILE_QUERY_INFO_NONE,
+                            NULL,
+                            NULL);
+  if (info == NULL)
+    return FALSE;
+
+  *mtime = g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED) * G_USEC_PER_SEC
+           + g_file_info_get_attribute_uint32 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+
+  g_object_unref (info);
+
+  return TRUE;
+}
+
+static void
+cache_remove (CacheEntry *entry)
+{
+  g_queue_unlink (&lru, &entry->link);
+  g_hash_table_remove (cache, &entry->key);
+}
+
+/*<private>
+ * gtk_css_image_cache_load:
+ * @file: the file to load
+ * @kind: what is loaded from the file
+ * @load_func: the function to load @file with
+ * @error: return location for an error
+ *
+ * Returns the texture for @file, loading it with @load_func if it
+ * is not in the cache.
+ *
+ * @load_func must always return the same texture for a file and
+ * @kind. Failed loads are not cached.
+ *
+ * Returns: (transfer full) (nullable): the texture
+ */
+GdkTexture *
+gtk_css_image_cache_load (GFile                     *file,
+                          GtkCssImageCacheKind       kind,
+                          GtkCssImageCacheLoadFunc   load_func,
+                          GError                   **error)
+{
+  CacheEntry *entry;
+  CacheKey key;
+  GdkTexture *texture;
+  guint64 mtime;
+
+  if (GTK_DEBUG_CHECK (NO_CSS_CACHE) ||
+      !can_cache (file))
+    {
+      frame_loads++;
+      return load_func (file, error);
+    }
+
+  ensure_cache ();
+
+  key.file = file;
+  key.kind = kind;
+
+  entry = g_hash_table_lookup (cache, &key);
+  if (entry)
+    {
+      if (entry->validated != validation)
+        {
+          if (!get_mtime (file, &mtime) || entry->mtime != mtime)
+            {
+              cache_remove (entry);
+              entry = NULL;
+            }
+          else
+            entry->validated = validation;
+        }
+
+      if (entry)
+        {
+          frame_hits++;
+
+          entry->theme = theme;
+          g_queue_unlink (&lru, &entry->link);
+          g_queue_push_head_link (&lru, &entry->link);
+
+          return g_object_ref (entry->texture);
+        }
+    }
+
+  frame_loads++;
+
+  if (!get_mtime (file, &mtime))
+    return load_func (file, error);
+
+  texture = load_func (file, error);
+  if (texture == NULL)
+    return NULL;
+
+  entry = g_new0 (CacheEntry, 1);
+  entry->key.file = g_object_ref (file);
+  entry->key.kind = kind;
+  entry->mtime = mtime;
+  entry->validated = validation;
+  entry->theme = theme;
+  entry->texture = g_object_ref (texture);
+  entry->size = (gsize) gdk_texture_get_width (texture) * gdk_texture_get_height (texture) * 4;
+  entry->link.data = entry;
+
+  g_hash_table_insert (cache, &entry->key, entry);
+  g_queue_push_head_link (&lru, &entry->link);
+  cache_size += entry->size;
+
+  /* Always keep the texture we just loaded */
+  while (cache_size > MAX_CACHE_SIZE && lru.length > 1)
+    cache_remove (g_queue_peek_tail (&lru));
+
+  return texture;
+}
+
+/*<private>
+ * gtk_css_image_cache_clear:
+ *
+ * Drops all textures from the cache.
+ */
+void
+gtk_css_image_cache_clear (void)
+{
+  if (cache == NULL)
+    return;
+
+  while (lru.length > 0)
+    cache_remove (g_queue_peek_tail (&lru));
+}
+
+/*<private>
+ * gtk_css_image_cache_revalidate:
+ *
+ * Makes the cache check the modification time of every file again
+ * the next time it is loaded. This is called when a style sheet is
+ * loaded, so that reloading it picks up edited images.
+ */
+void
+gtk_css_image_cache_revalidate (void)
+{
+  validation++;
+}
+
+/*<private>
+ * gtk_css_image_cache_theme_changed:
+ *
+ * Drops the textures that were not used by the current theme or the
+ * one before it, so that switching back and forth between two themes,
+ * or the light and dark variant of one, does not load their images
+ * again, while the images of older themes are not kept around.
+ */
+void
+gtk_css_image_cache_theme_changed (void)
+{
+  GList *l, *next;
+
+  if (cache)
+    {
+      for (l = lru.head; l; l = next)
+        {
+          CacheEntry *entry = l->data;
+
+          next = l->next;
+
+          if (theme - entry->theme >= MAX_THEMES)
+            cache_remove (entry);
+        }
+    }
+
+  theme++;
+  gtk_css_image_cache_revalidate ();
+}
+
+/*<private>
+ * gtk_css_image_cache_report_statistics:
+ *
+ * Reports the cache hits and loads since the last call
+ * to the profiler.
+ */
+void
+gtk_css_image_cache_report_statistics (void)
+{
+  if (cache && GDK_PROFILER_IS_RUNNING)
+    {
+      gdk_profiler_set_int_counter (hits_counter, frame_hits);
+      gdk_profiler_set_int_counter (loads_counter, frame_loads);
+    }
+
+  frame_hits = 0;
+  frame_loads = 0;
+}
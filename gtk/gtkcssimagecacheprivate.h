@@ -0,0 +1,45 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_CSS_IMAGE_CACHE_PRIVATE_H__
+#define __GTK_CSS_IMAGE_CACHE_PRIVATE_H__
+
+#include <gdk/gdk.h>
+
+G_BEGIN_DECLS
+
+typedef enum {
+  GTK_CSS_IMAGE_CACHE_TEXTURE,
+  GTK_CSS_IMAGE_CACHE_SYMBOLIC
+} GtkCssImageCacheKind;
+
+typedef GdkTexture * (* GtkCssImageCacheLoadFunc) (GFile   *file,
+                                                   GError **error);
+
+GdkTexture *    gtk_css_image_cache_load                (GFile                    *file,
+                                                         GtkCssImageCacheKind      kind,
+                                                         GtkCssImageCacheLoadFunc  load_func,
+                                                         GError                  **error);
+void            gtk_css_image_cache_clear               (void);
+void            gtk_css_image_cache_revalidate          (void);
+void            gtk_css_image_cache_theme_changed       (void);
+
+void            gtk_css_image_cache_report_statistics   (void);
+
+G_END_DECLS
+
+#endif /* __GTK_CSS_IMAGE_CACHE_PRIVATE_H__ */
@@ -20,6 +20,7 @@
 #include "config.h"
 
 #include "gtkcssimagerecolorprivate.h"
+#include "gtkcssimagecacheprivate.h"
 #include "gtkcssimageprivate.h"
 #include "gtkcsspalettevalueprivate.h"
 #include "gtkcsscolorvalueprivate.h"
@@ -93,37 +94,50 @@ lookup_symbolic_colors (GtkCssStyle *style,
     *error_out = *color_out;
 }
 
-static void
-gtk_css_image_recolor_load_texture (GtkCssImageRecolor  *recolor,
-                                    GError             **error)
+static GdkTexture *
+load_symbolic_texture (GFile   *file,
+                       GError **error)
 {
+  GdkTexture *texture;
   char *uri;
 
-  if (recolor->texture)
-    return;
+  uri = g_file_get_uri (file);
 
-  uri = g_file_get_uri (recolor->file);
-
-  if (g_file_has_uri_scheme (recolor->file, "resource"))
+  if (g_file_has_uri_scheme (file, "resource"))
     {
       char *resource_path = g_uri_unescape_string (uri + strlen ("resource://"), NULL);
 
       if (g_str_has_suffix (uri, ".symbolic.png"))
-        recolor->texture = gtk_load_symbolic_texture_from_resource (resource_path);
+        texture = gtk_load_symbolic_texture_from_resource (resource_path);
       else
-        recolor->texture = gtk_make_symbolic_texture_from_resource (resource_path, 0, 0, 1.0, NULL);
+        texture = gtk_make_symbolic_texture_from_resource (resource_path, 0, 0, 1.0, error);
 
       g_free (resource_path);
     }
   else
     {
       if (g_str_has_suffix (uri, ".symbolic.png"))
-        recolor->texture = gtk_load_symbolic_texture_from_file (recolor->file);
+        texture = gtk_load_symbolic_texture_from_file (file);
       else
-        recolor->texture = gtk_make_symbolic_texture_from_file (recolor->file, 0, 0, 1.0, NULL);
+        texture = gtk_make_symbolic_texture_from_file (file, 0, 0, 1.0, error);
     }
 
   g_free (uri);
+
+  return texture;
+}
+
+static void
+gtk_css_image_recolor_load_texture (GtkCssImageRecolor  *recolor,
+                                    GError             **error)
+{
+  if (recolor->texture)
+    return;
+
+  recolor->texture = gtk_css_image_cache_load (recolor->file,
+                                               GTK_CSS_IMAGE_CACHE_SYMBOLIC,
+                                               load_symbolic_texture,
+                                               error);
 }
 
 static GtkCssImage *
@@ -23,6 +23,7 @@
 
 #include "gtkcssimageurlprivate.h"
 
+#include "gtkcssimagecacheprivate.h"
 #include "gtkcssimageinvalidprivate.h"
 #include "gtkcssimagepaintableprivate.h"
 #include "gtkstyleproviderprivate.h"
@@ -31,6 +32,31 @@
 
 G_DEFINE_TYPE (GtkCssImageUrl, _gtk_css_image_url, GTK_TYPE_CSS_IMAGE)
 
+static GdkTexture *
+load_texture (GFile   *file,
+              GError **error)
+{
+  GdkTexture *texture;
+
+  /* We special case resources here so we can use gdk_texture_new_from_resource. */
+  if (g_file_has_uri_scheme (file, "resource"))
+    {
+      char *uri = g_file_get_uri (file);
+      char *resource_path = g_uri_unescape_string (uri + strlen ("resource://"), NULL);
+
+      texture = gdk_texture_new_from_resource (resource_path);
+
+      g_free (resource_path);
+      g_free (uri);
+    }
+  else
+    {
+      texture = gdk_texture_new_from_file (file, error);
+    }
+
+  return texture;
+}
+
 static GtkCssImage *
 gtk_css_image_url_load_image (GtkCssImageUrl  *url,
                               GError         **error)
@@ -47,21 +73,10 @@ gtk_css_image_url_load_image (GtkCssImageUrl  *url,
       return url->loaded_image;
     }
 
-  /* We special case resources here so we can use gdk_texture_new_from_resource. */
-  if (g_file_has_uri_scheme (url->file, "resource"))
-    {
-      char *uri = g_file_get_uri (url->file);
-      char *resource_path = g_uri_unescape_string (uri + strlen ("resource://"), NULL);
-
-      texture = gdk_texture_new_from_resource (resource_path);
-
-      g_free (resource_path);
-      g_free (uri);
-    }
-  else
-    {
-      texture = gdk_texture_new_from_file (url->file, &local_error);
-    }
+  texture = gtk_css_image_cache_load (url->file,
+                                      GTK_CSS_IMAGE_CACHE_TEXTURE,
+                                      load_texture,
+                                      &local_error);
 
   if (texture == NULL)
     {
@@ -24,6 +24,7 @@
 #include "gtk/css/gtkcssparserprivate.h"
 #include "gtkbitmaskprivate.h"
 #include "gtkcssarrayvalueprivate.h"
+#include "gtkcssimagecacheprivate.h"
 #include "gtkcsscolorvalueprivate.h"
 #include "gtkcsskeyframesprivate.h"
 #include "gtkcssselectorprivate.h"
@@ -1027,6 +1028,10 @@ gtk_css_provider_load_internal (GtkCssProvider *self,
 
   before = GDK_PROFILER_CURRENT_TIME;
 
+  /* Images that were edited since the last load show up */
+  if (parent == NULL)
+    gtk_css_image_cache_revalidate ();
+
   if (bytes == NULL)
     {
       GError *load_error = NULL;
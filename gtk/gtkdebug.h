@@ -55,6 +55,7 @@ G_BEGIN_DECLS
  * @GTK_DEBUG_BUILDER_OBJECTS: Log unused GtkBuilder objects
  * @GTK_DEBUG_A11Y: Information about accessibility state changes
  * @GTK_DEBUG_ICONFALLBACK: Information about icon fallback. Since: 4.2
+ * @GTK_DEBUG_NO_SHAPING_CACHE: Don't share laid out text between widgets. Since: 4.6
  *
  * Flags to use with gtk_set_debug_flags().
  *
@@ -82,6 +83,7 @@ typedef enum {
   GTK_DEBUG_BUILDER_OBJECTS = 1 << 16,
   GTK_DEBUG_A11Y            = 1 << 17,
   GTK_DEBUG_ICONFALLBACK    = 1 << 18,
+  GTK_DEBUG_NO_SHAPING_CACHE = 1 << 19,
 } GtkDebugFlags;
 
 #ifdef G_ENABLE_DEBUG
@@ -26,7 +26,7 @@
 #include "gtkentry.h"
 #include "gtkflowboxprivate.h"
 #include "gtkstack.h"
-#include "gtklabel.h"
+#include "gtklabelprivate.h"
 #include "gtkgesturelongpress.h"
 #include "gtkpopover.h"
 #include "gtkscrolledwindow.h"
@@ -572,7 +572,7 @@ add_emoji (GtkWidget    *box,
   gtk_label_set_attributes (GTK_LABEL (label), attrs);
   pango_attr_list_unref (attrs);
 
-  layout = gtk_label_get_layout (GTK_LABEL (label));
+  layout = _gtk_label_peek_layout (GTK_LABEL (label));
   pango_layout_get_extents (layout, &rect, NULL);
 
   /* Check for fallback rendering that generates too wide items */
@@ -159,26 +159,47 @@ gtk_filter_list_model_run_filter (GtkFilterListModel *self,
                                   guint               n_steps)
 {
   GtkBitsetIter iter;
-  guint i, pos;
-  gboolean more;
+  guint i, pos, first, last;
 
   g_return_if_fail (GTK_IS_FILTER_LIST_MODEL (self));
   
   if (self->pending == NULL)
     return;
 
-  for (i = 0, more = gtk_bitset_iter_init_first (&iter, self->pending, &pos);
-       i < n_steps && more;
-       i++, more = gtk_bitset_iter_next (&iter, &pos))
+  pos = last = 0;
+  i = 0;
+  gtk_bitset_iter_init_first (&iter, self->pending, NULL);
+  while (i < n_steps && gtk_bitset_iter_read_range_closed (&iter, &first, &last))
     {
-      if (gtk_filter_list_model_run_filter_on_item (self, pos))
-        gtk_bitset_add (self->matches, pos);
+      guint match_start = G_MAXUINT;
+
+      /* Add runs of matching items as ranges */
+      for (pos = first; ; pos++)
+        {
+          if (gtk_filter_list_model_run_filter_on_item (self, pos))
+            {
+              if (match_start == G_MAXUINT)
+                match_start = pos;
+            }
+          else if (match_start != G_MAXUINT)
+            {
+              gtk_bitset_add_range_closed (self->matches, match_start, pos - 1);
+              match_start = G_MAXUINT;
+            }
+
+          i++;
+          if (pos == last || i == n_steps)
+            break;
+        }
+
+      if (match_start != G_MAXUINT)
+        gtk_bitset_add_range_closed (self->matches, match_start, pos);
     }
 
-  if (more)
-    gtk_bitset_remove_range_closed (self->pending, 0, pos - 1);
-  else
+  if (pos == last && !gtk_bitset_iter_is_valid (&iter))
     g_clear_pointer (&self->pending, gtk_bitset_unref);
+  else if (i > 0)
+    gtk_bitset_remove_range_closed (self->pending, 0, pos);
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PENDING]);
 
   return;
@@ -0,0 +1,525 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkflightrecorderprivate.h"
+
+#include "gtknative.h"
+
+#include <errno.h>
+#include <glib/gstdio.h>
+
+#ifdef G_OS_UNIX
+#include <glib-unix.h>
+#include <signal.h>
+#endif
+
+/*
+ * The flight recorder keeps the render node trees, timings and input
+ * events of the last frames of the application, so that rare slow
+ * frames can be looked at after the fact. It is turned on with the
+ * GTK_FLIGHT_RECORDER environment variable, and writes what it has
+ * recorded to disk when a frame takes longer than a threshold, or
+ * when the process receives SIGUSR2. The inspector can open these
+ * recordings.
+ *
+ * Keeping the trees around is cheap: widgets reuse the render nodes
+ * of the parts of the window that did not change, so consecutive
+ * frames share most of their nodes, and the recorder only holds a
+ * reference to the root of each frame.
+ *
+ * A frame is measured from the start of the frame clock cycle, so
+ * that event handling and layout count as well as the rendering.
+ * Writing a recording serializes many render nodes, which would make
+ * the next frame slow too, so it happens in a thread, on references
+ * to the recorded frames.
+ */
+
+#define MAX_FRAMES 64
+#define MAX_EVENTS 256
+
+/* In milliseconds */
+#define DEFAULT_THRESHOLD 50
+
+/* Don't write a recording for every frame of a series of slow ones */
+#define MIN_DUMP_INTERVAL (10 * G_USEC_PER_SEC)
+
+typedef struct
+{
+  GskRenderNode *node;
+  const char *widget_type;
+  GdkRectangle area;
+  cairo_region_t *region;
+  gint64 frame_time;
+  gint64 frame_start;
+  gint64 snapshot_start;
+  gint64 render_start;
+  gint64 render_end;
+} Frame;
+
+typedef struct
+{
+  gint64 time;
+  GdkEventType type;
+} Event;
+
+/* What gets written to disk, copied from the ring buffers */
+typedef struct
+{
+  char *reason;
+  char *program;
+  char *path;
+  Frame *frames;
+  guint n_frames;
+  Event *events;
+  guint n_events;
+} Dump;
+
+static struct
+{
+  gboolean initialized;
+  gboolean enabled;
+  char *directory;
+  gint64 threshold;
+  gint64 last_dump;
+  gboolean dumping;
+
+  /* Ring buffers, indexed by the number of recorded items */
+  Frame frames[MAX_FRAMES];
+  guint64 n_frames;
+  Event events[MAX_EVENTS];
+  guint64 n_events;
+} recorder;
+
+static void
+frame_clear (Frame *frame)
+{
+  g_clear_pointer (&frame->node, gsk_render_node_unref);
+  g_clear_pointer (&frame->region, cairo_region_destroy);
+}
+
+static Dump *dump_new   (const char  *reason);
+static void  dump_free  (Dump        *dump);
+static char *dump_write (Dump        *dump,
+                         GError     **error);
+
+static void
+dump_thread (GTask        *task,
+             gpointer      source_object,
+             gpointer      task_data,
+             GCancellable *cancellable)
+{
+  GError *error = NULL;
+  char *filename;
+
+  filename = dump_write (task_data, &error);
+  if (filename)
+    g_task_return_pointer (task, filename, g_free);
+  else
+    g_task_return_error (task, error);
+}
+
+static void
+dump_done (GObject      *source_object,
+           GAsyncResult *result,
+           gpointer      user_data)
+{
+  Dump *dump = g_task_get_task_data (G_TASK (result));
+  GError *error = NULL;
+  char *filename;
+
+  recorder.dumping = FALSE;
+
+  filename = g_task_propagate_pointer (G_TASK (result), &error);
+  if (filename)
+    {
+      g_message ("%s, flight recording written to %s", dump->reason, filename);
+      g_free (filename);
+    }
+  else
+    {
+      g_warning ("Failed to write flight recording: %s", error->message);
+      g_error_free (error);
+    }
+}
+
+static void
+dump_and_report (const char *reason)
+{
+  GTask *task;
+
+  if (recorder.dumping)
+    return;
+
+  recorder.dumping = TRUE;
+
+  task = g_task_new (NULL, NULL, dump_done, NULL);
+  g_task_set_source_tag (task, dump_and_report);
+  g_task_set_task_data (task, dump_new (reason), (GDestroyNotify) dump_free);
+  g_task_run_in_thread (task, dump_thread);
+  g_object_unref (task);
+}
+
+#ifdef G_OS_UNIX
+static gboolean
+dump_on_signal (gpointer data)
+{
+  dump_and_report ("Received SIGUSR2");
+
+  return G_SOURCE_CONTINUE;
+}
+#endif
+
+void
+gtk_flight_recorder_init (void)
+{
+  const char *env;
+
+  if (recorder.initialized)
+    return;
+
+  recorder.initialized = TRUE;
+
+  env = g_getenv ("GTK_FLIGHT_RECORDER");
+  if (env == NULL)
+    return;
+
+  if (env[0] != '\0')
+    recorder.directory = g_strdup (env);
+  else
+    recorder.directory = g_build_filename (g_get_user_cache_dir (), "gtk-4.0", "flight-recorder", NULL);
+
+  recorder.threshold = DEFAULT_THRESHOLD * 1000;
+  env = g_getenv ("GTK_FLIGHT_RECORDER_THRESHOLD");
+  if (env)
+    recorder.threshold = g_ascii_strtod (env, NULL) * 1000;
+
+  recorder.enabled = TRUE;
+
+#ifdef G_OS_UNIX
+  g_unix_signal_add (SIGUSR2, dump_on_signal, NULL);
+#endif
+}
+
+gboolean
+gtk_flight_recorder_is_enabled (void)
+{
+  return recorder.enabled;
+}
+
+void
+gtk_flight_recorder_record_event (GdkEvent *event)
+{
+  Event *mark;
+
+  if (!recorder.enabled)
+    return;
+
+  mark = &recorder.events[recorder.n_events % MAX_EVENTS];
+  mark->time = g_get_monotonic_time ();
+  mark->type = gdk_event_get_event_type (event);
+  recorder.n_events++;
+}
+
+/*
+ * gtk_flight_recorder_record_frame:
+ * @widget: the native widget that was rendered
+ * @region: the region of the surface that was redrawn
+ * @root: the render node that was rendered
+ * @snapshot_start: the monotonic time when the snapshot started
+ * @render_start: the monotonic time when rendering started
+ * @render_end: the monotonic time when rendering was done
+ *
+ * Adds a frame to the recording, replacing the oldest one, and
+ * writes the recording to disk if the frame took longer than
+ * the threshold, counted from the start of the frame clock cycle.
+ */
+void
+gtk_flight_recorder_record_frame (GtkWidget            *widget,
+                                  const cairo_region_t *region,
+                                  GskRenderNode        *root,
+                                  gint64                snapshot_start,
+                                  gint64                render_start,
+                                  gint64                render_end)
+{
+  GdkFrameClock *frame_clock;
+  GdkFrameTimings *timings;
+  GdkSurface *surface;
+  Frame *frame;
+
+  if (!recorder.enabled)
+    return;
+
+  frame = &recorder.frames[recorder.n_frames % MAX_FRAMES];
+  frame_clear (frame);
+
+  surface = gtk_native_get_surface (GTK_NATIVE (widget));
+  frame_clock = gtk_widget_get_frame_clock (widget);
+
+  frame->node = gsk_render_node_ref (root);
+  frame->widget_type = G_OBJECT_TYPE_NAME (widget);
+  frame->area = (GdkRectangle) { 0, 0, gdk_surface_get_width (surface), gdk_surface_get_height (surface) };
+  if (region)
+    frame->region = cairo_region_copy (region);
+  else
+    frame->region = cairo_region_create_rectangle (&frame->area);
+  frame->frame_time = frame_clock ? gdk_frame_clock_get_frame_time (frame_clock) : 0;
+
+  /* The frame time of the clock is smoothed, the one in the timings
+   * is when the frame clock cycle really started.
+   */
+  timings = frame_clock ? gdk_frame_clock_get_current_timings (frame_clock) : NULL;
+  frame->frame_start = timings ? gdk_frame_timings_get_frame_time (timings) : 0;
+  if (frame->frame_start == 0 || frame->frame_start > snapshot_start)
+    frame->frame_start = snapshot_start;
+
+  frame->snapshot_start = snapshot_start;
+  frame->render_start = render_start;
+  frame->render_end = render_end;
+
+  recorder.n_frames++;
+
+  if (recorder.threshold > 0 &&
+      render_end - frame->frame_start > recorder.threshold &&
+      render_end - recorder.last_dump > MIN_DUMP_INTERVAL)
+    {
+      char *reason;
+
+      reason = g_strdup_printf ("Frame took %.1f ms", (render_end - frame->frame_start) / 1000.);
+      dump_and_report (reason);
+      g_free (reason);
+    }
+}
+
+static const char *
+event_type_nick (GdkEventType type)
+{
+  GEnumClass *enum_class;
+  GEnumValue *value;
+
+  enum_class = g_type_class_ref (GDK_TYPE_EVENT_TYPE);
+  value = g_enum_get_value (enum_class, type);
+  g_type_class_unref (enum_class);
+
+  return value ? value->value_nick : "unknown";
+}
+
+static gboolean
+save_frame (GKeyFile    *keyfile,
+            const char  *path,
+            guint        index,
+            Frame       *frame,
+            GError     **error)
+{
+  char *group, *basename, *filename;
+  GBytes *bytes;
+  GArray *rects;
+  gboolean result;
+  int i, n;
+
+  basename = g_strdup_printf ("frame-%u.node", index);
+  filename = g_build_filename (path, basename, NULL);
+  bytes = gsk_render_node_serialize (frame->node);
+  result = g_file_set_contents (filename,
+                                g_bytes_get_data (bytes, NULL),
+                                g_bytes_get_size (bytes),
+                                error);
+  g_bytes_unref (bytes);
+  g_free (filename);
+
+  if (!result)
+    {
+      g_free (basename);
+      return FALSE;
+    }
+
+  n = cairo_region_num_rectangles (frame->region);
+  rects = g_array_sized_new (FALSE, FALSE, sizeof (int), 4 * n);
+  for (i = 0; i < n; i++)
+    {
+      cairo_rectangle_int_t rect;
+
+      cairo_region_get_rectangle (frame->region, i, &rect);
+      g_array_append_vals (rects, (int[4]) { rect.x, rect.y, rect.width, rect.height }, 4);
+    }
+
+  group = g_strdup_printf ("Frame %u", index);
+  g_key_file_set_string (keyfile, group, "node", basename);
+  g_key_file_set_string (keyfile, group, "widget", frame->widget_type);
+  g_key_file_set_integer_list (keyfile, group, "area",
+                               (int[4]) { frame->area.x, frame->area.y, frame->area.width, frame->area.height }, 4);
+  g_key_file_set_integer_list (keyfile, group, "region", (int *) rects->data, rects->len);
+  g_key_file_set_int64 (keyfile, group, "frame-time", frame->frame_time);
+  g_key_file_set_int64 (keyfile, group, "frame-start", frame->frame_start);
+  g_key_file_set_int64 (keyfile, group, "snapshot-start", frame->snapshot_start);
+  g_key_file_set_int64 (keyfile, group, "render-start", frame->render_start);
+  g_key_file_set_int64 (keyfile, group, "render-end", frame->render_end);
+
+  g_array_unref (rects);
+  g_free (group);
+  g_free (basename);
+
+  return TRUE;
+}
+
+static Dump *
+dump_new (const char *reason)
+{
+  GDateTime *now;
+  char *dirname, *timestamp;
+  guint64 first;
+  Dump *dump;
+  guint i;
+
+  recorder.last_dump = g_get_monotonic_time ();
+
+  dump = g_new0 (Dump, 1);
+  dump->reason = g_strdup (reason);
+  dump->program = g_strdup (g_get_prgname ());
+
+  now = g_date_time_new_now_local ();
+  timestamp = g_date_time_format (now, "%Y%m%d-%H%M%S-%f");
+  dirname = g_strdup_printf ("%s-%s", dump->program ? dump->program : "gtk", timestamp);
+  dump->path = g_build_filename (recorder.directory, dirname, NULL);
+  g_date_time_unref (now);
+  g_free (timestamp);
+  g_free (dirname);
+
+  dump->n_frames = MIN (recorder.n_frames, MAX_FRAMES);
+  dump->frames = g_new (Frame, dump->n_frames);
+  first = recorder.n_frames - dump->n_frames;
+  for (i = 0; i < dump->n_frames; i++)
+    {
+      Frame *frame = &dump->frames[i];
+
+      *frame = recorder.frames[(first + i) % MAX_FRAMES];
+      frame->node = gsk_render_node_ref (frame->node);
+      frame->region = cairo_region_copy (frame->region);
+    }
+
+  dump->n_events = MIN (recorder.n_events, MAX_EVENTS);
+  dump->events = g_new (Event, dump->n_events);
+  first = recorder.n_events - dump->n_events;
+  for (i = 0; i < dump->n_events; i++)
+    dump->events[i] = recorder.events[(first + i) % MAX_EVENTS];
+
+  return dump;
+}
+
+static void
+dump_free (Dump *dump)
+{
+  guint i;
+
+  for (i = 0; i < dump->n_frames; i++)
+    frame_clear (&dump->frames[i]);
+
+  g_free (dump->frames);
+  g_free (dump->events);
+  g_free (dump->path);
+  g_free (dump->program);
+  g_free (dump->reason);
+  g_free (dump);
+}
+
+/* This runs in a thread when writing for a slow frame, so it
+ * must only touch @dump, not the recorder.
+ */
+static char *
+dump_write (Dump    *dump,
+            GError **error)
+{
+  GKeyFile *keyfile;
+  char *filename;
+  guint i;
+  gboolean result;
+
+  if (g_mkdir_with_parents (dump->path, 0755) != 0)
+    {
+      int saved_errno = errno;
+
+      g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (saved_errno),
+                   "Could not create %s: %s", dump->path, g_strerror (saved_errno));
+      return NULL;
+    }
+
+  keyfile = g_key_file_new ();
+
+  g_key_file_set_string (keyfile, "Flight Recording", "reason", dump->reason);
+  if (dump->program)
+    g_key_file_set_string (keyfile, "Flight Recording", "program", dump->program);
+  g_key_file_set_integer (keyfile, "Flight Recording", "frames", dump->n_frames);
+  g_key_file_set_integer (keyfile, "Flight Recording", "events", dump->n_events);
+
+  result = TRUE;
+  for (i = 0; i < dump->n_frames && result; i++)
+    result = save_frame (keyfile, dump->path, i, &dump->frames[i], error);
+
+  for (i = 0; i < dump->n_events; i++)
+    {
+      Event *event = &dump->events[i];
+      char *group = g_strdup_printf ("Event %u", i);
+
+      g_key_file_set_string (keyfile, group, "type", event_type_nick (event->type));
+      g_key_file_set_int64 (keyfile, group, "time", event->time);
+      g_free (group);
+    }
+
+  filename = g_build_filename (dump->path, GTK_FLIGHT_RECORDER_FILENAME, NULL);
+  if (result)
+    result = g_key_file_save_to_file (keyfile, filename, error);
+
+  g_key_file_free (keyfile);
+
+  if (!result)
+    g_clear_pointer (&filename, g_free);
+
+  return filename;
+}
+
+/*
+ * gtk_flight_recorder_dump:
+ * @reason: why the recording is written
+ * @error: return location for an error
+ *
+ * Writes the recorded frames and events to a new directory below
+ * the directory given in GTK_FLIGHT_RECORDER. The frames are saved
+ * as serialized render nodes, and everything else goes into a key
+ * file that refers to them.
+ *
+ * Unlike the recordings written for slow frames, this blocks until
+ * the recording is written.
+ *
+ * Returns: (transfer full) (nullable): the filename of the key file,
+ *   or %NULL if the recording could not be written
+ */
+char *
+gtk_flight_recorder_dump (const char  *reason,
+                          GError     **error)
+{
+  Dump *dump;
+  char *filename;
+
+  g_return_val_if_fail (recorder.enabled, NULL);
+
+  dump = dump_new (reason);
+  filename = dump_write (dump, error);
+  dump_free (dump);
+
+  return filename;
+}
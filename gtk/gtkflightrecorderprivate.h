@@ -0,0 +1,43 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_FLIGHT_RECORDER_PRIVATE_H__
+#define __GTK_FLIGHT_RECORDER_PRIVATE_H__
+
+#include <gtk/gtkwidget.h>
+
+G_BEGIN_DECLS
+
+#define GTK_FLIGHT_RECORDER_FILENAME "recording.ini"
+
+void            gtk_flight_recorder_init                (void);
+gboolean        gtk_flight_recorder_is_enabled          (void);
+
+void            gtk_flight_recorder_record_event        (GdkEvent             *event);
+void            gtk_flight_recorder_record_frame        (GtkWidget            *widget,
+                                                         const cairo_region_t *region,
+                                                         GskRenderNode        *root,
+                                                         gint64                snapshot_start,
+                                                         gint64                render_start,
+                                                         gint64                render_end);
+
+char *          gtk_flight_recorder_dump                (const char           *reason,
+                                                         GError              **error);
+
+G_END_DECLS
+
+#endif /* __GTK_FLIGHT_RECORDER_PRIVATE_H__ */
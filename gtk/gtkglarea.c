@@ -30,6 +30,10 @@
 #include "gtksnapshot.h"
 #include "gtknative.h"
 #include "gtkwidgetprivate.h"
+#include "gdk/gdkglcontextprivate.h"
+#include "gdk/gdkgltextureprivate.h"
+
+#include <gsk/gl/gskglrenderer.h>
 
 #include <epoxy/gl.h>
 
@@ -145,6 +149,13 @@ typedef struct {
   int width;
   int height;
   GdkTexture *holder;
+
+  /* signaled when the last frame rendered to the texture is done */
+  GLsync sync;
+
+  /* for reading back the texture when the renderer can't use it */
+  guint pixel_buffer;
+  gsize pixel_buffer_size;
 } Texture;
 
 typedef struct {
@@ -392,6 +403,18 @@ delete_one_texture (gpointer data)
       texture->id = 0;
     }
 
+  if (texture->sync)
+    {
+      glDeleteSync (texture->sync);
+      texture->sync = NULL;
+    }
+
+  if (texture->pixel_buffer != 0)
+    {
+      glDeleteBuffers (1, &texture->pixel_buffer);
+      texture->pixel_buffer = 0;
+    }
+
   g_free (texture);
 }
 
@@ -431,11 +454,7 @@ gtk_gl_area_ensure_texture (GtkGLArea *area)
 
   if (priv->texture == NULL)
     {
-      priv->texture = g_new (Texture, 1);
-
-      priv->texture->width = 0;
-      priv->texture->height = 0;
-      priv->texture->holder = NULL;
+      priv->texture = g_new0 (Texture, 1);
 
       glGenTextures (1, &priv->texture->id);
     }
@@ -668,6 +687,48 @@ gtk_gl_area_draw_error_screen (GtkGLArea   *area,
   g_object_unref (layout);
 }
 
+static gboolean
+gtk_gl_area_has_sync (GtkGLArea *area)
+{
+  GtkGLAreaPrivate *priv = gtk_gl_area_get_instance_private (area);
+
+  if (gdk_gl_context_get_use_es (priv->context))
+    return gdk_gl_context_check_version (priv->context, 3, 0);
+  else
+    return gdk_gl_context_check_version (priv->context, 3, 2);
+}
+
+/* Renderers that can't use our texture directly need to download
+ * it. Start doing that right away, so that the download doesn't
+ * have to wait for the GPU to finish rendering.
+ */
+static void
+gtk_gl_area_start_readback (GtkGLArea *area,
+                            Texture   *texture)
+{
+  GtkGLAreaPrivate *priv = gtk_gl_area_get_instance_private (area);
+  gsize size;
+
+  size = (gsize) texture->width * texture->height * 4;
+
+  if (texture->pixel_buffer == 0)
+    glGenBuffers (1, &texture->pixel_buffer);
+
+  glBindFramebuffer (GL_FRAMEBUFFER, priv->frame_buffer);
+  glBindBuffer (GL_PIXEL_PACK_BUFFER, texture->pixel_buffer);
+
+  if (texture->pixel_buffer_size != size)
+    {
+      glBufferData (GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+      texture->pixel_buffer_size = size;
+    }
+
+  glPixelStorei (GL_PACK_ALIGNMENT, 4);
+  glReadPixels (0, 0, texture->width, texture->height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+  glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+}
+
 static void
 release_texture (gpointer data)
 {
@@ -717,6 +778,8 @@ gtk_gl_area_snapshot (GtkWidget   *widget,
   if (status == GL_FRAMEBUFFER_COMPLETE)
     {
       Texture *texture;
+      GskRenderer *renderer;
+      gboolean readback;
 
       if (priv->needs_render || priv->auto_render)
         {
@@ -735,11 +798,34 @@ gtk_gl_area_snapshot (GtkWidget   *widget,
       priv->texture = NULL;
       priv->textures = g_list_prepend (priv->textures, texture);
 
+      renderer = gtk_native_get_renderer (gtk_widget_get_native (widget));
+      readback = !GSK_IS_GL_RENDERER (renderer) && gtk_gl_area_has_sync (area);
+
+      if (readback)
+        gtk_gl_area_start_readback (area, texture);
+
+      if (texture->sync)
+        glDeleteSync (texture->sync);
+
+      if (gtk_gl_area_has_sync (area))
+        {
+          texture->sync = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+          /* Make sure other contexts can see the fence */
+          glFlush ();
+        }
+      else
+        {
+          texture->sync = NULL;
+        }
+
       texture->holder = gdk_gl_texture_new (priv->context,
                                             texture->id,
                                             texture->width,
                                             texture->height,
                                             release_texture, texture);
+      gdk_gl_texture_set_sync (GDK_GL_TEXTURE (texture->holder), texture->sync);
+      if (readback)
+        gdk_gl_texture_set_pixel_buffer (GDK_GL_TEXTURE (texture->holder), texture->pixel_buffer);
 
       /* Our texture is rendered by OpenGL, so it is upside down,
        * compared to what GSK expects, so flip it back.
@@ -37,6 +37,7 @@
 #include "gtknotebook.h"
 #include "gtkpango.h"
 #include "gtkprivate.h"
+#include "gtkshapingcacheprivate.h"
 #include "gtkshortcut.h"
 #include "gtkshortcutcontroller.h"
 #include "gtkshortcuttrigger.h"
@@ -275,8 +276,11 @@ struct _GtkLabel
   guint    single_line_mode   : 1;
   guint    in_click           : 1;
   guint    track_links        : 1;
+  guint    layout_shared      : 1;
+  guint    layout_exported    : 1; /* given out by gtk_label_get_layout() */
 
   guint    mnemonic_keyval;
+  guint    layout_serial;
 
   int      width_chars;
   int      max_width_chars;
@@ -773,8 +777,10 @@ gtk_label_update_layout_attributes (GtkLabel      *self,
   GtkCssStyle *style;
   PangoAttrList *attrs;
 
-  if (self->layout == NULL)
+  if (self->layout == NULL || self->layout_shared)
     {
+      /* A shared layout is replaced when it is needed again */
+      gtk_label_clear_layout (self);
       pango_attr_list_unref (style_attrs);
       return;
     }
@@ -987,7 +993,7 @@ gtk_label_get_measuring_layout (GtkLabel    *self,
    * because we don't need it to be properly setup at that point.
    * This way we can make use of caching upon the label's creation.
    */
-  if (gtk_widget_get_width (GTK_WIDGET (self)) <= 1)
+  if (gtk_widget_get_width (GTK_WIDGET (self)) <= 1 && !self->layout_shared)
     {
       g_object_ref (self->layout);
       pango_layout_set_width (self->layout, width);
@@ -1293,10 +1299,12 @@ gtk_label_size_allocate (GtkWidget *widget,
 
   if (self->layout)
     {
-      if (self->ellipsize || self->wrap)
-        pango_layout_set_width (self->layout, width * PANGO_SCALE);
-      else
-        pango_layout_set_width (self->layout, -1);
+      int layout_width = self->ellipsize || self->wrap ? width * PANGO_SCALE : -1;
+
+      if (!self->layout_shared)
+        pango_layout_set_width (self->layout, layout_width);
+      else if (pango_layout_get_width (self->layout) != layout_width)
+        gtk_label_clear_layout (self);
     }
 
   if (self->popup_menu)
@@ -3999,6 +4007,26 @@ static void
 gtk_label_clear_layout (GtkLabel *self)
 {
   g_clear_object (&self->layout);
+  self->layout_shared = FALSE;
+}
+
+/* Labels that are not selectable and don't wrap share their layout
+ * with other labels with the same text and style, see gtkshapingcache.c.
+ * Ellipsized labels only do so once they have been allocated, so
+ * that they don't need to change the width of the layout. Labels
+ * whose layout was given out by gtk_label_get_layout() stop sharing,
+ * as the caller may modify it.
+ */
+static gboolean
+gtk_label_can_share_layout (GtkLabel *self)
+{
+  if (self->select_info || self->wrap || self->layout_exported)
+    return FALSE;
+
+  if (self->ellipsize && gtk_widget_get_width (GTK_WIDGET (self)) <= 1)
+    return FALSE;
+
+  return TRUE;
 }
 
 static void
@@ -4007,6 +4035,11 @@ gtk_label_ensure_layout (GtkLabel *self)
   PangoAlignment align;
   gboolean rtl;
 
+  /* Shared layouts don't follow changes to the context of the label */
+  if (self->layout && self->layout_shared &&
+      self->layout_serial != pango_context_get_serial (gtk_widget_get_pango_context (GTK_WIDGET (self))))
+    gtk_label_clear_layout (self);
+
   if (self->layout)
     return;
 
@@ -4043,6 +4076,19 @@ gtk_label_ensure_layout (GtkLabel *self)
 
   if (self->ellipsize || self->wrap)
     pango_layout_set_width (self->layout, gtk_widget_get_width (GTK_WIDGET (self)) * PANGO_SCALE);
+
+  if (gtk_label_can_share_layout (self))
+    {
+      PangoLayout *shared = gtk_shaping_cache_share_layout (self->layout);
+
+      if (shared)
+        {
+          g_object_unref (self->layout);
+          self->layout = shared;
+          self->layout_shared = TRUE;
+          self->layout_serial = pango_context_get_serial (gtk_widget_get_pango_context (GTK_WIDGET (self)));
+        }
+    }
 }
 
 /**
@@ -5045,6 +5091,25 @@ gtk_label_get_layout (GtkLabel *self)
 {
   g_return_val_if_fail (GTK_IS_LABEL (self), NULL);
 
+  /* Don't hand out a layout that other labels use too */
+  if (!self->layout_exported)
+    {
+      self->layout_exported = TRUE;
+      if (self->layout_shared)
+        gtk_label_clear_layout (self);
+    }
+
+  gtk_label_ensure_layout (self);
+
+  return self->layout;
+}
+
+/* Like gtk_label_get_layout(), for callers inside GTK that don't
+ * modify the layout, so the label can keep sharing it.
+ */
+PangoLayout *
+_gtk_label_peek_layout (GtkLabel *self)
+{
   gtk_label_ensure_layout (self);
 
   return self->layout;
@@ -27,6 +27,8 @@ G_BEGIN_DECLS
 int _gtk_label_get_cursor_position (GtkLabel *label);
 int _gtk_label_get_selection_bound (GtkLabel *label);
 
+PangoLayout *_gtk_label_peek_layout (GtkLabel *label);
+
 G_END_DECLS
 
 #endif /* __GTK_LABEL_PRIVATE_H__ */
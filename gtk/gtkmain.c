@@ -52,6 +52,7 @@
 #include "gtkbox.h"
 #include "gtkdebug.h"
 #include "gtkdropprivate.h"
+#include "gtkflightrecorderprivate.h"
 #include "gtkmain.h"
 #include "gtkmediafileprivate.h"
 #include "gtkmodulesprivate.h"
@@ -196,7 +197,8 @@ static const GdkDebugKey gtk_debug_keys[] = {
   { "layout", GTK_DEBUG_LAYOUT, "Information from layout managers" },
   { "builder", GTK_DEBUG_BUILDER, "Trace GtkBuilder operation" },
   { "builder-objects", GTK_DEBUG_BUILDER_OBJECTS, "Log unused GtkBuilder objects" },
-  { "no-css-cache", GTK_DEBUG_NO_CSS_CACHE, "Disable style property cache" },
+  { "no-css-cache", GTK_DEBUG_NO_CSS_CACHE, "Disable style property, render node and image caches" },
+  { "no-shaping-cache", GTK_DEBUG_NO_SHAPING_CACHE, "Don't share laid out text between widgets" },
   { "interactive", GTK_DEBUG_INTERACTIVE, "Enable the GTK inspector", TRUE },
   { "touchscreen", GTK_DEBUG_TOUCHSCREEN, "Pretend the pointer is a touchscreen" },
   { "snapshot", GTK_DEBUG_SNAPSHOT, "Generate debug render nodes" },
@@ -495,6 +497,8 @@ do_pre_parse_initialization (void)
       _gtk_set_slowdown (slowdown);
     }
 
+  gtk_flight_recorder_init ();
+
   /* Trigger fontconfig initialization early */
   pango_cairo_font_map_get_default ();
 }
@@ -1531,6 +1535,8 @@ gtk_main_do_event (GdkEvent *event)
   GdkEvent *rewritten_event = NULL;
   GList *tmp_list;
 
+  gtk_flight_recorder_record_event (event);
+
   if (gtk_inspector_handle_event (event))
     return;
 
@@ -54,6 +54,8 @@ struct _GtkMenuSectionBox
   GtkPopoverMenuFlags  flags;
   GtkSizeGroup        *indicators;
   GHashTable          *custom_slots;
+  GHashTable          *pending_submenus;
+  GPtrArray           *spare_buttons;
 };
 
 typedef struct
@@ -62,6 +64,27 @@ typedef struct
   gboolean previous_is_iconic;
 } MenuData;
 
+/* A sliding submenu that has not been opened yet. Its box is only
+ * created when the submenu is shown, see gtk_menu_section_box_ensure_submenu().
+ */
+typedef struct
+{
+  GtkMenuTrackerItem *item;
+  GtkWidget          *focus;
+  char               *parent_name;
+} PendingSubmenu;
+
+static void
+pending_submenu_free (gpointer data)
+{
+  PendingSubmenu *pending = data;
+
+  g_object_unref (pending->item);
+  g_object_unref (pending->focus);
+  g_free (pending->parent_name);
+  g_free (pending);
+}
+
 G_DEFINE_TYPE (GtkMenuSectionBox, gtk_menu_section_box, GTK_TYPE_BOX)
 
 static void        gtk_menu_section_box_sync_separators (GtkMenuSectionBox  *box,
@@ -70,6 +93,11 @@ static void        gtk_menu_section_box_new_submenu     (GtkMenuTrackerItem *ite
                                                          GtkMenuSectionBox  *toplevel,
                                                          GtkWidget          *focus,
                                                          const char         *name);
+static void        gtk_menu_section_box_build_submenu   (GtkMenuTrackerItem *item,
+                                                         GtkMenuSectionBox  *toplevel,
+                                                         GtkWidget          *focus,
+                                                         const char         *parent_name,
+                                                         const char         *name);
 static GtkWidget * gtk_menu_section_box_new_section     (GtkMenuTrackerItem *item,
                                                          GtkMenuSectionBox  *parent);
 
@@ -100,6 +128,11 @@ gtk_menu_section_box_sync_separators (GtkMenuSectionBox *box,
   n_items_before =  data->n_items;
   previous_section_is_iconic = data->previous_is_iconic;
 
+  /* The tracker is done changing items, so buttons that
+   * were not reused are not going to be
+   */
+  g_clear_pointer (&box->spare_buttons, g_ptr_array_unref);
+
   for (child = gtk_widget_get_first_child (GTK_WIDGET (box->item_box));
        child != NULL;
        child = gtk_widget_get_next_sibling (child))
@@ -206,6 +239,64 @@ gtk_popover_item_activate (GtkWidget *button,
     }
 }
 
+static void
+bind_item_property (GtkWidget          *widget,
+                    GtkMenuTrackerItem *item,
+                    const char         *item_property,
+                    const char         *widget_property)
+{
+  GPtrArray *bindings;
+  GBinding *binding;
+
+  bindings = g_object_get_data (G_OBJECT (widget), "gtk-menu-bindings");
+  binding = g_object_bind_property (item, item_property, widget, widget_property, G_BINDING_SYNC_CREATE);
+  g_ptr_array_add (bindings, binding);
+}
+
+static GtkWidget *
+gtk_menu_section_box_get_button (GtkMenuSectionBox *box)
+{
+  GtkWidget *widget;
+
+  if (box->spare_buttons && box->spare_buttons->len > 0)
+    return g_ptr_array_steal_index_fast (box->spare_buttons, box->spare_buttons->len - 1);
+
+  widget = g_object_new (GTK_TYPE_MODEL_BUTTON,
+                         "indicator-size-group", box->indicators,
+                         NULL);
+  g_object_set_data_full (G_OBJECT (widget), "gtk-menu-bindings",
+                          g_ptr_array_new (), (GDestroyNotify) g_ptr_array_unref);
+
+  return g_object_ref_sink (widget);
+}
+
+/* Takes ownership of @widget */
+static void
+gtk_menu_section_box_recycle_button (GtkMenuSectionBox *box,
+                                     GtkWidget         *widget)
+{
+  GtkMenuTrackerItem *item;
+  GPtrArray *bindings;
+  guint i;
+
+  item = g_object_get_data (G_OBJECT (widget), "GtkMenuTrackerItem");
+  bindings = g_object_get_data (G_OBJECT (widget), "gtk-menu-bindings");
+
+  for (i = 0; i < bindings->len; i++)
+    g_binding_unbind (g_ptr_array_index (bindings, i));
+  g_ptr_array_set_size (bindings, 0);
+
+  g_signal_handlers_disconnect_by_func (widget, gtk_popover_item_activate, item);
+  g_object_set_data (G_OBJECT (widget), "GtkMenuTrackerItem", NULL);
+
+  gtk_widget_unset_state_flags (widget, GTK_STATE_FLAG_PRELIGHT | GTK_STATE_FLAG_ACTIVE);
+
+  if (box->spare_buttons == NULL)
+    box->spare_buttons = g_ptr_array_new_with_free_func (g_object_unref);
+
+  g_ptr_array_add (box->spare_buttons, widget);
+}
+
 static void
 gtk_menu_section_box_remove_func (int      position,
                                   gpointer user_data)
@@ -227,14 +318,28 @@ gtk_menu_section_box_remove_func (int      position,
   if (gtk_menu_tracker_item_get_has_link (item, G_MENU_LINK_SUBMENU))
     {
       GtkWidget *stack, *subbox;
+      const char *name;
 
       stack = gtk_widget_get_ancestor (GTK_WIDGET (box->toplevel), GTK_TYPE_STACK);
-      subbox = gtk_stack_get_child_by_name (GTK_STACK (stack), gtk_menu_tracker_item_get_label (item));
+      name = gtk_menu_tracker_item_get_label (item);
+      subbox = gtk_stack_get_child_by_name (GTK_STACK (stack), name);
       if (subbox != NULL)
         gtk_stack_remove (GTK_STACK (stack), subbox);
+      else if (box->pending_submenus)
+        g_hash_table_remove (box->pending_submenus, name);
     }
 
-  gtk_box_remove (GTK_BOX (box->item_box), widget);
+  if (g_object_get_data (G_OBJECT (widget), "gtk-menu-bindings"))
+    {
+      /* Keep plain buttons around, in case the tracker
+       * is replacing items, as it does for most changes
+       */
+      g_object_ref (widget);
+      gtk_box_remove (GTK_BOX (box->item_box), widget);
+      gtk_menu_section_box_recycle_button (box, widget);
+    }
+  else
+    gtk_box_remove (GTK_BOX (box->item_box), widget);
 
   gtk_menu_section_box_schedule_separator_sync (box);
 }
@@ -290,7 +395,8 @@ open_submenu (GtkWidget *button,
     gtk_menu_tracker_item_request_submenu_shown (item, TRUE);
 
   focus = GTK_WIDGET (g_object_get_data (G_OBJECT (button), "focus"));
-  gtk_widget_grab_focus (focus);
+  if (focus)
+    gtk_widget_grab_focus (focus);
 }
 
 static void
@@ -349,7 +455,9 @@ gtk_menu_section_box_insert_func (GtkMenuTrackerItem *item,
 
           model = _gtk_menu_tracker_item_get_link (item, G_MENU_LINK_SUBMENU);
 
-          submenu = gtk_popover_menu_new_from_model_full (model, box->flags);
+          /* The popover is only filled when it is first shown */
+          submenu = gtk_popover_menu_new_from_model_lazy (model, box->flags);
+          g_object_unref (model);
           gtk_popover_set_has_arrow (GTK_POPOVER (submenu), FALSE);
           gtk_widget_set_valign (submenu, GTK_ALIGN_START);
 
@@ -380,7 +488,7 @@ gtk_menu_section_box_insert_func (GtkMenuTrackerItem *item,
 
           get_ancestors (GTK_WIDGET (box->toplevel), GTK_TYPE_STACK, &stack, &parent);
           g_object_get (gtk_stack_get_page (GTK_STACK (stack), parent), "name", &name, NULL);
-          gtk_menu_section_box_new_submenu (item, box->toplevel, widget, name);
+          gtk_menu_section_box_new_submenu (item, box, widget, name);
           g_free (name);
         }
     }
@@ -400,6 +508,19 @@ gtk_menu_section_box_insert_func (GtkMenuTrackerItem *item,
           g_hash_table_insert (box->custom_slots, slot_id, widget);
         }
     }
+  else if (!box->iconic && !box->inline_buttons && !box->circular)
+    {
+      widget = gtk_menu_section_box_get_button (box);
+
+      bind_item_property (widget, item, "label", "text");
+      bind_item_property (widget, item, "icon", "icon");
+      bind_item_property (widget, item, "use-markup", "use-markup");
+      bind_item_property (widget, item, "sensitive", "sensitive");
+      bind_item_property (widget, item, "role", "role");
+      bind_item_property (widget, item, "toggled", "active");
+      bind_item_property (widget, item, "accel", "accel");
+      g_signal_connect (widget, "clicked", G_CALLBACK (gtk_popover_item_activate), item);
+    }
   else
     {
       widget = g_object_new (GTK_TYPE_MODEL_BUTTON,
@@ -424,8 +545,6 @@ gtk_menu_section_box_insert_func (GtkMenuTrackerItem *item,
           g_object_set (widget, "iconic", TRUE, NULL);
           gtk_widget_add_css_class (widget, "circular");
         }
-      else
-        g_object_bind_property (item, "icon", widget, "icon", G_BINDING_SYNC_CREATE);
 
       g_object_bind_property (item, "use-markup", widget, "use-markup", G_BINDING_SYNC_CREATE);
       g_object_bind_property (item, "sensitive", widget, "sensitive", G_BINDING_SYNC_CREATE);
@@ -448,6 +567,9 @@ gtk_menu_section_box_insert_func (GtkMenuTrackerItem *item,
     }
   gtk_box_append (GTK_BOX (box->item_box), widget);
 
+  if (g_object_get_data (G_OBJECT (widget), "gtk-menu-bindings"))
+    g_object_unref (widget);
+
   if (position == 0)
     gtk_box_reorder_child_after (GTK_BOX (box->item_box), widget, NULL);
   else
@@ -519,6 +641,8 @@ gtk_menu_section_box_dispose (GObject *object)
 
   g_clear_object (&box->indicators);
   g_clear_pointer (&box->custom_slots, g_hash_table_unref);
+  g_clear_pointer (&box->pending_submenus, g_hash_table_unref);
+  g_clear_pointer (&box->spare_buttons, g_ptr_array_unref);
 
   G_OBJECT_CLASS (gtk_menu_section_box_parent_class)->dispose (object);
 }
@@ -563,6 +687,7 @@ gtk_menu_section_box_new_toplevel (GtkPopoverMenu      *popover,
   box = g_object_new (GTK_TYPE_MENU_SECTION_BOX, NULL);
   box->indicators = gtk_size_group_new (GTK_SIZE_GROUP_HORIZONTAL);
   box->custom_slots = g_hash_table_new (g_str_hash, g_str_equal);
+  box->pending_submenus = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, pending_submenu_free);
   box->flags = flags;
 
   gtk_popover_menu_add_submenu (popover, GTK_WIDGET (box), "main");
@@ -577,9 +702,67 @@ gtk_menu_section_box_new_toplevel (GtkPopoverMenu      *popover,
 
 static void
 gtk_menu_section_box_new_submenu (GtkMenuTrackerItem *item,
-                                  GtkMenuSectionBox  *toplevel,
+                                  GtkMenuSectionBox  *parent,
                                   GtkWidget          *focus,
                                   const char         *name)
+{
+  PendingSubmenu *pending;
+
+  g_signal_connect (focus, "clicked", G_CALLBACK (open_submenu), item);
+
+  /* Submenus are built when they are opened, which most never are */
+  if (parent->pending_submenus == NULL)
+    {
+      gtk_menu_section_box_build_submenu (item, parent->toplevel, focus, name,
+                                          gtk_menu_tracker_item_get_label (item));
+      return;
+    }
+
+  pending = g_new (PendingSubmenu, 1);
+  pending->item = g_object_ref (item);
+  pending->focus = g_object_ref (focus);
+  pending->parent_name = g_strdup (name);
+
+  g_hash_table_replace (parent->pending_submenus,
+                        g_strdup (gtk_menu_tracker_item_get_label (item)),
+                        pending);
+}
+
+void
+gtk_menu_section_box_ensure_submenu (GtkPopoverMenu *popover,
+                                     const char     *name)
+{
+  GtkWidget *stack;
+  GtkMenuSectionBox *box;
+  PendingSubmenu *pending;
+  gpointer key;
+
+  if (name == NULL)
+    return;
+
+  stack = gtk_popover_menu_get_stack (popover);
+  if (gtk_stack_get_child_by_name (GTK_STACK (stack), name))
+    return;
+
+  box = (GtkMenuSectionBox *) gtk_stack_get_child_by_name (GTK_STACK (stack), "main");
+  if (!GTK_IS_MENU_SECTION_BOX (box) || box->pending_submenus == NULL)
+    return;
+
+  if (!g_hash_table_steal_extended (box->pending_submenus, name, &key, (gpointer *) &pending))
+    return;
+
+  gtk_menu_section_box_build_submenu (pending->item, box, pending->focus, pending->parent_name, name);
+
+  g_free (key);
+  pending_submenu_free (pending);
+}
+
+static void
+gtk_menu_section_box_build_submenu (GtkMenuTrackerItem *item,
+                                    GtkMenuSectionBox  *toplevel,
+                                    GtkWidget          *focus,
+                                    const char         *parent_name,
+                                    const char         *name)
 {
   GtkMenuSectionBox *box;
   GtkWidget *button;
@@ -587,10 +770,12 @@ gtk_menu_section_box_new_submenu (GtkMenuTrackerItem *item,
   box = g_object_new (GTK_TYPE_MENU_SECTION_BOX, NULL);
   box->indicators = gtk_size_group_new (GTK_SIZE_GROUP_HORIZONTAL);
   box->custom_slots = g_hash_table_ref (toplevel->custom_slots);
+  if (toplevel->pending_submenus)
+    box->pending_submenus = g_hash_table_ref (toplevel->pending_submenus);
   box->flags = toplevel->flags;
 
   button = g_object_new (GTK_TYPE_MODEL_BUTTON,
-                         "menu-name", name,
+                         "menu-name", parent_name,
                          "role", GTK_BUTTON_ROLE_TITLE,
                          NULL);
 
@@ -602,11 +787,10 @@ gtk_menu_section_box_new_submenu (GtkMenuTrackerItem *item,
 
   gtk_box_insert_child_after (GTK_BOX (box), button, NULL);
 
-  g_signal_connect (focus, "clicked", G_CALLBACK (open_submenu), item);
   g_signal_connect (button, "clicked", G_CALLBACK (close_submenu), item);
 
   gtk_stack_add_named (GTK_STACK (gtk_widget_get_ancestor (GTK_WIDGET (toplevel), GTK_TYPE_STACK)),
-                       GTK_WIDGET (box), gtk_menu_tracker_item_get_label (item));
+                       GTK_WIDGET (box), name);
 
   box->tracker = gtk_menu_tracker_new_for_item_link (item, G_MENU_LINK_SUBMENU, FALSE, FALSE,
                                                      gtk_menu_section_box_insert_func,
@@ -626,6 +810,8 @@ gtk_menu_section_box_new_section (GtkMenuTrackerItem *item,
   box = g_object_new (GTK_TYPE_MENU_SECTION_BOX, NULL);
   box->indicators = g_object_ref (parent->indicators);
   box->custom_slots = g_hash_table_ref (parent->toplevel->custom_slots);
+  if (parent->toplevel->pending_submenus)
+    box->pending_submenus = g_hash_table_ref (parent->toplevel->pending_submenus);
   box->toplevel = parent->toplevel;
   box->depth = parent->depth + 1;
   box->flags = parent->flags;
@@ -52,6 +52,9 @@ gboolean                gtk_menu_section_box_add_custom                 (GtkPopo
 gboolean                gtk_menu_section_box_remove_custom              (GtkPopoverMenu *popover,
                                                                          GtkWidget      *child);
 
+void                    gtk_menu_section_box_ensure_submenu             (GtkPopoverMenu *popover,
+                                                                         const char     *name);
+
 G_END_DECLS
 
 #endif /* __GTK_MENU_SECTION_BOX_PRIVATE_H__ */
@@ -1016,8 +1016,17 @@ gtk_model_button_dispose (GObject *object)
 static void
 switch_menu (GtkModelButton *button)
 {
+  GtkWidget *popover;
   GtkWidget *stack;
 
+  /* Let the popover create the submenu, if needed */
+  popover = gtk_widget_get_ancestor (GTK_WIDGET (button), GTK_TYPE_POPOVER_MENU);
+  if (popover != NULL)
+    {
+      gtk_popover_menu_open_submenu (GTK_POPOVER_MENU (popover), button->menu_name);
+      return;
+    }
+
   stack = gtk_widget_get_ancestor (GTK_WIDGET (button), GTK_TYPE_STACK);
   if (stack != NULL)
     gtk_stack_set_visible_child_name (GTK_STACK (stack), button->menu_name);
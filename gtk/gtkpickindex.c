@@ -0,0 +1,536 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkpickindexprivate.h"
+
+#include "gtkcssboxesimplprivate.h"
+#include "gtknative.h"
+#include "gtkwidgetprivate.h"
+
+#include <math.h>
+
+/*
+ * GtkPickIndex is a uniform grid of the bounds of a widget's children,
+ * used by gtk_widget_pick() to avoid testing every child of widgets
+ * with many children, like canvases built with GtkFixed.
+ *
+ * The bounds of a child include everything inside it that could be
+ * picked, so children with overflowing descendants are indexed by
+ * the union of all their bounds. Children where this can't be
+ * determined (because they override GtkWidgetClass::contains or
+ * have a 3D transform) or that cover a large part of the grid are
+ * checked for every point.
+ *
+ * The bounds of every widget are cached in the widget, and the widget
+ * code invalidates them for the widget and those of its ancestors that
+ * include them whenever an allocation changes. The entry of a child in
+ * the index is marked as outdated at the same time, and updated in
+ * place before the next pick, as long as the child stays within the
+ * cells it is listed in. Children that move out of them are checked
+ * everywhere instead, until too many of them did and the grid is built
+ * again.
+ *
+ * Indexes are only rebuilt from scratch when the generation they were
+ * built for is outdated, which the widget code bumps when children are
+ * added, removed, mapped or unmapped.
+ */
+#define MAX_GRID_SIZE 64
+#define MAX_CELLS_PER_CHILD 16
+
+typedef struct _GtkPickIndexChild GtkPickIndexChild;
+
+struct _GtkPickIndexChild
+{
+  GtkWidget *widget;
+  graphene_rect_t bounds;
+  gboolean bounded;
+
+  /* The cells the child is listed in */
+  guint8 column0, row0, column1, row1;
+};
+
+struct _GtkPickIndex
+{
+  guint generation;
+  guint enabled : 1;
+
+  GtkPickIndexChild *children;
+  guint n_children;
+
+  /* children that need to be checked everywhere, in order */
+  guint *everywhere;
+  guint n_everywhere;
+
+  /* children whose bounds are outdated, and the number of
+   * children that moved out of their cells since the grid
+   * was built
+   */
+  GPtrArray *dirty;
+  guint n_moved;
+
+  graphene_rect_t extents;
+  guint n_columns;
+  guint n_rows;
+  float cell_width;
+  float cell_height;
+
+  /* n_columns * n_rows + 1 offsets into entries */
+  guint *cell_offsets;
+  guint *cell_entries;
+};
+
+static gboolean gtk_pick_index_get_child_bounds (GtkWidget       *child,
+                                                 graphene_rect_t *bounds);
+
+static gboolean
+gtk_pick_index_compute_bounds (GtkWidget       *widget,
+                               graphene_rect_t *bounds)
+{
+  static GtkWidgetClass *widget_class = NULL;
+  GtkCssBoxes boxes;
+  GtkWidget *child;
+
+  if (widget_class == NULL)
+    widget_class = g_type_class_peek (GTK_TYPE_WIDGET);
+
+  /* We can't know where custom implementations return TRUE */
+  if (GTK_WIDGET_GET_CLASS (widget)->contains != widget_class->contains)
+    return FALSE;
+
+  gtk_css_boxes_init (&boxes, widget);
+  *bounds = gtk_css_boxes_get_border_box (&boxes)->bounds;
+
+  if (widget->priv->overflow == GTK_OVERFLOW_HIDDEN)
+    return TRUE;
+
+  for (child = widget->priv->first_child;
+       child != NULL;
+       child = child->priv->next_sibling)
+    {
+      graphene_rect_t child_bounds;
+
+      if (!child->priv->mapped || GTK_IS_NATIVE (child))
+        continue;
+
+      if (!gtk_pick_index_get_child_bounds (child, &child_bounds))
+        return FALSE;
+
+      graphene_rect_union (bounds, &child_bounds, bounds);
+    }
+
+  return TRUE;
+}
+
+/*<private>
+ * gtk_pick_index_get_bounds:
+ * @widget: a widget
+ * @bounds: (out): return location for the bounds
+ *
+ * Gets the bounds of everything that can be picked in @widget,
+ * in its own coordinates. The bounds are cached in @widget until
+ * the widget code invalidates them.
+ *
+ * Returns: %FALSE if the bounds can't be determined, because @widget
+ *   or one of its descendants overrides GtkWidgetClass::contains or
+ *   has a 3D transform
+ */
+gboolean
+gtk_pick_index_get_bounds (GtkWidget       *widget,
+                           graphene_rect_t *bounds)
+{
+  GtkWidgetPrivate *priv = widget->priv;
+
+  if (!priv->pick_bounds_valid)
+    {
+      priv->pick_bounded = gtk_pick_index_compute_bounds (widget, &priv->pick_bounds);
+      priv->pick_bounds_valid = TRUE;
+    }
+
+  *bounds = priv->pick_bounds;
+
+  return priv->pick_bounded;
+}
+
+/* Gets the bounds of @child in the coordinates of its parent */
+static gboolean
+gtk_pick_index_get_child_bounds (GtkWidget       *child,
+                                 graphene_rect_t *bounds)
+{
+  GskTransform *transform = child->priv->transform;
+
+  if (!gtk_pick_index_get_bounds (child, bounds))
+    return FALSE;
+
+  if (transform)
+    {
+      if (gsk_transform_get_category (transform) < GSK_TRANSFORM_CATEGORY_2D)
+        return FALSE;
+
+      gsk_transform_transform_bounds (transform, bounds, bounds);
+    }
+
+  return TRUE;
+}
+
+static guint
+gtk_pick_index_get_column (const GtkPickIndex *self,
+                           float               x)
+{
+  int column = floor ((x - self->extents.origin.x) / self->cell_width);
+
+  return CLAMP (column, 0, (int) self->n_columns - 1);
+}
+
+static guint
+gtk_pick_index_get_row (const GtkPickIndex *self,
+                        float               y)
+{
+  int row = floor ((y - self->extents.origin.y) / self->cell_height);
+
+  return CLAMP (row, 0, (int) self->n_rows - 1);
+}
+
+static void
+gtk_pick_index_build_grid (GtkPickIndex *self)
+{
+  guint i, x, y, n_cells, n_bounded, size;
+  guint *fill;
+
+  graphene_rect_init (&self->extents, 0, 0, 0, 0);
+  n_bounded = 0;
+  for (i = 0; i < self->n_children; i++)
+    {
+      GtkPickIndexChild *child = &self->children[i];
+
+      child->bounded = gtk_pick_index_get_child_bounds (child->widget, &child->bounds);
+      if (!child->bounded)
+        continue;
+
+      if (n_bounded == 0)
+        self->extents = child->bounds;
+      else
+        graphene_rect_union (&self->extents, &child->bounds, &self->extents);
+      n_bounded++;
+    }
+
+  self->n_everywhere = 0;
+  self->n_moved = 0;
+
+  size = CLAMP ((guint) sqrt (n_bounded), 1, MAX_GRID_SIZE);
+  self->n_columns = size;
+  self->n_rows = size;
+  self->cell_width = MAX (self->extents.size.width / size, 1.f);
+  self->cell_height = MAX (self->extents.size.height / size, 1.f);
+
+  n_cells = self->n_columns * self->n_rows;
+  g_free (self->cell_offsets);
+  self->cell_offsets = g_new0 (guint, n_cells + 1);
+
+  /* First count the entries per cell... */
+  for (i = 0; i < self->n_children; i++)
+    {
+      GtkPickIndexChild *child = &self->children[i];
+      guint x0, y0, x1, y1;
+
+      if (!child->bounded)
+        continue;
+
+      x0 = gtk_pick_index_get_column (self, child->bounds.origin.x);
+      x1 = gtk_pick_index_get_column (self, child->bounds.origin.x + child->bounds.size.width);
+      y0 = gtk_pick_index_get_row (self, child->bounds.origin.y);
+      y1 = gtk_pick_index_get_row (self, child->bounds.origin.y + child->bounds.size.height);
+
+      if ((x1 - x0 + 1) * (y1 - y0 + 1) > MAX_CELLS_PER_CHILD)
+        {
+          child->bounded = FALSE;
+          continue;
+        }
+
+      child->column0 = x0;
+      child->row0 = y0;
+      child->column1 = x1;
+      child->row1 = y1;
+
+      for (y = y0; y <= y1; y++)
+        for (x = x0; x <= x1; x++)
+          self->cell_offsets[y * self->n_columns + x + 1]++;
+    }
+
+  for (i = 1; i <= n_cells; i++)
+    self->cell_offsets[i] += self->cell_offsets[i - 1];
+
+  /* ...then fill them, in order */
+  g_free (self->cell_entries);
+  self->cell_entries = g_new (guint, self->cell_offsets[n_cells]);
+  fill = g_memdup2 (self->cell_offsets, sizeof (guint) * n_cells);
+
+  for (i = 0; i < self->n_children; i++)
+    {
+      GtkPickIndexChild *child = &self->children[i];
+
+      if (!child->bounded)
+        {
+          self->everywhere[self->n_everywhere++] = i;
+          continue;
+        }
+
+      for (y = child->row0; y <= child->row1; y++)
+        for (x = child->column0; x <= child->column1; x++)
+          self->cell_entries[fill[y * self->n_columns + x]++] = i;
+    }
+
+  g_free (fill);
+}
+
+/*<private>
+ * gtk_pick_index_new:
+ * @widget: the widget to index the children of
+ * @generation: the current generation
+ *
+ * Creates an index for the mapped children of @widget.
+ *
+ * If @widget does not have enough children to make an index
+ * worthwhile, the index will not be enabled, and callers should
+ * walk the children instead.
+ *
+ * Returns: (transfer full): a new `GtkPickIndex`
+ */
+GtkPickIndex *
+gtk_pick_index_new (GtkWidget *widget,
+                    guint      generation)
+{
+  GtkPickIndex *self;
+  GtkWidget *child;
+  guint i, n;
+
+  self = g_new0 (GtkPickIndex, 1);
+  self->generation = generation;
+
+  n = 0;
+  for (child = widget->priv->first_child;
+       child != NULL;
+       child = child->priv->next_sibling)
+    {
+      if (child->priv->mapped && !GTK_IS_NATIVE (child))
+        n++;
+    }
+
+  if (n < GTK_PICK_INDEX_MIN_CHILDREN)
+    return self;
+
+  self->enabled = TRUE;
+  self->children = g_new0 (GtkPickIndexChild, n);
+  self->n_children = n;
+  self->everywhere = g_new (guint, n);
+  self->dirty = g_ptr_array_new ();
+
+  i = 0;
+  for (child = widget->priv->first_child;
+       child != NULL;
+       child = child->priv->next_sibling)
+    {
+      if (!child->priv->mapped || GTK_IS_NATIVE (child))
+        continue;
+
+      child->priv->pick_slot = i;
+      child->priv->pick_dirty = FALSE;
+      self->children[i++].widget = child;
+    }
+
+  gtk_pick_index_build_grid (self);
+
+  return self;
+}
+
+void
+gtk_pick_index_free (GtkPickIndex *self)
+{
+  g_free (self->children);
+  g_free (self->everywhere);
+  g_free (self->cell_offsets);
+  g_free (self->cell_entries);
+  g_clear_pointer (&self->dirty, g_ptr_array_unref);
+  g_free (self);
+}
+
+gboolean
+gtk_pick_index_is_valid (const GtkPickIndex *self,
+                         guint               generation)
+{
+  return self->generation == generation;
+}
+
+gboolean
+gtk_pick_index_is_enabled (const GtkPickIndex *self)
+{
+  return self->enabled;
+}
+
+/*<private>
+ * gtk_pick_index_invalidate_child:
+ * @self: a `GtkPickIndex`
+ * @child: a child of the indexed widget
+ *
+ * Marks the bounds of @child as outdated, to be updated
+ * by the next call to gtk_pick_index_update().
+ */
+void
+gtk_pick_index_invalidate_child (GtkPickIndex *self,
+                                 GtkWidget    *child)
+{
+  if (!self->enabled || child->priv->pick_dirty)
+    return;
+
+  child->priv->pick_dirty = TRUE;
+  g_ptr_array_add (self->dirty, child);
+}
+
+static void
+gtk_pick_index_add_everywhere (GtkPickIndex *self,
+                               guint         i)
+{
+  guint pos;
+
+  for (pos = self->n_everywhere; pos > 0 && self->everywhere[pos - 1] > i; pos--)
+    self->everywhere[pos] = self->everywhere[pos - 1];
+
+  self->everywhere[pos] = i;
+  self->n_everywhere++;
+}
+
+/*<private>
+ * gtk_pick_index_update:
+ * @self: a `GtkPickIndex` that is valid for the current generation
+ *
+ * Updates the bounds of the children that were invalidated with
+ * gtk_pick_index_invalidate_child(). If too many of them moved out
+ * of their cells, the grid is built again.
+ */
+void
+gtk_pick_index_update (GtkPickIndex *self)
+{
+  guint i;
+
+  if (!self->enabled || self->dirty->len == 0)
+    return;
+
+  for (i = 0; i < self->dirty->len; i++)
+    {
+      GtkWidget *widget = g_ptr_array_index (self->dirty, i);
+      guint slot = widget->priv->pick_slot;
+      GtkPickIndexChild *child;
+      graphene_rect_t bounds;
+
+      widget->priv->pick_dirty = FALSE;
+
+      /* Popovers, or children that were unmapped since */
+      if (slot >= self->n_children || self->children[slot].widget != widget)
+        continue;
+
+      child = &self->children[slot];
+      if (!child->bounded)
+        continue;
+
+      if (gtk_pick_index_get_child_bounds (widget, &bounds) &&
+          graphene_rect_contains_rect (&self->extents, &bounds) &&
+          gtk_pick_index_get_column (self, bounds.origin.x) >= child->column0 &&
+          gtk_pick_index_get_column (self, bounds.origin.x + bounds.size.width) <= child->column1 &&
+          gtk_pick_index_get_row (self, bounds.origin.y) >= child->row0 &&
+          gtk_pick_index_get_row (self, bounds.origin.y + bounds.size.height) <= child->row1)
+        {
+          child->bounds = bounds;
+          continue;
+        }
+
+      /* The cells still list the child, but it is skipped there */
+      child->bounded = FALSE;
+      gtk_pick_index_add_everywhere (self, slot);
+      self->n_moved++;
+    }
+
+  g_ptr_array_set_size (self->dirty, 0);
+
+  if (self->n_moved > self->n_children / 4)
+    gtk_pick_index_build_grid (self);
+}
+
+/*<private>
+ * gtk_pick_index_iter_init:
+ * @iter: the iter to initialize
+ * @self: an enabled `GtkPickIndex`
+ * @x: X coordinate, relative to the indexed widget
+ * @y: Y coordinate, relative to the indexed widget
+ *
+ * Initializes @iter to iterate over all children that might
+ * contain the point, from top to bottom.
+ */
+void
+gtk_pick_index_iter_init (GtkPickIndexIter   *iter,
+                          const GtkPickIndex *self,
+                          double              x,
+                          double              y)
+{
+  g_assert (self->enabled);
+
+  iter->index = self;
+  graphene_point_init (&iter->point, x, y);
+  iter->everywhere_pos = (int) self->n_everywhere - 1;
+
+  if (graphene_rect_contains_point (&self->extents, &iter->point))
+    {
+      guint cell = gtk_pick_index_get_row (self, y) * self->n_columns
+                 + gtk_pick_index_get_column (self, x);
+
+      iter->cell = self->cell_entries + self->cell_offsets[cell];
+      iter->cell_pos = (int) (self->cell_offsets[cell + 1] - self->cell_offsets[cell]) - 1;
+    }
+  else
+    {
+      iter->cell = NULL;
+      iter->cell_pos = -1;
+    }
+}
+
+GtkWidget *
+gtk_pick_index_iter_next (GtkPickIndexIter *iter)
+{
+  const GtkPickIndex *self = iter->index;
+
+  while (iter->cell_pos >= 0 || iter->everywhere_pos >= 0)
+    {
+      guint i;
+
+      if (iter->everywhere_pos < 0 ||
+          (iter->cell_pos >= 0 && iter->cell[iter->cell_pos] > self->everywhere[iter->everywhere_pos]))
+        {
+          i = iter->cell[iter->cell_pos--];
+          if (!self->children[i].bounded ||
+              !graphene_rect_contains_point (&self->children[i].bounds, &iter->point))
+            continue;
+        }
+      else
+        {
+          i = self->everywhere[iter->everywhere_pos--];
+        }
+
+      return self->children[i].widget;
+    }
+
+  return NULL;
+}
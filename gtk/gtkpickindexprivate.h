@@ -0,0 +1,64 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_PICK_INDEX_PRIVATE_H__
+#define __GTK_PICK_INDEX_PRIVATE_H__
+
+#include "gtkwidget.h"
+
+G_BEGIN_DECLS
+
+/* widgets with fewer children are just walked */
+#define GTK_PICK_INDEX_MIN_CHILDREN 32
+
+typedef struct _GtkPickIndex GtkPickIndex;
+typedef struct _GtkPickIndexIter GtkPickIndexIter;
+
+struct _GtkPickIndexIter
+{
+  /*< private >*/
+  const GtkPickIndex *index;
+  graphene_point_t point;
+  const guint *cell;
+  int cell_pos;
+  int everywhere_pos;
+};
+
+GtkPickIndex *          gtk_pick_index_new                      (GtkWidget              *widget,
+                                                                 guint                   generation);
+void                    gtk_pick_index_free                     (GtkPickIndex           *self);
+
+gboolean                gtk_pick_index_is_valid                 (const GtkPickIndex     *self,
+                                                                 guint                   generation);
+gboolean                gtk_pick_index_is_enabled               (const GtkPickIndex     *self);
+
+void                    gtk_pick_index_invalidate_child         (GtkPickIndex           *self,
+                                                                 GtkWidget              *child);
+void                    gtk_pick_index_update                   (GtkPickIndex           *self);
+
+gboolean                gtk_pick_index_get_bounds               (GtkWidget              *widget,
+                                                                 graphene_rect_t        *bounds);
+
+void                    gtk_pick_index_iter_init                (GtkPickIndexIter       *iter,
+                                                                 const GtkPickIndex     *self,
+                                                                 double                  x,
+                                                                 double                  y);
+GtkWidget *             gtk_pick_index_iter_next                (GtkPickIndexIter       *iter);
+
+G_END_DECLS
+
+#endif /* __GTK_PICK_INDEX_PRIVATE_H__ */
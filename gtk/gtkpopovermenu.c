@@ -158,6 +158,7 @@ struct _GtkPopoverMenu
   GtkWidget *parent_menu;
   GMenuModel *model;
   GtkPopoverMenuFlags flags;
+  guint needs_populate : 1;
 };
 
 struct _GtkPopoverMenuClass
@@ -421,7 +422,7 @@ gtk_popover_menu_set_property (GObject      *object,
   switch (property_id)
     {
     case PROP_VISIBLE_SUBMENU:
-      gtk_stack_set_visible_child_name (GTK_STACK (gtk_popover_menu_get_stack (menu)), g_value_get_string (value));
+      gtk_popover_menu_open_submenu (menu, g_value_get_string (value));
       break;
 
     case PROP_MENU_MODEL:
@@ -547,6 +548,15 @@ add_arrow_bindings (GtkWidgetClass   *widget_class,
 static void
 gtk_popover_menu_show (GtkWidget *widget)
 {
+  GtkPopoverMenu *popover = GTK_POPOVER_MENU (widget);
+
+  if (popover->needs_populate)
+    {
+      popover->needs_populate = FALSE;
+      if (popover->model)
+        gtk_menu_section_box_new_toplevel (popover, popover->model, popover->flags);
+    }
+
   gtk_popover_menu_set_open_submenu (GTK_POPOVER_MENU (widget), NULL);
 
   GTK_WIDGET_CLASS (gtk_popover_menu_parent_class)->show (widget);
@@ -705,6 +715,8 @@ gtk_popover_menu_open_submenu (GtkPopoverMenu *popover,
 
   g_return_if_fail (GTK_IS_POPOVER_MENU (popover));
 
+  gtk_menu_section_box_ensure_submenu (popover, name);
+
   stack = gtk_popover_menu_get_stack (popover);
   gtk_stack_set_visible_child_name (GTK_STACK (stack), name);
 }
@@ -779,6 +791,32 @@ gtk_popover_menu_new_from_model_full (GMenuModel          *model,
   return popover;
 }
 
+/*< private >
+ * gtk_popover_menu_new_from_model_lazy:
+ * @model: a `GMenuModel`
+ * @flags: flags that affect how the menu is created
+ *
+ * Creates a `GtkPopoverMenu` like gtk_popover_menu_new_from_model_full(),
+ * but only populates it from @model when it is shown for the first time.
+ *
+ * This is used for nested submenus, which can not have custom children.
+ *
+ * Returns: the new `GtkPopoverMenu`
+ */
+GtkWidget *
+gtk_popover_menu_new_from_model_lazy (GMenuModel          *model,
+                                      GtkPopoverMenuFlags  flags)
+{
+  GtkPopoverMenu *popover;
+
+  popover = GTK_POPOVER_MENU (gtk_popover_menu_new ());
+  popover->flags = flags;
+  popover->model = g_object_ref (model);
+  popover->needs_populate = TRUE;
+
+  return GTK_WIDGET (popover);
+}
+
 /**
  * gtk_popover_menu_set_menu_model: (attributes org.gtk.Method.set_property=menu-model)
  * @popover: a `GtkPopoverMenu`
@@ -802,6 +840,8 @@ gtk_popover_menu_set_menu_model (GtkPopoverMenu *popover,
       GtkWidget *stack;
       GtkWidget *child;
 
+      popover->needs_populate = FALSE;
+
       stack = gtk_popover_menu_get_stack (popover);
       while ((child = gtk_widget_get_first_child (stack)))
         gtk_stack_remove (GTK_STACK (stack), child);
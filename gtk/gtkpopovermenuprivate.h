@@ -35,6 +35,8 @@ void       gtk_popover_menu_set_parent_menu  (GtkPopoverMenu *menu,
                                               GtkWidget      *parent);
 
 GtkWidget * gtk_popover_menu_new (void);
+GtkWidget * gtk_popover_menu_new_from_model_lazy (GMenuModel          *model,
+                                                  GtkPopoverMenuFlags  flags);
 
 void  gtk_popover_menu_add_submenu (GtkPopoverMenu *popover,
                                     GtkWidget      *submenu,
@@ -36,6 +36,7 @@
 #include "gtkcsscolorvalueprivate.h"
 #include "gtkcssstyleprivate.h"
 #include "gtkcsstypesprivate.h"
+#include "gtkrendercacheprivate.h"
 
 #include <math.h>
 
@@ -247,6 +248,7 @@ gtk_css_style_snapshot_background (GtkCssBoxes *boxes,
 {
   const GtkCssBackgroundValues *background = boxes->style->background;
   GtkCssValue *background_image;
+  GtkSnapshot *target;
   const GdkRGBA *bg_color;
   const GtkCssValue *box_shadow;
   gboolean has_bg_color;
@@ -270,11 +272,15 @@ gtk_css_style_snapshot_background (GtkCssBoxes *boxes,
   if (!has_bg_color && !has_bg_image && !has_shadow)
     return;
 
-  gtk_snapshot_push_debug (snapshot, "CSS background");
+  target = gtk_render_cache_begin (GTK_RENDER_CACHE_BACKGROUND, boxes, snapshot);
+  if (target == NULL)
+    return;
+
+  gtk_snapshot_push_debug (target, "CSS background");
 
   if (has_shadow)
     gtk_css_shadow_value_snapshot_outset (box_shadow,
-                                          snapshot,
+                                          target,
                                           gtk_css_boxes_get_border_box (boxes));
 
   number_of_layers = _gtk_css_array_value_get_n_values (background_image);
@@ -289,36 +295,38 @@ gtk_css_style_snapshot_background (GtkCssBoxes *boxes,
           blend_mode_values[idx] = _gtk_css_blend_mode_value_get (_gtk_css_array_value_get_nth (blend_modes, idx));
 
           if (blend_mode_values[idx] != GSK_BLEND_MODE_DEFAULT)
-            gtk_snapshot_push_blend (snapshot, blend_mode_values[idx]);
+            gtk_snapshot_push_blend (target, blend_mode_values[idx]);
         }
 
       if (has_bg_color)
-        gtk_theming_background_snapshot_color (boxes, snapshot, bg_color, number_of_layers);
+        gtk_theming_background_snapshot_color (boxes, target, bg_color, number_of_layers);
 
       for (idx = number_of_layers - 1; idx >= 0; idx--)
         {
           if (blend_mode_values[idx] == GSK_BLEND_MODE_DEFAULT)
             {
-              gtk_theming_background_snapshot_layer (boxes, idx, snapshot);
+              gtk_theming_background_snapshot_layer (boxes, idx, target);
             }
           else
             {
-              gtk_snapshot_pop (snapshot);
-              gtk_theming_background_snapshot_layer (boxes, idx, snapshot);
-              gtk_snapshot_pop (snapshot);
+              gtk_snapshot_pop (target);
+              gtk_theming_background_snapshot_layer (boxes, idx, target);
+              gtk_snapshot_pop (target);
             }
         }
     }
   else if (has_bg_color)
     {
-      gtk_theming_background_snapshot_color (boxes, snapshot, bg_color, number_of_layers);
+      gtk_theming_background_snapshot_color (boxes, target, bg_color, number_of_layers);
     }
 
   if (has_shadow)
     gtk_css_shadow_value_snapshot_inset (box_shadow,
-                                         snapshot,
+                                         target,
                                          gtk_css_boxes_get_padding_box (boxes));
 
-  gtk_snapshot_pop (snapshot);
+  gtk_snapshot_pop (target);
+
+  gtk_render_cache_end (GTK_RENDER_CACHE_BACKGROUND, boxes, snapshot, target);
 }
 
@@ -33,6 +33,7 @@
 #include "gtkcssrepeatvalueprivate.h"
 #include "gtkcsscolorvalueprivate.h"
 #include "gtkcssstyleprivate.h"
+#include "gtkrendercacheprivate.h"
 #include "gtkroundedboxprivate.h"
 #include "gtksnapshotprivate.h"
 
@@ -648,6 +649,7 @@ gtk_css_style_snapshot_border (GtkCssBoxes *boxes,
 {
   const GtkCssBorderValues *border = boxes->style->border;
   GtkBorderImage border_image;
+  GtkSnapshot *target;
   float border_width[4];
 
   if (border->base.type == GTK_CSS_BORDER_INITIAL_VALUES)
@@ -665,11 +667,17 @@ gtk_css_style_snapshot_border (GtkCssBoxes *boxes,
 
       bounds = gtk_css_boxes_get_border_rect (boxes);
 
-      gtk_snapshot_push_debug (snapshot, "CSS border image");
-      cr = gtk_snapshot_append_cairo (snapshot, bounds);
+      target = gtk_render_cache_begin (GTK_RENDER_CACHE_BORDER, boxes, snapshot);
+      if (target == NULL)
+        return;
+
+      gtk_snapshot_push_debug (target, "CSS border image");
+      cr = gtk_snapshot_append_cairo (target, bounds);
       gtk_border_image_render (&border_image, border_width, cr, bounds);
       cairo_destroy (cr);
-      gtk_snapshot_pop (snapshot);
+      gtk_snapshot_pop (target);
+
+      gtk_render_cache_end (GTK_RENDER_CACHE_BORDER, boxes, snapshot, target);
     }
   else
     {
@@ -701,27 +709,33 @@ gtk_css_style_snapshot_border (GtkCssBoxes *boxes,
       border_width[2] = _gtk_css_number_value_get (border->border_bottom_width, 100);
       border_width[3] = _gtk_css_number_value_get (border->border_left_width, 100);
 
-      gtk_snapshot_push_debug (snapshot, "CSS border");
+      target = gtk_render_cache_begin (GTK_RENDER_CACHE_BORDER, boxes, snapshot);
+      if (target == NULL)
+        return;
+
+      gtk_snapshot_push_debug (target, "CSS border");
       if (border_style[0] <= GTK_BORDER_STYLE_SOLID &&
           border_style[1] <= GTK_BORDER_STYLE_SOLID &&
           border_style[2] <= GTK_BORDER_STYLE_SOLID &&
           border_style[3] <= GTK_BORDER_STYLE_SOLID)
         {
           /* The most common case of a solid border */
-          gtk_snapshot_append_border (snapshot,
+          gtk_snapshot_append_border (target,
                                       gtk_css_boxes_get_border_box (boxes),
                                       border_width,
                                       colors);
         }
       else
         {
-          snapshot_border (snapshot,
+          snapshot_border (target,
                            gtk_css_boxes_get_border_box (boxes),
                            border_width,
                            colors,
                            border_style);
         }
-       gtk_snapshot_pop (snapshot);
+       gtk_snapshot_pop (target);
+
+      gtk_render_cache_end (GTK_RENDER_CACHE_BORDER, boxes, snapshot, target);
     }
 }
 
@@ -730,6 +744,7 @@ gtk_css_style_snapshot_outline (GtkCssBoxes *boxes,
                                 GtkSnapshot *snapshot)
 {
   GtkCssOutlineValues *outline = boxes->style->outline;
+  GtkSnapshot *target;
   GtkBorderStyle border_style[4];
   float border_width[4];
   GdkRGBA colors[4];
@@ -752,10 +767,16 @@ gtk_css_style_snapshot_outline (GtkCssBoxes *boxes,
       border_width[3] = border_width[2] = border_width[1] = border_width[0];
       colors[0] = colors[1] = colors[2] = colors[3] = *color;
 
-      snapshot_border (snapshot,
+      target = gtk_render_cache_begin (GTK_RENDER_CACHE_OUTLINE, boxes, snapshot);
+      if (target == NULL)
+        return;
+
+      snapshot_border (target,
                        gtk_css_boxes_get_outline_box (boxes),
                        border_width,
                        colors,
                        border_style);
+
+      gtk_render_cache_end (GTK_RENDER_CACHE_OUTLINE, boxes, snapshot, target);
     }
 }
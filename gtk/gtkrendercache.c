@@ -0,0 +1,245 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkrendercacheprivate.h"
+
+#include "gtkcssstyleprivate.h"
+#include "gtkdebug.h"
+#include "gtksnapshot.h"
+#include "gdkprofilerprivate.h"
+
+/*
+ * The render cache keeps the render nodes created for the CSS
+ * background, border and outline of a box, so that boxes with the same
+ * style and size, like the thousands of identical buttons or rows in
+ * a large grid or list, create them only once and share them.
+ *
+ * Sibling widgets in the same state share their style, and all boxes
+ * are computed from the border box and the style, so those two are all
+ * the key needs. The nodes don't depend on the scale, anything that
+ * does, like icon theme images, has the scale in its computed value
+ * already.
+ *
+ * Only static styles are cached, as animated styles are replaced every
+ * frame anyway. The cache holds a reference to the styles in it and is
+ * bounded, with the least recently used entries being dropped first.
+ */
+
+#define MAX_ENTRIES 1024
+
+typedef struct
+{
+  GtkRenderCacheKind kind;
+  GtkCssStyle *style;
+  graphene_rect_t bounds;
+} CacheKey;
+
+typedef struct
+{
+  CacheKey key;
+  GskRenderNode *node; /* may be NULL if nothing gets drawn */
+  GList link;
+} CacheEntry;
+
+static GHashTable *cache;
+static GQueue lru = G_QUEUE_INIT;
+
+static guint frame_hits, frame_misses;
+static guint hits_counter, misses_counter;
+
+static guint
+cache_key_hash (gconstpointer data)
+{
+  const CacheKey *key = data;
+  guint h;
+
+  h = g_direct_hash (key->style);
+  h = h * 31 + key->kind;
+  h = h * 31 + (int) (key->bounds.origin.x * 8);
+  h = h * 31 + (int) (key->bounds.origin.y * 8);
+  h = h * 31 + (int) (key->bounds.size.width * 8);
+  h = h * 31 + (int) (key->bounds.size.height * 8);
+
+  return h;
+}
+
+static gboolean
+cache_key_equal (gconstpointer a,
+                 gconstpointer b)
+{
+  const CacheKey *ka = a;
+  const CacheKey *kb = b;
+
+  return ka->style == kb->style &&
+         ka->kind == kb->kind &&
+         graphene_rect_equal (&ka->bounds, &kb->bounds);
+}
+
+static void
+cache_entry_free (gpointer data)
+{
+  CacheEntry *entry = data;
+
+  g_object_unref (entry->key.style);
+  g_clear_pointer (&entry->node, gsk_render_node_unref);
+  g_free (entry);
+}
+
+static void
+ensure_cache (void)
+{
+  if (cache)
+    return;
+
+  cache = g_hash_table_new_full (cache_key_hash, cache_key_equal, NULL, cache_entry_free);
+
+  hits_counter = gdk_profiler_define_int_counter ("render-cache-hits", "CSS render node cache hits");
+  misses_counter = gdk_profiler_define_int_counter ("render-cache-misses", "CSS render node cache misses");
+}
+
+static gboolean
+cache_key_init (CacheKey           *key,
+                GtkRenderCacheKind  kind,
+                GtkCssBoxes        *boxes)
+{
+  if (!gtk_css_style_is_static (boxes->style) ||
+      GTK_DEBUG_CHECK (NO_CSS_CACHE))
+    return FALSE;
+
+  key->kind = kind;
+  key->style = boxes->style;
+  key->bounds = *gtk_css_boxes_get_border_rect (boxes);
+
+  return TRUE;
+}
+
+/*<private>
+ * gtk_render_cache_begin:
+ * @kind: what is going to be drawn
+ * @boxes: the boxes to draw for
+ * @snapshot: the snapshot to draw to
+ *
+ * Starts drawing the part of @boxes given by @kind. If it is in the
+ * cache, the cached node is appended to @snapshot and %NULL is
+ * returned. Otherwise a snapshot to draw to is returned, which must
+ * be passed to gtk_render_cache_end() when done.
+ *
+ * Returns: (nullable): the snapshot to draw to
+ */
+GtkSnapshot *
+gtk_render_cache_begin (GtkRenderCacheKind  kind,
+                        GtkCssBoxes        *boxes,
+                        GtkSnapshot        *snapshot)
+{
+  CacheEntry *entry;
+  CacheKey key;
+
+  if (!cache_key_init (&key, kind, boxes))
+    return snapshot;
+
+  ensure_cache ();
+
+  entry = g_hash_table_lookup (cache, &key);
+  if (entry == NULL)
+    {
+      frame_misses++;
+      return gtk_snapshot_new ();
+    }
+
+  frame_hits++;
+
+  g_queue_unlink (&lru, &entry->link);
+  g_queue_push_head_link (&lru, &entry->link);
+
+  if (entry->node)
+    gtk_snapshot_append_node (snapshot, entry->node);
+
+  return NULL;
+}
+
+/*<private>
+ * gtk_render_cache_end:
+ * @kind: what was drawn
+ * @boxes: the boxes that were drawn for
+ * @snapshot: the snapshot passed to gtk_render_cache_begin()
+ * @cache_snapshot: the snapshot returned by gtk_render_cache_begin()
+ *
+ * Finishes drawing after gtk_render_cache_begin(), storing the
+ * result in the cache and appending it to @snapshot if needed.
+ */
+void
+gtk_render_cache_end (GtkRenderCacheKind  kind,
+                      GtkCssBoxes        *boxes,
+                      GtkSnapshot        *snapshot,
+                      GtkSnapshot        *cache_snapshot)
+{
+  CacheEntry *entry;
+  GskRenderNode *node;
+  CacheKey key;
+
+  if (cache_snapshot == snapshot)
+    return;
+
+  node = gtk_snapshot_free_to_node (cache_snapshot);
+  if (node)
+    gtk_snapshot_append_node (snapshot, node);
+
+  /* The debug flags may have changed while drawing */
+  if (!cache_key_init (&key, kind, boxes))
+    {
+      g_clear_pointer (&node, gsk_render_node_unref);
+      return;
+    }
+
+  entry = g_new0 (CacheEntry, 1);
+  entry->key = key;
+  g_object_ref (entry->key.style);
+  entry->node = node;
+  entry->link.data = entry;
+
+  g_hash_table_insert (cache, &entry->key, entry);
+  g_queue_push_head_link (&lru, &entry->link);
+
+  while (lru.length > MAX_ENTRIES)
+    {
+      GList *last = g_queue_pop_tail_link (&lru);
+      CacheEntry *old = last->data;
+
+      g_hash_table_remove (cache, &old->key);
+    }
+}
+
+/*<private>
+ * gtk_render_cache_report_statistics:
+ *
+ * Reports the cache hits and misses since the last call
+ * to the profiler.
+ */
+void
+gtk_render_cache_report_statistics (void)
+{
+  if (cache && GDK_PROFILER_IS_RUNNING)
+    {
+      gdk_profiler_set_int_counter (hits_counter, frame_hits);
+      gdk_profiler_set_int_counter (misses_counter, frame_misses);
+    }
+
+  frame_hits = 0;
+  frame_misses = 0;
+}
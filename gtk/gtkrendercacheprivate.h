@@ -0,0 +1,44 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_RENDER_CACHE_PRIVATE_H__
+#define __GTK_RENDER_CACHE_PRIVATE_H__
+
+#include "gtkcssboxesprivate.h"
+#include "gtktypes.h"
+
+G_BEGIN_DECLS
+
+typedef enum {
+  GTK_RENDER_CACHE_BACKGROUND,
+  GTK_RENDER_CACHE_BORDER,
+  GTK_RENDER_CACHE_OUTLINE
+} GtkRenderCacheKind;
+
+GtkSnapshot *   gtk_render_cache_begin                  (GtkRenderCacheKind      kind,
+                                                         GtkCssBoxes            *boxes,
+                                                         GtkSnapshot            *snapshot);
+void            gtk_render_cache_end                    (GtkRenderCacheKind      kind,
+                                                         GtkCssBoxes            *boxes,
+                                                         GtkSnapshot            *snapshot,
+                                                         GtkSnapshot            *cache_snapshot);
+
+void            gtk_render_cache_report_statistics      (void);
+
+G_END_DECLS
+
+#endif /* __GTK_RENDER_CACHE_PRIVATE_H__ */
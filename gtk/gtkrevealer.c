@@ -28,6 +28,7 @@
 #include "gtkprivate.h"
 #include "gtkprogresstrackerprivate.h"
 #include "gtksettingsprivate.h"
+#include "gtktransitioncacheprivate.h"
 #include "gtktypebuiltins.h"
 #include "gtkwidgetprivate.h"
 #include "gtkbuildable.h"
@@ -90,6 +91,7 @@ struct _GtkRevealer
 
   guint tick_id;
   GtkProgressTracker tracker;
+  GtkTransitionCache cache;
 };
 
 typedef struct
@@ -169,6 +171,7 @@ gtk_revealer_dispose (GObject *obj)
   GtkRevealer *revealer = GTK_REVEALER (obj);
 
   g_clear_pointer (&revealer->child, gtk_widget_unparent);
+  gtk_transition_cache_clear (&revealer->cache);
 
   G_OBJECT_CLASS (gtk_revealer_parent_class)->dispose (obj);
 }
@@ -260,6 +263,26 @@ gtk_revealer_unmap (GtkWidget *widget)
       gtk_widget_remove_tick_callback (GTK_WIDGET (revealer), revealer->tick_id);
       revealer->tick_id = 0;
     }
+
+  gtk_transition_cache_clear (&revealer->cache);
+}
+
+static void
+gtk_revealer_snapshot (GtkWidget   *widget,
+                       GtkSnapshot *snapshot)
+{
+  GtkRevealer *revealer = GTK_REVEALER (widget);
+
+  if (revealer->child == NULL)
+    return;
+
+  /* While animating, only the position or opacity of the
+   * child changes, so we can reuse a texture of it.
+   */
+  if (revealer->tick_id != 0)
+    gtk_transition_cache_snapshot_child (&revealer->cache, widget, revealer->child, snapshot);
+  else
+    gtk_widget_snapshot_child (widget, revealer->child, snapshot);
 }
 
 static void
@@ -305,6 +328,7 @@ gtk_revealer_class_init (GtkRevealerClass *klass)
 
   widget_class->unmap = gtk_revealer_unmap;
   widget_class->size_allocate = gtk_revealer_size_allocate;
+  widget_class->snapshot = gtk_revealer_snapshot;
   widget_class->measure = gtk_revealer_measure;
   widget_class->compute_expand = gtk_revealer_compute_expand;
   widget_class->get_request_mode = gtk_revealer_get_request_mode;
@@ -638,6 +662,7 @@ gtk_revealer_animate_cb (GtkWidget     *widget,
   if (gtk_progress_tracker_get_state (&revealer->tracker) == GTK_PROGRESS_STATE_AFTER)
     {
       revealer->tick_id = 0;
+      gtk_transition_cache_clear (&revealer->cache);
       return FALSE;
     }
 
@@ -664,6 +689,7 @@ gtk_revealer_start_animation (GtkRevealer *revealer,
       gtk_settings_get_enable_animations (gtk_widget_get_settings (widget)))
     {
       revealer->source_pos = revealer->current_pos;
+      gtk_transition_cache_clear (&revealer->cache);
       if (revealer->tick_id == 0)
         revealer->tick_id =
           gtk_widget_add_tick_callback (widget, gtk_revealer_animate_cb, revealer, NULL);
@@ -878,6 +904,7 @@ gtk_revealer_set_child (GtkRevealer *revealer,
   g_return_if_fail (child == NULL || GTK_IS_WIDGET (child));
 
   g_clear_pointer (&revealer->child, gtk_widget_unparent);
+  gtk_transition_cache_clear (&revealer->cache);
 
   if (child)
     {
@@ -274,6 +274,11 @@ typedef struct
 
   guint scroll_events_overshoot_id;
 
+  /* Scroll deltas waiting to be applied in the next frame */
+  double pending_scroll_dx;
+  double pending_scroll_dy;
+  guint scroll_flush_id;
+
   /* Kinetic scrolling */
   GtkGesture *long_press_gesture;
   GtkGesture *swipe_gesture;
@@ -390,6 +395,7 @@ static gboolean _gtk_scrolled_window_get_overshoot (GtkScrolledWindow *scrolled_
                                                     int               *overshoot_y);
 
 static void     gtk_scrolled_window_start_deceleration (GtkScrolledWindow *scrolled_window);
+static void     gtk_scrolled_window_flush_scroll       (GtkScrolledWindow *scrolled_window);
 
 static void     gtk_scrolled_window_update_use_indicators (GtkScrolledWindow *scrolled_window);
 static void     remove_indicator     (GtkScrolledWindow *sw,
@@ -1350,59 +1356,53 @@ scroll_controller_scroll_begin (GtkEventControllerScroll *scroll,
   priv->smooth_scroll = TRUE;
 }
 
+static gboolean
+scroll_flush_cb (GtkWidget     *widget,
+                 GdkFrameClock *frame_clock,
+                 gpointer       user_data)
+{
+  GtkScrolledWindow *scrolled_window = user_data;
+  GtkScrolledWindowPrivate *priv = gtk_scrolled_window_get_instance_private (scrolled_window);
+
+  priv->scroll_flush_id = 0;
+  gtk_scrolled_window_flush_scroll (scrolled_window);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Applies the scroll deltas accumulated since the last frame */
 static void
-scrolled_window_scroll (GtkScrolledWindow        *scrolled_window,
-                        double                    delta_x,
-                        double                    delta_y,
-                        GtkEventControllerScroll *scroll)
+gtk_scrolled_window_flush_scroll (GtkScrolledWindow *scrolled_window)
 {
   GtkScrolledWindowPrivate *priv =
     gtk_scrolled_window_get_instance_private (scrolled_window);
-  gboolean shifted;
-  GdkModifierType state;
-
-  state = gtk_event_controller_get_current_event_state (GTK_EVENT_CONTROLLER (scroll));
-  shifted = (state & GDK_SHIFT_MASK) != 0;
-
-  gtk_scrolled_window_invalidate_overshoot (scrolled_window);
 
-  if (shifted)
+  if (priv->scroll_flush_id)
     {
-      double delta;
-
-      delta = delta_x;
-      delta_x = delta_y;
-      delta_y = delta;
+      gtk_widget_remove_tick_callback (GTK_WIDGET (scrolled_window), priv->scroll_flush_id);
+      priv->scroll_flush_id = 0;
     }
+  else if (priv->pending_scroll_dx == 0.0 && priv->pending_scroll_dy == 0.0)
+    return;
 
-  if (delta_x != 0.0 &&
-      may_hscroll (scrolled_window))
+  if (priv->pending_scroll_dx != 0.0)
     {
       GtkAdjustment *adj;
-      double new_value;
-      double scroll_unit;
 
       adj = gtk_scrollbar_get_adjustment (GTK_SCROLLBAR (priv->hscrollbar));
-      scroll_unit = get_scroll_unit (scrolled_window, GTK_ORIENTATION_HORIZONTAL);
-
-      new_value = priv->unclamped_hadj_value + delta_x * scroll_unit;
       _gtk_scrolled_window_set_adjustment_value (scrolled_window, adj,
-                                                 new_value);
+                                                 priv->unclamped_hadj_value + priv->pending_scroll_dx);
+      priv->pending_scroll_dx = 0.0;
     }
 
-  if (delta_y != 0.0 &&
-      may_vscroll (scrolled_window))
+  if (priv->pending_scroll_dy != 0.0)
     {
       GtkAdjustment *adj;
-      double new_value;
-      double scroll_unit;
 
       adj = gtk_scrollbar_get_adjustment (GTK_SCROLLBAR (priv->vscrollbar));
-      scroll_unit = get_scroll_unit (scrolled_window, GTK_ORIENTATION_VERTICAL);
-
-      new_value = priv->unclamped_vadj_value + delta_y * scroll_unit;
       _gtk_scrolled_window_set_adjustment_value (scrolled_window, adj,
-                                                 new_value);
+                                                 priv->unclamped_vadj_value + priv->pending_scroll_dy);
+      priv->pending_scroll_dy = 0.0;
     }
 
   g_clear_handle_id (&priv->scroll_events_overshoot_id, g_source_remove);
@@ -1417,6 +1417,51 @@ scrolled_window_scroll (GtkScrolledWindow        *scrolled_window,
     }
 }
 
+static void
+scrolled_window_scroll (GtkScrolledWindow        *scrolled_window,
+                        double                    delta_x,
+                        double                    delta_y,
+                        GtkEventControllerScroll *scroll)
+{
+  GtkScrolledWindowPrivate *priv =
+    gtk_scrolled_window_get_instance_private (scrolled_window);
+  gboolean shifted;
+  GdkModifierType state;
+
+  state = gtk_event_controller_get_current_event_state (GTK_EVENT_CONTROLLER (scroll));
+  shifted = (state & GDK_SHIFT_MASK) != 0;
+
+  gtk_scrolled_window_invalidate_overshoot (scrolled_window);
+
+  if (shifted)
+    {
+      double delta;
+
+      delta = delta_x;
+      delta_x = delta_y;
+      delta_y = delta;
+    }
+
+  if (delta_x != 0.0 &&
+      may_hscroll (scrolled_window))
+    priv->pending_scroll_dx += delta_x * get_scroll_unit (scrolled_window, GTK_ORIENTATION_HORIZONTAL);
+
+  if (delta_y != 0.0 &&
+      may_vscroll (scrolled_window))
+    priv->pending_scroll_dy += delta_y * get_scroll_unit (scrolled_window, GTK_ORIENTATION_VERTICAL);
+
+  /* Input devices can send many scroll events per frame. Instead of
+   * changing the adjustments - and relayouting the child - for each
+   * of them, sum them up and apply them once per frame.
+   */
+  if (!gtk_widget_get_mapped (GTK_WIDGET (scrolled_window)))
+    gtk_scrolled_window_flush_scroll (scrolled_window);
+  else if (priv->scroll_flush_id == 0)
+    priv->scroll_flush_id = gtk_widget_add_tick_callback (GTK_WIDGET (scrolled_window),
+                                                          scroll_flush_cb, scrolled_window,
+                                                          NULL);
+}
+
 static gboolean
 scroll_controller_scroll (GtkEventControllerScroll *scroll,
                           double                    delta_x,
@@ -1438,6 +1483,7 @@ scroll_controller_scroll_end (GtkEventControllerScroll *scroll,
 {
   GtkScrolledWindowPrivate *priv = gtk_scrolled_window_get_instance_private (scrolled_window);
 
+  gtk_scrolled_window_flush_scroll (scrolled_window);
   priv->smooth_scroll = FALSE;
 }
 
@@ -2602,6 +2648,12 @@ gtk_scrolled_window_dispose (GObject *object)
 
   g_clear_pointer (&priv->child, gtk_widget_unparent);
 
+  if (priv->scroll_flush_id)
+    {
+      gtk_widget_remove_tick_callback (GTK_WIDGET (self), priv->scroll_flush_id);
+      priv->scroll_flush_id = 0;
+    }
+
   remove_indicator (self, &priv->hindicator);
   remove_indicator (self, &priv->vindicator);
 
@@ -3229,6 +3281,24 @@ _gtk_scrolled_window_set_adjustment_value (GtkScrolledWindow *scrolled_window,
   g_signal_emit (scrolled_window, signals[EDGE_OVERSHOT], 0, edge_pos);
 }
 
+/* The time at which the frame that is being drawn will be shown, so
+ * that kinetic scrolling positions match what ends up on screen.
+ */
+static gint64
+gtk_scrolled_window_get_predicted_time (GdkFrameClock *frame_clock)
+{
+  gint64 frame_time, refresh_interval, presentation_time;
+
+  frame_time = gdk_frame_clock_get_frame_time (frame_clock);
+  gdk_frame_clock_get_refresh_info (frame_clock, frame_time,
+                                    &refresh_interval, &presentation_time);
+
+  if (presentation_time == 0)
+    return frame_time;
+
+  return presentation_time;
+}
+
 static gboolean
 scrolled_window_deceleration_cb (GtkWidget         *widget,
                                  GdkFrameClock     *frame_clock,
@@ -3240,8 +3310,8 @@ scrolled_window_deceleration_cb (GtkWidget         *widget,
   gint64 current_time;
   double position, elapsed;
 
-  current_time = gdk_frame_clock_get_frame_time (frame_clock);
-  elapsed = (current_time - priv->last_deceleration_time) / (double)G_TIME_SPAN_SECOND;
+  current_time = gtk_scrolled_window_get_predicted_time (frame_clock);
+  elapsed = MAX (current_time - priv->last_deceleration_time, 0) / (double)G_TIME_SPAN_SECOND;
   priv->last_deceleration_time = current_time;
 
   hadjustment = gtk_scrollbar_get_adjustment (GTK_SCROLLBAR (priv->hscrollbar));
@@ -3327,10 +3397,13 @@ gtk_scrolled_window_start_deceleration (GtkScrolledWindow *scrolled_window)
 
   g_return_if_fail (priv->deceleration_id == 0);
 
+  /* Start from where pending scroll events would have taken us */
+  gtk_scrolled_window_flush_scroll (scrolled_window);
+
   frame_clock = gtk_widget_get_frame_clock (GTK_WIDGET (scrolled_window));
 
-  current_time = gdk_frame_clock_get_frame_time (frame_clock);
-  elapsed = (current_time - priv->last_deceleration_time) / (double)G_TIME_SPAN_SECOND;
+  current_time = gtk_scrolled_window_get_predicted_time (frame_clock);
+  elapsed = MAX (current_time - priv->last_deceleration_time, 0) / (double)G_TIME_SPAN_SECOND;
   priv->last_deceleration_time = current_time;
 
   if (may_hscroll (scrolled_window))
@@ -3616,6 +3689,8 @@ gtk_scrolled_window_unmap (GtkWidget *widget)
   GtkScrolledWindow *scrolled_window = GTK_SCROLLED_WINDOW (widget);
   GtkScrolledWindowPrivate *priv = gtk_scrolled_window_get_instance_private (scrolled_window);
 
+  gtk_scrolled_window_flush_scroll (scrolled_window);
+
   GTK_WIDGET_CLASS (gtk_scrolled_window_parent_class)->unmap (widget);
 
   gtk_scrolled_window_update_animating (scrolled_window);
@@ -20,10 +20,12 @@
 
 #include "gtksettingsprivate.h"
 
+#include "gtkcssimagecacheprivate.h"
 #include "gtkcssproviderprivate.h"
 #include "gtkintl.h"
 #include "gtkprivate.h"
 #include "gtkscrolledwindow.h"
+#include "gtkshapingcacheprivate.h"
 #include "gtkstylecontextprivate.h"
 #include "gtkstyleproviderprivate.h"
 #include "gtktypebuiltins.h"
@@ -1445,6 +1447,7 @@ gtk_settings_notify (GObject    *object,
       break;
     case PROP_FONT_NAME:
       settings_update_font_values (settings);
+      gtk_shaping_cache_clear ();
       settings_invalidate_style (settings);
       gtk_system_setting_changed (settings->display, GTK_SYSTEM_SETTING_FONT_NAME);
       break;
@@ -1453,6 +1456,7 @@ gtk_settings_notify (GObject    *object,
       settings_update_theme (settings);
       break;
     case PROP_XFT_DPI:
+      gtk_shaping_cache_clear ();
       settings_invalidate_style (settings);
       gtk_system_setting_changed (settings->display, GTK_SYSTEM_SETTING_DPI);
       break;
@@ -1462,11 +1466,15 @@ gtk_settings_notify (GObject    *object,
     case PROP_XFT_RGBA:
     case PROP_HINT_FONT_METRICS:
       settings_update_font_options (settings);
+      gtk_shaping_cache_clear ();
       gtk_system_setting_changed (settings->display, GTK_SYSTEM_SETTING_FONT_CONFIG);
       break;
     case PROP_FONTCONFIG_TIMESTAMP:
       if (settings_update_fontconfig (settings))
-        gtk_system_setting_changed (settings->display, GTK_SYSTEM_SETTING_FONT_CONFIG);
+        {
+          gtk_shaping_cache_clear ();
+          gtk_system_setting_changed (settings->display, GTK_SYSTEM_SETTING_FONT_CONFIG);
+        }
       break;
     case PROP_ENABLE_ANIMATIONS:
       settings_invalidate_style (settings);
@@ -1894,6 +1902,8 @@ settings_update_theme (GtkSettings *settings)
 
   get_theme_name (settings, &theme_name, &theme_variant);
 
+  gtk_css_image_cache_theme_changed ();
+
   gtk_css_provider_load_named (settings->theme_provider,
                                theme_name,
                                theme_variant);
@@ -0,0 +1,514 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkshapingcacheprivate.h"
+
+#include "gtkdebug.h"
+#include "gdkprofilerprivate.h"
+
+#include <string.h>
+#include <pango/pangocairo.h>
+
+/*
+ * The shaping cache lets widgets share laid out PangoLayouts for the
+ * same text, so that itemizing and shaping the same strings again in
+ * every label of a large list or grid is avoided.
+ *
+ * A layout depends on its settings and on those of its context, which
+ * belongs to the widget and changes with it. So the cache keeps its own
+ * contexts, one for every set of context settings in use, and creates
+ * the shared layouts from those. Widgets look up a layout by passing
+ * one they have set up, which they replace with the shared one. The
+ * shared layouts must not be modified.
+ *
+ * The cache is bounded by an estimate of the memory used by the
+ * layouts, with the least recently used ones being dropped first.
+ *
+ * Contexts are keyed on their font map, but the fonts of a font map
+ * change when fontconfig is reloaded, and the font settings can change
+ * without the context settings changing. The cache is flushed when the
+ * serial of a font map changes, and GtkSettings flushes it when the
+ * font settings change.
+ */
+
+#define MAX_CACHE_SIZE (8 * 1024 * 1024)
+#define MAX_TEXT_LENGTH 1024
+#define MAX_CONTEXTS 32
+
+/* Memory used by a layout apart from its lines */
+#define LAYOUT_OVERHEAD 256
+
+typedef struct
+{
+  PangoFontMap *font_map;
+  PangoFontDescription *font_desc;
+  PangoLanguage *language;
+  PangoDirection base_dir;
+  PangoGravity base_gravity;
+  PangoGravityHint gravity_hint;
+  gboolean round_glyph_positions;
+  double resolution;
+  cairo_font_options_t *font_options; /* may be NULL */
+} ContextKey;
+
+typedef struct
+{
+  ContextKey key;
+  PangoContext *context;
+  guint serial;
+} ContextEntry;
+
+/* All pointers are owned by the layout of the entry */
+typedef struct
+{
+  PangoContext *context;
+  const char *text;
+  PangoAttrList *attrs;
+  const PangoFontDescription *font_desc;
+  int width;
+  int height;
+  int indent;
+  int spacing;
+  float line_spacing;
+  PangoAlignment alignment;
+  PangoEllipsizeMode ellipsize;
+  PangoWrapMode wrap;
+  guint justify : 1;
+  guint single_paragraph : 1;
+  guint auto_dir : 1;
+} LayoutKey;
+
+typedef struct
+{
+  LayoutKey key;
+  PangoLayout *layout;
+  gsize size;
+  GList link;
+} LayoutEntry;
+
+static GHashTable *contexts;
+static GHashTable *layouts;
+static GQueue lru = G_QUEUE_INIT;
+static gsize cache_size;
+
+static guint frame_hits, frame_misses;
+static guint hits_counter, misses_counter, size_counter;
+
+static guint
+context_key_hash (gconstpointer data)
+{
+  const ContextKey *key = data;
+  guint h;
+
+  h = g_direct_hash (key->font_map);
+  h = h * 31 + pango_font_description_hash (key->font_desc);
+  h = h * 31 + g_direct_hash (key->language);
+  h = h * 31 + key->base_dir;
+  h = h * 31 + key->base_gravity;
+  h = h * 31 + key->gravity_hint;
+  h = h * 31 + key->round_glyph_positions;
+  h = h * 31 + (guint) key->resolution;
+  if (key->font_options)
+    h = h * 31 + cairo_font_options_hash (key->font_options);
+
+  return h;
+}
+
+static gboolean
+context_key_equal (gconstpointer a,
+                   gconstpointer b)
+{
+  const ContextKey *ka = a;
+  const ContextKey *kb = b;
+
+  if (ka->font_options == NULL || kb->font_options == NULL)
+    {
+      if (ka->font_options != kb->font_options)
+        return FALSE;
+    }
+  else if (!cairo_font_options_equal (ka->font_options, kb->font_options))
+    return FALSE;
+
+  return ka->font_map == kb->font_map &&
+         ka->language == kb->language &&
+         ka->base_dir == kb->base_dir &&
+         ka->base_gravity == kb->base_gravity &&
+         ka->gravity_hint == kb->gravity_hint &&
+         ka->round_glyph_positions == kb->round_glyph_positions &&
+         ka->resolution == kb->resolution &&
+         pango_font_description_equal (ka->font_desc, kb->font_desc);
+}
+
+static void
+context_entry_free (gpointer data)
+{
+  ContextEntry *entry = data;
+
+  g_object_unref (entry->key.font_map);
+  pango_font_description_free (entry->key.font_desc);
+  g_clear_pointer (&entry->key.font_options, cairo_font_options_destroy);
+  g_object_unref (entry->context);
+  g_free (entry);
+}
+
+static guint
+layout_key_hash (gconstpointer data)
+{
+  const LayoutKey *key = data;
+  guint h;
+
+  h = g_str_hash (key->text);
+  h = h * 31 + g_direct_hash (key->context);
+  h = h * 31 + key->width;
+  h = h * 31 + key->height;
+  h = h * 31 + key->alignment;
+  h = h * 31 + key->ellipsize;
+  h = h * 31 + key->wrap;
+
+  return h;
+}
+
+static gboolean
+layout_key_equal (gconstpointer a,
+                  gconstpointer b)
+{
+  const LayoutKey *ka = a;
+  const LayoutKey *kb = b;
+
+  if (ka->context != kb->context ||
+      ka->width != kb->width ||
+      ka->height != kb->height ||
+      ka->indent != kb->indent ||
+      ka->spacing != kb->spacing ||
+      ka->line_spacing != kb->line_spacing ||
+      ka->alignment != kb->alignment ||
+      ka->ellipsize != kb->ellipsize ||
+      ka->wrap != kb->wrap ||
+      ka->justify != kb->justify ||
+      ka->single_paragraph != kb->single_paragraph ||
+      ka->auto_dir != kb->auto_dir)
+    return FALSE;
+
+  if (strcmp (ka->text, kb->text) != 0)
+    return FALSE;
+
+  if (ka->attrs == NULL || kb->attrs == NULL)
+    {
+      if (ka->attrs != kb->attrs)
+        return FALSE;
+    }
+  else if (!pango_attr_list_equal (ka->attrs, kb->attrs))
+    return FALSE;
+
+  if (ka->font_desc == NULL || kb->font_desc == NULL)
+    return ka->font_desc == kb->font_desc;
+
+  return pango_font_description_equal (ka->font_desc, kb->font_desc);
+}
+
+static void
+layout_entry_free (gpointer data)
+{
+  LayoutEntry *entry = data;
+
+  g_object_unref (entry->layout);
+  g_free (entry);
+}
+
+static void
+ensure_cache (void)
+{
+  if (layouts)
+    return;
+
+  contexts = g_hash_table_new_full (context_key_hash, context_key_equal, NULL, context_entry_free);
+  layouts = g_hash_table_new_full (layout_key_hash, layout_key_equal, NULL, layout_entry_free);
+
+  hits_counter = gdk_profiler_define_int_counter ("shaping-cache-hits", "Shared layout cache hits");
+  misses_counter = gdk_profiler_define_int_counter ("shaping-cache-misses", "Shared layout cache misses");
+  size_counter = gdk_profiler_define_int_counter ("shaping-cache-size", "Estimated size of the shared layouts, in bytes");
+}
+
+/* Returns the context of the cache with the same settings as @context */
+static PangoContext *
+get_shared_context (PangoContext *context)
+{
+  ContextEntry *entry;
+  ContextKey key;
+  const cairo_font_options_t *font_options;
+
+  if (pango_context_get_matrix (context) != NULL)
+    return NULL;
+
+  font_options = pango_cairo_context_get_font_options (context);
+
+  key.font_map = pango_context_get_font_map (context);
+  key.font_desc = pango_context_get_font_description (context);
+  key.language = pango_context_get_language (context);
+  key.base_dir = pango_context_get_base_dir (context);
+  key.base_gravity = pango_context_get_base_gravity (context);
+  key.gravity_hint = pango_context_get_gravity_hint (context);
+  key.round_glyph_positions = pango_context_get_round_glyph_positions (context);
+  key.resolution = pango_cairo_context_get_resolution (context);
+  key.font_options = (cairo_font_options_t *) font_options;
+
+  if (key.font_map == NULL)
+    return NULL;
+
+  entry = g_hash_table_lookup (contexts, &key);
+  if (entry)
+    {
+      if (entry->serial == pango_font_map_get_serial (key.font_map))
+        return entry->context;
+
+      /* The fonts changed, so all layouts from this font map are stale */
+      gtk_shaping_cache_clear ();
+      entry = NULL;
+    }
+
+  /* Contexts are only dropped from here, layouts keep using theirs */
+  if (g_hash_table_size (contexts) >= MAX_CONTEXTS)
+    g_hash_table_remove_all (contexts);
+
+  entry = g_new0 (ContextEntry, 1);
+  entry->key = key;
+  g_object_ref (entry->key.font_map);
+  entry->key.font_desc = pango_font_description_copy (key.font_desc);
+  if (font_options)
+    entry->key.font_options = cairo_font_options_copy (font_options);
+
+  entry->context = pango_font_map_create_context (key.font_map);
+  entry->serial = pango_font_map_get_serial (key.font_map);
+  pango_context_set_font_description (entry->context, key.font_desc);
+  pango_context_set_language (entry->context, key.language);
+  pango_context_set_base_dir (entry->context, key.base_dir);
+  pango_context_set_base_gravity (entry->context, key.base_gravity);
+  pango_context_set_gravity_hint (entry->context, key.gravity_hint);
+  pango_context_set_round_glyph_positions (entry->context, key.round_glyph_positions);
+  pango_cairo_context_set_resolution (entry->context, key.resolution);
+  pango_cairo_context_set_font_options (entry->context, font_options);
+
+  g_hash_table_insert (contexts, &entry->key, entry);
+
+  return entry->context;
+}
+
+static void
+layout_key_init (LayoutKey    *key,
+                 PangoContext *context,
+                 PangoLayout  *layout)
+{
+  key->context = context;
+  key->text = pango_layout_get_text (layout);
+  key->attrs = pango_layout_get_attributes (layout);
+  key->font_desc = pango_layout_get_font_description (layout);
+  key->width = pango_layout_get_width (layout);
+  key->height = pango_layout_get_height (layout);
+  key->indent = pango_layout_get_indent (layout);
+  key->spacing = pango_layout_get_spacing (layout);
+  key->line_spacing = pango_layout_get_line_spacing (layout);
+  key->alignment = pango_layout_get_alignment (layout);
+  key->ellipsize = pango_layout_get_ellipsize (layout);
+  key->wrap = pango_layout_get_wrap (layout);
+  key->justify = pango_layout_get_justify (layout);
+  key->single_paragraph = pango_layout_get_single_paragraph_mode (layout);
+  key->auto_dir = pango_layout_get_auto_dir (layout);
+}
+
+static PangoLayout *
+create_shared_layout (const LayoutKey *key)
+{
+  PangoLayout *layout;
+  PangoAttrList *attrs;
+
+  layout = pango_layout_new (key->context);
+
+  pango_layout_set_text (layout, key->text, -1);
+  if (key->attrs)
+    {
+      attrs = pango_attr_list_copy (key->attrs);
+      pango_layout_set_attributes (layout, attrs);
+      pango_attr_list_unref (attrs);
+    }
+  pango_layout_set_font_description (layout, key->font_desc);
+  pango_layout_set_width (layout, key->width);
+  pango_layout_set_height (layout, key->height);
+  pango_layout_set_indent (layout, key->indent);
+  pango_layout_set_spacing (layout, key->spacing);
+  pango_layout_set_line_spacing (layout, key->line_spacing);
+  pango_layout_set_alignment (layout, key->alignment);
+  pango_layout_set_ellipsize (layout, key->ellipsize);
+  pango_layout_set_wrap (layout, key->wrap);
+  pango_layout_set_justify (layout, key->justify);
+  pango_layout_set_single_paragraph_mode (layout, key->single_paragraph);
+  pango_layout_set_auto_dir (layout, key->auto_dir);
+
+  return layout;
+}
+
+/* Estimates the memory used by the lines of @layout, laying it out */
+static gsize
+estimate_layout_size (PangoLayout *layout)
+{
+  gsize size;
+  GSList *l, *r;
+
+  size = LAYOUT_OVERHEAD;
+  size += strlen (pango_layout_get_text (layout)) * (1 + sizeof (PangoLogAttr));
+
+  for (l = pango_layout_get_lines_readonly (layout); l; l = l->next)
+    {
+      PangoLayoutLine *line = l->data;
+
+      size += sizeof (PangoLayoutLine);
+
+      for (r = line->runs; r; r = r->next)
+        {
+          PangoGlyphItem *run = r->data;
+
+          size += sizeof (PangoGlyphItem) + sizeof (PangoItem);
+          size += run->glyphs->num_glyphs * (sizeof (PangoGlyphInfo) + sizeof (int));
+        }
+    }
+
+  return size;
+}
+
+/*<private>
+ * gtk_shaping_cache_share_layout:
+ * @layout: a layout that has not been laid out yet
+ *
+ * Looks for a shared layout with the same text and settings as
+ * @layout, and adds one if there is none. The returned layout is
+ * laid out already, and must not be modified.
+ *
+ * Layouts with settings that the cache does not handle, like tabs or
+ * a transformed context, or with a long text, are not shared.
+ *
+ * Returns: (transfer full) (nullable): the shared layout to use
+ *   instead of @layout
+ */
+PangoLayout *
+gtk_shaping_cache_share_layout (PangoLayout *layout)
+{
+  PangoContext *context;
+  PangoTabArray *tabs;
+  LayoutEntry *entry;
+  LayoutKey key;
+
+  if (GTK_DEBUG_CHECK (NO_SHAPING_CACHE))
+    return NULL;
+
+  if (strlen (pango_layout_get_text (layout)) > MAX_TEXT_LENGTH)
+    return NULL;
+
+  tabs = pango_layout_get_tabs (layout);
+  if (tabs)
+    {
+      pango_tab_array_free (tabs);
+      return NULL;
+    }
+
+  ensure_cache ();
+
+  context = get_shared_context (pango_layout_get_context (layout));
+  if (context == NULL)
+    return NULL;
+
+  layout_key_init (&key, context, layout);
+
+  entry = g_hash_table_lookup (layouts, &key);
+  if (entry)
+    {
+      frame_hits++;
+
+      g_queue_unlink (&lru, &entry->link);
+      g_queue_push_head_link (&lru, &entry->link);
+
+      return g_object_ref (entry->layout);
+    }
+
+  frame_misses++;
+
+  entry = g_new0 (LayoutEntry, 1);
+  entry->layout = create_shared_layout (&key);
+  entry->size = estimate_layout_size (entry->layout);
+  entry->link.data = entry;
+  layout_key_init (&entry->key, context, entry->layout);
+
+  g_hash_table_insert (layouts, &entry->key, entry);
+  g_queue_push_head_link (&lru, &entry->link);
+  cache_size += entry->size;
+
+  while (cache_size > MAX_CACHE_SIZE && lru.length > 1)
+    {
+      GList *last = g_queue_pop_tail_link (&lru);
+      LayoutEntry *old = last->data;
+
+      cache_size -= old->size;
+      g_hash_table_remove (layouts, &old->key);
+    }
+
+  return g_object_ref (entry->layout);
+}
+
+/*<private>
+ * gtk_shaping_cache_clear:
+ *
+ * Drops all shared layouts and contexts. This must be called when
+ * anything changes that affects laying out text without showing up
+ * in the settings of the contexts, like the font settings.
+ *
+ * Widgets keep using the layouts they got from the cache until they
+ * look up a new one.
+ */
+void
+gtk_shaping_cache_clear (void)
+{
+  if (layouts == NULL)
+    return;
+
+  /* The entries are linked into the queue, so unlink them all first */
+  while (lru.head)
+    g_queue_pop_head_link (&lru);
+
+  g_hash_table_remove_all (layouts);
+  g_hash_table_remove_all (contexts);
+  cache_size = 0;
+}
+
+/*<private>
+ * gtk_shaping_cache_report_statistics:
+ *
+ * Reports the cache hits and misses since the last call
+ * and the size of the cache to the profiler.
+ */
+void
+gtk_shaping_cache_report_statistics (void)
+{
+  if (layouts && GDK_PROFILER_IS_RUNNING)
+    {
+      gdk_profiler_set_int_counter (hits_counter, frame_hits);
+      gdk_profiler_set_int_counter (misses_counter, frame_misses);
+      gdk_profiler_set_int_counter (size_counter, cache_size);
+    }
+
+  frame_hits = 0;
+  frame_misses = 0;
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_SHAPING_CACHE_PRIVATE_H__
+#define __GTK_SHAPING_CACHE_PRIVATE_H__
+
+#include <pango/pango.h>
+
+G_BEGIN_DECLS
+
+PangoLayout *   gtk_shaping_cache_share_layout          (PangoLayout    *layout);
+
+void            gtk_shaping_cache_clear                 (void);
+
+void            gtk_shaping_cache_report_statistics     (void);
+
+G_END_DECLS
+
+#endif /* __GTK_SHAPING_CACHE_PRIVATE_H__ */
@@ -31,6 +31,7 @@
 #include "gtkprogresstrackerprivate.h"
 #include "gtksettingsprivate.h"
 #include "gtksnapshot.h"
+#include "gtktransitioncacheprivate.h"
 #include "gtkwidgetprivate.h"
 #include "gtksingleselection.h"
 #include "gtklistlistmodelprivate.h"
@@ -151,6 +152,8 @@ typedef struct {
 
   GtkStackPage *last_visible_child;
   guint tick_id;
+  GtkTransitionCache last_visible_cache;
+  GtkTransitionCache visible_cache;
   GtkProgressTracker tracker;
   gboolean first_frame_skipped;
 
@@ -683,6 +686,15 @@ static void stack_remove (GtkStack  *stack,
                           GtkWidget *child,
                           gboolean   in_dispose);
 
+static void
+gtk_stack_clear_transition_caches (GtkStack *stack)
+{
+  GtkStackPrivate *priv = gtk_stack_get_instance_private (stack);
+
+  gtk_transition_cache_clear (&priv->last_visible_cache);
+  gtk_transition_cache_clear (&priv->visible_cache);
+}
+
 static void
 gtk_stack_dispose (GObject *obj)
 {
@@ -694,6 +706,8 @@ gtk_stack_dispose (GObject *obj)
   while ((child = gtk_widget_get_first_child (GTK_WIDGET (stack))))
     stack_remove (stack, child, TRUE);
 
+  gtk_stack_clear_transition_caches (stack);
+
   if (priv->pages)
     g_list_model_items_changed (G_LIST_MODEL (priv->pages), 0, n_pages, 0);
 
@@ -1090,11 +1104,15 @@ gtk_stack_progress_updated (GtkStack *stack)
   else
     gtk_widget_queue_draw (GTK_WIDGET (stack));
 
-  if (gtk_progress_tracker_get_state (&priv->tracker) == GTK_PROGRESS_STATE_AFTER &&
-      priv->last_visible_child != NULL)
+  if (gtk_progress_tracker_get_state (&priv->tracker) == GTK_PROGRESS_STATE_AFTER)
     {
-      gtk_widget_set_child_visible (priv->last_visible_child->widget, FALSE);
-      priv->last_visible_child = NULL;
+      gtk_stack_clear_transition_caches (stack);
+
+      if (priv->last_visible_child != NULL)
+        {
+          gtk_widget_set_child_visible (priv->last_visible_child->widget, FALSE);
+          priv->last_visible_child = NULL;
+        }
     }
 }
 
@@ -1212,6 +1230,9 @@ gtk_stack_start_transition (GtkStack               *stack,
   GtkStackPrivate *priv = gtk_stack_get_instance_private (stack);
   GtkWidget *widget = GTK_WIDGET (stack);
 
+  /* The pages are rendered again for every transition */
+  gtk_stack_clear_transition_caches (stack);
+
   if (gtk_widget_get_mapped (widget) &&
       gtk_settings_get_enable_animations (gtk_widget_get_settings (widget)) &&
       transition_type != GTK_STACK_TRANSITION_TYPE_NONE &&
@@ -1405,6 +1426,7 @@ update_child_visible (GtkStack     *stack,
     {
       gtk_widget_set_child_visible (priv->last_visible_child->widget, FALSE);
       priv->last_visible_child = NULL;
+      gtk_stack_clear_transition_caches (stack);
     }
 
   gtk_accessible_update_state (GTK_ACCESSIBLE (child_info),
@@ -1587,6 +1609,9 @@ stack_remove (GtkStack  *stack,
   if (priv->last_visible_child == child_info)
     priv->last_visible_child = NULL;
 
+  if (priv->visible_cache.child == child || priv->last_visible_cache.child == child)
+    gtk_stack_clear_transition_caches (stack);
+
   gtk_widget_unparent (child);
 
   g_clear_object (&child_info->widget);
@@ -2195,15 +2220,17 @@ gtk_stack_snapshot_crossfade (GtkWidget   *widget,
 
   if (priv->last_visible_child)
     {
-      gtk_widget_snapshot_child (widget,
-                                 priv->last_visible_child->widget,
-                                 snapshot);
+      gtk_transition_cache_snapshot_child (&priv->last_visible_cache,
+                                           widget,
+                                           priv->last_visible_child->widget,
+                                           snapshot);
     }
   gtk_snapshot_pop (snapshot);
 
-  gtk_widget_snapshot_child (widget,
-                             priv->visible_child->widget,
-                             snapshot);
+  gtk_transition_cache_snapshot_child (&priv->visible_cache,
+                                       widget,
+                                       priv->visible_child->widget,
+                                       snapshot);
   gtk_snapshot_pop (snapshot);
 }
 
@@ -2251,9 +2278,10 @@ gtk_stack_snapshot_under (GtkWidget   *widget,
 
   gtk_snapshot_push_clip (snapshot, &GRAPHENE_RECT_INIT(x, y, width, height));
 
-  gtk_widget_snapshot_child (widget,
-                             priv->visible_child->widget,
-                             snapshot);
+  gtk_transition_cache_snapshot_child (&priv->visible_cache,
+                                       widget,
+                                       priv->visible_child->widget,
+                                       snapshot);
 
   gtk_snapshot_pop (snapshot);
 
@@ -2261,7 +2289,7 @@ gtk_stack_snapshot_under (GtkWidget   *widget,
     {
       gtk_snapshot_save (snapshot);
       gtk_snapshot_translate (snapshot, &GRAPHENE_POINT_INIT (pos_x, pos_y));
-      gtk_widget_snapshot_child (widget, priv->last_visible_child->widget, snapshot);
+      gtk_transition_cache_snapshot_child (&priv->last_visible_cache, widget, priv->last_visible_child->widget, snapshot);
       gtk_snapshot_restore (snapshot);
     }
 }
@@ -2297,9 +2325,9 @@ gtk_stack_snapshot_cube (GtkWidget   *widget,
                                  - gtk_widget_get_height (widget) / 2.f,
                                  gtk_widget_get_width (widget) / 2.f));
       if (priv->active_transition_type == GTK_STACK_TRANSITION_TYPE_ROTATE_LEFT)
-        gtk_widget_snapshot_child (widget, priv->last_visible_child->widget, snapshot);
+        gtk_transition_cache_snapshot_child (&priv->last_visible_cache, widget, priv->last_visible_child->widget, snapshot);
       else
-        gtk_widget_snapshot_child (widget, priv->visible_child->widget, snapshot);
+        gtk_transition_cache_snapshot_child (&priv->visible_cache, widget, priv->visible_child->widget, snapshot);
       gtk_snapshot_restore (snapshot);
     }
 
@@ -2319,9 +2347,9 @@ gtk_stack_snapshot_cube (GtkWidget   *widget,
                              gtk_widget_get_width (widget) / 2.f));
 
   if (priv->active_transition_type == GTK_STACK_TRANSITION_TYPE_ROTATE_LEFT)
-    gtk_widget_snapshot_child (widget, priv->visible_child->widget, snapshot);
+    gtk_transition_cache_snapshot_child (&priv->visible_cache, widget, priv->visible_child->widget, snapshot);
   else if (priv->last_visible_child)
-    gtk_widget_snapshot_child (widget, priv->last_visible_child->widget, snapshot);
+    gtk_transition_cache_snapshot_child (&priv->last_visible_cache, widget, priv->last_visible_child->widget, snapshot);
   gtk_snapshot_restore (snapshot);
 
   if (priv->last_visible_child && progress <= 0.5)
@@ -2341,9 +2369,9 @@ gtk_stack_snapshot_cube (GtkWidget   *widget,
                                  - gtk_widget_get_height (widget) / 2.f,
                                  gtk_widget_get_width (widget) / 2.f));
       if (priv->active_transition_type == GTK_STACK_TRANSITION_TYPE_ROTATE_LEFT)
-        gtk_widget_snapshot_child (widget, priv->last_visible_child->widget, snapshot);
+        gtk_transition_cache_snapshot_child (&priv->last_visible_cache, widget, priv->last_visible_child->widget, snapshot);
       else
-        gtk_widget_snapshot_child (widget, priv->visible_child->widget, snapshot);
+        gtk_transition_cache_snapshot_child (&priv->visible_cache, widget, priv->visible_child->widget, snapshot);
       gtk_snapshot_restore (snapshot);
     }
 }
@@ -2404,13 +2432,14 @@ gtk_stack_snapshot_slide (GtkWidget   *widget,
 
       gtk_snapshot_save (snapshot);
       gtk_snapshot_translate (snapshot, &GRAPHENE_POINT_INIT (x, y));
-      gtk_widget_snapshot_child (widget, priv->last_visible_child->widget, snapshot);
+      gtk_transition_cache_snapshot_child (&priv->last_visible_cache, widget, priv->last_visible_child->widget, snapshot);
       gtk_snapshot_restore (snapshot);
      }
 
-  gtk_widget_snapshot_child (widget,
-                             priv->visible_child->widget,
-                             snapshot);
+  gtk_transition_cache_snapshot_child (&priv->visible_cache,
+                                       widget,
+                                       priv->visible_child->widget,
+                                       snapshot);
 }
 
 static void
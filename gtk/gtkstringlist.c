@@ -66,18 +66,114 @@
  * a [property@Gtk.StringObject:string] property.
  */
 
-#define GDK_ARRAY_ELEMENT_TYPE GtkStringObject *
-#define GDK_ARRAY_NAME objects
-#define GDK_ARRAY_TYPE_NAME Objects
-#define GDK_ARRAY_FREE_FUNC g_object_unref
+/* Strings are stored in chunks of memory that are shared between
+ * many items, so that a list with many strings does not need an
+ * allocation per string. Chunks are refcounted by the items and
+ * objects pointing into them, and never move, so the pointers
+ * returned by gtk_string_list_get_string() stay valid as long as
+ * the item exists.
+ */
+typedef struct _GtkStringChunk GtkStringChunk;
+
+struct _GtkStringChunk
+{
+  int ref_count;
+  gsize size;
+  gsize used;
+  char data[];
+};
+
+#define STRING_CHUNK_SIZE (4096 - sizeof (GtkStringChunk))
+
+static GtkStringChunk *
+gtk_string_chunk_new (gsize size)
+{
+  GtkStringChunk *chunk;
+
+  chunk = g_malloc (sizeof (GtkStringChunk) + size);
+  chunk->ref_count = 1;
+  chunk->size = size;
+  chunk->used = 0;
+
+  return chunk;
+}
+
+static GtkStringChunk *
+gtk_string_chunk_ref (GtkStringChunk *chunk)
+{
+  g_atomic_int_inc (&chunk->ref_count);
+
+  return chunk;
+}
+
+static void
+gtk_string_chunk_unref (GtkStringChunk *chunk)
+{
+  if (g_atomic_int_dec_and_test (&chunk->ref_count))
+    g_free (chunk);
+}
+
+typedef struct _GtkStringItem GtkStringItem;
+
+struct _GtkStringItem
+{
+  const char *string;
+  GtkStringChunk *chunk;
+  /* not owned, cleared when the object is disposed */
+  GtkStringObject *object;
+};
+
+static void gtk_string_item_clear (GtkStringItem *item);
+
+#define GDK_ARRAY_ELEMENT_TYPE GtkStringItem
+#define GDK_ARRAY_NAME items
+#define GDK_ARRAY_TYPE_NAME Items
+#define GDK_ARRAY_BY_VALUE 1
+#define GDK_ARRAY_FREE_FUNC gtk_string_item_clear
 #include "gdk/gdkarrayimpl.c"
 
 struct _GtkStringObject
 {
   GObject parent_instance;
   char *string;
+  /* if set, @string points into it */
+  GtkStringChunk *chunk;
+
+  /* the list caching this object and its position in it,
+   * protected by the string_objects lock
+   */
+  GtkStringList *list;
+  guint position;
+};
+
+struct _GtkStringList
+{
+  GObject parent_instance;
+
+  Items items;
+  GtkStringChunk *chunk;
+};
+
+struct _GtkStringListClass
+{
+  GObjectClass parent_class;
 };
 
+/* String objects can be released in any thread, so the links
+ * between items and the objects caching them are only changed
+ * with this lock held, and so is the list's array of items,
+ * which a released object writes to.
+ */
+G_LOCK_DEFINE_STATIC (string_objects);
+
+static void
+gtk_string_item_clear (GtkStringItem *item)
+{
+  if (item->object)
+    item->object->list = NULL;
+  gtk_string_chunk_unref (item->chunk);
+}
+
 enum {
   PROP_STRING = 1,
   PROP_NUM_PROPERTIES
@@ -90,12 +186,35 @@ gtk_string_object_init (GtkStringObject *object)
 {
 }
 
+static void
+gtk_string_object_dispose (GObject *object)
+{
+  GtkStringObject *self = GTK_STRING_OBJECT (object);
+
+  /* This is done in dispose, while the object can still be
+   * referenced, so that the list never hands out an object
+   * that is being finalized in another thread.
+   */
+  G_LOCK (string_objects);
+  if (self->list)
+    {
+      items_index (&self->list->items, self->position)->object = NULL;
+      self->list = NULL;
+    }
+  G_UNLOCK (string_objects);
+
+  G_OBJECT_CLASS (gtk_string_object_parent_class)->dispose (object);
+}
+
 static void
 gtk_string_object_finalize (GObject *object)
 {
   GtkStringObject *self = GTK_STRING_OBJECT (object);
 
-  g_free (self->string);
+  if (self->chunk)
+    gtk_string_chunk_unref (self->chunk);
+  else
+    g_free (self->string);
 
   G_OBJECT_CLASS (gtk_string_object_parent_class)->finalize (object);
 }
@@ -126,6 +245,7 @@ gtk_string_object_class_init (GtkStringObjectClass *class)
   GObjectClass *object_class = G_OBJECT_CLASS (class);
   GParamSpec *pspec;
 
+  object_class->dispose = gtk_string_object_dispose;
   object_class->finalize = gtk_string_object_finalize;
   object_class->get_property = gtk_string_object_get_property;
 
@@ -154,6 +274,24 @@ gtk_string_object_new_take (char *string)
   return obj;
 }
 
+static GtkStringObject *
+gtk_string_object_new_for_item (GtkStringList *list,
+                                guint          position)
+{
+  GtkStringItem *item = items_index (&list->items, position);
+  GtkStringObject *obj;
+
+  obj = g_object_new (GTK_TYPE_STRING_OBJECT, NULL);
+  obj->string = (char *) item->string;
+  obj->chunk = gtk_string_chunk_ref (item->chunk);
+  obj->list = list;
+  obj->position = position;
+
+  item->object = obj;
+
+  return obj;
+}
+
 /**
  * gtk_string_object_new:
  * @string: (not nullable): The string to wrap
@@ -184,18 +322,6 @@ gtk_string_object_get_string (GtkStringObject *self)
   return self->string;
 }
 
-struct _GtkStringList
-{
-  GObject parent_instance;
-
-  Objects items;
-};
-
-struct _GtkStringListClass
-{
-  GObjectClass parent_class;
-};
-
 static GType
 gtk_string_list_get_item_type (GListModel *list)
 {
@@ -207,7 +333,7 @@ gtk_string_list_get_n_items (GListModel *list)
 {
   GtkStringList *self = GTK_STRING_LIST (list);
 
-  return objects_get_size (&self->items);
+  return items_get_size (&self->items);
 }
 
 static gpointer
@@ -215,11 +341,24 @@ gtk_string_list_get_item (GListModel *list,
                           guint       position)
 {
   GtkStringList *self = GTK_STRING_LIST (list);
+  GtkStringItem *item;
+  GtkStringObject *object;
 
-  if (position >= objects_get_size (&self->items))
+  if (position >= items_get_size (&self->items))
     return NULL;
 
-  return g_object_ref (objects_get (&self->items, position));
+  /* Objects are created on demand and only cached as long as
+   * somebody holds a reference to them.
+   */
+  G_LOCK (string_objects);
+  item = items_index (&self->items, position);
+  if (item->object)
+    object = g_object_ref (item->object);
+  else
+    object = gtk_string_object_new_for_item (self, position);
+  G_UNLOCK (string_objects);
+
+  return object;
 }
 
 static void
@@ -406,7 +545,10 @@ gtk_string_list_dispose (GObject *object)
 {
   GtkStringList *self = GTK_STRING_LIST (object);
 
-  objects_clear (&self->items);
+  G_LOCK (string_objects);
+  items_clear (&self->items);
+  G_UNLOCK (string_objects);
+  g_clear_pointer (&self->chunk, gtk_string_chunk_unref);
 
   G_OBJECT_CLASS (gtk_string_list_parent_class)->dispose (object);
 }
@@ -422,7 +564,60 @@ gtk_string_list_class_init (GtkStringListClass *class)
 static void
 gtk_string_list_init (GtkStringList *self)
 {
-  objects_init (&self->items);
+  items_init (&self->items);
+}
+
+static const char *
+gtk_string_list_store (GtkStringList   *self,
+                       const char      *string,
+                       gsize            length,
+                       GtkStringChunk **out_chunk)
+{
+  GtkStringChunk *chunk;
+  char *dest;
+
+  if (self->chunk && self->chunk->size - self->chunk->used > length)
+    {
+      chunk = gtk_string_chunk_ref (self->chunk);
+    }
+  else if (length >= STRING_CHUNK_SIZE / 4)
+    {
+      /* Large strings get a chunk of their own, so they don't
+       * waste the rest of the current one.
+       */
+      chunk = gtk_string_chunk_new (length + 1);
+    }
+  else
+    {
+      g_clear_pointer (&self->chunk, gtk_string_chunk_unref);
+      self->chunk = gtk_string_chunk_new (STRING_CHUNK_SIZE);
+      chunk = gtk_string_chunk_ref (self->chunk);
+    }
+
+  dest = chunk->data + chunk->used;
+  memcpy (dest, string, length);
+  dest[length] = '\0';
+  chunk->used += length + 1;
+
+  *out_chunk = chunk;
+
+  return dest;
+}
+
+static void
+gtk_string_list_update_positions (GtkStringList *self,
+                                  guint          start)
+{
+  guint i, n;
+
+  n = items_get_size (&self->items);
+  for (i = start; i < n; i++)
+    {
+      GtkStringItem *item = items_index (&self->items, i);
+
+      if (item->object)
+        item->object->position = i;
+    }
 }
 
 /**
@@ -459,7 +654,9 @@ gtk_string_list_new (const char * const *strings)
  * and [method@Gtk.StringList.remove], because it only emits the
  * ::items-changed signal once for the change.
  *
- * This function copies the strings in @additions.
+ * This function copies the strings in @additions. To add a large
+ * number of strings, [method@Gtk.StringList.splice_packed] is
+ * more efficient.
  *
  * The parameters @position and @n_removals must be correct (ie:
  * @position + @n_removals must be less than or equal to the length
@@ -471,28 +668,144 @@ gtk_string_list_splice (GtkStringList      *self,
                         guint               n_removals,
                         const char * const *additions)
 {
+  GtkStringItem *new_items;
   guint i, n_additions;
 
   g_return_if_fail (GTK_IS_STRING_LIST (self));
   g_return_if_fail (position + n_removals >= position); /* overflow */
-  g_return_if_fail (position + n_removals <= objects_get_size (&self->items));
+  g_return_if_fail (position + n_removals <= items_get_size (&self->items));
 
   if (additions)
     n_additions = g_strv_length ((char **) additions);
   else
     n_additions = 0;
 
-  objects_splice (&self->items, position, n_removals, FALSE, NULL, n_additions);
+  /* Copy the strings before removing anything, @additions might
+   * point into strings that are about to be removed.
+   */
+  new_items = g_new (GtkStringItem, n_additions);
+  for (i = 0; i < n_additions; i++)
+    {
+      new_items[i].string = gtk_string_list_store (self,
+                                                   additions[i],
+                                                   strlen (additions[i]),
+                                                   &new_items[i].chunk);
+      new_items[i].object = NULL;
+    }
+
+  G_LOCK (string_objects);
+  items_splice (&self->items, position, n_removals, FALSE, new_items, n_additions);
+  if (n_removals != n_additions)
+    gtk_string_list_update_positions (self, position + n_additions);
+  G_UNLOCK (string_objects);
+
+  g_free (new_items);
+
+  if (n_removals || n_additions)
+    g_list_model_items_changed (G_LIST_MODEL (self), position, n_removals, n_additions);
+}
+
+/**
+ * gtk_string_list_splice_packed:
+ * @self: a `GtkStringList`
+ * @position: the position at which to make the change
+ * @n_removals: the number of strings to remove
+ * @buffer: (array length=length) (element-type guint8) (nullable): packed
+ *   strings to add
+ * @length: the length of @buffer in bytes
+ *
+ * Changes @self by removing @n_removals strings and adding the
+ * strings contained in @buffer to it.
+ *
+ * @buffer must contain zero or more nul-terminated strings that
+ * are packed back to back, so that every string starts right after
+ * the terminating nul byte of the previous one. In particular, if
+ * @length is not 0, the last byte of @buffer must be a nul byte.
+ *
+ * This is the most efficient way to add a large number of strings
+ * to @self, since @buffer is copied in one piece.
+ *
+ * The parameters @position and @n_removals must be correct (ie:
+ * @position + @n_removals must be less than or equal to the length
+ * of the list at the time this function is called).
+ *
+ * Since: 4.6
+ */
+void
+gtk_string_list_splice_packed (GtkStringList *self,
+                               guint          position,
+                               guint          n_removals,
+                               const char    *buffer,
+                               gsize          length)
+{
+  GtkStringChunk *chunk;
+  const char *p, *end;
+  guint i, n_additions;
+
+  g_return_if_fail (GTK_IS_STRING_LIST (self));
+  g_return_if_fail (position + n_removals >= position); /* overflow */
+  g_return_if_fail (position + n_removals <= items_get_size (&self->items));
+  g_return_if_fail (buffer != NULL || length == 0);
+  g_return_if_fail (length == 0 || buffer[length - 1] == '\0');
+
+  end = buffer + length;
+  n_additions = 0;
+  for (p = buffer; p < end; p += strlen (p) + 1)
+    n_additions++;
+
+  chunk = NULL;
+  if (n_additions > 0)
+    {
+      if (self->chunk && self->chunk->size - self->chunk->used >= length)
+        chunk = gtk_string_chunk_ref (self->chunk);
+      else
+        chunk = gtk_string_chunk_new (length);
+
+      memcpy (chunk->data + chunk->used, buffer, length);
+      p = chunk->data + chunk->used;
+      chunk->used += length;
+
+      /* one reference per item */
+      g_atomic_int_add (&chunk->ref_count, n_additions - 1);
+    }
+
+  G_LOCK (string_objects);
+  items_splice (&self->items, position, n_removals, FALSE, NULL, n_additions);
 
   for (i = 0; i < n_additions; i++)
     {
-      *objects_index (&self->items, position + i) = gtk_string_object_new (additions[i]);
+      GtkStringItem *item = items_index (&self->items, position + i);
+
+      item->string = p;
+      item->chunk = chunk;
+      p += strlen (p) + 1;
     }
 
+  if (n_removals != n_additions)
+    gtk_string_list_update_positions (self, position + n_additions);
+  G_UNLOCK (string_objects);
+
   if (n_removals || n_additions)
     g_list_model_items_changed (G_LIST_MODEL (self), position, n_removals, n_additions);
 }
 
+static void
+gtk_string_list_append_len (GtkStringList *self,
+                            const char    *string,
+                            gsize          length)
+{
+  GtkStringItem item;
+
+  item.string = gtk_string_list_store (self, string, length, &item.chunk);
+  item.object = NULL;
+
+  G_LOCK (string_objects);
+  items_append (&self->items, &item);
+  G_UNLOCK (string_objects);
+
+  g_list_model_items_changed (G_LIST_MODEL (self), items_get_size (&self->items) - 1, 0, 1);
+}
+
 /**
  * gtk_string_list_append:
  * @self: a `GtkStringList`
@@ -500,8 +813,7 @@ gtk_string_list_splice (GtkStringList      *self,
  *
  * Appends @string to @self.
  *
- * The @string will be copied. See
- * [method@Gtk.StringList.take] for a way to avoid that.
+ * The @string will be copied.
  */
 void
 gtk_string_list_append (GtkStringList *self,
@@ -509,9 +821,7 @@ gtk_string_list_append (GtkStringList *self,
 {
   g_return_if_fail (GTK_IS_STRING_LIST (self));
 
-  objects_append (&self->items, gtk_string_object_new (string));
-
-  g_list_model_items_changed (G_LIST_MODEL (self), objects_get_size (&self->items) - 1, 0, 1);
+  gtk_string_list_append_len (self, string, strlen (string));
 }
 
 /**
@@ -535,9 +845,8 @@ gtk_string_list_take (GtkStringList *self,
 {
   g_return_if_fail (GTK_IS_STRING_LIST (self));
 
-  objects_append (&self->items, gtk_string_object_new_take (string));
-
-  g_list_model_items_changed (G_LIST_MODEL (self), objects_get_size (&self->items) - 1, 0, 1);
+  gtk_string_list_append_len (self, string, strlen (string));
+  g_free (string);
 }
 
 /**
@@ -579,8 +888,8 @@ gtk_string_list_get_string (GtkStringList *self,
 {
   g_return_val_if_fail (GTK_IS_STRING_LIST (self), NULL);
 
-  if (position >= objects_get_size (&self->items))
+  if (position >= items_get_size (&self->items))
     return NULL;
 
-  return objects_get (&self->items, position)->string;
+  return items_get (&self->items, position)->string;
 }
@@ -67,6 +67,13 @@ void            gtk_string_list_splice          (GtkStringList         *self,
                                                  guint                  n_removals,
                                                  const char * const    *additions);
 
+GDK_AVAILABLE_IN_4_6
+void            gtk_string_list_splice_packed   (GtkStringList         *self,
+                                                 guint                  position,
+                                                 guint                  n_removals,
+                                                 const char            *buffer,
+                                                 gsize                  length);
+
 GDK_AVAILABLE_IN_ALL
 const char *    gtk_string_list_get_string      (GtkStringList         *self,
                                                  guint                  position);
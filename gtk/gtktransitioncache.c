@@ -0,0 +1,194 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtktransitioncacheprivate.h"
+
+#include "gtknative.h"
+#include "gtksnapshot.h"
+#include "gtkwidgetprivate.h"
+
+#include <math.h>
+
+/*
+ * GtkTransitionCache renders a child of a widget to a texture once,
+ * when a transition starts, and then snapshots that texture instead
+ * of the child for the remaining frames of the transition, so that
+ * widgets like GtkStack and GtkRevealer only need to move, clip or
+ * fade a single texture per frame, no matter how expensive the child
+ * is to render.
+ *
+ * The texture is only used while the render node of the child is the
+ * one it was made from. As soon as the child is redrawn, the cache
+ * gives up and the child is snapshot normally until the cache is
+ * cleared, which is expected to happen when the transition ends.
+ */
+
+/* Don't try to create textures the renderer can't handle */
+#define MAX_TEXTURE_SIZE 8192
+
+static gboolean
+gtk_transition_cache_render (GtkTransitionCache *cache,
+                             GtkWidget          *child,
+                             GskRenderNode      *node)
+{
+  GtkNative *native;
+  GskRenderer *renderer;
+  GskRenderNode *scaled;
+  GskTransform *transform;
+  GdkTexture *texture;
+  graphene_rect_t bounds, viewport;
+  int scale;
+
+  native = gtk_widget_get_native (child);
+  if (native == NULL)
+    return FALSE;
+
+  renderer = gtk_native_get_renderer (native);
+  if (renderer == NULL)
+    return FALSE;
+
+  scale = gtk_widget_get_scale_factor (child);
+  gsk_render_node_get_bounds (node, &bounds);
+
+  viewport.origin.x = floorf (bounds.origin.x * scale);
+  viewport.origin.y = floorf (bounds.origin.y * scale);
+  viewport.size.width = ceilf ((bounds.origin.x + bounds.size.width) * scale) - viewport.origin.x;
+  viewport.size.height = ceilf ((bounds.origin.y + bounds.size.height) * scale) - viewport.origin.y;
+
+  if (viewport.size.width <= 0 || viewport.size.height <= 0 ||
+      viewport.size.width > MAX_TEXTURE_SIZE || viewport.size.height > MAX_TEXTURE_SIZE)
+    return FALSE;
+
+  transform = gsk_transform_scale (NULL, scale, scale);
+  scaled = gsk_transform_node_new (node, transform);
+  gsk_transform_unref (transform);
+
+  texture = gsk_renderer_render_texture (renderer, scaled, &viewport);
+  gsk_render_node_unref (scaled);
+
+  if (texture == NULL)
+    return FALSE;
+
+  graphene_rect_init (&bounds,
+                      viewport.origin.x / scale,
+                      viewport.origin.y / scale,
+                      viewport.size.width / scale,
+                      viewport.size.height / scale);
+
+  cache->node = gsk_texture_node_new (texture, &bounds);
+  cache->source = gsk_render_node_ref (node);
+  g_object_unref (texture);
+
+  return TRUE;
+}
+
+/*<private>
+ * gtk_transition_cache_clear:
+ * @cache: a `GtkTransitionCache`
+ *
+ * Drops the texture of @cache, if any, so that the next call to
+ * gtk_transition_cache_snapshot_child() creates a new one.
+ */
+void
+gtk_transition_cache_clear (GtkTransitionCache *cache)
+{
+  cache->child = NULL;
+  g_clear_pointer (&cache->source, gsk_render_node_unref);
+  g_clear_pointer (&cache->node, gsk_render_node_unref);
+  cache->live = FALSE;
+}
+
+/*<private>
+ * gtk_transition_cache_snapshot_child:
+ * @cache: a `GtkTransitionCache`
+ * @widget: a `GtkWidget`
+ * @child: a child of @widget
+ * @snapshot: `GtkSnapshot` as passed to the widget
+ *
+ * Like gtk_widget_snapshot_child(), but snapshots a texture of
+ * @child that is rendered the first time this is called after
+ * gtk_transition_cache_clear(), for as long as @child does not
+ * need to be redrawn.
+ */
+void
+gtk_transition_cache_snapshot_child (GtkTransitionCache *cache,
+                                     GtkWidget          *widget,
+                                     GtkWidget          *child,
+                                     GtkSnapshot        *snapshot)
+{
+  GtkWidgetPrivate *priv = child->priv;
+
+  if (cache->child != child)
+    {
+      gtk_transition_cache_clear (cache);
+      cache->child = child;
+    }
+
+  if (cache->live || !priv->mapped || GTK_IS_NATIVE (child))
+    {
+      gtk_widget_snapshot_child (widget, child, snapshot);
+      return;
+    }
+
+  if (cache->node == NULL)
+    {
+      GtkSnapshot *child_snapshot;
+      GskRenderNode *node;
+
+      /* Make sure the render node of the child is up to date */
+      child_snapshot = gtk_snapshot_new ();
+      gtk_widget_snapshot (child, child_snapshot);
+      node = gtk_snapshot_free_to_node (child_snapshot);
+
+      if (node == NULL)
+        return;
+
+      if (node != priv->render_node ||
+          !gtk_transition_cache_render (cache, child, node))
+        cache->live = TRUE;
+
+      gsk_render_node_unref (node);
+    }
+  else if (priv->draw_needed || priv->render_node != cache->source)
+    {
+      /* The child changed, the texture is outdated */
+      g_clear_pointer (&cache->source, gsk_render_node_unref);
+      g_clear_pointer (&cache->node, gsk_render_node_unref);
+      cache->live = TRUE;
+    }
+
+  if (cache->live)
+    {
+      gtk_widget_snapshot_child (widget, child, snapshot);
+      return;
+    }
+
+  if (priv->transform)
+    {
+      GskRenderNode *transform_node = gsk_transform_node_new (cache->node,
+                                                              priv->transform);
+
+      gtk_snapshot_append_node (snapshot, transform_node);
+      gsk_render_node_unref (transform_node);
+    }
+  else
+    {
+      gtk_snapshot_append_node (snapshot, cache->node);
+    }
+}
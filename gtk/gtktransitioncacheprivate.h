@@ -0,0 +1,45 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_TRANSITION_CACHE_PRIVATE_H__
+#define __GTK_TRANSITION_CACHE_PRIVATE_H__
+
+#include "gtkwidget.h"
+
+G_BEGIN_DECLS
+
+typedef struct _GtkTransitionCache GtkTransitionCache;
+
+struct _GtkTransitionCache
+{
+  /*< private >*/
+  GtkWidget *child;
+  GskRenderNode *source;
+  GskRenderNode *node;
+  guint live : 1;
+};
+
+void                    gtk_transition_cache_clear              (GtkTransitionCache     *cache);
+
+void                    gtk_transition_cache_snapshot_child     (GtkTransitionCache     *cache,
+                                                                 GtkWidget              *widget,
+                                                                 GtkWidget              *child,
+                                                                 GtkSnapshot            *snapshot);
+
+G_END_DECLS
+
+#endif /* __GTK_TRANSITION_CACHE_PRIVATE_H__ */
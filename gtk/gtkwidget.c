@@ -35,12 +35,14 @@
 #include "gtkconstraint.h"
 #include "gtkcssboxesprivate.h"
 #include "gtkcssfiltervalueprivate.h"
+#include "gtkcssimagecacheprivate.h"
 #include "gtkcsstransformvalueprivate.h"
 #include "gtkcsspositionvalueprivate.h"
 #include "gtkcssfontvariationsvalueprivate.h"
 #include "gtkcssnumbervalueprivate.h"
 #include "gtkcsswidgetnodeprivate.h"
 #include "gtkdebug.h"
+#include "gtkflightrecorderprivate.h"
 #include "gtkgesturedrag.h"
 #include "gtkgestureprivate.h"
 #include "gtkgesturesingle.h"
@@ -54,6 +56,8 @@
 #include "gtkpopover.h"
 #include "gtkprivate.h"
 #include "gtkrenderbackgroundprivate.h"
+#include "gtkrendercacheprivate.h"
+#include "gtkshapingcacheprivate.h"
 #include "gtkrenderborderprivate.h"
 #include "gtkrootprivate.h"
 #include "gtknativeprivate.h"
@@ -2540,6 +2544,43 @@ gtk_widget_unroot (GtkWidget *widget)
     }
 }
 
+/* Invalidates the cached pick bounds of @widget, marks its entry in
+ * the pick index of its parent as outdated and invalidates the bounds
+ * of the ancestors that include it. Those stop at the first ancestor
+ * that clips its children, or whose bounds are already outdated.
+ */
+static void
+gtk_widget_invalidate_pick_bounds (GtkWidget *widget)
+{
+  GtkWidget *parent;
+
+  widget->priv->pick_bounds_valid = FALSE;
+
+  for (parent = widget->priv->parent;
+       parent != NULL;
+       widget = parent, parent = parent->priv->parent)
+    {
+      if (parent->priv->pick_index)
+        gtk_pick_index_invalidate_child (parent->priv->pick_index, widget);
+
+      if (parent->priv->overflow == GTK_OVERFLOW_HIDDEN ||
+          !parent->priv->pick_bounds_valid)
+        break;
+
+      parent->priv->pick_bounds_valid = FALSE;
+    }
+}
+
+/* Makes the pick index of @widget be rebuilt, after
+ * a child was added, removed, mapped or unmapped
+ */
+static void
+gtk_widget_invalidate_pick_children (GtkWidget *widget)
+{
+  widget->priv->pick_generation++;
+  gtk_widget_invalidate_pick_bounds (widget);
+}
+
 /**
  * gtk_widget_unparent:
  * @widget: a `GtkWidget`
@@ -2566,6 +2607,9 @@ gtk_widget_unparent (GtkWidget *widget)
 
   g_object_freeze_notify (G_OBJECT (widget));
 
+  gtk_widget_invalidate_pick_children (priv->parent);
+  priv->parent->priv->n_children--;
+
   gtk_accessible_update_children (GTK_ACCESSIBLE (priv->parent),
                                   GTK_ACCESSIBLE (widget),
                                   GTK_ACCESSIBLE_CHILD_STATE_REMOVED);
@@ -4045,6 +4089,12 @@ gtk_widget_allocate (GtkWidget    *widget,
   if (adjusted.x || adjusted.y)
     transform = gsk_transform_translate (transform, &GRAPHENE_POINT_INIT (adjusted.x, adjusted.y));
 
+  /* The transform also moves the border box by the CSS border
+   * and padding, so the bounds of the widget itself change too
+   */
+  if (!gsk_transform_equal (priv->transform, transform))
+    gtk_widget_invalidate_pick_bounds (widget);
+
   gsk_transform_unref (priv->transform);
   priv->transform = transform;
 
@@ -4059,6 +4109,9 @@ gtk_widget_allocate (GtkWidget    *widget,
                      border.bottom + padding.bottom;
   size_changed = (priv->width != adjusted.width) || (priv->height != adjusted.height);
 
+  if (size_changed)
+    gtk_widget_invalidate_pick_bounds (widget);
+
   if (!alloc_needed && !size_changed && !baseline_changed)
     goto skip_allocate;
 
@@ -5990,6 +6043,10 @@ gtk_widget_reposition_after (GtkWidget *widget,
 
   priv->parent = parent;
 
+  if (prev_parent == NULL)
+    parent->priv->n_children++;
+  gtk_widget_invalidate_pick_children (parent);
+
   if (previous_sibling)
     {
       if (previous_sibling->priv->next_sibling)
@@ -7597,6 +7654,7 @@ gtk_widget_finalize (GObject *object)
 
   g_clear_pointer (&priv->transform, gsk_transform_unref);
   g_clear_pointer (&priv->allocated_transform, gsk_transform_unref);
+  g_clear_pointer (&priv->pick_index, gtk_pick_index_free);
 
   gtk_css_widget_node_widget_destroyed (GTK_CSS_WIDGET_NODE (priv->cssnode));
   g_object_unref (priv->cssnode);
@@ -7652,6 +7710,8 @@ gtk_widget_real_map (GtkWidget *widget)
     {
       GtkWidget *p;
       priv->mapped = TRUE;
+      if (priv->parent)
+        gtk_widget_invalidate_pick_children (priv->parent);
 
       for (p = gtk_widget_get_first_child (widget);
            p != NULL;
@@ -7674,6 +7734,8 @@ gtk_widget_real_unmap (GtkWidget *widget)
     {
       GtkWidget *child;
       priv->mapped = FALSE;
+      if (priv->parent)
+        gtk_widget_invalidate_pick_children (priv->parent);
 
       for (child = _gtk_widget_get_first_child (widget);
            child != NULL;
@@ -10021,6 +10083,13 @@ gtk_widget_contains (GtkWidget  *widget,
   if (!_gtk_widget_get_mapped (widget))
     return FALSE;
 
+  /* The bounds the pick index uses cover the border box, so points
+   * outside of them are rejected without looking at the CSS boxes.
+   */
+  if (widget->priv->pick_bounds_valid && widget->priv->pick_bounded &&
+      !graphene_rect_contains_point (&widget->priv->pick_bounds, &GRAPHENE_POINT_INIT (x, y)))
+    return FALSE;
+
   return GTK_WIDGET_GET_CLASS (widget)->contains (widget, x, y);
 }
 
@@ -10043,6 +10112,68 @@ gtk_widget_can_be_picked (GtkWidget    *widget,
   return TRUE;
 }
 
+static GtkWidget *gtk_widget_do_pick (GtkWidget    *widget,
+                                       double        x,
+                                       double        y,
+                                       GtkPickFlags  flags);
+
+static GtkWidget *
+gtk_widget_do_pick_child (GtkWidget    *child,
+                          double        x,
+                          double        y,
+                          GtkPickFlags  flags)
+{
+  GtkWidgetPrivate *child_priv = gtk_widget_get_instance_private (child);
+  graphene_point3d_t res;
+
+  if (!gtk_widget_can_be_picked (child, flags))
+    return NULL;
+
+  if (GTK_IS_NATIVE (child))
+    return NULL;
+
+  if (child_priv->transform)
+    {
+      if (gsk_transform_get_category (child_priv->transform) >= GSK_TRANSFORM_CATEGORY_2D_TRANSLATE)
+        {
+          graphene_point_t transformed_p;
+
+          gsk_transform_transform_point (child_priv->transform,
+                                         &(graphene_point_t) { 0, 0 },
+                                         &transformed_p);
+
+          graphene_point3d_init (&res, x - transformed_p.x, y - transformed_p.y, 0.);
+        }
+      else
+        {
+          GskTransform *transform;
+          graphene_matrix_t inv;
+          graphene_point3d_t p0, p1;
+
+          transform = gsk_transform_invert (gsk_transform_ref (child_priv->transform));
+          if (transform == NULL)
+            return NULL;
+
+          gsk_transform_to_matrix (transform, &inv);
+          gsk_transform_unref (transform);
+          graphene_point3d_init (&p0, x, y, 0);
+          graphene_point3d_init (&p1, x, y, 1);
+          graphene_matrix_transform_point3d (&inv, &p0, &p0);
+          graphene_matrix_transform_point3d (&inv, &p1, &p1);
+          if (fabs (p0.z - p1.z) < 1.f / 4096)
+            return NULL;
+
+          graphene_point3d_interpolate (&p0, &p1, p0.z / (p0.z - p1.z), &res);
+        }
+    }
+  else
+    {
+      graphene_point3d_init (&res, x, y, 0);
+    }
+
+  return gtk_widget_do_pick (child, res.x, res.y, flags);
+}
+
 static GtkWidget *
 gtk_widget_do_pick (GtkWidget    *widget,
                     double        x,
@@ -10050,7 +10181,7 @@ gtk_widget_do_pick (GtkWidget    *widget,
                     GtkPickFlags  flags)
 {
   GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
-  GtkWidget *child;
+  GtkWidget *child, *picked;
 
   if (priv->overflow == GTK_OVERFLOW_HIDDEN)
     {
@@ -10063,62 +10194,42 @@ gtk_widget_do_pick (GtkWidget    *widget,
         return NULL;
     }
 
-  for (child = _gtk_widget_get_last_child (widget);
-       child;
-       child = _gtk_widget_get_prev_sibling (child))
+  if (priv->n_children >= GTK_PICK_INDEX_MIN_CHILDREN)
     {
-      GtkWidgetPrivate *child_priv = gtk_widget_get_instance_private (child);
-      GtkWidget *picked;
-      graphene_point3d_t res;
-
-      if (!gtk_widget_can_be_picked (child, flags))
-        continue;
-
-      if (GTK_IS_NATIVE (child))
-        continue;
-
-      if (child_priv->transform)
+      if (priv->pick_index == NULL ||
+          !gtk_pick_index_is_valid (priv->pick_index, priv->pick_generation))
         {
-          if (gsk_transform_get_category (child_priv->transform) >= GSK_TRANSFORM_CATEGORY_2D_TRANSLATE)
-            {
-              graphene_point_t transformed_p;
-
-              gsk_transform_transform_point (child_priv->transform,
-                                             &(graphene_point_t) { 0, 0 },
-                                             &transformed_p);
-
-              graphene_point3d_init (&res, x - transformed_p.x, y - transformed_p.y, 0.);
-            }
-          else
-            {
-              GskTransform *transform;
-              graphene_matrix_t inv;
-              graphene_point3d_t p0, p1;
-
-              transform = gsk_transform_invert (gsk_transform_ref (child_priv->transform));
-              if (transform == NULL)
-                continue;
+          g_clear_pointer (&priv->pick_index, gtk_pick_index_free);
+          priv->pick_index = gtk_pick_index_new (widget, priv->pick_generation);
+        }
+      else
+        gtk_pick_index_update (priv->pick_index);
+    }
+  else
+    g_clear_pointer (&priv->pick_index, gtk_pick_index_free);
 
-              gsk_transform_to_matrix (transform, &inv);
-              gsk_transform_unref (transform);
-              graphene_point3d_init (&p0, x, y, 0);
-              graphene_point3d_init (&p1, x, y, 1);
-              graphene_matrix_transform_point3d (&inv, &p0, &p0);
-              graphene_matrix_transform_point3d (&inv, &p1, &p1);
-              if (fabs (p0.z - p1.z) < 1.f / 4096)
-                continue;
+  if (priv->pick_index && gtk_pick_index_is_enabled (priv->pick_index))
+    {
+      GtkPickIndexIter iter;
 
-              graphene_point3d_interpolate (&p0, &p1, p0.z / (p0.z - p1.z), &res);
-            }
+      gtk_pick_index_iter_init (&iter, priv->pick_index, x, y);
+      while ((child = gtk_pick_index_iter_next (&iter)))
+        {
+          picked = gtk_widget_do_pick_child (child, x, y, flags);
+          if (picked)
+            return picked;
         }
-      else
+    }
+  else
+    {
+      for (child = _gtk_widget_get_last_child (widget);
+           child;
+           child = _gtk_widget_get_prev_sibling (child))
         {
-          graphene_point3d_init (&res, x, y, 0);
+          picked = gtk_widget_do_pick_child (child, x, y, flags);
+          if (picked)
+            return picked;
         }
-
-      picked = gtk_widget_do_pick (child, res.x, res.y, flags);
-      if (picked)
-        return picked;
     }
 
   if (!GTK_WIDGET_GET_CLASS (widget)->contains (widget, x, y))
@@ -10461,6 +10572,7 @@ gtk_widget_set_overflow (GtkWidget   *widget,
     return;
 
   priv->overflow = overflow;
+  gtk_widget_invalidate_pick_bounds (widget);
 
   gtk_widget_queue_draw (widget);
 
@@ -11658,6 +11770,9 @@ gtk_widget_render (GtkWidget            *widget,
   double x, y;
   gint64 before_snapshot G_GNUC_UNUSED;
   gint64 before_render G_GNUC_UNUSED;
+  gint64 snapshot_start = 0;
+  gint64 render_start = 0;
+  gboolean record;
 
   before_snapshot = GDK_PROFILER_CURRENT_TIME;
   before_render = 0;
@@ -11669,6 +11784,10 @@ gtk_widget_render (GtkWidget            *widget,
   if (renderer == NULL)
     return;
 
+  record = gtk_flight_recorder_is_enabled ();
+  if (record)
+    snapshot_start = g_get_monotonic_time ();
+
   snapshot = gtk_snapshot_new ();
   gtk_native_get_surface_transform (GTK_NATIVE (widget), &x, &y);
   gtk_snapshot_translate (snapshot, &GRAPHENE_POINT_INIT (x, y));
@@ -11679,6 +11798,9 @@ gtk_widget_render (GtkWidget            *widget,
     {
       before_render = GDK_PROFILER_CURRENT_TIME;
       gdk_profiler_add_mark (before_snapshot, (before_render - before_snapshot), "widget snapshot", "");
+      gtk_render_cache_report_statistics ();
+      gtk_shaping_cache_report_statistics ();
+      gtk_css_image_cache_report_statistics ();
     }
 
   if (root != NULL)
@@ -11690,8 +11812,16 @@ gtk_widget_render (GtkWidget            *widget,
                                            root,
                                            priv->render_node);
 
+      if (record)
+        render_start = g_get_monotonic_time ();
+
       gsk_renderer_render (renderer, root, region);
 
+      if (record)
+        gtk_flight_recorder_record_frame (widget, region, root,
+                                          snapshot_start, render_start,
+                                          g_get_monotonic_time ());
+
       gsk_render_node_unref (root);
 
       gdk_profiler_end_mark (before_render, "widget render", "");
@@ -32,6 +32,7 @@
 #include "gtkcsstypesprivate.h"
 #include "gtkeventcontrollerprivate.h"
 #include "gtklistlistmodelprivate.h"
+#include "gtkpickindexprivate.h"
 #include "gtkrootprivate.h"
 #include "gtksizerequestcacheprivate.h"
 #include "gtkwindowprivate.h"
@@ -102,6 +103,11 @@ struct _GtkWidgetPrivate
   /* SizeGroup related flags */
   guint have_size_groups      : 1;
 
+  /* Picking related flags */
+  guint pick_bounds_valid     : 1; /* pick_bounds is up to date */
+  guint pick_bounded          : 1; /* pick_bounds can be used at all */
+  guint pick_dirty            : 1; /* our entry in the parent's pick index is outdated */
+
   /* Alignment */
   guint   halign              : 4;
   guint   valign              : 4;
@@ -181,6 +187,20 @@ struct _GtkWidgetPrivate
   GtkWidget *first_child;
   GtkWidget *last_child;
 
+  guint n_children;
+
+  /* Spatial index of the children, rebuilt on demand when it is
+   * older than pick_generation
+   */
+  GtkPickIndex *pick_index;
+  guint pick_generation;
+
+  /* The bounds of everything that can be picked in the widget,
+   * and its position in the pick index of the parent
+   */
+  graphene_rect_t pick_bounds;
+  guint pick_slot;
+
   /* only created on-demand */
   GtkListListModel *children_observer;
   GtkListListModel *controller_observer;
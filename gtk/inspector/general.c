@@ -65,6 +65,10 @@
 #include "broadway/gdkbroadway.h"
 #endif
 
+#ifdef GDK_WINDOWING_HEADLESS
+#include "headless/gdkheadless.h"
+#endif
+
 #ifdef GDK_RENDERING_VULKAN
 #include <vulkan/vulkan.h>
 #endif
@@ -140,6 +144,11 @@ init_version (GtkInspectorGeneral *gen)
     backend = "Broadway";
   else
 #endif
+#ifdef GDK_WINDOWING_HEADLESS
+  if (GDK_IS_HEADLESS_DISPLAY (gen->display))
+    backend = "Headless";
+  else
+#endif
 #ifdef GDK_WINDOWING_WIN32
   if (GDK_IS_WIN32_DISPLAY (gen->display))
     backend = "Windows";
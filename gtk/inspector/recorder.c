@@ -24,6 +24,7 @@
 #include <gtk/gtkdragsource.h>
 #include <gtk/gtkeventcontroller.h>
 #include <gtk/gtkfilechooserdialog.h>
+#include <gtk/gtkfilefilter.h>
 #include <gtk/gtksignallistitemfactory.h>
 #include <gtk/gtklabel.h>
 #include <gtk/gtklistbox.h>
@@ -48,6 +49,7 @@
 #include <gdk/gdktextureprivate.h>
 #include "gtk/gtkdebug.h"
 #include "gtk/gtkbuiltiniconprivate.h"
+#include "gtk/gtkflightrecorderprivate.h"
 #include "gtk/gtkrendernodepaintableprivate.h"
 
 #include "recording.h"
@@ -238,6 +240,246 @@ recordings_clear_all (GtkButton            *button,
   g_list_store_remove_all (G_LIST_STORE (recorder->recordings));
 }
 
+static GskRenderNode *
+load_flight_recording_node (GFile       *dir,
+                            const char  *name,
+                            GError     **error)
+{
+  GFile *file;
+  GBytes *bytes;
+  GskRenderNode *node;
+
+  file = g_file_get_child (dir, name);
+  bytes = g_file_load_bytes (file, NULL, NULL, error);
+  g_object_unref (file);
+  if (bytes == NULL)
+    return NULL;
+
+  node = gsk_render_node_deserialize (bytes, NULL, NULL);
+  g_bytes_unref (bytes);
+
+  if (node == NULL)
+    g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                 "Could not load render node from %s", name);
+
+  return node;
+}
+
+/* Loads a recording written by the flight recorder, see
+ * gtkflightrecorder.c. The timings of each frame and the events
+ * that happened since the previous one are shown as its info.
+ */
+static gboolean
+load_flight_recording (GtkInspectorRecorder  *recorder,
+                       GFile                 *file,
+                       GError               **error)
+{
+  GKeyFile *keyfile;
+  GFile *dir;
+  char *contents;
+  gsize length;
+  char **groups;
+  GPtrArray *event_groups;
+  GtkInspectorRecording *recording;
+  gint64 previous_end;
+  guint next_event;
+  gsize i;
+  gboolean result;
+
+  if (!g_file_load_contents (file, NULL, &contents, &length, NULL, error))
+    return FALSE;
+
+  keyfile = g_key_file_new ();
+  result = g_key_file_load_from_data (keyfile, contents, length, G_KEY_FILE_NONE, error);
+  g_free (contents);
+
+  if (result && !g_key_file_has_group (keyfile, "Flight Recording"))
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                   "Not a flight recording");
+      result = FALSE;
+    }
+
+  if (!result)
+    {
+      g_key_file_free (keyfile);
+      return FALSE;
+    }
+
+  dir = g_file_get_parent (file);
+  groups = g_key_file_get_groups (keyfile, NULL);
+
+  event_groups = g_ptr_array_new ();
+  for (i = 0; groups[i]; i++)
+    {
+      if (g_str_has_prefix (groups[i], "Event "))
+        g_ptr_array_add (event_groups, groups[i]);
+    }
+
+  recording = gtk_inspector_start_recording_new ();
+  g_list_store_append (G_LIST_STORE (recorder->recordings), recording);
+  g_object_unref (recording);
+
+  previous_end = G_MININT64;
+  next_event = 0;
+
+  for (i = 0; groups[i] && result; i++)
+    {
+      const char *group = groups[i];
+      GskRenderNode *node;
+      GString *info;
+      char *name, *widget;
+      int *area, *rects;
+      gsize n_area, n_rects, j;
+      gint64 frame_start, snapshot_start, render_start, render_end;
+      cairo_region_t *region;
+
+      if (!g_str_has_prefix (group, "Frame "))
+        continue;
+
+      name = g_key_file_get_string (keyfile, group, "node", error);
+      if (name == NULL)
+        {
+          result = FALSE;
+          break;
+        }
+
+      node = load_flight_recording_node (dir, name, error);
+      g_free (name);
+      if (node == NULL)
+        {
+          result = FALSE;
+          break;
+        }
+
+      area = g_key_file_get_integer_list (keyfile, group, "area", &n_area, NULL);
+      rects = g_key_file_get_integer_list (keyfile, group, "region", &n_rects, NULL);
+      widget = g_key_file_get_string (keyfile, group, "widget", NULL);
+      frame_start = g_key_file_get_int64 (keyfile, group, "frame-start", NULL);
+      snapshot_start = g_key_file_get_int64 (keyfile, group, "snapshot-start", NULL);
+      render_start = g_key_file_get_int64 (keyfile, group, "render-start", NULL);
+      render_end = g_key_file_get_int64 (keyfile, group, "render-end", NULL);
+
+      region = cairo_region_create ();
+      for (j = 0; j + 4 <= n_rects; j += 4)
+        cairo_region_union_rectangle (region,
+                                      &(cairo_rectangle_int_t) {
+                                        rects[j], rects[j + 1], rects[j + 2], rects[j + 3]
+                                      });
+
+      info = g_string_new (NULL);
+      g_string_append_printf (info, "Widget: %s\n", widget ? widget : "unknown");
+      if (frame_start != 0)
+        g_string_append_printf (info, "Frame: %.2f ms\n", (render_end - frame_start) / 1000.);
+      g_string_append_printf (info, "Snapshot: %.2f ms\n", (render_start - snapshot_start) / 1000.);
+      g_string_append_printf (info, "Render: %.2f ms\n", (render_end - render_start) / 1000.);
+
+      for (; next_event < event_groups->len; next_event++)
+        {
+          const char *event_group = g_ptr_array_index (event_groups, next_event);
+          gint64 time = g_key_file_get_int64 (keyfile, event_group, "time", NULL);
+          char *type;
+
+          if (time > render_end)
+            break;
+
+          if (time <= previous_end)
+            continue;
+
+          type = g_key_file_get_string (keyfile, event_group, "type", NULL);
+          g_string_append_printf (info, "Event: %s at %+.2f ms\n",
+                                  type ? type : "unknown",
+                                  (time - snapshot_start) / 1000.);
+          g_free (type);
+        }
+
+      recording = gtk_inspector_render_recording_new_with_info (g_key_file_get_int64 (keyfile, group, "frame-time", NULL),
+                                                                info->str,
+                                                                n_area == 4
+                                                                ? &(GdkRectangle) { area[0], area[1], area[2], area[3] }
+                                                                : &(GdkRectangle) { 0, 0, 0, 0 },
+                                                                region,
+                                                                node);
+      g_list_store_append (G_LIST_STORE (recorder->recordings), recording);
+      g_object_unref (recording);
+
+      previous_end = render_end;
+
+      g_string_free (info, TRUE);
+      cairo_region_destroy (region);
+      gsk_render_node_unref (node);
+      g_free (widget);
+      g_free (rects);
+      g_free (area);
+    }
+
+  g_ptr_array_unref (event_groups);
+  g_strfreev (groups);
+  g_object_unref (dir);
+  g_key_file_free (keyfile);
+
+  return result;
+}
+
+static void
+recordings_open_response (GtkWidget            *dialog,
+                          int                   response,
+                          GtkInspectorRecorder *recorder)
+{
+  gtk_widget_hide (dialog);
+
+  if (response == GTK_RESPONSE_ACCEPT)
+    {
+      GFile *file = gtk_file_chooser_get_file (GTK_FILE_CHOOSER (dialog));
+      GError *error = NULL;
+
+      if (!load_flight_recording (recorder, file, &error))
+        {
+          GtkWidget *message_dialog;
+
+          message_dialog = gtk_message_dialog_new (GTK_WINDOW (gtk_window_get_transient_for (GTK_WINDOW (dialog))),
+                                                   GTK_DIALOG_MODAL|GTK_DIALOG_DESTROY_WITH_PARENT,
+                                                   GTK_MESSAGE_INFO,
+                                                   GTK_BUTTONS_OK,
+                                                   _("Opening flight recording failed"));
+          gtk_message_dialog_format_secondary_text (GTK_MESSAGE_DIALOG (message_dialog),
+                                                    "%s", error->message);
+          g_signal_connect (message_dialog, "response", G_CALLBACK (gtk_window_destroy), NULL);
+          gtk_widget_show (message_dialog);
+          g_error_free (error);
+        }
+
+      g_object_unref (file);
+    }
+
+  gtk_window_destroy (GTK_WINDOW (dialog));
+}
+
+static void
+recordings_open (GtkButton            *button,
+                 GtkInspectorRecorder *recorder)
+{
+  GtkWidget *dialog;
+  GtkFileFilter *filter;
+
+  dialog = gtk_file_chooser_dialog_new ("",
+                                        GTK_WINDOW (gtk_widget_get_root (GTK_WIDGET (recorder))),
+                                        GTK_FILE_CHOOSER_ACTION_OPEN,
+                                        _("_Cancel"), GTK_RESPONSE_CANCEL,
+                                        _("_Open"), GTK_RESPONSE_ACCEPT,
+                                        NULL);
+  filter = gtk_file_filter_new ();
+  gtk_file_filter_set_name (filter, _("Flight recordings"));
+  gtk_file_filter_add_pattern (filter, GTK_FLIGHT_RECORDER_FILENAME);
+  gtk_file_chooser_add_filter (GTK_FILE_CHOOSER (dialog), filter);
+  g_object_unref (filter);
+
+  gtk_dialog_set_default_response (GTK_DIALOG (dialog), GTK_RESPONSE_ACCEPT);
+  gtk_window_set_modal (GTK_WINDOW (dialog), TRUE);
+  g_signal_connect (dialog, "response", G_CALLBACK (recordings_open_response), recorder);
+  gtk_widget_show (dialog);
+}
+
 static const char *
 node_type_name (GskRenderNodeType type)
 {
@@ -1518,6 +1760,7 @@ gtk_inspector_recorder_class_init (GtkInspectorRecorderClass *klass)
   gtk_widget_class_bind_template_child (widget_class, GtkInspectorRecorder, node_property_tree);
 
   gtk_widget_class_bind_template_callback (widget_class, recordings_clear_all);
+  gtk_widget_class_bind_template_callback (widget_class, recordings_open);
   gtk_widget_class_bind_template_callback (widget_class, recordings_list_row_selected);
   gtk_widget_class_bind_template_callback (widget_class, render_node_save);
   gtk_widget_class_bind_template_callback (widget_class, render_node_clip);
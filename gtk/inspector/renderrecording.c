@@ -80,6 +80,27 @@ gtk_inspector_render_recording_new (gint64                timestamp,
   return GTK_INSPECTOR_RECORDING (recording);
 }
 
+GtkInspectorRecording *
+gtk_inspector_render_recording_new_with_info (gint64                timestamp,
+                                              const char           *profiler_info,
+                                              const GdkRectangle   *area,
+                                              const cairo_region_t *clip_region,
+                                              GskRenderNode        *node)
+{
+  GtkInspectorRenderRecording *recording;
+
+  recording = g_object_new (GTK_TYPE_INSPECTOR_RENDER_RECORDING,
+                            "timestamp", timestamp,
+                            NULL);
+
+  recording->profiler_info = g_strdup (profiler_info);
+  recording->area = *area;
+  recording->clip_region = cairo_region_copy (clip_region);
+  recording->node = gsk_render_node_ref (node);
+
+  return GTK_INSPECTOR_RECORDING (recording);
+}
+
 GskRenderNode *
 gtk_inspector_render_recording_get_node (GtkInspectorRenderRecording *recording)
 {
@@ -59,6 +59,12 @@ GtkInspectorRecording *
                                                               const GdkRectangle                *area,
                                                               const cairo_region_t              *clip_region,
                                                               GskRenderNode                     *node);
+GtkInspectorRecording *
+                gtk_inspector_render_recording_new_with_info (gint64                             timestamp,
+                                                              const char                        *profiler_info,
+                                                              const GdkRectangle                *area,
+                                                              const cairo_region_t              *clip_region,
+                                                              GskRenderNode                     *node);
 
 GskRenderNode * gtk_inspector_render_recording_get_node      (GtkInspectorRenderRecording       *recording);
 const cairo_region_t *
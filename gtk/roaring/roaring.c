@@ -3406,6 +3406,37 @@ bool array_container_iterate64(const array_container_t *cont, uint32_t base,
 #include <stdlib.h>
 #include <string.h>
 
+/* GTK: with ROARING_RUNTIME_DISPATCH (see roaring.h), the bitset
+ * container operations have a generic name_impl() and a name_avx2()
+ * that uses the AVX2 Harley-Seal functions, and name() picks one at
+ * runtime. */
+#ifdef ROARING_RUNTIME_DISPATCH
+#define ROARING_ALWAYS_INLINE inline __attribute__((always_inline))
+
+static bool croaring_avx2(void) {
+    static int support = -1;
+    if (support < 0) {
+        __builtin_cpu_init();
+        support = __builtin_cpu_supports("avx2") &&
+                  __builtin_cpu_supports("popcnt");
+    }
+    return support;
+}
+
+/* Defines name() calling either name_impl() or name_avx2() */
+#define BITSET_CONTAINER_DISPATCH(name, params, args) \
+int name params {                                    \
+    if (croaring_avx2()) return name##_avx2 args;    \
+    return name##_impl args;                         \
+}
+#else
+#define ROARING_ALWAYS_INLINE inline
+#define BITSET_CONTAINER_DISPATCH(name, params, args) \
+int name params {                                    \
+    return name##_impl args;                         \
+}
+#endif
+
 
 void bitset_container_clear(bitset_container_t *bitset) {
     memset(bitset->array, 0, sizeof(uint64_t) * BITSET_CONTAINER_SIZE_IN_WORDS);
@@ -3558,7 +3589,8 @@ int bitset_container_compute_cardinality(const bitset_container_t *bitset) {
 #else
 
 /* Get the number of bits set (force computation) */
-int bitset_container_compute_cardinality(const bitset_container_t *bitset) {
+static ROARING_ALWAYS_INLINE int bitset_container_compute_cardinality_impl(
+    const bitset_container_t *bitset) {
     const uint64_t *array = bitset->array;
     int32_t sum = 0;
     for (int i = 0; i < BITSET_CONTAINER_SIZE_IN_WORDS; i += 4) {
@@ -3570,6 +3602,19 @@ int bitset_container_compute_cardinality(const bitset_container_t *bitset) {
     return sum;
 }
 
+#ifdef ROARING_RUNTIME_DISPATCH
+static ROARING_TARGET_AVX2 int bitset_container_compute_cardinality_avx2(
+    const bitset_container_t *bitset) {
+    return (int) avx2_harley_seal_popcount256(
+        (const __m256i *)bitset->array,
+        BITSET_CONTAINER_SIZE_IN_WORDS / (sizeof(__m256i) / sizeof(uint64_t)));
+}
+#endif
+
+BITSET_CONTAINER_DISPATCH(bitset_container_compute_cardinality,
+                          (const bitset_container_t *bitset),
+                          (bitset))
+
 #endif
 
 #ifdef USEAVX
@@ -3747,8 +3792,63 @@ int bitset_container_##opname##_justcard(const bitset_container_t *src_1,     \
 
 #else /* not USEAVX  */
 
+#ifdef ROARING_RUNTIME_DISPATCH
+#define WORDS_IN_AVX2_REG sizeof(__m256i) / sizeof(uint64_t)
+
+/* The AVX2 versions of the functions below, like the USEAVX ones above */
+#define BITSET_CONTAINER_FN_AVX2(opname, avx_intrinsic)                   \
+static ROARING_TARGET_AVX2 int bitset_container_##opname##_avx2(          \
+                              const bitset_container_t *src_1,            \
+                              const bitset_container_t *src_2,            \
+                              bitset_container_t *dst) {                  \
+    const __m256i * __restrict__ array_1 = (const __m256i *) src_1->array; \
+    const __m256i * __restrict__ array_2 = (const __m256i *) src_2->array; \
+    __m256i *out = (__m256i *) dst->array;                                \
+    dst->cardinality = (int32_t)avx2_harley_seal_popcount256andstore_##opname( \
+        array_2, array_1, out,                                            \
+        BITSET_CONTAINER_SIZE_IN_WORDS / (WORDS_IN_AVX2_REG));            \
+    return dst->cardinality;                                              \
+}                                                                         \
+static ROARING_TARGET_AVX2 int bitset_container_##opname##_nocard_avx2(   \
+                              const bitset_container_t *src_1,            \
+                              const bitset_container_t *src_2,            \
+                              bitset_container_t *dst) {                  \
+    const __m256i * __restrict__ array_1 = (const __m256i *) src_1->array; \
+    const __m256i * __restrict__ array_2 = (const __m256i *) src_2->array; \
+    __m256i *out = (__m256i *) dst->array;                                \
+    for (size_t i = 0;                                                    \
+         i < BITSET_CONTAINER_SIZE_IN_WORDS / (WORDS_IN_AVX2_REG); i += 4) { \
+        _mm256_storeu_si256(out + i,                                      \
+            avx_intrinsic(_mm256_lddqu_si256(array_2 + i),                \
+                          _mm256_lddqu_si256(array_1 + i)));              \
+        _mm256_storeu_si256(out + i + 1,                                  \
+            avx_intrinsic(_mm256_lddqu_si256(array_2 + i + 1),            \
+                          _mm256_lddqu_si256(array_1 + i + 1)));          \
+        _mm256_storeu_si256(out + i + 2,                                  \
+            avx_intrinsic(_mm256_lddqu_si256(array_2 + i + 2),            \
+                          _mm256_lddqu_si256(array_1 + i + 2)));          \
+        _mm256_storeu_si256(out + i + 3,                                  \
+            avx_intrinsic(_mm256_lddqu_si256(array_2 + i + 3),            \
+                          _mm256_lddqu_si256(array_1 + i + 3)));          \
+    }                                                                     \
+    dst->cardinality = BITSET_UNKNOWN_CARDINALITY;                        \
+    return dst->cardinality;                                              \
+}                                                                         \
+static ROARING_TARGET_AVX2 int bitset_container_##opname##_justcard_avx2( \
+                              const bitset_container_t *src_1,            \
+                              const bitset_container_t *src_2) {          \
+    const __m256i * __restrict__ data1 = (const __m256i *) src_1->array;  \
+    const __m256i * __restrict__ data2 = (const __m256i *) src_2->array;  \
+    return (int)avx2_harley_seal_popcount256_##opname(data2, data1,      \
+        BITSET_CONTAINER_SIZE_IN_WORDS / (WORDS_IN_AVX2_REG));            \
+}
+#else
+#define BITSET_CONTAINER_FN_AVX2(opname, avx_intrinsic)
+#endif
+
 #define BITSET_CONTAINER_FN(opname, opsymbol, avx_intrinsic, neon_intrinsic)  \
-int bitset_container_##opname(const bitset_container_t *src_1,            \
+static ROARING_ALWAYS_INLINE int bitset_container_##opname##_impl(        \
+                              const bitset_container_t *src_1,            \
                               const bitset_container_t *src_2,            \
                               bitset_container_t *dst) {                  \
     const uint64_t * __restrict__ array_1 = src_1->array;                 \
@@ -3766,7 +3866,8 @@ int bitset_container_##opname(const bitset_container_t *src_1,            \
     dst->cardinality = sum;                                               \
     return dst->cardinality;                                              \
 }                                                                         \
-int bitset_container_##opname##_nocard(const bitset_container_t *src_1,   \
+static ROARING_ALWAYS_INLINE int bitset_container_##opname##_nocard_impl( \
+                                       const bitset_container_t *src_1,   \
                                        const bitset_container_t *src_2,   \
                                        bitset_container_t *dst) {         \
     const uint64_t * __restrict__ array_1 = src_1->array;                 \
@@ -3778,7 +3879,8 @@ int bitset_container_##opname##_nocard(const bitset_container_t *src_1,   \
     dst->cardinality = BITSET_UNKNOWN_CARDINALITY;                        \
     return dst->cardinality;                                              \
 }                                                                         \
-int bitset_container_##opname##_justcard(const bitset_container_t *src_1, \
+static ROARING_ALWAYS_INLINE int bitset_container_##opname##_justcard_impl( \
+                              const bitset_container_t *src_1,            \
                               const bitset_container_t *src_2) {          \
     const uint64_t * __restrict__ array_1 = src_1->array;                 \
     const uint64_t * __restrict__ array_2 = src_2->array;                 \
@@ -3790,7 +3892,22 @@ int bitset_container_##opname##_justcard(const bitset_container_t *src_1, \
         sum += hamming(word_2);                                    \
     }                                                                     \
     return sum;                                                           \
-}
+}                                                                         \
+BITSET_CONTAINER_FN_AVX2(opname, avx_intrinsic)                           \
+BITSET_CONTAINER_DISPATCH(bitset_container_##opname,                      \
+                          (const bitset_container_t *src_1,               \
+                           const bitset_container_t *src_2,               \
+                           bitset_container_t *dst),                      \
+                          (src_1, src_2, dst))                            \
+BITSET_CONTAINER_DISPATCH(bitset_container_##opname##_nocard,             \
+                          (const bitset_container_t *src_1,               \
+                           const bitset_container_t *src_2,               \
+                           bitset_container_t *dst),                      \
+                          (src_1, src_2, dst))                            \
+BITSET_CONTAINER_DISPATCH(bitset_container_##opname##_justcard,           \
+                          (const bitset_container_t *src_1,               \
+                           const bitset_container_t *src_2),              \
+                          (src_1, src_2))
 
 #endif
 
@@ -9252,6 +9369,68 @@ uint32_t roaring_read_uint32_iterator(roaring_uint32_iterator_t *it, uint32_t* b
   return ret;
 }
 
+bool roaring_read_range_uint32_iterator(roaring_uint32_iterator_t *it, uint32_t *first, uint32_t *last) {
+  uint32_t wordindex;  // used for bitsets
+  uint64_t word;       // used for bitsets
+  uint32_t index;      // used for arrays
+  uint16_t lastlow;
+  const array_container_t* acont;
+  const run_container_t* rcont;
+  const bitset_container_t* bcont;
+
+  if (!it->has_value) return false;
+
+  *first = it->current_value;
+  while (true) {
+    switch (it->typecode) {
+      case BITSET_CONTAINER_TYPE_CODE:
+        bcont = (const bitset_container_t*)(it->container);
+        // look for the first unset bit after the current value
+        wordindex = it->in_container_index / 64;
+        word = ~bcont->array[wordindex] & (UINT64_MAX << (it->in_container_index % 64));
+        while (word == 0 && wordindex+1 < BITSET_CONTAINER_SIZE_IN_WORDS) {
+          wordindex++;
+          word = ~bcont->array[wordindex];
+        }
+        if (word == 0) {
+          lastlow = UINT16_MAX;
+        } else {
+          lastlow = wordindex * 64 + __builtin_ctzll(word) - 1;
+        }
+        break;
+      case ARRAY_CONTAINER_TYPE_CODE:
+        acont = (const array_container_t *)(it->container);
+        index = it->in_container_index;
+        while (index + 1 < (uint32_t) acont->cardinality &&
+               acont->array[index + 1] == acont->array[index] + 1) {
+          index++;
+        }
+        lastlow = acont->array[index];
+        break;
+      case RUN_CONTAINER_TYPE_CODE:
+        rcont = (const run_container_t*)(it->container);
+        lastlow = rcont->runs[it->run_index].value + rcont->runs[it->run_index].length;
+        break;
+      default:
+        assert(false);
+        return false;
+    }
+
+    *last = it->highbits | lastlow;
+    if (*last == UINT32_MAX) {
+      it->container_index = it->parent->high_low_container.size;
+      it->has_value = false;
+      return true;
+    }
+
+    // the range may continue in the next container
+    roaring_move_uint32_iterator_equalorlarger(it, *last + 1);
+    if (lastlow != UINT16_MAX || !it->has_value || it->current_value != *last + 1) {
+      return true;
+    }
+  }
+}
+
 
 
 void roaring_free_uint32_iterator(roaring_uint32_iterator_t *it) { free(it); }
@@ -139,6 +139,20 @@ enum {
 
 #endif  // DISABLE_X64
 
+/* GTK: when not building for AVX2, the bitset container operations
+ * are compiled a second time with the AVX2 Harley-Seal functions below,
+ * and the version to use is picked at runtime. */
+#if !defined(USEAVX) && !defined(USENEON) && defined(IS_X64) && \
+    defined(__GNUC__) && !defined(DISABLE_RUNTIME_DISPATCH)
+#define ROARING_RUNTIME_DISPATCH
+#endif
+
+#ifdef ROARING_RUNTIME_DISPATCH
+#define ROARING_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#else
+#define ROARING_TARGET_AVX2
+#endif
+
 #ifdef _MSC_VER
 /* Microsoft C/C++-compatible compiler */
 #include <intrin.h>
@@ -903,7 +917,7 @@ uint64_t bitset_flip_list_withcard(void *bitset, uint64_t card,
 
 void bitset_flip_list(void *bitset, const uint16_t *list, uint64_t length);
 
-#ifdef USEAVX
+#if defined(USEAVX) || defined(ROARING_RUNTIME_DISPATCH)
 /***
  * BEGIN Harley-Seal popcount functions.
  */
@@ -912,7 +926,7 @@ void bitset_flip_list(void *bitset, const uint16_t *list, uint64_t length);
  * Compute the population count of a 256-bit word
  * This is not especially fast, but it is convenient as part of other functions.
  */
-static inline __m256i popcount256(__m256i v) {
+static inline ROARING_TARGET_AVX2 __m256i popcount256(__m256i v) {
     const __m256i lookuppos = _mm256_setr_epi8(
         /* 0 */ 4 + 0, /* 1 */ 4 + 1, /* 2 */ 4 + 1, /* 3 */ 4 + 2,
         /* 4 */ 4 + 1, /* 5 */ 4 + 2, /* 6 */ 4 + 2, /* 7 */ 4 + 3,
@@ -945,8 +959,8 @@ static inline __m256i popcount256(__m256i v) {
 /**
  * Simple CSA over 256 bits
  */
-static inline void CSA(__m256i *h, __m256i *l, __m256i a, __m256i b,
-                       __m256i c) {
+static inline ROARING_TARGET_AVX2 void CSA(__m256i *h, __m256i *l,
+                                          __m256i a, __m256i b, __m256i c) {
     const __m256i u = _mm256_xor_si256(a, b);
     *h = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
     *l = _mm256_xor_si256(u, c);
@@ -955,8 +969,8 @@ static inline void CSA(__m256i *h, __m256i *l, __m256i a, __m256i b,
 /**
  * Fast Harley-Seal AVX population count function
  */
-inline static uint64_t avx2_harley_seal_popcount256(const __m256i *data,
-                                                    const uint64_t size) {
+inline static ROARING_TARGET_AVX2 uint64_t avx2_harley_seal_popcount256(
+    const __m256i *data, const uint64_t size) {
     __m256i total = _mm256_setzero_si256();
     __m256i ones = _mm256_setzero_si256();
     __m256i twos = _mm256_setzero_si256();
@@ -1015,7 +1029,8 @@ inline static uint64_t avx2_harley_seal_popcount256(const __m256i *data,
 }
 
 #define AVXPOPCNTFNC(opname, avx_intrinsic)                                    \
-    static inline uint64_t avx2_harley_seal_popcount256_##opname(              \
+    static inline ROARING_TARGET_AVX2 uint64_t                                 \
+    avx2_harley_seal_popcount256_##opname(                                     \
         const __m256i *data1, const __m256i *data2, const uint64_t size) {     \
         __m256i total = _mm256_setzero_si256();                                \
         __m256i ones = _mm256_setzero_si256();                                 \
@@ -1095,7 +1110,8 @@ inline static uint64_t avx2_harley_seal_popcount256(const __m256i *data,
                (uint64_t)(_mm256_extract_epi64(total, 2)) +                    \
                (uint64_t)(_mm256_extract_epi64(total, 3));                     \
     }                                                                          \
-    static inline uint64_t avx2_harley_seal_popcount256andstore_##opname(      \
+    static inline ROARING_TARGET_AVX2 uint64_t                                 \
+    avx2_harley_seal_popcount256andstore_##opname(                             \
         const __m256i *__restrict__ data1, const __m256i *__restrict__ data2,  \
         __m256i *__restrict__ out, const uint64_t size) {                      \
         __m256i total = _mm256_setzero_si256();                                \
@@ -1205,7 +1221,7 @@ AVXPOPCNTFNC(andnot, _mm256_andnot_si256)
  * END Harley-Seal popcount functions.
  */
 
-#endif  // USEAVX
+#endif  // USEAVX || ROARING_RUNTIME_DISPATCH
 
 #endif
 /* end file include/roaring/bitset_util.h */
@@ -7082,6 +7098,16 @@ void roaring_free_uint32_iterator(roaring_uint32_iterator_t *it);
  */
 uint32_t roaring_read_uint32_iterator(roaring_uint32_iterator_t *it, uint32_t* buf, uint32_t count);
 
+/*
+ * Reads the range of consecutive values starting at ${it}->current_value
+ * into ${first} and ${last}, both inclusive.
+ * Returns false if the iterator has no value.
+ *
+ * After function returns, iterator is positioned at the next element
+ * after the range.
+ */
+bool roaring_read_range_uint32_iterator(roaring_uint32_iterator_t *it, uint32_t *first, uint32_t *last);
+
 #ifdef __cplusplus
 }
 #endif
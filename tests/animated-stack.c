@@ -0,0 +1,127 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+#include "frame-stats.h"
+
+/* Switches a stack between two pages that are expensive to render,
+ * to measure the frame times of stack transitions.
+ */
+
+static double transition_time = 1;
+static char *transition_name = NULL;
+static int n_rows = 40;
+
+static GOptionEntry options[] = {
+  { "time", 't', 0, G_OPTION_ARG_DOUBLE, &transition_time, "Transition time", "SECONDS" },
+  { "transition", 0, 0, G_OPTION_ARG_STRING, &transition_name, "Transition type", "TYPE" },
+  { "rows", 'r', 0, G_OPTION_ARG_INT, &n_rows, "Number of rows per page", "COUNT" },
+  { NULL }
+};
+
+static GtkWidget *
+create_page (GtkCssProvider *provider,
+             const char     *text)
+{
+  GtkWidget *grid, *widget;
+  int x, y;
+
+  grid = gtk_grid_new ();
+
+  for (x = 0; x < 10; x++)
+    {
+      for (y = 0; y < n_rows; y++)
+        {
+          widget = gtk_label_new (text);
+          gtk_style_context_add_provider (gtk_widget_get_style_context (widget),
+                                          GTK_STYLE_PROVIDER (provider),
+                                          GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+          gtk_grid_attach (GTK_GRID (grid), widget, x, y, 1, 1);
+        }
+    }
+
+  return grid;
+}
+
+static void
+switch_page (GtkStack *stack)
+{
+  if (gtk_stack_get_transition_running (stack))
+    return;
+
+  if (g_strcmp0 (gtk_stack_get_visible_child_name (stack), "first") == 0)
+    gtk_stack_set_visible_child_name (stack, "second");
+  else
+    gtk_stack_set_visible_child_name (stack, "first");
+}
+
+static void
+quit_cb (GtkWidget *widget,
+         gpointer   data)
+{
+  gboolean *done = data;
+
+  *done = TRUE;
+
+  g_main_context_wakeup (NULL);
+}
+
+int
+main (int argc, char **argv)
+{
+  GtkWidget *window, *stack;
+  GtkCssProvider *provider;
+  GtkStackTransitionType transition = GTK_STACK_TRANSITION_TYPE_SLIDE_LEFT_RIGHT;
+  GError *error = NULL;
+  gboolean done = FALSE;
+
+  GOptionContext *context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+  frame_stats_add_options (g_option_context_get_main_group (context));
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+
+  gtk_init ();
+
+  if (transition_name)
+    {
+      GEnumClass *enum_class = g_type_class_ref (GTK_TYPE_STACK_TRANSITION_TYPE);
+      GEnumValue *value = g_enum_get_value_by_nick (enum_class, transition_name);
+
+      if (value == NULL)
+        {
+          g_printerr ("Unknown transition type: %s\n", transition_name);
+          return 1;
+        }
+
+      transition = value->value;
+      g_type_class_unref (enum_class);
+    }
+
+  window = gtk_window_new ();
+  g_signal_connect (window, "destroy", G_CALLBACK (quit_cb), &done);
+  frame_stats_ensure (GTK_WINDOW (window));
+
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_load_from_data (provider, "* { padding: 2px; text-shadow: 5px 5px 2px grey; }", -1);
+
+  stack = gtk_stack_new ();
+  gtk_stack_set_transition_type (GTK_STACK (stack), transition);
+  gtk_stack_set_transition_duration (GTK_STACK (stack), transition_time * 1000);
+  gtk_stack_add_named (GTK_STACK (stack), create_page (provider, "Hello World"), "first");
+  gtk_stack_add_named (GTK_STACK (stack), create_page (provider, "Goodbye World"), "second");
+  g_signal_connect_after (stack, "map", G_CALLBACK (switch_page), NULL);
+  g_signal_connect_after (stack, "notify::transition-running", G_CALLBACK (switch_page), NULL);
+  gtk_window_set_child (GTK_WINDOW (window), stack);
+
+  gtk_widget_show (window);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  return 0;
+}
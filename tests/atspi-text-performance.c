@@ -0,0 +1,414 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Fills a text view with a large buffer and measures how long it
+ * takes to answer the queries that screen readers make through the
+ * AT-SPI text interface, both at the start and at the end of the
+ * buffer. Then a log is appended to the buffer, one line at a time,
+ * and the number and size of the TextChanged events that are sent
+ * for it is counted.
+ *
+ * The queries are made from a thread, through the accessibility bus,
+ * like an AT would make them. This needs a running accessibility bus.
+ */
+
+static int n_lines = 200000;
+static int n_queries = 1000;
+static int n_appends = 10000;
+
+static GOptionEntry options[] = {
+  { "lines", 'l', 0, G_OPTION_ARG_INT, &n_lines, "Number of lines in the buffer", "COUNT" },
+  { "queries", 'q', 0, G_OPTION_ARG_INT, &n_queries, "Number of times to make each query", "COUNT" },
+  { "appends", 'a', 0, G_OPTION_ARG_INT, &n_appends, "Number of lines to append", "COUNT" },
+  { NULL }
+};
+
+#define TEXT_INTERFACE "org.a11y.atspi.Text"
+
+typedef struct {
+  GDBusConnection *connection;
+  char *name;
+  char *path;
+  int n_chars;
+
+  GtkTextBuffer *buffer;
+  gboolean done;
+
+  int n_events;
+  gsize n_event_bytes;
+} Benchmark;
+
+static GVariant *
+call (GDBusConnection *connection,
+      const char      *name,
+      const char      *path,
+      const char      *interface,
+      const char      *method,
+      GVariant        *parameters)
+{
+  GError *error = NULL;
+  GVariant *result;
+
+  result = g_dbus_connection_call_sync (connection, name, path, interface, method,
+                                        parameters, NULL, G_DBUS_CALL_FLAGS_NONE,
+                                        -1, NULL, &error);
+  if (error)
+    {
+      g_printerr ("%s.%s failed: %s\n", interface, method, error->message);
+      g_error_free (error);
+    }
+
+  return result;
+}
+
+static GDBusConnection *
+get_a11y_bus (void)
+{
+  GDBusConnection *session, *connection;
+  GVariant *result;
+  const char *address;
+  GError *error = NULL;
+
+  session = g_bus_get_sync (G_BUS_TYPE_SESSION, NULL, NULL);
+  if (session == NULL)
+    return NULL;
+
+  result = g_dbus_connection_call_sync (session, "org.a11y.Bus", "/org/a11y/bus",
+                                        "org.a11y.Bus", "GetAddress",
+                                        NULL, G_VARIANT_TYPE ("(s)"),
+                                        G_DBUS_CALL_FLAGS_NONE, -1, NULL, NULL);
+  g_object_unref (session);
+  if (result == NULL)
+    return NULL;
+
+  g_variant_get (result, "(&s)", &address);
+  connection = g_dbus_connection_new_for_address_sync (address,
+                                                       G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+                                                       G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+                                                       NULL, NULL, &error);
+  g_variant_unref (result);
+
+  if (error)
+    {
+      g_printerr ("Could not connect to the accessibility bus: %s\n", error->message);
+      g_error_free (error);
+    }
+
+  return connection;
+}
+
+static gboolean
+find_text (Benchmark  *bench,
+           const char *name,
+           const char *path)
+{
+  GVariant *result;
+  GVariantIter *iter;
+  const char *child_name, *child_path;
+  gboolean found = FALSE;
+
+  result = call (bench->connection, name, path,
+                 "org.a11y.atspi.Accessible", "GetInterfaces", NULL);
+  if (result)
+    {
+      const char **interfaces;
+
+      g_variant_get (result, "(^a&s)", &interfaces);
+      found = g_strv_contains (interfaces, TEXT_INTERFACE);
+      g_free (interfaces);
+      g_variant_unref (result);
+    }
+
+  if (found)
+    {
+      GVariant *value;
+
+      result = call (bench->connection, name, path,
+                     "org.freedesktop.DBus.Properties", "Get",
+                     g_variant_new ("(ss)", TEXT_INTERFACE, "CharacterCount"));
+      g_variant_get (result, "(v)", &value);
+      bench->n_chars = g_variant_get_int32 (value);
+      g_variant_unref (value);
+      g_variant_unref (result);
+
+      /* Skip labels and the like */
+      if (bench->n_chars > n_lines)
+        {
+          bench->name = g_strdup (name);
+          bench->path = g_strdup (path);
+          return TRUE;
+        }
+    }
+
+  result = call (bench->connection, name, path,
+                 "org.a11y.atspi.Accessible", "GetChildren", NULL);
+  if (result == NULL)
+    return FALSE;
+
+  found = FALSE;
+  g_variant_get (result, "(a(so))", &iter);
+  while (!found && g_variant_iter_loop (iter, "(&s&o)", &child_name, &child_path))
+    found = find_text (bench, child_name, child_path);
+  g_variant_iter_free (iter);
+  g_variant_unref (result);
+
+  return found;
+}
+
+static gboolean
+find_application (Benchmark *bench)
+{
+  GVariant *result;
+  GVariantIter *iter;
+  const char *name, *path;
+  gboolean found = FALSE;
+
+  result = call (bench->connection, "org.a11y.atspi.Registry",
+                 "/org/a11y/atspi/accessible/root",
+                 "org.a11y.atspi.Accessible", "GetChildren", NULL);
+  if (result == NULL)
+    return FALSE;
+
+  g_variant_get (result, "(a(so))", &iter);
+  while (!found && g_variant_iter_loop (iter, "(&s&o)", &name, &path))
+    {
+      GVariant *pid;
+      guint32 value;
+
+      pid = g_dbus_connection_call_sync (bench->connection, "org.freedesktop.DBus",
+                                         "/org/freedesktop/DBus", "org.freedesktop.DBus",
+                                         "GetConnectionUnixProcessID",
+                                         g_variant_new ("(s)", name), G_VARIANT_TYPE ("(u)"),
+                                         G_DBUS_CALL_FLAGS_NONE, -1, NULL, NULL);
+      if (pid == NULL)
+        continue;
+
+      g_variant_get (pid, "(u)", &value);
+      g_variant_unref (pid);
+
+      if (value == getpid ())
+        found = find_text (bench, name, "/org/a11y/atspi/accessible/root");
+    }
+  g_variant_iter_free (iter);
+  g_variant_unref (result);
+
+  return found;
+}
+
+static void
+time_query (Benchmark  *bench,
+            const char *label,
+            const char *method,
+            const char *format,
+            gboolean    at_end)
+{
+  gint64 start;
+  int i;
+
+  start = g_get_monotonic_time ();
+
+  for (i = 0; i < n_queries; i++)
+    {
+      GVariant *result;
+      int offset;
+
+      if (at_end)
+        offset = bench->n_chars - 1 - (i * 37) % MIN (bench->n_chars, 10000);
+      else
+        offset = (i * 37) % MIN (bench->n_chars, 10000);
+
+      if (g_str_equal (format, "(ii)"))
+        result = call (bench->connection, bench->name, bench->path, TEXT_INTERFACE, method,
+                       g_variant_new ("(ii)", offset, offset + 80));
+      else if (g_str_equal (format, "(iu)"))
+        result = call (bench->connection, bench->name, bench->path, TEXT_INTERFACE, method,
+                       g_variant_new ("(iu)", offset, strstr (method, "String") ? 3 : 5));
+      else if (g_str_equal (format, "(ib)"))
+        result = call (bench->connection, bench->name, bench->path, TEXT_INTERFACE, method,
+                       g_variant_new ("(ib)", offset, FALSE));
+      else
+        result = call (bench->connection, bench->name, bench->path, TEXT_INTERFACE, method,
+                       g_variant_new ("(i)", offset));
+
+      if (result)
+        g_variant_unref (result);
+    }
+
+  g_print ("%-32s %-5s %8.2f µs/call\n", label, at_end ? "end" : "start",
+           (double) (g_get_monotonic_time () - start) / n_queries);
+}
+
+static void
+text_changed (GDBusConnection *connection,
+              const char      *sender,
+              const char      *path,
+              const char      *interface,
+              const char      *signal,
+              GVariant        *parameters,
+              gpointer         data)
+{
+  Benchmark *bench = data;
+  GVariant *text;
+
+  g_variant_get_child (parameters, 3, "v", &text);
+  g_atomic_int_inc (&bench->n_events);
+  bench->n_event_bytes += g_variant_get_size (text);
+  g_variant_unref (text);
+}
+
+static gboolean
+append_lines (gpointer data)
+{
+  Benchmark *bench = data;
+  GtkTextIter end;
+  int i;
+
+  for (i = 0; i < n_appends; i++)
+    {
+      char *line = g_strdup_printf ("%06d: appended log line\n", i);
+
+      gtk_text_buffer_get_end_iter (bench->buffer, &end);
+      gtk_text_buffer_insert (bench->buffer, &end, line, -1);
+      g_free (line);
+    }
+
+  return G_SOURCE_REMOVE;
+}
+
+static gpointer
+run_queries (gpointer data)
+{
+  Benchmark *bench = data;
+  GMainContext *context;
+  guint subscription;
+  gint64 start;
+  int i;
+
+  /* Give the application time to register */
+  for (i = 0; i < 50 && !find_application (bench); i++)
+    g_usleep (G_USEC_PER_SEC / 10);
+
+  if (bench->name == NULL)
+    {
+      g_print ("Text view not found on the accessibility bus\n");
+      bench->done = TRUE;
+      g_main_context_wakeup (NULL);
+      return NULL;
+    }
+
+  g_print ("%d characters\n", bench->n_chars);
+
+  for (i = 0; i < 2; i++)
+    {
+      time_query (bench, "GetText", "GetText", "(ii)", i);
+      time_query (bench, "GetCharacterAtOffset", "GetCharacterAtOffset", "(i)", i);
+      time_query (bench, "GetStringAtOffset (line)", "GetStringAtOffset", "(iu)", i);
+      time_query (bench, "GetTextAtOffset (line start)", "GetTextAtOffset", "(iu)", i);
+      time_query (bench, "GetAttributeRun", "GetAttributeRun", "(ib)", i);
+    }
+
+  context = g_main_context_new ();
+  g_main_context_push_thread_default (context);
+
+  subscription = g_dbus_connection_signal_subscribe (bench->connection, bench->name,
+                                                     "org.a11y.atspi.Event.Object", "TextChanged",
+                                                     bench->path, NULL, G_DBUS_SIGNAL_FLAGS_NONE,
+                                                     text_changed, bench, NULL);
+
+  start = g_get_monotonic_time ();
+  g_main_context_invoke (NULL, append_lines, bench);
+
+  /* Collect events until there haven't been any for a second */
+  while (TRUE)
+    {
+      int n_events = g_atomic_int_get (&bench->n_events);
+      gint64 wait_start = g_get_monotonic_time ();
+
+      while (g_get_monotonic_time () - wait_start < G_USEC_PER_SEC)
+        g_main_context_iteration (context, FALSE);
+
+      if (n_events > 0 && n_events == g_atomic_int_get (&bench->n_events))
+        break;
+      if (g_get_monotonic_time () - start > 30 * G_USEC_PER_SEC)
+        break;
+    }
+
+  g_print ("Appending %d lines: %d TextChanged events, %" G_GSIZE_FORMAT " bytes\n",
+           n_appends, bench->n_events, bench->n_event_bytes);
+
+  g_dbus_connection_signal_unsubscribe (bench->connection, subscription);
+  g_main_context_pop_thread_default (context);
+  g_main_context_unref (context);
+
+  bench->done = TRUE;
+  g_main_context_wakeup (NULL);
+
+  return NULL;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GtkWidget *window, *sw, *view;
+  GString *text;
+  Benchmark bench = { NULL, };
+  GThread *thread;
+  int i;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  n_queries = MAX (n_queries, 1);
+
+  gtk_init ();
+
+  bench.connection = get_a11y_bus ();
+  if (bench.connection == NULL)
+    {
+      g_print ("No accessibility bus, skipping\n");
+      return 0;
+    }
+
+  text = g_string_new (NULL);
+  for (i = 0; i < n_lines; i++)
+    g_string_append_printf (text, "Line %d of a large buffer, with some words in it.\n", i);
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 600, 400);
+  sw = gtk_scrolled_window_new ();
+  gtk_window_set_child (GTK_WINDOW (window), sw);
+  view = gtk_text_view_new ();
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (sw), view);
+
+  bench.buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (view));
+  gtk_text_buffer_set_text (bench.buffer, text->str, text->len);
+  g_string_free (text, TRUE);
+
+  gtk_window_present (GTK_WINDOW (window));
+
+  thread = g_thread_new ("queries", run_queries, &bench);
+
+  while (!bench.done)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_thread_join (thread);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+  g_object_unref (bench.connection);
+  g_free (bench.name);
+  g_free (bench.path);
+
+  return 0;
+}
@@ -0,0 +1,177 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+/* Measures the GtkBitset operations used by filter and selection
+ * models on large sets: the matches of a filter that keeps a random
+ * part of the items, a selection made of ranges, and the operations
+ * that compute their intersection, the changes between two
+ * selections and the number of selected items.
+ */
+
+static int n_items = 10000000;
+static double density = 0.5;
+static int n_runs = 10;
+
+/* Keeps the compiler from optimizing the loops away */
+static guint64 sum;
+
+static GOptionEntry options[] = {
+  { "items", 'n', 0, G_OPTION_ARG_INT, &n_items, "Size of the sets", "COUNT" },
+  { "density", 'd', 0, G_OPTION_ARG_DOUBLE, &density, "Part of the items a filter matches", "FRACTION" },
+  { "runs", 'r', 0, G_OPTION_ARG_INT, &n_runs, "Number of runs for each operation", "COUNT" },
+  { NULL }
+};
+
+static GtkBitset *
+create_matches (GRand *rand)
+{
+  GtkBitset *set;
+  guint i;
+
+  set = gtk_bitset_new_empty ();
+  for (i = 0; i < (guint) n_items; i++)
+    {
+      if (g_rand_double (rand) < density)
+        gtk_bitset_add (set, i);
+    }
+
+  return set;
+}
+
+static GtkBitset *
+create_selection (GRand *rand)
+{
+  GtkBitset *set;
+  guint i;
+
+  set = gtk_bitset_new_empty ();
+  for (i = 0; i < (guint) n_items; i += 1000)
+    gtk_bitset_add_range (set, i, g_rand_int_range (rand, 0, 1000));
+
+  return set;
+}
+
+#define BENCHMARK(name, setup, code, teardown) G_STMT_START { \
+  gint64 total = 0; \
+  int run; \
+  for (run = 0; run < n_runs; run++) \
+    { \
+      gint64 start; \
+      setup; \
+      start = g_get_monotonic_time (); \
+      code; \
+      total += g_get_monotonic_time () - start; \
+      teardown; \
+    } \
+  g_print ("%-24s %10.3f ms\n", name, total / 1000. / n_runs); \
+} G_STMT_END
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GtkBitset *matches, *other_matches, *selection, *result;
+  GtkBitsetIter iter;
+  GRand *rand;
+  guint values[256];
+  guint value, first, last, i, n;
+  gboolean more;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  if (n_runs <= 0)
+    n_runs = 1;
+
+  rand = g_rand_new_with_seed (42);
+  matches = create_matches (rand);
+  other_matches = create_matches (rand);
+  selection = create_selection (rand);
+
+  g_print ("%d items, %.0f%% matches\n", n_items, density * 100);
+
+  BENCHMARK ("union",
+             result = gtk_bitset_copy (matches),
+             gtk_bitset_union (result, other_matches),
+             gtk_bitset_unref (result));
+  BENCHMARK ("intersect",
+             result = gtk_bitset_copy (matches),
+             gtk_bitset_intersect (result, other_matches),
+             gtk_bitset_unref (result));
+  BENCHMARK ("subtract",
+             result = gtk_bitset_copy (matches),
+             gtk_bitset_subtract (result, other_matches),
+             gtk_bitset_unref (result));
+  BENCHMARK ("difference",
+             result = gtk_bitset_copy (matches),
+             gtk_bitset_difference (result, other_matches),
+             gtk_bitset_unref (result));
+  BENCHMARK ("selected matches",
+             result = gtk_bitset_copy (matches),
+             gtk_bitset_intersect (result, selection),
+             gtk_bitset_unref (result));
+  BENCHMARK ("size",
+             ,
+             sum = gtk_bitset_get_size (matches),
+             );
+  BENCHMARK ("size in range",
+             ,
+             sum = gtk_bitset_get_size_in_range (matches, n_items / 4, n_items / 2),
+             );
+
+  BENCHMARK ("iterate values",
+             sum = 0,
+             {
+               for (more = gtk_bitset_iter_init_first (&iter, matches, &value);
+                    more;
+                    more = gtk_bitset_iter_next (&iter, &value))
+                 sum += value;
+             },
+             );
+  BENCHMARK ("read values",
+             sum = 0,
+             {
+               gtk_bitset_iter_init_first (&iter, matches, NULL);
+               do
+                 {
+                   n = gtk_bitset_iter_read_values (&iter, values, G_N_ELEMENTS (values));
+                   for (i = 0; i < n; i++)
+                     sum += values[i];
+                 }
+               while (n == G_N_ELEMENTS (values));
+             },
+             );
+  BENCHMARK ("iterate selection",
+             sum = 0,
+             {
+               for (more = gtk_bitset_iter_init_first (&iter, selection, &value);
+                    more;
+                    more = gtk_bitset_iter_next (&iter, &value))
+                 sum++;
+             },
+             );
+  BENCHMARK ("read selection ranges",
+             sum = 0,
+             {
+               gtk_bitset_iter_init_first (&iter, selection, NULL);
+               while (gtk_bitset_iter_read_range_closed (&iter, &first, &last))
+                 sum += last - first + 1;
+             },
+             );
+
+  gtk_bitset_unref (selection);
+  gtk_bitset_unref (other_matches);
+  gtk_bitset_unref (matches);
+  g_rand_free (rand);
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+#include "frame-stats.h"
+
+/* Redraws a large grid of buttons every frame, to measure the cost of
+ * snapshotting the CSS backgrounds, borders and shadows of many widgets
+ * with the same style. Run with GTK_DEBUG=no-css-cache to compare with
+ * the render node cache disabled.
+ */
+
+static int n_buttons = 10000;
+static int n_columns = 100;
+
+static GOptionEntry options[] = {
+  { "buttons", 'n', 0, G_OPTION_ARG_INT, &n_buttons, "Number of buttons", "COUNT" },
+  { "columns", 'c', 0, G_OPTION_ARG_INT, &n_columns, "Number of columns", "COUNT" },
+  { NULL }
+};
+
+static gboolean
+tick_cb (GtkWidget     *grid,
+         GdkFrameClock *frame_clock,
+         gpointer       data)
+{
+  GtkWidget *child;
+
+  /* Queueing a draw on the grid alone would reuse the render nodes
+   * of the buttons */
+  for (child = gtk_widget_get_first_child (grid);
+       child != NULL;
+       child = gtk_widget_get_next_sibling (child))
+    gtk_widget_queue_draw (child);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+quit_cb (GtkWidget *widget,
+         gpointer   data)
+{
+  gboolean *done = data;
+
+  *done = TRUE;
+
+  g_main_context_wakeup (NULL);
+}
+
+int
+main (int argc, char **argv)
+{
+  GtkWidget *window, *sw, *grid;
+  GOptionContext *context;
+  GError *error = NULL;
+  gboolean done = FALSE;
+  int i;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+  frame_stats_add_options (g_option_context_get_main_group (context));
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  if (n_columns <= 0)
+    {
+      g_printerr ("Need at least one column\n");
+      return 1;
+    }
+
+  gtk_init ();
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 1200, 900);
+  g_signal_connect (window, "destroy", G_CALLBACK (quit_cb), &done);
+  frame_stats_ensure (GTK_WINDOW (window));
+
+  sw = gtk_scrolled_window_new ();
+  gtk_window_set_child (GTK_WINDOW (window), sw);
+
+  grid = gtk_grid_new ();
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (sw), grid);
+
+  for (i = 0; i < n_buttons; i++)
+    {
+      GtkWidget *button;
+
+      button = gtk_button_new ();
+      gtk_widget_set_size_request (button, 32, 32);
+      gtk_grid_attach (GTK_GRID (grid), button, i % n_columns, i / n_columns, 1, 1);
+    }
+
+  gtk_widget_add_tick_callback (grid, tick_cb, NULL, NULL);
+
+  gtk_widget_show (window);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  return 0;
+}
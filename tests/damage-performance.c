@@ -0,0 +1,117 @@
+#include <gtk/gtk.h>
+#include "gdk/gdkdamageprivate.h"
+
+/* Simulates scattered small invalidations, like many blinking
+ * indicators, and compares accumulating them in a cairo region,
+ * in a bounding box and in a GdkDamage.
+ */
+
+#define WIDTH 1920
+#define HEIGHT 1080
+#define FRAMES 1000
+
+static int n_changes[] = { 10, 50, 100, 500 };
+
+static gint64
+region_get_pixels (const cairo_region_t *region)
+{
+  cairo_rectangle_int_t rect;
+  gint64 pixels = 0;
+  int i, n;
+
+  n = cairo_region_num_rectangles (region);
+  for (i = 0; i < n; i++)
+    {
+      cairo_region_get_rectangle (region, i, &rect);
+      pixels += (gint64) rect.width * rect.height;
+    }
+
+  return pixels;
+}
+
+static void
+create_changes (GRand                 *rand,
+                cairo_rectangle_int_t *rects,
+                int                    n_rects)
+{
+  int i;
+
+  for (i = 0; i < n_rects; i++)
+    {
+      rects[i].width = g_rand_int_range (rand, 8, 33);
+      rects[i].height = g_rand_int_range (rand, 8, 33);
+      rects[i].x = g_rand_int_range (rand, 0, WIDTH - rects[i].width);
+      rects[i].y = g_rand_int_range (rand, 0, HEIGHT - rects[i].height);
+    }
+}
+
+static void
+run (int n_rects)
+{
+  cairo_rectangle_int_t *rects;
+  cairo_region_t *region;
+  cairo_rectangle_int_t extents;
+  GdkDamage damage;
+  GRand *rand;
+  gint64 region_time, damage_time, start;
+  gint64 bounds_pixels, damage_pixels, changed_pixels;
+  gint64 region_rects, damage_rects;
+  int frame, i;
+
+  rects = g_new (cairo_rectangle_int_t, n_rects);
+  rand = g_rand_new_with_seed (42);
+
+  region_time = damage_time = 0;
+  bounds_pixels = damage_pixels = changed_pixels = 0;
+  region_rects = damage_rects = 0;
+
+  for (frame = 0; frame < FRAMES; frame++)
+    {
+      create_changes (rand, rects, n_rects);
+
+      start = g_get_monotonic_time ();
+      region = cairo_region_create ();
+      for (i = 0; i < n_rects; i++)
+        cairo_region_union_rectangle (region, &rects[i]);
+      region_time += g_get_monotonic_time () - start;
+
+      changed_pixels += region_get_pixels (region);
+      region_rects += cairo_region_num_rectangles (region);
+      cairo_region_get_extents (region, &extents);
+      bounds_pixels += (gint64) extents.width * extents.height;
+      cairo_region_destroy (region);
+
+      start = g_get_monotonic_time ();
+      gdk_damage_init (&damage, GDK_DAMAGE_DEFAULT_RECTS);
+      for (i = 0; i < n_rects; i++)
+        gdk_damage_add_rectangle (&damage, &rects[i]);
+      region = gdk_damage_to_region (&damage);
+      damage_time += g_get_monotonic_time () - start;
+
+      damage_pixels += region_get_pixels (region);
+      damage_rects += cairo_region_num_rectangles (region);
+      cairo_region_destroy (region);
+    }
+
+  g_print ("%4d changes:\n", n_rects);
+  g_print ("  region:       %8.2f µs/frame, %6.1f rects, %10" G_GINT64_FORMAT " pixels\n",
+           (double) region_time / FRAMES, (double) region_rects / FRAMES, changed_pixels / FRAMES);
+  g_print ("  bounding box:                 %6.1f rects, %10" G_GINT64_FORMAT " pixels (%.1fx)\n",
+           1.0, bounds_pixels / FRAMES, (double) bounds_pixels / changed_pixels);
+  g_print ("  damage:       %8.2f µs/frame, %6.1f rects, %10" G_GINT64_FORMAT " pixels (%.1fx)\n",
+           (double) damage_time / FRAMES, (double) damage_rects / FRAMES, damage_pixels / FRAMES, (double) damage_pixels / changed_pixels);
+
+  g_rand_free (rand);
+  g_free (rects);
+}
+
+int
+main (int argc, char **argv)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (n_changes); i++)
+    run (n_changes[i]);
+
+  return 0;
+}
@@ -7,6 +7,13 @@
 #include "variable.h"
 
 typedef struct FrameStats FrameStats;
+typedef struct Counter Counter;
+
+struct Counter
+{
+  const char *description;
+  guint *value;
+};
 
 struct FrameStats
 {
@@ -18,6 +25,12 @@ struct FrameStats
   gint64 last_handled_frame;
 
   Variable latency;
+
+  /* time spent between before-paint and after-paint, in ms */
+  gint64 paint_start_time;
+  GArray *frame_times;
+
+  GArray *counters;
 };
 
 static int max_stats = -1;
@@ -71,21 +84,73 @@ print_variable (const char *description,
     }
 }
 
+static int
+compare_doubles (gconstpointer a,
+                 gconstpointer b)
+{
+  double da = *(const double *) a;
+  double db = *(const double *) b;
+
+  return da < db ? -1 : (da > db ? 1 : 0);
+}
+
+static void
+print_percentiles (const char *description,
+                   GArray     *values)
+{
+  const guint percentiles[] = { 50, 90, 99 };
+  guint i;
+
+  g_array_sort (values, compare_doubles);
+
+  for (i = 0; i < G_N_ELEMENTS (percentiles); i++)
+    {
+      char *name;
+      double value;
+
+      if (values->len > 0)
+        value = g_array_index (values, double, (values->len - 1) * percentiles[i] / 100);
+      else
+        value = 0;
+
+      name = g_strdup_printf ("%s (p%u)", description, percentiles[i]);
+      print_double (name, value);
+      g_free (name);
+    }
+}
+
+static void
+on_frame_clock_before_paint (GdkFrameClock *frame_clock,
+                             FrameStats    *frame_stats)
+{
+  frame_stats->paint_start_time = g_get_monotonic_time ();
+}
+
 static void
 on_frame_clock_after_paint (GdkFrameClock *frame_clock,
                             FrameStats    *frame_stats)
 {
   gint64 frame_counter;
   gint64 current_time;
+  guint i;
 
   current_time = g_get_monotonic_time ();
+
+  if (frame_stats->paint_start_time != 0)
+    {
+      double frame_time = (current_time - frame_stats->paint_start_time) / 1000.;
+      g_array_append_val (frame_stats->frame_times, frame_time);
+    }
   if (current_time >= frame_stats->last_print_time + 1000000 * statistics_time)
     {
       if (frame_stats->frames_since_last_print)
         {
           if (frame_stats->num_stats == 0 && machine_readable)
             {
-              g_print ("# load_factor frame_rate latency\n");
+              g_print ("# load_factor frame_rate latency frame_time_p50 frame_time_p90 frame_time_p99");
+              for (i = 0; i < frame_stats->counters->len; i++)
+                g_print (" %s", g_array_index (frame_stats->counters, Counter, i).description);
+              g_print ("\n");
             }
 
           frame_stats->num_stats++;
@@ -95,12 +160,25 @@ on_frame_clock_after_paint (GdkFrameClock *frame_clock,
 
           print_variable ("Latency", &frame_stats->latency);
 
+          print_percentiles ("Frame time", frame_stats->frame_times);
+
+          for (i = 0; i < frame_stats->counters->len; i++)
+            {
+              Counter *counter = &g_array_index (frame_stats->counters, Counter, i);
+
+              print_double (counter->description,
+                            (double) *counter->value / frame_stats->frames_since_last_print);
+            }
+
           g_print ("\n");
         }
 
       frame_stats->last_print_time = current_time;
       frame_stats->frames_since_last_print = 0;
       variable_init (&frame_stats->latency);
+      g_array_set_size (frame_stats->frame_times, 0);
+      for (i = 0; i < frame_stats->counters->len; i++)
+        *g_array_index (frame_stats->counters, Counter, i).value = 0;
 
       if (frame_stats->num_stats == max_stats)
         exit (0);
@@ -135,6 +213,8 @@ on_window_realize (GtkWidget  *window,
                    FrameStats *frame_stats)
 {
   frame_stats->frame_clock = gtk_widget_get_frame_clock (GTK_WIDGET (window));
+  g_signal_connect (frame_stats->frame_clock, "before-paint",
+                    G_CALLBACK (on_frame_clock_before_paint), frame_stats);
   g_signal_connect (frame_stats->frame_clock, "after-paint",
                     G_CALLBACK (on_frame_clock_after_paint), frame_stats);
 }
@@ -143,6 +223,9 @@ static void
 on_window_unrealize (GtkWidget  *window,
                      FrameStats *frame_stats)
 {
+  g_signal_handlers_disconnect_by_func (frame_stats->frame_clock,
+                                        (gpointer) on_frame_clock_before_paint,
+                                        frame_stats);
   g_signal_handlers_disconnect_by_func (frame_stats->frame_clock,
                                         (gpointer) on_frame_clock_after_paint,
                                         frame_stats);
@@ -153,6 +236,8 @@ static void
 on_window_destroy (GtkWidget  *window,
                    FrameStats *stats)
 {
+  g_array_unref (stats->frame_times);
+  g_array_unref (stats->counters);
   g_free (stats);
 }
 
@@ -170,6 +255,8 @@ frame_stats_ensure (GtkWindow *window)
 
   variable_init (&frame_stats->latency);
   frame_stats->last_handled_frame = -1;
+  frame_stats->frame_times = g_array_new (FALSE, FALSE, sizeof (double));
+  frame_stats->counters = g_array_new (FALSE, FALSE, sizeof (Counter));
 
   g_signal_connect (window, "realize",
                     G_CALLBACK (on_window_realize), frame_stats);
@@ -181,3 +268,21 @@ frame_stats_ensure (GtkWindow *window)
   if (gtk_widget_get_realized (GTK_WIDGET (window)))
     on_window_realize (GTK_WIDGET (window), frame_stats);
 }
+
+/* Adds a counter that is reset after being printed as a per-frame
+ * average, for things like the number of relayouts.
+ * frame_stats_ensure() must have been called for @window before.
+ */
+void
+frame_stats_add_counter (GtkWindow  *window,
+                         const char *description,
+                         guint      *counter)
+{
+  FrameStats *frame_stats;
+  Counter c = { description, counter };
+
+  frame_stats = g_object_get_data (G_OBJECT (window), "frame-stats");
+  g_return_if_fail (frame_stats != NULL);
+
+  g_array_append_val (frame_stats->counters, c);
+}
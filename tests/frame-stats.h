@@ -5,5 +5,8 @@
 
 void frame_stats_add_options (GOptionGroup *group);
 void frame_stats_ensure      (GtkWindow    *window);
+void frame_stats_add_counter (GtkWindow    *window,
+                              const char   *description,
+                              guint        *counter);
 
 #endif /* __FRAME_STATS_H__ */
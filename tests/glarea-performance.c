@@ -0,0 +1,87 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+#include "gtkgears.h"
+#include "frame-stats.h"
+
+/* Animates a grid of GL areas and prints frame statistics. With the
+ * GL renderer, the textures of the areas are sampled after waiting on
+ * their fences. With any other renderer, for example --renderer=cairo,
+ * they are read back through pixel buffers instead. Run with
+ * LIBGL_ALWAYS_SOFTWARE=1 to measure this on llvmpipe.
+ */
+
+static int n_columns = 2;
+static int n_rows = 2;
+static char *renderer = NULL;
+
+static GOptionEntry options[] = {
+  { "columns", 'c', 0, G_OPTION_ARG_INT, &n_columns, "Number of columns of GL areas", "COUNT" },
+  { "rows", 'r', 0, G_OPTION_ARG_INT, &n_rows, "Number of rows of GL areas", "COUNT" },
+  { "renderer", 0, 0, G_OPTION_ARG_STRING, &renderer, "Renderer to use, like GSK_RENDERER", "RENDERER" },
+  { NULL }
+};
+
+static gboolean done = FALSE;
+
+static void
+quit_cb (GtkWidget *widget,
+         gpointer   data)
+{
+  done = TRUE;
+
+  g_main_context_wakeup (NULL);
+}
+
+int
+main (int argc, char **argv)
+{
+  GtkWidget *window, *grid;
+  GOptionContext *context;
+  GError *error = NULL;
+  int x, y;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+  frame_stats_add_options (g_option_context_get_main_group (context));
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  if (renderer)
+    g_setenv ("GSK_RENDERER", renderer, TRUE);
+
+  gtk_init ();
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 800, 600);
+  frame_stats_ensure (GTK_WINDOW (window));
+  g_signal_connect (window, "destroy", G_CALLBACK (quit_cb), NULL);
+
+  grid = gtk_grid_new ();
+  gtk_grid_set_row_homogeneous (GTK_GRID (grid), TRUE);
+  gtk_grid_set_column_homogeneous (GTK_GRID (grid), TRUE);
+  gtk_window_set_child (GTK_WINDOW (window), grid);
+
+  for (y = 0; y < n_rows; y++)
+    for (x = 0; x < n_columns; x++)
+      {
+        GtkWidget *gears = gtk_gears_new ();
+
+        gtk_widget_set_hexpand (gears, TRUE);
+        gtk_widget_set_vexpand (gears, TRUE);
+        gtk_grid_attach (GTK_GRID (grid), gears, x, y, 1, 1);
+      }
+
+  gtk_widget_show (window);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  return 0;
+}
@@ -0,0 +1,97 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+/* Fills a table with labels whose texts come from a small set of
+ * strings, like the cells of a large data table, and measures the
+ * time it takes to measure all of them. Then the texts are shifted
+ * to other cells, as when the rows of a list are reused, and the
+ * labels measured again. Run with GTK_DEBUG=no-shaping-cache to
+ * compare with every label laying out its own text.
+ */
+
+static int n_cells = 100000;
+static int n_strings = 1000;
+static int n_runs = 5;
+
+static GOptionEntry options[] = {
+  { "cells", 'n', 0, G_OPTION_ARG_INT, &n_cells, "Number of cells", "COUNT" },
+  { "strings", 's', 0, G_OPTION_ARG_INT, &n_strings, "Number of distinct strings", "COUNT" },
+  { "runs", 'r', 0, G_OPTION_ARG_INT, &n_runs, "Number of times to change all texts", "COUNT" },
+  { NULL }
+};
+
+static void
+measure_cells (GtkWidget **cells)
+{
+  int i, min, nat;
+
+  for (i = 0; i < n_cells; i++)
+    {
+      gtk_widget_measure (cells[i], GTK_ORIENTATION_HORIZONTAL, -1, &min, &nat, NULL, NULL);
+      gtk_widget_measure (cells[i], GTK_ORIENTATION_VERTICAL, nat, &min, &nat, NULL, NULL);
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GtkWidget *window, *box;
+  GtkWidget **cells;
+  char **strings;
+  gint64 start;
+  int i, run;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  n_strings = MAX (n_strings, 1);
+
+  gtk_init ();
+
+  strings = g_new (char *, n_strings);
+  for (i = 0; i < n_strings; i++)
+    strings[i] = g_strdup_printf ("Item %d – %s", i, i % 2 ? "pending" : "shipped");
+
+  window = gtk_window_new ();
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  gtk_window_set_child (GTK_WINDOW (window), box);
+
+  cells = g_new (GtkWidget *, n_cells);
+  for (i = 0; i < n_cells; i++)
+    {
+      cells[i] = gtk_label_new (strings[i % n_strings]);
+      gtk_box_append (GTK_BOX (box), cells[i]);
+    }
+
+  start = g_get_monotonic_time ();
+  measure_cells (cells);
+  g_print ("Initial layout: %.2f ms\n", (g_get_monotonic_time () - start) / 1000.);
+
+  for (run = 1; run <= n_runs; run++)
+    {
+      for (i = 0; i < n_cells; i++)
+        gtk_label_set_text (GTK_LABEL (cells[i]), strings[(i + run * 7) % n_strings]);
+
+      start = g_get_monotonic_time ();
+      measure_cells (cells);
+      g_print ("Relayout %d: %.2f ms\n", run, (g_get_monotonic_time () - start) / 1000.);
+    }
+
+  gtk_window_destroy (GTK_WINDOW (window));
+  g_free (cells);
+  for (i = 0; i < n_strings; i++)
+    g_free (strings[i]);
+  g_free (strings);
+
+  return 0;
+}
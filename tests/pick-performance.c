@@ -0,0 +1,175 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+/* Measures how long it takes to find the widget below the pointer,
+ * which is what GTK does for every motion event, on a canvas with
+ * many absolutely positioned children.
+ */
+
+#define WIDTH 2000
+#define HEIGHT 2000
+
+static int n_children = 10000;
+static int picks_per_frame = 1000;
+static int n_frames = 200;
+static gboolean churn = FALSE;
+
+static GOptionEntry options[] = {
+  { "children", 'n', 0, G_OPTION_ARG_INT, &n_children, "Number of children", "COUNT" },
+  { "picks", 'p', 0, G_OPTION_ARG_INT, &picks_per_frame, "Picks per frame", "COUNT" },
+  { "frames", 'f', 0, G_OPTION_ARG_INT, &n_frames, "Number of frames", "COUNT" },
+  { "churn", 'c', 0, G_OPTION_ARG_NONE, &churn, "Move a child every frame", NULL },
+  { NULL }
+};
+
+static GtkWidget *fixed;
+static GtkWidget *moving;
+static int frame;
+static double total_time;
+
+static gboolean
+tick_cb (GtkWidget     *window,
+         GdkFrameClock *frame_clock,
+         gpointer       data)
+{
+  gboolean *done = data;
+  gint64 start;
+  int i;
+
+  if (churn)
+    {
+      gtk_fixed_move (GTK_FIXED (fixed), moving,
+                      g_random_int_range (0, WIDTH),
+                      g_random_int_range (0, HEIGHT));
+      /* make sure the move takes effect before picking */
+      return G_SOURCE_CONTINUE;
+    }
+
+  start = g_get_monotonic_time ();
+
+  for (i = 0; i < picks_per_frame; i++)
+    gtk_widget_pick (window,
+                     g_random_double_range (0, gtk_widget_get_width (window)),
+                     g_random_double_range (0, gtk_widget_get_height (window)),
+                     GTK_PICK_DEFAULT);
+
+  total_time += g_get_monotonic_time () - start;
+
+  if (++frame == n_frames)
+    {
+      g_print ("%d children: %.2f µs per pick\n",
+               n_children,
+               total_time / ((double) n_frames * picks_per_frame));
+      *done = TRUE;
+      g_main_context_wakeup (NULL);
+      return G_SOURCE_REMOVE;
+    }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+after_paint_cb (GdkFrameClock *frame_clock,
+                GtkWidget     *window)
+{
+  gint64 start;
+  int i;
+
+  if (!churn)
+    return;
+
+  /* Picking right after a layout change includes rebuilding indexes */
+  start = g_get_monotonic_time ();
+
+  for (i = 0; i < picks_per_frame; i++)
+    gtk_widget_pick (window,
+                     g_random_double_range (0, gtk_widget_get_width (window)),
+                     g_random_double_range (0, gtk_widget_get_height (window)),
+                     GTK_PICK_DEFAULT);
+
+  total_time += g_get_monotonic_time () - start;
+  frame++;
+
+  if (frame == n_frames)
+    {
+      g_print ("%d children, moving: %.2f µs per pick\n",
+               n_children,
+               total_time / ((double) n_frames * picks_per_frame));
+      gtk_window_destroy (GTK_WINDOW (window));
+    }
+}
+
+static void
+realize_cb (GtkWidget *window)
+{
+  g_signal_connect_after (gtk_widget_get_frame_clock (window), "after-paint",
+                          G_CALLBACK (after_paint_cb), window);
+}
+
+static void
+quit_cb (GtkWidget *widget,
+         gpointer   data)
+{
+  gboolean *done = data;
+
+  *done = TRUE;
+
+  g_main_context_wakeup (NULL);
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GtkWidget *window, *sw;
+  gboolean done = FALSE;
+  int i;
+
+  gtk_init ();
+
+  context = g_option_context_new ("");
+  g_option_context_add_main_entries (context, options, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 800, 600);
+  g_signal_connect (window, "realize", G_CALLBACK (realize_cb), NULL);
+  g_signal_connect (window, "destroy", G_CALLBACK (quit_cb), &done);
+
+  sw = gtk_scrolled_window_new ();
+  gtk_window_set_child (GTK_WINDOW (window), sw);
+
+  fixed = gtk_fixed_new ();
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (sw), fixed);
+
+  for (i = 0; i < n_children; i++)
+    {
+      GtkWidget *button;
+      char *label;
+
+      label = g_strdup_printf ("%d", i);
+      button = gtk_button_new_with_label (label);
+      g_free (label);
+
+      gtk_fixed_put (GTK_FIXED (fixed), button,
+                     g_random_int_range (0, WIDTH),
+                     g_random_int_range (0, HEIGHT));
+    }
+  moving = gtk_widget_get_last_child (fixed);
+
+  gtk_widget_add_tick_callback (window, tick_cb, &done, NULL);
+
+  gtk_window_present (GTK_WINDOW (window));
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  return 0;
+}
@@ -0,0 +1,165 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+/* Creates a popover menu from a large menu model, with a section of
+ * recent files and a lot of plugin submenus, and measures how long
+ * it takes until the menu is shown. Then the recent files are
+ * replaced, as an application does before opening its context
+ * menu again, and the menu is shown again.
+ */
+
+static int n_recent = 200;
+static int n_submenus = 100;
+static int n_subitems = 20;
+static int n_runs = 10;
+static gboolean nested;
+
+static GOptionEntry options[] = {
+  { "recent", 'r', 0, G_OPTION_ARG_INT, &n_recent, "Number of recent files", "COUNT" },
+  { "submenus", 's', 0, G_OPTION_ARG_INT, &n_submenus, "Number of submenus", "COUNT" },
+  { "subitems", 'i', 0, G_OPTION_ARG_INT, &n_subitems, "Number of items per submenu", "COUNT" },
+  { "runs", 'n', 0, G_OPTION_ARG_INT, &n_runs, "Number of times to open the menu", "COUNT" },
+  { "nested", 0, 0, G_OPTION_ARG_NONE, &nested, "Use nested submenus", NULL },
+  { NULL }
+};
+
+static void
+fill_recent (GMenu *recent,
+             int    run)
+{
+  int i;
+
+  g_menu_remove_all (recent);
+  for (i = 0; i < n_recent; i++)
+    {
+      char *label = g_strdup_printf ("Document %d.txt", i + run);
+      char *action = g_strdup_printf ("app.open-recent(%d)", i + run);
+
+      g_menu_append (recent, label, action);
+      g_free (label);
+      g_free (action);
+    }
+}
+
+static GMenuModel *
+create_model (GMenu *recent)
+{
+  GMenu *menu, *plugins;
+  int i, j;
+
+  menu = g_menu_new ();
+
+  fill_recent (recent, 0);
+  g_menu_append_section (menu, "Recent Files", G_MENU_MODEL (recent));
+
+  plugins = g_menu_new ();
+  for (i = 0; i < n_submenus; i++)
+    {
+      GMenu *submenu = g_menu_new ();
+      char *label;
+
+      for (j = 0; j < n_subitems; j++)
+        {
+          label = g_strdup_printf ("Command %d", j);
+          g_menu_append (submenu, label, "app.plugin-command");
+          g_free (label);
+        }
+
+      label = g_strdup_printf ("Plugin %d", i);
+      g_menu_append_submenu (plugins, label, G_MENU_MODEL (submenu));
+      g_free (label);
+      g_object_unref (submenu);
+    }
+  g_menu_append_section (menu, "Plugins", G_MENU_MODEL (plugins));
+  g_object_unref (plugins);
+
+  return G_MENU_MODEL (menu);
+}
+
+static void
+mapped (GtkWidget *widget,
+        gboolean  *done)
+{
+  *done = TRUE;
+  g_main_context_wakeup (NULL);
+}
+
+static double
+show_menu (GtkWidget *popover)
+{
+  gboolean done = FALSE;
+  gint64 start;
+  gulong id;
+
+  id = g_signal_connect (popover, "map", G_CALLBACK (mapped), &done);
+
+  start = g_get_monotonic_time ();
+  gtk_popover_popup (GTK_POPOVER (popover));
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_signal_handler_disconnect (popover, id);
+
+  return (g_get_monotonic_time () - start) / 1000.;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GtkWidget *window, *button, *popover;
+  GMenuModel *model;
+  GMenu *recent;
+  gint64 start;
+  double create;
+  int run;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  window = gtk_window_new ();
+  button = gtk_menu_button_new ();
+  gtk_window_set_child (GTK_WINDOW (window), button);
+  gtk_window_present (GTK_WINDOW (window));
+
+  recent = g_menu_new ();
+  model = create_model (recent);
+
+  start = g_get_monotonic_time ();
+  popover = gtk_popover_menu_new_from_model_full (model, nested ? GTK_POPOVER_MENU_NESTED : 0);
+  gtk_menu_button_set_popover (GTK_MENU_BUTTON (button), popover);
+  create = (g_get_monotonic_time () - start) / 1000.;
+
+  g_print ("Create: %.2f ms, first open: %.2f ms\n", create, show_menu (popover));
+  gtk_popover_popdown (GTK_POPOVER (popover));
+
+  for (run = 1; run <= n_runs; run++)
+    {
+      double update, open;
+
+      start = g_get_monotonic_time ();
+      fill_recent (recent, run);
+      update = (g_get_monotonic_time () - start) / 1000.;
+
+      open = show_menu (popover);
+      g_print ("Update %d: %.2f ms, open: %.2f ms\n", run, update, open);
+      gtk_popover_popdown (GTK_POPOVER (popover));
+    }
+
+  gtk_window_destroy (GTK_WINDOW (window));
+  g_object_unref (model);
+  g_object_unref (recent);
+
+  return 0;
+}
@@ -26,7 +26,249 @@ my_text_view_init (MyTextView *tv) {}
 static void
 my_text_view_class_init (MyTextViewClass *tv_class) {}
 
+/* A minimal scrollable viewport that counts how often it gets
+ * allocated. GtkViewport only moves its child with a transform,
+ * and a transform-only change does not run the child's
+ * size_allocate, so we have to count at the viewport itself.
+ */
+typedef struct
+{
+  GtkWidget parent;
+  GtkWidget *child;
+  GtkAdjustment *adjustment[2];
+  guint scroll_policy[2];
+} CountingViewport;
+
+typedef GtkWidgetClass CountingViewportClass;
+
+enum {
+  PROP_0,
+  PROP_HADJUSTMENT,
+  PROP_VADJUSTMENT,
+  PROP_HSCROLL_POLICY,
+  PROP_VSCROLL_POLICY
+};
+
+static GType counting_viewport_get_type (void);
+G_DEFINE_TYPE_WITH_CODE (CountingViewport, counting_viewport, GTK_TYPE_WIDGET,
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_SCROLLABLE, NULL))
+
+static guint n_value_changes;
+static guint n_allocations;
+
+static void
+counting_viewport_value_changed (GtkAdjustment    *adjustment,
+                                 CountingViewport *self)
+{
+  n_value_changes++;
+
+  gtk_widget_queue_allocate (GTK_WIDGET (self));
+}
+
+static void
+counting_viewport_set_adjustment (CountingViewport *self,
+                                  GtkOrientation    orientation,
+                                  GtkAdjustment    *adjustment)
+{
+  if (adjustment && adjustment == self->adjustment[orientation])
+    return;
+
+  if (self->adjustment[orientation])
+    {
+      g_signal_handlers_disconnect_by_func (self->adjustment[orientation],
+                                            counting_viewport_value_changed,
+                                            self);
+      g_object_unref (self->adjustment[orientation]);
+    }
+
+  if (adjustment == NULL)
+    adjustment = gtk_adjustment_new (0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+
+  self->adjustment[orientation] = g_object_ref_sink (adjustment);
+  g_signal_connect (adjustment, "value-changed",
+                    G_CALLBACK (counting_viewport_value_changed), self);
+
+  gtk_widget_queue_allocate (GTK_WIDGET (self));
+}
+
+static void
+counting_viewport_measure (GtkWidget      *widget,
+                           GtkOrientation  orientation,
+                           int             for_size,
+                           int            *minimum,
+                           int            *natural,
+                           int            *minimum_baseline,
+                           int            *natural_baseline)
+{
+  CountingViewport *self = (CountingViewport *) widget;
+
+  gtk_widget_measure (self->child, orientation, -1,
+                      minimum, natural, NULL, NULL);
+}
+
+static void
+counting_viewport_configure (CountingViewport *self,
+                             GtkOrientation    orientation,
+                             int               size)
+{
+  GtkAdjustment *adjustment = self->adjustment[orientation];
+  int natural;
+
+  gtk_widget_measure (self->child, orientation, -1, NULL, &natural, NULL, NULL);
+
+  gtk_adjustment_configure (adjustment,
+                            gtk_adjustment_get_value (adjustment),
+                            0,
+                            MAX (natural, size),
+                            size * 0.1,
+                            size * 0.9,
+                            size);
+}
+
+static void
+counting_viewport_size_allocate (GtkWidget *widget,
+                                 int        width,
+                                 int        height,
+                                 int        baseline)
+{
+  CountingViewport *self = (CountingViewport *) widget;
+  GtkAdjustment *hadjustment = self->adjustment[GTK_ORIENTATION_HORIZONTAL];
+  GtkAdjustment *vadjustment = self->adjustment[GTK_ORIENTATION_VERTICAL];
+
+  n_allocations++;
+
+  g_object_freeze_notify (G_OBJECT (hadjustment));
+  g_object_freeze_notify (G_OBJECT (vadjustment));
+
+  counting_viewport_configure (self, GTK_ORIENTATION_HORIZONTAL, width);
+  counting_viewport_configure (self, GTK_ORIENTATION_VERTICAL, height);
+
+  gtk_widget_size_allocate (self->child,
+                            &(GtkAllocation) {
+                              - gtk_adjustment_get_value (hadjustment),
+                              - gtk_adjustment_get_value (vadjustment),
+                              gtk_adjustment_get_upper (hadjustment),
+                              gtk_adjustment_get_upper (vadjustment)
+                            }, -1);
+
+  g_object_thaw_notify (G_OBJECT (hadjustment));
+  g_object_thaw_notify (G_OBJECT (vadjustment));
+}
+
+static void
+counting_viewport_set_property (GObject      *object,
+                                guint         prop_id,
+                                const GValue *value,
+                                GParamSpec   *pspec)
+{
+  CountingViewport *self = (CountingViewport *) object;
+
+  switch (prop_id)
+    {
+    case PROP_HADJUSTMENT:
+      counting_viewport_set_adjustment (self, GTK_ORIENTATION_HORIZONTAL, g_value_get_object (value));
+      break;
+    case PROP_VADJUSTMENT:
+      counting_viewport_set_adjustment (self, GTK_ORIENTATION_VERTICAL, g_value_get_object (value));
+      break;
+    case PROP_HSCROLL_POLICY:
+      self->scroll_policy[GTK_ORIENTATION_HORIZONTAL] = g_value_get_enum (value);
+      break;
+    case PROP_VSCROLL_POLICY:
+      self->scroll_policy[GTK_ORIENTATION_VERTICAL] = g_value_get_enum (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+counting_viewport_get_property (GObject    *object,
+                                guint       prop_id,
+                                GValue     *value,
+                                GParamSpec *pspec)
+{
+  CountingViewport *self = (CountingViewport *) object;
+
+  switch (prop_id)
+    {
+    case PROP_HADJUSTMENT:
+      g_value_set_object (value, self->adjustment[GTK_ORIENTATION_HORIZONTAL]);
+      break;
+    case PROP_VADJUSTMENT:
+      g_value_set_object (value, self->adjustment[GTK_ORIENTATION_VERTICAL]);
+      break;
+    case PROP_HSCROLL_POLICY:
+      g_value_set_enum (value, self->scroll_policy[GTK_ORIENTATION_HORIZONTAL]);
+      break;
+    case PROP_VSCROLL_POLICY:
+      g_value_set_enum (value, self->scroll_policy[GTK_ORIENTATION_VERTICAL]);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+counting_viewport_dispose (GObject *object)
+{
+  CountingViewport *self = (CountingViewport *) object;
+  int i;
+
+  g_clear_pointer (&self->child, gtk_widget_unparent);
+
+  for (i = 0; i < 2; i++)
+    {
+      if (self->adjustment[i])
+        {
+          g_signal_handlers_disconnect_by_func (self->adjustment[i],
+                                                counting_viewport_value_changed,
+                                                self);
+          g_clear_object (&self->adjustment[i]);
+        }
+    }
 
+  G_OBJECT_CLASS (counting_viewport_parent_class)->dispose (object);
+}
+
+static void
+counting_viewport_init (CountingViewport *self)
+{
+  gtk_widget_set_overflow (GTK_WIDGET (self), GTK_OVERFLOW_HIDDEN);
+
+  counting_viewport_set_adjustment (self, GTK_ORIENTATION_HORIZONTAL, NULL);
+  counting_viewport_set_adjustment (self, GTK_ORIENTATION_VERTICAL, NULL);
+}
+
+static void
+counting_viewport_class_init (CountingViewportClass *class)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (class);
+
+  object_class->set_property = counting_viewport_set_property;
+  object_class->get_property = counting_viewport_get_property;
+  object_class->dispose = counting_viewport_dispose;
+  class->measure = counting_viewport_measure;
+  class->size_allocate = counting_viewport_size_allocate;
+
+  g_object_class_override_property (object_class, PROP_HADJUSTMENT, "hadjustment");
+  g_object_class_override_property (object_class, PROP_VADJUSTMENT, "vadjustment");
+  g_object_class_override_property (object_class, PROP_HSCROLL_POLICY, "hscroll-policy");
+  g_object_class_override_property (object_class, PROP_VSCROLL_POLICY, "vscroll-policy");
+}
+
+static GtkWidget *
+counting_viewport_new (GtkWidget *child)
+{
+  CountingViewport *self = g_object_new (counting_viewport_get_type (), NULL);
+
+  self->child = child;
+  gtk_widget_set_parent (child, GTK_WIDGET (self));
+
+  return GTK_WIDGET (self);
+}
 
 static GtkWidget *
 create_widget_factory_content (void)
@@ -62,6 +304,8 @@ set_adjustment_to_fraction (GtkAdjustment *adjustment,
                             fraction * (upper - page_size));
 }
 
+static int scroll_events_per_frame = 0;
+
 static gboolean
 scroll_viewport (GtkWidget     *viewport,
                  GdkFrameClock *frame_clock,
@@ -86,7 +330,60 @@ scroll_viewport (GtkWidget     *viewport,
   return TRUE;
 }
 
+/* Emulates a high frequency touchpad by sending many small scroll
+ * events per frame, instead of setting the adjustments directly.
+ */
+static gboolean
+scroll_events (GtkWidget     *scrolled_window,
+               GdkFrameClock *frame_clock,
+               gpointer       user_data)
+{
+  static gint64 start_time;
+  GtkEventController *controller = user_data;
+  gint64 now = gdk_frame_clock_get_frame_time (frame_clock);
+  double elapsed;
+  gboolean retval;
+  int i;
+
+  if (start_time == 0)
+    start_time = now;
+
+  elapsed = (now - start_time) / 1000000.;
+
+  for (i = 0; i < scroll_events_per_frame; i++)
+    g_signal_emit_by_name (controller, "scroll",
+                           0.1 * cos (elapsed) / scroll_events_per_frame,
+                           -0.1 * sin (elapsed) / scroll_events_per_frame,
+                           &retval);
+
+  return TRUE;
+}
+
+static GtkEventController *
+find_scroll_controller (GtkWidget *widget)
+{
+  GListModel *controllers;
+  GtkEventController *result = NULL;
+  guint i;
+
+  controllers = gtk_widget_observe_controllers (widget);
+  for (i = 0; i < g_list_model_get_n_items (controllers); i++)
+    {
+      GtkEventController *controller = g_list_model_get_item (controllers, i);
+
+      if (GTK_IS_EVENT_CONTROLLER_SCROLL (controller) &&
+          gtk_event_controller_get_propagation_phase (controller) == GTK_PHASE_BUBBLE)
+        result = controller;
+
+      g_object_unref (controller);
+    }
+  g_object_unref (controllers);
+
+  return result;
+}
+
 static GOptionEntry options[] = {
+  { "scroll-events", 'e', 0, G_OPTION_ARG_INT, &scroll_events_per_frame, "Send scroll events instead of scrolling directly", "EVENTS_PER_FRAME" },
   { NULL }
 };
 
@@ -126,16 +423,16 @@ main (int argc, char **argv)
 
   window = gtk_window_new ();
   frame_stats_ensure (GTK_WINDOW (window));
+  frame_stats_add_counter (GTK_WINDOW (window), "Value changes per frame", &n_value_changes);
+  frame_stats_add_counter (GTK_WINDOW (window), "Viewport allocations per frame", &n_allocations);
   gtk_window_set_default_size (GTK_WINDOW (window), 800, 600);
 
   scrolled_window = gtk_scrolled_window_new ();
   gtk_window_set_child (GTK_WINDOW (window), scrolled_window);
 
-  viewport = gtk_viewport_new (NULL, NULL);
-  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (scrolled_window), viewport);
-
   grid = gtk_grid_new ();
-  gtk_viewport_set_child (GTK_VIEWPORT (viewport), grid);
+  viewport = counting_viewport_new (grid);
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (scrolled_window), viewport);
 
   for (i = 0; i < 4; i++)
     {
@@ -145,10 +442,16 @@ main (int argc, char **argv)
       g_object_unref (content);
     }
 
-  gtk_widget_add_tick_callback (viewport,
-                                scroll_viewport,
-                                NULL,
-                                NULL);
+  if (scroll_events_per_frame > 0)
+    gtk_widget_add_tick_callback (scrolled_window,
+                                  scroll_events,
+                                  find_scroll_controller (scrolled_window),
+                                  NULL);
+  else
+    gtk_widget_add_tick_callback (viewport,
+                                  scroll_viewport,
+                                  NULL,
+                                  NULL);
 
   gtk_widget_show (window);
   g_signal_connect (window, "destroy",
@@ -0,0 +1,180 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+#define GTK_COMPILATION
+#include "gdk/gdkeventsprivate.h"
+
+/* Matches key events against a large number of keyval triggers,
+ * like a shortcut controller of an application with many actions
+ * does for every key press, and translates the keys of the events
+ * like the backends and input methods do.
+ */
+
+static int n_triggers = 1000;
+static int n_runs = 1000;
+
+static GOptionEntry options[] = {
+  { "triggers", 't', 0, G_OPTION_ARG_INT, &n_triggers, "Number of triggers", "COUNT" },
+  { "runs", 'r', 0, G_OPTION_ARG_INT, &n_runs, "Number of times to match all events", "COUNT" },
+  { NULL }
+};
+
+static const GdkModifierType modifiers[] = {
+  GDK_CONTROL_MASK,
+  GDK_CONTROL_MASK | GDK_SHIFT_MASK,
+  GDK_ALT_MASK,
+  GDK_CONTROL_MASK | GDK_ALT_MASK,
+  0,
+};
+
+static GdkEvent *
+key_event_new (GdkSurface      *surface,
+               GdkDevice       *device,
+               guint            keycode,
+               GdkModifierType  state,
+               guint            keyval,
+               int              layout,
+               int              level)
+{
+  GdkKeyEvent *key_event = (GdkKeyEvent *) g_type_create_instance (GDK_TYPE_KEY_EVENT);
+  GdkEvent *event = (GdkEvent *) key_event;
+
+  event->event_type = GDK_KEY_PRESS;
+  event->surface = g_object_ref (surface);
+  event->device = g_object_ref (device);
+  event->time = GDK_CURRENT_TIME;
+
+  key_event->keycode = keycode;
+  key_event->state = state;
+  key_event->translated[0].keyval = keyval;
+  key_event->translated[0].consumed = 0;
+  key_event->translated[0].layout = layout;
+  key_event->translated[0].level = level;
+  key_event->translated[1] = key_event->translated[0];
+
+  return event;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GdkDisplay *display;
+  GdkSeat *seat;
+  GdkSurface *surface;
+  GtkShortcutTrigger **triggers;
+  GPtrArray *events;
+  GArray *keycodes;
+  gint64 start;
+  guint n_matches;
+  int i, j, run;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  display = gdk_display_get_default ();
+  seat = gdk_display_get_default_seat (display);
+  if (seat == NULL)
+    {
+      g_print ("Display has no seat, skipping\n");
+      return 0;
+    }
+
+  surface = gdk_surface_new_toplevel (display);
+
+  triggers = g_new (GtkShortcutTrigger *, n_triggers);
+  for (i = 0; i < n_triggers; i++)
+    triggers[i] = gtk_keyval_trigger_new (GDK_KEY_a + i % 26,
+                                          modifiers[(i / 26) % G_N_ELEMENTS (modifiers)] |
+                                          (i / 130 % 2 ? GDK_SUPER_MASK : 0));
+
+  /* One event for every letter with every modifier combination */
+  events = g_ptr_array_new_with_free_func ((GDestroyNotify) gdk_event_unref);
+  keycodes = g_array_new (FALSE, FALSE, sizeof (guint));
+  for (i = 0; i < 26; i++)
+    {
+      GdkKeymapKey *keys;
+      int n_keys;
+
+      if (!gdk_display_map_keyval (display, GDK_KEY_a + i, &keys, &n_keys))
+        continue;
+
+      g_array_append_val (keycodes, keys[0].keycode);
+
+      for (j = 0; j < G_N_ELEMENTS (modifiers); j++)
+        g_ptr_array_add (events, key_event_new (surface,
+                                                gdk_seat_get_keyboard (seat),
+                                                keys[0].keycode,
+                                                modifiers[j],
+                                                GDK_KEY_a + i,
+                                                keys[0].group,
+                                                keys[0].level));
+
+      g_free (keys);
+    }
+
+  if (events->len == 0)
+    {
+      g_print ("No keys for letters in the keymap, skipping\n");
+      return 0;
+    }
+
+  n_matches = 0;
+  start = g_get_monotonic_time ();
+  for (run = 0; run < n_runs; run++)
+    {
+      for (i = 0; i < events->len; i++)
+        {
+          for (j = 0; j < n_triggers; j++)
+            {
+              if (gtk_shortcut_trigger_trigger (triggers[j], g_ptr_array_index (events, i), FALSE))
+                n_matches++;
+            }
+        }
+    }
+  g_print ("Matching %u events against %d triggers: %.2f µs/event, %u matches\n",
+           events->len, n_triggers,
+           (double) (g_get_monotonic_time () - start) / (n_runs * events->len),
+           n_matches / n_runs);
+
+  start = g_get_monotonic_time ();
+  for (run = 0; run < n_runs; run++)
+    {
+      for (i = 0; i < keycodes->len; i++)
+        {
+          for (j = 0; j < G_N_ELEMENTS (modifiers); j++)
+            {
+              guint keyval;
+              GdkModifierType consumed;
+
+              gdk_display_translate_key (display,
+                                         g_array_index (keycodes, guint, i),
+                                         modifiers[j], 0,
+                                         &keyval, NULL, NULL, &consumed);
+            }
+        }
+    }
+  g_print ("Translating %u keys: %.3f µs/translation\n",
+           keycodes->len * G_N_ELEMENTS (modifiers),
+           (double) (g_get_monotonic_time () - start) / (n_runs * keycodes->len * G_N_ELEMENTS (modifiers)));
+
+  g_array_unref (keycodes);
+  g_ptr_array_unref (events);
+  for (i = 0; i < n_triggers; i++)
+    g_object_unref (triggers[i]);
+  g_free (triggers);
+  gdk_surface_destroy (surface);
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include "config.h"
+
+#include <gtk/gtk.h>
+
+#ifdef HAVE_MALLINFO2
+#include <malloc.h>
+#endif
+
+static int n_items = 1000000;
+static int n_rounds = 3;
+
+static GOptionEntry options[] = {
+  { "items", 'n', 0, G_OPTION_ARG_INT, &n_items, "Number of strings", "COUNT" },
+  { "rounds", 'r', 0, G_OPTION_ARG_INT, &n_rounds, "Number of rounds", "COUNT" },
+  { NULL }
+};
+
+static gsize
+get_allocated_bytes (void)
+{
+#ifdef HAVE_MALLINFO2
+  return mallinfo2 ().uordblks;
+#else
+  return 0;
+#endif
+}
+
+static GtkStringList *
+create_appended (void)
+{
+  GtkStringList *list;
+  int i;
+
+  list = gtk_string_list_new (NULL);
+  for (i = 0; i < n_items; i++)
+    gtk_string_list_take (list, g_strdup_printf ("Item number %d", i));
+
+  return list;
+}
+
+static GtkStringList *
+create_packed (void)
+{
+  GtkStringList *list;
+  GString *buffer;
+  int i;
+
+  buffer = g_string_new (NULL);
+  for (i = 0; i < n_items; i++)
+    {
+      g_string_append_printf (buffer, "Item number %d", i);
+      g_string_append_c (buffer, '\0');
+    }
+
+  list = gtk_string_list_new (NULL);
+  gtk_string_list_splice_packed (list, 0, 0, buffer->str, buffer->len);
+  g_string_free (buffer, TRUE);
+
+  return list;
+}
+
+static void
+run (const char      *name,
+     GtkStringList *(* create) (void))
+{
+  GtkStringList *list;
+  GTimer *timer;
+  gsize before, after;
+  double create_time, access_time, string_time;
+  int r, i;
+
+  timer = g_timer_new ();
+
+  for (r = 0; r < n_rounds; r++)
+    {
+      before = get_allocated_bytes ();
+
+      g_timer_start (timer);
+      list = create ();
+      create_time = g_timer_elapsed (timer, NULL);
+
+      after = get_allocated_bytes ();
+
+      /* Typical for list views: get the item, look at it, drop it */
+      g_timer_start (timer);
+      for (i = 0; i < n_items; i++)
+        {
+          GtkStringObject *obj = g_list_model_get_item (G_LIST_MODEL (list), i);
+          g_object_unref (obj);
+        }
+      access_time = g_timer_elapsed (timer, NULL);
+
+      g_timer_start (timer);
+      for (i = 0; i < n_items; i++)
+        gtk_string_list_get_string (list, i);
+      string_time = g_timer_elapsed (timer, NULL);
+
+      g_print ("%s: create %.2f ms, %.1f bytes/item, "
+               "get_item %.2f Mitems/s, get_string %.2f Mitems/s\n",
+               name,
+               create_time * 1000,
+               (double) (after - before) / n_items,
+               n_items / access_time / 1e6,
+               n_items / string_time / 1e6);
+
+      g_object_unref (list);
+    }
+
+  g_timer_destroy (timer);
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+
+  context = g_option_context_new ("");
+  g_option_context_add_main_entries (context, options, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+
+  g_option_context_free (context);
+
+  run ("append", create_appended);
+  run ("packed", create_packed);
+
+  return 0;
+}
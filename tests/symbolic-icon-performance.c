@@ -0,0 +1,113 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+
+/* Loads all symbolic icons of an icon theme once, and prints how long
+ * that took. Run it with --cold to clear the on-disk cache of rendered
+ * symbolic icons first, and without it to measure loads from the cache.
+ */
+
+static char *theme_name = NULL;
+static int icon_size = 16;
+static int icon_scale = 1;
+static gboolean cold = FALSE;
+
+static GOptionEntry options[] = {
+  { "theme", 't', 0, G_OPTION_ARG_STRING, &theme_name, "Icon theme to use", "NAME" },
+  { "size", 's', 0, G_OPTION_ARG_INT, &icon_size, "Size of the icons", "PIXELS" },
+  { "scale", 0, 0, G_OPTION_ARG_INT, &icon_scale, "Scale of the icons", "SCALE" },
+  { "cold", 'c', 0, G_OPTION_ARG_NONE, &cold, "Clear the icon cache first", NULL },
+  { NULL }
+};
+
+static void
+clear_cache (void)
+{
+  GDir *dir;
+  const char *name;
+  char *path;
+
+  path = g_build_filename (g_get_user_cache_dir (), "gtk-4.0", "symbolic", NULL);
+  dir = g_dir_open (path, 0, NULL);
+  if (dir)
+    {
+      while ((name = g_dir_read_name (dir)))
+        {
+          char *file = g_build_filename (path, name, NULL);
+          g_remove (file);
+          g_free (file);
+        }
+      g_dir_close (dir);
+    }
+
+  g_free (path);
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GtkIconTheme *theme;
+  char **names;
+  gint64 start, end;
+  int i, n_icons;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  if (cold)
+    clear_cache ();
+
+  theme = gtk_icon_theme_new ();
+  gtk_icon_theme_set_theme_name (theme, theme_name ? theme_name : "Adwaita");
+
+  names = gtk_icon_theme_get_icon_names (theme);
+  n_icons = 0;
+
+  start = g_get_monotonic_time ();
+
+  for (i = 0; names[i]; i++)
+    {
+      GtkIconPaintable *icon;
+      GtkSnapshot *snapshot;
+      GskRenderNode *node;
+
+      if (!g_str_has_suffix (names[i], "-symbolic"))
+        continue;
+
+      icon = gtk_icon_theme_lookup_icon (theme, names[i], NULL,
+                                         icon_size, icon_scale,
+                                         GTK_TEXT_DIR_NONE, 0);
+
+      /* Snapshotting the icon makes it load its texture */
+      snapshot = gtk_snapshot_new ();
+      gdk_paintable_snapshot (GDK_PAINTABLE (icon), snapshot, icon_size, icon_size);
+      node = gtk_snapshot_free_to_node (snapshot);
+      g_clear_pointer (&node, gsk_render_node_unref);
+
+      g_object_unref (icon);
+      n_icons++;
+    }
+
+  end = g_get_monotonic_time ();
+
+  g_print ("Loaded %d symbolic icons at size %d, scale %d (%s) in %.2f ms\n",
+           n_icons, icon_size, icon_scale, cold ? "cold" : "warm",
+           (end - start) / 1000.);
+
+  g_strfreev (names);
+  g_object_unref (theme);
+
+  return 0;
+}
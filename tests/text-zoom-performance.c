@@ -0,0 +1,116 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+#include <math.h>
+
+#include "frame-stats.h"
+
+/* Zooms a page of text in and out on every frame and prints frame
+ * statistics. With the GL renderer, the text is drawn with distance
+ * field glyphs once its scale keeps changing. Run with
+ * GSK_DEBUG=gl-no-sdf-glyphs to compare with bitmap glyphs only.
+ */
+
+static const char text[] =
+  "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod\n"
+  "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim\n"
+  "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea\n"
+  "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate\n"
+  "velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint\n"
+  "occaecat cupidatat non proident, sunt in culpa qui officia deserunt\n"
+  "mollit anim id est laborum.";
+
+static int n_lines = 40;
+static double max_scale = 4.0;
+static double period = 4.0;
+
+static GOptionEntry options[] = {
+  { "lines", 'n', 0, G_OPTION_ARG_INT, &n_lines, "Number of paragraphs", "COUNT" },
+  { "max-scale", 's', 0, G_OPTION_ARG_DOUBLE, &max_scale, "Largest scale of the text", "SCALE" },
+  { "period", 'p', 0, G_OPTION_ARG_DOUBLE, &period, "Seconds for zooming in and out", "SECONDS" },
+  { NULL }
+};
+
+static gboolean
+zoom_cb (GtkWidget     *fixed,
+         GdkFrameClock *frame_clock,
+         gpointer       data)
+{
+  static gint64 start_time;
+  GtkWidget *label = data;
+  gint64 now = gdk_frame_clock_get_frame_time (frame_clock);
+  GskTransform *transform;
+  double elapsed, scale;
+
+  if (start_time == 0)
+    start_time = now;
+
+  elapsed = (now - start_time) / 1000000.;
+  scale = 1 + (max_scale - 1) * (0.5 - 0.5 * cos (2 * G_PI * elapsed / period));
+
+  transform = gsk_transform_scale (NULL, scale, scale);
+  gtk_fixed_set_child_transform (GTK_FIXED (fixed), label, transform);
+  gsk_transform_unref (transform);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static gboolean done = FALSE;
+
+static void
+quit_cb (GtkWidget *widget,
+         gpointer   data)
+{
+  done = TRUE;
+
+  g_main_context_wakeup (NULL);
+}
+
+int
+main (int argc, char **argv)
+{
+  GtkWidget *window, *fixed, *label;
+  GOptionContext *context;
+  GError *error = NULL;
+  GString *s;
+  int i;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+  frame_stats_add_options (g_option_context_get_main_group (context));
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 800, 600);
+  frame_stats_ensure (GTK_WINDOW (window));
+  g_signal_connect (window, "destroy", G_CALLBACK (quit_cb), NULL);
+
+  fixed = gtk_fixed_new ();
+  gtk_widget_set_overflow (fixed, GTK_OVERFLOW_HIDDEN);
+  gtk_window_set_child (GTK_WINDOW (window), fixed);
+
+  s = g_string_new ("");
+  for (i = 0; i < n_lines; i++)
+    g_string_append_printf (s, "%s%s", i > 0 ? "\n\n" : "", text);
+
+  label = gtk_label_new (s->str);
+  g_string_free (s, TRUE);
+  gtk_fixed_put (GTK_FIXED (fixed), label, 0, 0);
+
+  gtk_widget_add_tick_callback (fixed, zoom_cb, label, NULL);
+
+  gtk_widget_show (window);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  return 0;
+}
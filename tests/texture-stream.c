@@ -0,0 +1,154 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+#include "frame-stats.h"
+
+/* Shows a large texture of which only a small part changes every
+ * frame, like a video with a moving cursor, to measure the cost of
+ * creating and uploading the frames.
+ */
+
+static int frame_width = 1920;
+static int frame_height = 1080;
+static int box_size = 64;
+
+static GOptionEntry options[] = {
+  { "width", 0, 0, G_OPTION_ARG_INT, &frame_width, "Width of the frames", "PIXELS" },
+  { "height", 0, 0, G_OPTION_ARG_INT, &frame_height, "Height of the frames", "PIXELS" },
+  { "box-size", 'b', 0, G_OPTION_ARG_INT, &box_size, "Size of the moving box", "PIXELS" },
+  { NULL }
+};
+
+typedef struct
+{
+  GdkTextureStream *stream;
+  int x, y;
+  int dx, dy;
+} Animation;
+
+static void
+fill_rect (guchar                *data,
+           gsize                  stride,
+           cairo_rectangle_int_t *rect,
+           gboolean               box)
+{
+  int x, y;
+
+  for (y = rect->y; y < rect->y + rect->height; y++)
+    {
+      guint32 *row = (guint32 *) (data + y * stride);
+
+      for (x = rect->x; x < rect->x + rect->width; x++)
+        row[x] = box ? 0xffffffff : 0xff000000 | ((x ^ y) & 0xff) << 8;
+    }
+}
+
+static gboolean
+tick_cb (GtkWidget     *picture,
+         GdkFrameClock *frame_clock,
+         gpointer       data)
+{
+  Animation *animation = data;
+  cairo_rectangle_int_t old_box, new_box;
+  cairo_region_t *damage;
+  GdkTexture *texture;
+  guchar *pixels;
+  gsize stride;
+
+  pixels = gdk_texture_stream_begin_frame (animation->stream, &stride);
+
+  if (gtk_picture_get_paintable (GTK_PICTURE (picture)) == NULL)
+    {
+      fill_rect (pixels, stride, &(cairo_rectangle_int_t) { 0, 0, frame_width, frame_height }, FALSE);
+      damage = NULL;
+    }
+  else
+    {
+      old_box = (cairo_rectangle_int_t) { animation->x, animation->y, box_size, box_size };
+
+      if (animation->x + animation->dx < 0 || animation->x + animation->dx + box_size > frame_width)
+        animation->dx = -animation->dx;
+      if (animation->y + animation->dy < 0 || animation->y + animation->dy + box_size > frame_height)
+        animation->dy = -animation->dy;
+      animation->x += animation->dx;
+      animation->y += animation->dy;
+
+      new_box = (cairo_rectangle_int_t) { animation->x, animation->y, box_size, box_size };
+
+      fill_rect (pixels, stride, &old_box, FALSE);
+      fill_rect (pixels, stride, &new_box, TRUE);
+
+      damage = cairo_region_create_rectangle (&old_box);
+      cairo_region_union_rectangle (damage, &new_box);
+    }
+
+  texture = gdk_texture_stream_end_frame (animation->stream, damage);
+  gtk_picture_set_paintable (GTK_PICTURE (picture), GDK_PAINTABLE (texture));
+
+  g_object_unref (texture);
+  g_clear_pointer (&damage, cairo_region_destroy);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+quit_cb (GtkWidget *widget,
+         gpointer   data)
+{
+  gboolean *done = data;
+
+  *done = TRUE;
+
+  g_main_context_wakeup (NULL);
+}
+
+int
+main (int argc, char **argv)
+{
+  GtkWidget *window, *picture;
+  GOptionContext *context;
+  GError *error = NULL;
+  Animation animation = { NULL, 0, 0, 7, 5 };
+  gboolean done = FALSE;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+  frame_stats_add_options (g_option_context_get_main_group (context));
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  if (box_size <= 0 || box_size > frame_width || box_size > frame_height)
+    {
+      g_printerr ("The box must fit into the frames\n");
+      return 1;
+    }
+
+  gtk_init ();
+
+  animation.stream = gdk_texture_stream_new (frame_width, frame_height, GDK_MEMORY_DEFAULT);
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 960, 540);
+  g_signal_connect (window, "destroy", G_CALLBACK (quit_cb), &done);
+  frame_stats_ensure (GTK_WINDOW (window));
+
+  picture = gtk_picture_new ();
+  gtk_window_set_child (GTK_WINDOW (window), picture);
+
+  gtk_widget_add_tick_callback (picture, tick_cb, &animation, NULL);
+
+  gtk_widget_show (window);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_object_unref (animation.stream);
+
+  return 0;
+}
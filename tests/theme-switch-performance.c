@@ -0,0 +1,125 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+/* Switches between the light and dark variant of the theme on every
+ * frame and prints how long each switch took, from changing the setting
+ * until the next frame. Run with GTK_DEBUG=no-css-cache to compare with
+ * the image cache disabled.
+ */
+
+static int n_switches = 20;
+static int n_widgets = 500;
+
+static GOptionEntry options[] = {
+  { "switches", 's', 0, G_OPTION_ARG_INT, &n_switches, "Number of theme switches", "COUNT" },
+  { "widgets", 'n', 0, G_OPTION_ARG_INT, &n_widgets, "Number of widgets of each kind", "COUNT" },
+  { NULL }
+};
+
+static int switches_done = 0;
+static gint64 switch_start = 0;
+static gint64 total_time = 0;
+static gboolean done = FALSE;
+
+static gboolean
+tick_cb (GtkWidget     *widget,
+         GdkFrameClock *frame_clock,
+         gpointer       data)
+{
+  GtkSettings *settings = gtk_widget_get_settings (widget);
+  gboolean dark;
+  gint64 now;
+
+  now = g_get_monotonic_time ();
+
+  if (switch_start != 0)
+    {
+      g_print ("Switch %d: %.2f ms\n", switches_done, (now - switch_start) / 1000.);
+      total_time += now - switch_start;
+    }
+
+  if (switches_done == n_switches)
+    {
+      g_print ("Average: %.2f ms\n", total_time / 1000. / MAX (n_switches, 1));
+      done = TRUE;
+      g_main_context_wakeup (NULL);
+      return G_SOURCE_REMOVE;
+    }
+
+  g_object_get (settings, "gtk-application-prefer-dark-theme", &dark, NULL);
+  g_object_set (settings, "gtk-application-prefer-dark-theme", !dark, NULL);
+
+  switches_done++;
+  switch_start = g_get_monotonic_time ();
+
+  gtk_widget_queue_draw (widget);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+quit_cb (GtkWidget *widget,
+         gpointer   data)
+{
+  done = TRUE;
+
+  g_main_context_wakeup (NULL);
+}
+
+int
+main (int argc, char **argv)
+{
+  GtkWidget *window, *sw, *box;
+  GOptionContext *context;
+  GError *error = NULL;
+  int i;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 800, 600);
+  g_signal_connect (window, "destroy", G_CALLBACK (quit_cb), NULL);
+
+  sw = gtk_scrolled_window_new ();
+  gtk_window_set_child (GTK_WINDOW (window), sw);
+
+  box = gtk_flow_box_new ();
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (sw), box);
+
+  /* Widgets whose styles use images: check marks, radio
+   * indicators, switches, expander arrows and icons */
+  for (i = 0; i < n_widgets; i++)
+    {
+      GtkWidget *radio1, *radio2;
+
+      gtk_flow_box_append (GTK_FLOW_BOX (box), gtk_check_button_new_with_label ("Check"));
+      radio1 = gtk_check_button_new_with_label ("Radio");
+      radio2 = gtk_check_button_new_with_label ("Radio");
+      gtk_check_button_set_group (GTK_CHECK_BUTTON (radio2), GTK_CHECK_BUTTON (radio1));
+      gtk_flow_box_append (GTK_FLOW_BOX (box), radio1);
+      gtk_flow_box_append (GTK_FLOW_BOX (box), radio2);
+      gtk_flow_box_append (GTK_FLOW_BOX (box), gtk_switch_new ());
+      gtk_flow_box_append (GTK_FLOW_BOX (box), gtk_expander_new ("Expander"));
+      gtk_flow_box_append (GTK_FLOW_BOX (box), gtk_button_new_from_icon_name ("open-menu-symbolic"));
+    }
+
+  gtk_widget_add_tick_callback (window, tick_cb, NULL, NULL);
+
+  gtk_widget_show (window);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  return 0;
+}
@@ -0,0 +1,163 @@
+#include <gtk/gtk.h>
+
+static int n_threads = 0;
+static int n_renders = 1000;
+
+static GOptionEntry options[] = {
+  { "threads", 't', 0, G_OPTION_ARG_INT, &n_threads, "Use up to N threads (default: number of CPUs)", "N" },
+  { "renders", 'n', 0, G_OPTION_ARG_INT, &n_renders, "Render N nodes in each run", "N" },
+  { NULL }
+};
+
+typedef struct {
+  GskRenderNode **nodes;
+  guint n_nodes;
+  int done;
+  GMutex mutex;
+  GCond cond;
+} RenderData;
+
+static void
+render_func (gpointer data,
+             gpointer user_data)
+{
+  RenderData *render = user_data;
+  int i = GPOINTER_TO_INT (data) - 1;
+  GdkTexture *texture;
+
+  texture = gsk_render_node_render_texture (render->nodes[i % render->n_nodes], NULL);
+  g_object_unref (texture);
+
+  g_mutex_lock (&render->mutex);
+  render->done++;
+  if (render->done == n_renders)
+    g_cond_signal (&render->cond);
+  g_mutex_unlock (&render->mutex);
+}
+
+static double
+run (RenderData *render,
+     int         threads)
+{
+  GThreadPool *pool;
+  gint64 start, end;
+  int i;
+
+  render->done = 0;
+
+  pool = g_thread_pool_new (render_func, render, threads, TRUE, NULL);
+
+  start = g_get_monotonic_time ();
+
+  for (i = 0; i < n_renders; i++)
+    g_thread_pool_push (pool, GINT_TO_POINTER (i + 1), NULL);
+
+  g_mutex_lock (&render->mutex);
+  while (render->done < n_renders)
+    g_cond_wait (&render->cond, &render->mutex);
+  g_mutex_unlock (&render->mutex);
+
+  end = g_get_monotonic_time ();
+
+  g_thread_pool_free (pool, FALSE, TRUE);
+
+  return (double) (end - start) / G_USEC_PER_SEC;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  RenderData render = { 0, };
+  GPtrArray *nodes;
+  double single, elapsed;
+  int i, threads;
+
+  context = g_option_context_new ("NODE-FILE…");
+  g_option_context_set_summary (context,
+                                "Renders the given node files from multiple threads at once\n"
+                                "and reports how the rendering time scales with the number\n"
+                                "of threads.");
+  g_option_context_add_main_entries (context, options, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  if (argc < 2)
+    {
+      g_printerr ("Usage: %s [OPTIONS] NODE-FILE…\n", argv[0]);
+      return 1;
+    }
+
+  if (n_threads <= 0)
+    n_threads = g_get_num_processors ();
+
+  if (n_renders < 1)
+    {
+      g_printerr ("Number of renders given with -n/--renders must be at least 1 and not %d.\n", n_renders);
+      return 1;
+    }
+
+  nodes = g_ptr_array_new_with_free_func ((GDestroyNotify) gsk_render_node_unref);
+
+  for (i = 1; i < argc; i++)
+    {
+      GskRenderNode *node;
+      char *contents;
+      GBytes *bytes;
+      gsize len;
+
+      if (!g_file_get_contents (argv[i], &contents, &len, &error))
+        {
+          g_printerr ("Could not open node file: %s\n", error->message);
+          return 1;
+        }
+
+      bytes = g_bytes_new_take (contents, len);
+      node = gsk_render_node_deserialize (bytes, NULL, NULL);
+      g_bytes_unref (bytes);
+
+      if (node == NULL)
+        {
+          g_printerr ("Could not load node file %s\n", argv[i]);
+          return 1;
+        }
+
+      g_ptr_array_add (nodes, node);
+    }
+
+  render.nodes = (GskRenderNode **) nodes->pdata;
+  render.n_nodes = nodes->len;
+  g_mutex_init (&render.mutex);
+  g_cond_init (&render.cond);
+
+  /* Warm up the caches of the nodes, like mipmaps and shadow masks */
+  run (&render, 1);
+
+  single = 0;
+  threads = 1;
+  while (TRUE)
+    {
+      elapsed = run (&render, threads);
+      if (threads == 1)
+        single = elapsed;
+
+      g_print ("%2d threads: %d renders in %.4gs, %.4g renders/s, speedup %.2fx\n",
+               threads, n_renders, elapsed, n_renders / elapsed, single / elapsed);
+
+      if (threads == n_threads)
+        break;
+
+      threads = MIN (threads * 2, n_threads);
+    }
+
+  g_mutex_clear (&render.mutex);
+  g_cond_clear (&render.cond);
+  g_ptr_array_unref (nodes);
+
+  return 0;
+}
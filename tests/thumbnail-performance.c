@@ -0,0 +1,133 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+#include "frame-stats.h"
+
+/* Draws many large images as small thumbnails, and redraws them
+ * every frame, to measure the cost of downscaling textures.
+ */
+
+static int n_images = 200;
+static int image_width = 2400;
+static int image_height = 1800;
+static int thumbnail_size = 128;
+
+static GOptionEntry options[] = {
+  { "images", 'n', 0, G_OPTION_ARG_INT, &n_images, "Number of images", "COUNT" },
+  { "width", 0, 0, G_OPTION_ARG_INT, &image_width, "Width of the images", "PIXELS" },
+  { "height", 0, 0, G_OPTION_ARG_INT, &image_height, "Height of the images", "PIXELS" },
+  { "thumbnail-size", 't', 0, G_OPTION_ARG_INT, &thumbnail_size, "Size of the thumbnails", "PIXELS" },
+  { NULL }
+};
+
+static GBytes *
+create_pixels (void)
+{
+  guchar *data;
+  int x, y;
+
+  data = g_malloc_n (image_height, image_width * 4);
+
+  for (y = 0; y < image_height; y++)
+    for (x = 0; x < image_width; x++)
+      {
+        guchar *p = data + (y * image_width + x) * 4;
+
+        p[0] = x * 255 / image_width;
+        p[1] = y * 255 / image_height;
+        p[2] = (x ^ y) & 0xff;
+        p[3] = 255;
+      }
+
+  return g_bytes_new_take (data, (gsize) image_height * image_width * 4);
+}
+
+static gboolean
+tick_cb (GtkWidget     *widget,
+         GdkFrameClock *frame_clock,
+         gpointer       data)
+{
+  gtk_widget_queue_draw (widget);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+quit_cb (GtkWidget *widget,
+         gpointer   data)
+{
+  gboolean *done = data;
+
+  *done = TRUE;
+
+  g_main_context_wakeup (NULL);
+}
+
+int
+main (int argc, char **argv)
+{
+  GtkWidget *window, *sw, *flowbox;
+  GOptionContext *context;
+  GError *error = NULL;
+  GBytes *pixels;
+  gboolean done = FALSE;
+  int i;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+  frame_stats_add_options (g_option_context_get_main_group (context));
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 1200, 900);
+  g_signal_connect (window, "destroy", G_CALLBACK (quit_cb), &done);
+  frame_stats_ensure (GTK_WINDOW (window));
+
+  sw = gtk_scrolled_window_new ();
+  gtk_window_set_child (GTK_WINDOW (window), sw);
+
+  flowbox = gtk_flow_box_new ();
+  gtk_flow_box_set_max_children_per_line (GTK_FLOW_BOX (flowbox), 100);
+  gtk_flow_box_set_selection_mode (GTK_FLOW_BOX (flowbox), GTK_SELECTION_NONE);
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (sw), flowbox);
+
+  /* All images share their pixels, but are separate textures */
+  pixels = create_pixels ();
+
+  for (i = 0; i < n_images; i++)
+    {
+      GdkTexture *texture;
+      GtkWidget *image;
+
+      texture = gdk_memory_texture_new (image_width, image_height,
+                                        GDK_MEMORY_R8G8B8A8,
+                                        pixels,
+                                        image_width * 4);
+
+      image = gtk_image_new_from_paintable (GDK_PAINTABLE (texture));
+      gtk_image_set_pixel_size (GTK_IMAGE (image), thumbnail_size);
+      gtk_flow_box_insert (GTK_FLOW_BOX (flowbox), image, -1);
+
+      g_object_unref (texture);
+    }
+
+  g_bytes_unref (pixels);
+
+  gtk_widget_add_tick_callback (flowbox, tick_cb, NULL, NULL);
+
+  gtk_widget_show (window);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  return 0;
+}
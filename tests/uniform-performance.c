@@ -0,0 +1,123 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+#include <gsk/gl/gskglrenderer.h>
+
+/* Renders a node tree whose draws mostly differ in their shared uniforms
+ * (modelview, clip and alpha) with the GL renderer, and prints the average
+ * time per frame. Each cell is drawn with a few programs, so the shared
+ * uniforms also have to reach each program in turn.
+ *
+ * Run with LIBGL_ALWAYS_SOFTWARE=1 to measure on llvmpipe, and with
+ * GSK_DEBUG=gl-no-ubo to compare with setting the shared uniforms one
+ * by one.
+ */
+
+static int n_cells = 2000;
+static int n_frames = 100;
+
+static GOptionEntry options[] = {
+  { "cells", 'n', 0, G_OPTION_ARG_INT, &n_cells, "Number of cells", "COUNT" },
+  { "frames", 'f', 0, G_OPTION_ARG_INT, &n_frames, "Number of frames", "COUNT" },
+  { NULL }
+};
+
+static GskRenderNode *
+create_cell (int i)
+{
+  GskRenderNode *nodes[3];
+  GskRenderNode *node, *child;
+  GskRoundedRect outline;
+  GdkRGBA color;
+  GskTransform *transform;
+
+  color = (GdkRGBA) { (i % 7) / 7., (i % 11) / 11., (i % 13) / 13., 1 };
+
+  gsk_rounded_rect_init_from_rect (&outline, &GRAPHENE_RECT_INIT (0, 0, 16, 16), 4);
+
+  nodes[0] = gsk_color_node_new (&color, &GRAPHENE_RECT_INIT (0, 0, 16, 16));
+  nodes[1] = gsk_border_node_new (&outline,
+                                  (float[4]) { 1, 1, 1, 1 },
+                                  (GdkRGBA[4]) { color, color, color, color });
+  nodes[2] = gsk_outset_shadow_node_new (&outline, &color, 1, 1, 0, 0);
+
+  child = gsk_container_node_new (nodes, G_N_ELEMENTS (nodes));
+  node = gsk_rounded_clip_node_new (child, &outline);
+  gsk_render_node_unref (child);
+
+  child = node;
+  node = gsk_opacity_node_new (child, 0.5 + (i % 2) / 2.);
+  gsk_render_node_unref (child);
+
+  transform = gsk_transform_translate (NULL, &GRAPHENE_POINT_INIT ((i % 40) * 20, (i / 40) % 40 * 20));
+  transform = gsk_transform_rotate (transform, i % 5);
+  child = node;
+  node = gsk_transform_node_new (child, transform);
+  gsk_render_node_unref (child);
+  gsk_transform_unref (transform);
+
+  for (guint j = 0; j < G_N_ELEMENTS (nodes); j++)
+    gsk_render_node_unref (nodes[j]);
+
+  return node;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GskRenderNode **cells;
+  GskRenderNode *node;
+  GskRenderer *renderer;
+  GdkTexture *texture;
+  gint64 start, total = 0;
+  int i;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  gtk_init ();
+
+  renderer = gsk_gl_renderer_new ();
+  if (!gsk_renderer_realize (renderer, NULL, &error))
+    {
+      g_printerr ("Could not realize the GL renderer: %s\n", error->message);
+      return 1;
+    }
+
+  cells = g_new (GskRenderNode *, n_cells);
+  for (i = 0; i < n_cells; i++)
+    cells[i] = create_cell (i);
+  node = gsk_container_node_new (cells, n_cells);
+  for (i = 0; i < n_cells; i++)
+    gsk_render_node_unref (cells[i]);
+  g_free (cells);
+
+  /* The first frame compiles the shaders */
+  texture = gsk_renderer_render_texture (renderer, node, &GRAPHENE_RECT_INIT (0, 0, 800, 800));
+  g_object_unref (texture);
+
+  for (i = 0; i < n_frames; i++)
+    {
+      start = g_get_monotonic_time ();
+      texture = gsk_renderer_render_texture (renderer, node, &GRAPHENE_RECT_INIT (0, 0, 800, 800));
+      total += g_get_monotonic_time () - start;
+      g_object_unref (texture);
+    }
+
+  g_print ("%d cells: %.3f ms per frame\n", n_cells, total / 1000. / MAX (n_frames, 1));
+
+  gsk_render_node_unref (node);
+  gsk_renderer_unrealize (renderer);
+  g_object_unref (renderer);
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+
+#include "frame-stats.h"
+
+/* Shows a video-like stream of frames at their natural size, so that
+ * GSK can show them in a subsurface instead of redrawing the window.
+ *
+ * Run it with GSK_DEBUG=offload-textures:offload to turn offloading on
+ * and see for every frame whether the texture was offloaded and how
+ * much of the window had to be redrawn,
+ * for example under weston --backend=headless-backend.so. With --cover,
+ * a label is drawn on top of the video, which forces the fallback of
+ * drawing every frame into the window.
+ */
+
+static int frame_width = 640;
+static int frame_height = 360;
+static gboolean cover = FALSE;
+
+static GOptionEntry options[] = {
+  { "width", 0, 0, G_OPTION_ARG_INT, &frame_width, "Width of the frames", "PIXELS" },
+  { "height", 0, 0, G_OPTION_ARG_INT, &frame_height, "Height of the frames", "PIXELS" },
+  { "cover", 'c', 0, G_OPTION_ARG_NONE, &cover, "Draw a label on top of the video", NULL },
+  { NULL }
+};
+
+typedef struct
+{
+  GdkTextureStream *stream;
+  guint frame;
+  guint n_frames;
+} Video;
+
+static gboolean
+tick_cb (GtkWidget     *picture,
+         GdkFrameClock *frame_clock,
+         gpointer       data)
+{
+  Video *video = data;
+  GdkTexture *texture;
+  guchar *pixels;
+  gsize stride;
+  int x, y;
+
+  pixels = gdk_texture_stream_begin_frame (video->stream, &stride);
+
+  for (y = 0; y < frame_height; y++)
+    {
+      guint32 *row = (guint32 *) (pixels + y * stride);
+
+      for (x = 0; x < frame_width; x++)
+        row[x] = 0xff000000 | (((x + video->frame) ^ y) & 0xff) << 8;
+    }
+
+  video->frame++;
+  video->n_frames++;
+
+  texture = gdk_texture_stream_end_frame (video->stream, NULL);
+  gtk_picture_set_paintable (GTK_PICTURE (picture), GDK_PAINTABLE (texture));
+  g_object_unref (texture);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+quit_cb (GtkWidget *widget,
+         gpointer   data)
+{
+  gboolean *done = data;
+
+  *done = TRUE;
+
+  g_main_context_wakeup (NULL);
+}
+
+int
+main (int argc, char **argv)
+{
+  GtkWidget *window, *overlay, *picture, *label;
+  GOptionContext *context;
+  GError *error = NULL;
+  Video video = { NULL, 0, 0 };
+  gboolean done = FALSE;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+  frame_stats_add_options (g_option_context_get_main_group (context));
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  if (frame_width <= 0 || frame_height <= 0)
+    {
+      g_printerr ("Frames must not be empty\n");
+      return 1;
+    }
+
+  gtk_init ();
+
+  video.stream = gdk_texture_stream_new (frame_width, frame_height, GDK_MEMORY_DEFAULT);
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), frame_width + 200, frame_height + 200);
+  g_signal_connect (window, "destroy", G_CALLBACK (quit_cb), &done);
+  frame_stats_ensure (GTK_WINDOW (window));
+  frame_stats_add_counter (GTK_WINDOW (window), "Video frames per frame", &video.n_frames);
+
+  overlay = gtk_overlay_new ();
+  gtk_window_set_child (GTK_WINDOW (window), overlay);
+
+  /* Keep the picture at the size of the frames, as scaled textures
+   * are never offloaded.
+   */
+  picture = gtk_picture_new ();
+  gtk_picture_set_can_shrink (GTK_PICTURE (picture), FALSE);
+  gtk_widget_set_halign (picture, GTK_ALIGN_CENTER);
+  gtk_widget_set_valign (picture, GTK_ALIGN_CENTER);
+  gtk_overlay_set_child (GTK_OVERLAY (overlay), picture);
+
+  if (cover)
+    {
+      label = gtk_label_new ("Covering the video");
+      gtk_widget_set_halign (label, GTK_ALIGN_CENTER);
+      gtk_widget_set_valign (label, GTK_ALIGN_CENTER);
+      gtk_overlay_add_overlay (GTK_OVERLAY (overlay), label);
+    }
+
+  gtk_widget_add_tick_callback (picture, tick_cb, &video, NULL);
+
+  gtk_widget_show (window);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_object_unref (video.stream);
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+
+/* Times the realization of a window and its first frame, which is
+ * where the Vulkan renderer loads its pipeline cache and creates its
+ * pipelines. Run with --cold to delete the pipeline caches first, and
+ * once more without to see the time with a warm cache.
+ */
+
+static gboolean cold = FALSE;
+static gint64 start_time;
+static gint64 realize_time;
+static gboolean done = FALSE;
+
+static GOptionEntry options[] = {
+  { "cold", 0, 0, G_OPTION_ARG_NONE, &cold, "Delete the pipeline caches first", NULL },
+  { NULL }
+};
+
+static void
+delete_pipeline_caches (void)
+{
+  const char *name;
+  char *dirname;
+  GDir *dir;
+
+  dirname = g_build_filename (g_get_user_cache_dir (), "gtk-4.0", "vulkan-pipelines", NULL);
+  dir = g_dir_open (dirname, 0, NULL);
+  if (dir)
+    {
+      while ((name = g_dir_read_name (dir)))
+        {
+          char *path;
+
+          if (!g_str_has_suffix (name, ".cache"))
+            continue;
+
+          path = g_build_filename (dirname, name, NULL);
+          if (g_unlink (path) != 0)
+            g_printerr ("Could not delete %s\n", path);
+          g_free (path);
+        }
+
+      g_dir_close (dir);
+    }
+
+  g_free (dirname);
+}
+
+static void
+after_paint (GdkFrameClock *frame_clock,
+             GtkWidget     *window)
+{
+  gint64 now = g_get_monotonic_time ();
+
+  g_signal_handlers_disconnect_by_func (frame_clock, after_paint, window);
+
+  g_print ("Realize: %.2f ms\n", (realize_time - start_time) / 1000.);
+  g_print ("First frame: %.2f ms\n", (now - realize_time) / 1000.);
+  g_print ("Total: %.2f ms\n", (now - start_time) / 1000.);
+
+  done = TRUE;
+  g_main_context_wakeup (NULL);
+}
+
+static void
+realized (GtkWidget *window)
+{
+  GdkSurface *surface = gtk_native_get_surface (GTK_NATIVE (window));
+
+  realize_time = g_get_monotonic_time ();
+
+  g_signal_connect (gdk_surface_get_frame_clock (surface), "after-paint",
+                    G_CALLBACK (after_paint), window);
+}
+
+int
+main (int argc, char **argv)
+{
+  GtkWidget *window;
+  GOptionContext *context;
+  GError *error = NULL;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  if (cold)
+    delete_pipeline_caches ();
+
+  g_setenv ("GSK_RENDERER", "vulkan", FALSE);
+
+  gtk_init ();
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 800, 600);
+  gtk_window_set_child (GTK_WINDOW (window), gtk_label_new ("Hello"));
+  g_signal_connect_after (window, "realize", G_CALLBACK (realized), NULL);
+
+  start_time = g_get_monotonic_time ();
+  gtk_widget_show (window);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+#include <gtk/gtk.h>
+#include "gdk/gdkdamageprivate.h"
+
+static void
+assert_damage_contains (const GdkDamage             *damage,
+                        const cairo_rectangle_int_t *rect)
+{
+  cairo_region_t *region;
+
+  region = gdk_damage_to_region (damage);
+  g_assert_cmpint (cairo_region_contains_rectangle (region, rect), ==, CAIRO_REGION_OVERLAP_IN);
+  cairo_region_destroy (region);
+}
+
+static void
+test_damage_empty (void)
+{
+  GdkDamage damage;
+
+  gdk_damage_init (&damage, 4);
+  gdk_damage_add_rectangle (&damage, &(cairo_rectangle_int_t) { 10, 10, 0, 10 });
+  gdk_damage_add_rectangle (&damage, &(cairo_rectangle_int_t) { 10, 10, 10, -1 });
+
+  g_assert_cmpuint (damage.n_rects, ==, 0);
+}
+
+static void
+test_damage_merge (void)
+{
+  GdkDamage damage;
+
+  gdk_damage_init (&damage, 4);
+
+  /* contained rectangles never add anything */
+  gdk_damage_add_rectangle (&damage, &(cairo_rectangle_int_t) { 0, 0, 100, 100 });
+  gdk_damage_add_rectangle (&damage, &(cairo_rectangle_int_t) { 10, 10, 10, 10 });
+  g_assert_cmpuint (damage.n_rects, ==, 1);
+
+  /* neighbours are merged */
+  gdk_damage_add_rectangle (&damage, &(cairo_rectangle_int_t) { 100, 0, 100, 100 });
+  g_assert_cmpuint (damage.n_rects, ==, 1);
+  g_assert_cmpint (damage.rects[0].width, ==, 200);
+
+  /* far away rectangles are not */
+  gdk_damage_add_rectangle (&damage, &(cairo_rectangle_int_t) { 1000, 1000, 10, 10 });
+  g_assert_cmpuint (damage.n_rects, ==, 2);
+
+  /* a rectangle covering both merges everything */
+  gdk_damage_add_rectangle (&damage, &(cairo_rectangle_int_t) { 0, 0, 1010, 1010 });
+  g_assert_cmpuint (damage.n_rects, ==, 1);
+}
+
+static void
+test_damage_bounded (void)
+{
+  cairo_rectangle_int_t rects[1000];
+  GdkDamage damage;
+  GRand *rand;
+  guint i;
+
+  rand = g_rand_new_with_seed (g_test_rand_int ());
+
+  gdk_damage_init (&damage, 8);
+  for (i = 0; i < G_N_ELEMENTS (rects); i++)
+    {
+      rects[i].x = g_rand_int_range (rand, 0, 4000);
+      rects[i].y = g_rand_int_range (rand, 0, 4000);
+      rects[i].width = g_rand_int_range (rand, 1, 32);
+      rects[i].height = g_rand_int_range (rand, 1, 32);
+
+      gdk_damage_add_rectangle (&damage, &rects[i]);
+      g_assert_cmpuint (damage.n_rects, <=, 8);
+    }
+
+  for (i = 0; i < G_N_ELEMENTS (rects); i++)
+    assert_damage_contains (&damage, &rects[i]);
+
+  g_rand_free (rand);
+}
+
+static void
+test_damage_simplify (void)
+{
+  cairo_region_t *region, *copy;
+  int i;
+
+  region = cairo_region_create ();
+  for (i = 0; i < 4; i++)
+    cairo_region_union_rectangle (region, &(cairo_rectangle_int_t) { i * 1000, 0, 10, 10 });
+
+  /* few enough rectangles are left alone */
+  copy = cairo_region_copy (region);
+  gdk_damage_simplify_region (region, 4);
+  g_assert_true (cairo_region_equal (region, copy));
+
+  gdk_damage_simplify_region (region, 2);
+  g_assert_cmpint (cairo_region_num_rectangles (region), <=, 2);
+  cairo_region_subtract (copy, region);
+  g_assert_true (cairo_region_is_empty (copy));
+
+  cairo_region_destroy (copy);
+  cairo_region_destroy (region);
+}
+
+static void
+test_damage_simplify_staggered (void)
+{
+  cairo_region_t *region, *copy;
+  int i;
+
+  /* Overlapping rectangles that all start at different heights,
+   * so a region splits them into many bands.
+   */
+  region = cairo_region_create ();
+  for (i = 0; i < 64; i++)
+    cairo_region_union_rectangle (region, &(cairo_rectangle_int_t) { i * 40, i * 13, 60, 400 });
+  g_assert_cmpint (cairo_region_num_rectangles (region), >, 16);
+
+  copy = cairo_region_copy (region);
+  gdk_damage_simplify_region (region, 16);
+
+  g_assert_cmpint (cairo_region_num_rectangles (region), <=, 16);
+  cairo_region_subtract (copy, region);
+  g_assert_true (cairo_region_is_empty (copy));
+
+  cairo_region_destroy (copy);
+  cairo_region_destroy (region);
+}
+
+int
+main (int argc, char *argv[])
+{
+  (g_test_init) (&argc, &argv, NULL);
+
+  g_test_add_func ("/damage/empty", test_damage_empty);
+  g_test_add_func ("/damage/merge", test_damage_merge);
+  g_test_add_func ("/damage/bounded", test_damage_bounded);
+  g_test_add_func ("/damage/simplify", test_damage_simplify);
+  g_test_add_func ("/damage/simplify-staggered", test_damage_simplify_staggered);
+
+  return g_test_run ();
+}
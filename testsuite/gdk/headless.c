@@ -0,0 +1,95 @@
+#include <gtk/gtk.h>
+#include <gdk/headless/gdkheadless.h>
+
+static void
+test_headless_display (void)
+{
+  GdkDisplay *display = gdk_display_get_default ();
+  GListModel *monitors;
+
+  g_assert_true (GDK_IS_HEADLESS_DISPLAY (display));
+
+  monitors = gdk_display_get_monitors (display);
+  g_assert_cmpuint (g_list_model_get_n_items (monitors), >=, 1);
+}
+
+static gboolean
+timeout_cb (gpointer data)
+{
+  gboolean *timed_out = data;
+
+  *timed_out = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+test_headless_last_frame (void)
+{
+  GtkCssProvider *provider;
+  GtkWidget *window;
+  GdkSurface *surface;
+  GdkTexture *frame;
+  gboolean timed_out = FALSE;
+  guint32 *pixels;
+  int scale, width, height;
+  guint id;
+
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_load_from_data (provider, "window { background: rgb(255,0,0); }", -1);
+  gtk_style_context_add_provider_for_display (gdk_display_get_default (),
+                                              GTK_STYLE_PROVIDER (provider),
+                                              GTK_STYLE_PROVIDER_PRIORITY_USER);
+
+  window = gtk_window_new ();
+  gtk_window_set_decorated (GTK_WINDOW (window), FALSE);
+  gtk_window_set_default_size (GTK_WINDOW (window), 200, 100);
+  gtk_window_present (GTK_WINDOW (window));
+
+  surface = gtk_native_get_surface (GTK_NATIVE (window));
+  g_assert_true (GDK_IS_HEADLESS_SURFACE (surface));
+
+  id = g_timeout_add_seconds (10, timeout_cb, &timed_out);
+  while (gdk_headless_surface_get_last_frame (surface) == NULL && !timed_out)
+    g_main_context_iteration (NULL, TRUE);
+  g_assert_false (timed_out);
+  g_source_remove (id);
+
+  frame = gdk_headless_surface_get_last_frame (surface);
+  scale = gdk_surface_get_scale_factor (surface);
+  width = gdk_texture_get_width (frame);
+  height = gdk_texture_get_height (frame);
+
+  g_assert_cmpint (gdk_surface_get_width (surface), ==, 200);
+  g_assert_cmpint (gdk_surface_get_height (surface), ==, 100);
+  g_assert_cmpint (width, ==, 200 * scale);
+  g_assert_cmpint (height, ==, 100 * scale);
+
+  pixels = g_new (guint32, width * height);
+  gdk_texture_download (frame, (guchar *) pixels, width * 4);
+
+  g_assert_cmphex (pixels[0], ==, 0xffff0000);
+  g_assert_cmphex (pixels[(height / 2) * width + width / 2], ==, 0xffff0000);
+  g_assert_cmphex (pixels[width * height - 1], ==, 0xffff0000);
+
+  g_free (pixels);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+  gtk_style_context_remove_provider_for_display (gdk_display_get_default (),
+                                                 GTK_STYLE_PROVIDER (provider));
+  g_object_unref (provider);
+}
+
+int
+main (int argc, char *argv[])
+{
+  (g_test_init) (&argc, &argv, NULL);
+
+  g_setenv ("GDK_BACKEND", "headless", TRUE);
+  gtk_init ();
+
+  g_test_add_func ("/headless/display", test_headless_display);
+  g_test_add_func ("/headless/last-frame", test_headless_last_frame);
+
+  return g_test_run ();
+}
@@ -0,0 +1,161 @@
+#include <gtk.h>
+
+#define WIDTH 32
+#define HEIGHT 24
+
+static void
+fill_rect (guchar  *data,
+           gsize    stride,
+           int      x,
+           int      y,
+           int      width,
+           int      height,
+           guint32  pixel)
+{
+  int i, j;
+
+  for (j = y; j < y + height; j++)
+    for (i = x; i < x + width; i++)
+      ((guint32 *) (data + j * stride))[i] = pixel;
+}
+
+static void
+assert_texture_pixels (GdkTexture *texture,
+                       guchar     *expected,
+                       gsize       expected_stride)
+{
+  guchar *data;
+  int x, y;
+
+  data = g_malloc (WIDTH * HEIGHT * 4);
+  gdk_texture_download (texture, data, WIDTH * 4);
+
+  for (y = 0; y < HEIGHT; y++)
+    for (x = 0; x < WIDTH; x++)
+      g_assert_cmphex (((guint32 *) (data + y * WIDTH * 4))[x], ==,
+                       ((guint32 *) (expected + y * expected_stride))[x]);
+
+  g_free (data);
+}
+
+static void
+test_texture_stream_keeps_contents (void)
+{
+  GdkTextureStream *stream;
+  GdkTexture *first, *second;
+  cairo_region_t *damage;
+  guchar expected[WIDTH * HEIGHT * 4];
+  guchar *data;
+  gsize stride;
+
+  stream = gdk_texture_stream_new (WIDTH, HEIGHT, GDK_MEMORY_DEFAULT);
+
+  data = gdk_texture_stream_begin_frame (stream, &stride);
+  g_assert_nonnull (data);
+  g_assert_cmpuint (stride, >=, WIDTH * 4);
+  fill_rect (data, stride, 0, 0, WIDTH, HEIGHT, 0xffff0000);
+  first = gdk_texture_stream_end_frame (stream, NULL);
+
+  g_assert_cmpint (gdk_texture_get_width (first), ==, WIDTH);
+  g_assert_cmpint (gdk_texture_get_height (first), ==, HEIGHT);
+
+  data = gdk_texture_stream_begin_frame (stream, &stride);
+  fill_rect (data, stride, 4, 4, 8, 8, 0xff0000ff);
+  damage = cairo_region_create_rectangle (&(cairo_rectangle_int_t) { 4, 4, 8, 8 });
+  second = gdk_texture_stream_end_frame (stream, damage);
+  cairo_region_destroy (damage);
+
+  fill_rect (expected, WIDTH * 4, 0, 0, WIDTH, HEIGHT, 0xffff0000);
+  assert_texture_pixels (first, expected, WIDTH * 4);
+
+  fill_rect (expected, WIDTH * 4, 4, 4, 8, 8, 0xff0000ff);
+  assert_texture_pixels (second, expected, WIDTH * 4);
+
+  g_object_unref (first);
+  g_object_unref (second);
+  g_object_unref (stream);
+}
+
+static void
+test_texture_stream_reuses_memory (void)
+{
+  GdkTextureStream *stream;
+  guchar expected[WIDTH * HEIGHT * 4];
+  guchar *buffers[10];
+  gboolean reused = FALSE;
+  int i, j;
+
+  stream = gdk_texture_stream_new (WIDTH, HEIGHT, GDK_MEMORY_DEFAULT);
+  fill_rect (expected, WIDTH * 4, 0, 0, WIDTH, HEIGHT, 0xff000000);
+
+  for (i = 0; i < G_N_ELEMENTS (buffers); i++)
+    {
+      cairo_region_t *damage;
+      GdkTexture *texture;
+      gsize stride;
+
+      buffers[i] = gdk_texture_stream_begin_frame (stream, &stride);
+
+      if (i == 0)
+        {
+          fill_rect (buffers[i], stride, 0, 0, WIDTH, HEIGHT, 0xff000000);
+          damage = NULL;
+        }
+      else
+        {
+          /* Draw a different line each frame */
+          fill_rect (buffers[i], stride, 0, i, WIDTH, 1, 0xff00ff00);
+          damage = cairo_region_create_rectangle (&(cairo_rectangle_int_t) { 0, i, WIDTH, 1 });
+        }
+      fill_rect (expected, WIDTH * 4, 0, i, WIDTH, 1, i == 0 ? 0xff000000 : 0xff00ff00);
+
+      texture = gdk_texture_stream_end_frame (stream, damage);
+      g_clear_pointer (&damage, cairo_region_destroy);
+
+      assert_texture_pixels (texture, expected, WIDTH * 4);
+      g_object_unref (texture);
+
+      for (j = 0; j < i; j++)
+        if (buffers[j] == buffers[i])
+          reused = TRUE;
+    }
+
+  g_assert_true (reused);
+
+  g_object_unref (stream);
+}
+
+static void
+test_texture_stream_outlives_stream (void)
+{
+  GdkTextureStream *stream;
+  GdkTexture *texture;
+  guchar expected[WIDTH * HEIGHT * 4];
+  guchar *data;
+  gsize stride;
+
+  stream = gdk_texture_stream_new (WIDTH, HEIGHT, GDK_MEMORY_DEFAULT);
+
+  data = gdk_texture_stream_begin_frame (stream, &stride);
+  fill_rect (data, stride, 0, 0, WIDTH, HEIGHT, 0xff123456);
+  texture = gdk_texture_stream_end_frame (stream, NULL);
+
+  g_object_unref (stream);
+
+  fill_rect (expected, WIDTH * 4, 0, 0, WIDTH, HEIGHT, 0xff123456);
+  assert_texture_pixels (texture, expected, WIDTH * 4);
+
+  g_object_unref (texture);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/texturestream/keeps-contents", test_texture_stream_keeps_contents);
+  g_test_add_func ("/texturestream/reuses-memory", test_texture_stream_reuses_memory);
+  g_test_add_func ("/texturestream/outlives-stream", test_texture_stream_outlives_stream);
+
+  return g_test_run ();
+}
@@ -5,6 +5,8 @@
 #include "../reftests/reftest-compare.h"
 
 static char *arg_output_dir = NULL;
+static int arg_tolerance = 0;
+static double arg_max_differing = 0;
 
 static const char *
 get_output_dir (void)
@@ -138,6 +140,10 @@ deserialize_error_func (const GskParseLocation *start,
 static const GOptionEntry options[] = {
   { "output", 0, 0, G_OPTION_ARG_FILENAME, &arg_output_dir,
     "Directory to save image files to", "DIR" },
+  { "tolerance", 0, 0, G_OPTION_ARG_INT, &arg_tolerance,
+    "Maximum difference of a channel for pixels to count as equal", "VALUE" },
+  { "max-differing", 0, 0, G_OPTION_ARG_DOUBLE, &arg_max_differing,
+    "Percentage of pixels that may differ", "PERCENT" },
   { NULL }
 };
 
@@ -227,15 +233,27 @@ main (int argc, char **argv)
   else
     {
       GdkTexture *diff_texture;
+      gsize n_differing;
+      double max_differing;
 
       /* Now compare the two */
-      diff_texture = reftest_compare_textures (rendered_texture, reference_texture);
+      diff_texture = reftest_compare_textures_with_tolerance (rendered_texture,
+                                                              reference_texture,
+                                                              MAX (arg_tolerance, 0),
+                                                              &n_differing);
 
       if (diff_texture)
         {
+          max_differing = arg_max_differing / 100 *
+                          gdk_texture_get_width (diff_texture) *
+                          gdk_texture_get_height (diff_texture);
+
+          g_print ("%" G_GSIZE_FORMAT " pixels differ\n", n_differing);
+
           save_image (diff_texture, node_file, ".diff.png");
           g_object_unref (diff_texture);
-          success = FALSE;
+          if (n_differing > max_differing)
+            success = FALSE;
         }
     }
 
@@ -0,0 +1,153 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <gtk/gtk.h>
+#include "gsk/gskfallbackcacheprivate.h"
+#include "gdk/gdktextureprivate.h"
+
+static GskRenderNode *
+create_circle_node (void)
+{
+  GskRenderNode *node;
+  cairo_t *cr;
+
+  node = gsk_cairo_node_new (&GRAPHENE_RECT_INIT (0, 0, 64, 64));
+  cr = gsk_cairo_node_get_draw_context (node);
+  cairo_arc (cr, 32, 32, 30, 0, 2 * G_PI);
+  cairo_fill (cr);
+  cairo_destroy (cr);
+
+  return node;
+}
+
+/* The circle on the left, which is the same node every time, like
+ * an unchanged widget, and a square on the right in the given color
+ */
+static GskRenderNode *
+create_node (GskRenderNode *circle,
+             const GdkRGBA *color)
+{
+  GskRenderNode *children[2];
+  GskRenderNode *node;
+
+  children[0] = circle;
+  children[1] = gsk_color_node_new (color, &GRAPHENE_RECT_INIT (70, 6, 52, 52));
+
+  node = gsk_container_node_new (children, 2);
+
+  gsk_render_node_unref (children[1]);
+
+  return node;
+}
+
+static void
+assert_texture_matches_node (GdkTexture    *texture,
+                             GskRenderNode *node,
+                             float          scale)
+{
+  cairo_surface_t *surface;
+  guchar *pixels;
+  int width, height, stride, y;
+  cairo_t *cr;
+
+  width = gdk_texture_get_width (texture);
+  height = gdk_texture_get_height (texture);
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, height);
+  cairo_surface_set_device_scale (surface, scale, scale);
+  cr = cairo_create (surface);
+  gsk_render_node_draw (node, cr);
+  cairo_destroy (cr);
+  cairo_surface_flush (surface);
+
+  stride = cairo_image_surface_get_stride (surface);
+  pixels = g_malloc (stride * height);
+  gdk_texture_download (texture, pixels, stride);
+
+  for (y = 0; y < height; y++)
+    g_assert_cmpmem (pixels + y * stride, width * 4,
+                     cairo_image_surface_get_data (surface) + y * stride, width * 4);
+
+  g_free (pixels);
+  cairo_surface_destroy (surface);
+}
+
+static void
+test_replaced_node (gconstpointer data)
+{
+  float scale = *(const float *) data;
+  GskFallbackCache *cache;
+  GskRenderNode *circle, *node1, *node2, *node3;
+  GdkTexture *texture1, *texture2, *texture3;
+  cairo_rectangle_int_t extents;
+  gboolean rasterized;
+
+  cache = gsk_fallback_cache_new ();
+
+  circle = create_circle_node ();
+  node1 = create_node (circle, &(GdkRGBA) { 1, 0, 0, 1 });
+  node2 = create_node (circle, &(GdkRGBA) { 0, 0, 1, 1 });
+  node3 = create_node (circle, &(GdkRGBA) { 0, 0, 1, 1 });
+
+  gsk_fallback_cache_begin_frame (cache);
+  texture1 = gsk_fallback_cache_get_texture (cache, node1, scale, scale, &rasterized);
+  g_assert_true (rasterized);
+  g_object_ref (texture1);
+  assert_texture_matches_node (texture1, node1, scale);
+
+  /* Only the square is drawn again, and only its tiles are updated */
+  gsk_fallback_cache_begin_frame (cache);
+  texture2 = gsk_fallback_cache_get_texture (cache, node2, scale, scale, &rasterized);
+  g_assert_true (rasterized);
+  g_object_ref (texture2);
+  assert_texture_matches_node (texture2, node2, scale);
+
+  g_assert_true (texture2->update_texture == texture1);
+  cairo_region_get_extents (texture2->update_region, &extents);
+  g_assert_cmpint (extents.x, >=, 64 * scale - 32);
+
+  /* A new node with the same contents is not drawn at all */
+  gsk_fallback_cache_begin_frame (cache);
+  texture3 = gsk_fallback_cache_get_texture (cache, node3, scale, scale, &rasterized);
+  g_assert_false (rasterized);
+  g_assert_true (texture3 == texture2);
+
+  g_object_unref (texture1);
+  g_object_unref (texture2);
+  gsk_render_node_unref (node1);
+  gsk_render_node_unref (node2);
+  gsk_render_node_unref (node3);
+  gsk_render_node_unref (circle);
+  gsk_fallback_cache_free (cache);
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const float scale1 = 1.0f;
+  static const float scale2 = 2.0f;
+  static const float scale3 = 1.5f;
+
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add_data_func ("/fallback-cache/replaced-node/scale-1", &scale1, test_replaced_node);
+  g_test_add_data_func ("/fallback-cache/replaced-node/scale-2", &scale2, test_replaced_node);
+  g_test_add_data_func ("/fallback-cache/replaced-node/scale-1.5", &scale3, test_replaced_node);
+
+  return g_test_run ();
+}
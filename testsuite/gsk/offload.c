@@ -0,0 +1,246 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+#include "gsk/gskrendererprivate.h"
+
+#ifdef GDK_WINDOWING_WAYLAND
+#include "gdk/wayland/gdkwayland.h"
+#endif
+
+/* These tests are meant to be run against a Wayland compositor
+ * such as weston --backend=headless-backend.so, like the wayland
+ * setup in CI does, and are skipped everywhere else.
+ */
+
+#define FRAME_SIZE 100
+#define N_WARMUP_FRAMES 5
+#define N_FRAMES 30
+
+typedef struct
+{
+  GskRenderer *renderer;
+  guint frame;
+  guint n_measured;
+  guint n_offloaded;
+  gint64 repainted_pixels;
+} Video;
+
+static GdkTexture *
+make_frame (guint frame)
+{
+  GdkTexture *texture;
+  GBytes *bytes;
+  guint32 *pixels;
+  int x, y;
+
+  pixels = g_new (guint32, FRAME_SIZE * FRAME_SIZE);
+  for (y = 0; y < FRAME_SIZE; y++)
+    for (x = 0; x < FRAME_SIZE; x++)
+      pixels[y * FRAME_SIZE + x] = 0xff000000 | (((x + frame) ^ y) & 0xff) << 8;
+
+  bytes = g_bytes_new_take (pixels, FRAME_SIZE * FRAME_SIZE * 4);
+  texture = gdk_memory_texture_new (FRAME_SIZE, FRAME_SIZE,
+                                    GDK_MEMORY_DEFAULT,
+                                    bytes,
+                                    FRAME_SIZE * 4);
+  g_bytes_unref (bytes);
+
+  return texture;
+}
+
+static gboolean
+tick_cb (GtkWidget     *picture,
+         GdkFrameClock *frame_clock,
+         gpointer       data)
+{
+  Video *video = data;
+  GdkTexture *texture;
+
+  texture = make_frame (video->frame);
+  gtk_picture_set_paintable (GTK_PICTURE (picture), GDK_PAINTABLE (texture));
+  g_object_unref (texture);
+
+  video->frame++;
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+after_paint_cb (GdkFrameClock *frame_clock,
+                gpointer       data)
+{
+  Video *video = data;
+  GskProfiler *profiler;
+
+  /* The first frames map the window and create the subsurface */
+  if (video->frame <= N_WARMUP_FRAMES)
+    return;
+
+  profiler = gsk_renderer_get_profiler (video->renderer);
+
+  video->n_measured++;
+  video->n_offloaded += gsk_profiler_counter_get (profiler, g_quark_from_static_string ("offloaded-textures"));
+  video->repainted_pixels += gsk_profiler_counter_get (profiler, g_quark_from_static_string ("clip-pixels"));
+}
+
+static gboolean
+timeout_cb (gpointer data)
+{
+  gboolean *timed_out = data;
+
+  *timed_out = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+play_video (gboolean  offload,
+            gboolean  cover,
+            Video    *video)
+{
+  GtkWidget *window, *overlay, *picture, *label;
+  GdkFrameClock *frame_clock;
+  gboolean timed_out = FALSE;
+  gulong handler;
+  guint id;
+
+  window = gtk_window_new ();
+  gtk_window_set_decorated (GTK_WINDOW (window), FALSE);
+  gtk_window_set_default_size (GTK_WINDOW (window), 3 * FRAME_SIZE, 2 * FRAME_SIZE);
+
+  overlay = gtk_overlay_new ();
+  gtk_window_set_child (GTK_WINDOW (window), overlay);
+
+  picture = gtk_picture_new ();
+  gtk_picture_set_can_shrink (GTK_PICTURE (picture), FALSE);
+  gtk_widget_set_halign (picture, GTK_ALIGN_CENTER);
+  gtk_widget_set_valign (picture, GTK_ALIGN_CENTER);
+  gtk_overlay_set_child (GTK_OVERLAY (overlay), picture);
+
+  if (cover)
+    {
+      label = gtk_label_new ("Covering the video");
+      gtk_widget_set_halign (label, GTK_ALIGN_CENTER);
+      gtk_widget_set_valign (label, GTK_ALIGN_CENTER);
+      gtk_overlay_add_overlay (GTK_OVERLAY (overlay), label);
+    }
+
+  gtk_widget_realize (window);
+
+  video->renderer = gtk_native_get_renderer (GTK_NATIVE (window));
+  if (offload)
+    gsk_renderer_set_debug_flags (video->renderer,
+                                  gsk_renderer_get_debug_flags (video->renderer) | GSK_DEBUG_OFFLOAD_TEXTURES);
+  else
+    gsk_renderer_set_debug_flags (video->renderer,
+                                  gsk_renderer_get_debug_flags (video->renderer) & ~GSK_DEBUG_OFFLOAD_TEXTURES);
+
+  frame_clock = gtk_widget_get_frame_clock (window);
+  handler = g_signal_connect (frame_clock, "after-paint", G_CALLBACK (after_paint_cb), video);
+  gtk_widget_add_tick_callback (picture, tick_cb, video, NULL);
+
+  gtk_window_present (GTK_WINDOW (window));
+
+  id = g_timeout_add_seconds (30, timeout_cb, &timed_out);
+  while (video->n_measured < N_FRAMES && !timed_out)
+    g_main_context_iteration (NULL, TRUE);
+  g_assert_false (timed_out);
+  g_source_remove (id);
+
+  g_signal_handler_disconnect (frame_clock, handler);
+  gtk_window_destroy (GTK_WINDOW (window));
+
+  g_test_message ("%u of %u frames offloaded, %.1f pixels repainted per video frame",
+                  video->n_offloaded, video->n_measured,
+                  (double) video->repainted_pixels / video->n_measured);
+}
+
+static gboolean
+check_wayland (void)
+{
+#ifdef GDK_WINDOWING_WAYLAND
+  if (GDK_IS_WAYLAND_DISPLAY (gdk_display_get_default ()))
+    {
+#ifndef G_ENABLE_DEBUG
+      g_test_skip ("Offloading needs GSK_DEBUG, which needs G_ENABLE_DEBUG");
+      return FALSE;
+#else
+      return TRUE;
+#endif
+    }
+#endif
+
+  g_test_skip ("Offloading needs a Wayland compositor");
+  return FALSE;
+}
+
+static void
+test_offload_video (void)
+{
+  Video video = { NULL, };
+
+  if (!check_wayland ())
+    return;
+
+  play_video (TRUE, FALSE, &video);
+
+  /* Every frame is shown in the subsurface and nothing else is redrawn */
+  g_assert_cmpuint (video.n_offloaded, ==, video.n_measured);
+  g_assert_cmpint (video.repainted_pixels, ==, 0);
+}
+
+static void
+test_offload_covered (void)
+{
+  Video video = { NULL, };
+
+  if (!check_wayland ())
+    return;
+
+  play_video (TRUE, TRUE, &video);
+
+  /* The label is drawn on top, so every frame is drawn into the window */
+  g_assert_cmpuint (video.n_offloaded, ==, 0);
+  g_assert_cmpint (video.repainted_pixels, >=, (gint64) video.n_measured * FRAME_SIZE * FRAME_SIZE);
+}
+
+static void
+test_offload_disabled (void)
+{
+  Video video = { NULL, };
+
+  if (!check_wayland ())
+    return;
+
+  play_video (FALSE, FALSE, &video);
+
+  g_assert_cmpuint (video.n_offloaded, ==, 0);
+  g_assert_cmpint (video.repainted_pixels, >=, (gint64) video.n_measured * FRAME_SIZE * FRAME_SIZE);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/offload/video", test_offload_video);
+  g_test_add_func ("/offload/covered", test_offload_covered);
+  g_test_add_func ("/offload/disabled", test_offload_disabled);
+
+  return g_test_run ();
+}
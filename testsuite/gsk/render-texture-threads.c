@@ -0,0 +1,200 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <gtk/gtk.h>
+
+#define N_THREADS 8
+#define N_RENDERS 20
+
+/* Renders the same nodes from several threads at once and checks
+ * that every result matches rendering them in a single thread.
+ * The nodes cover the state that is shared between nodes or kept
+ * in them: fonts, shadow corner masks, cairo recordings and texture
+ * mipmaps.
+ */
+
+static GskRenderNode *
+create_text_node (PangoFontMap *fontmap)
+{
+  GtkSnapshot *snapshot;
+  PangoContext *context;
+  PangoLayout *layout;
+  PangoFontDescription *desc;
+
+  context = pango_font_map_create_context (fontmap);
+  layout = pango_layout_new (context);
+  desc = pango_font_description_from_string ("Sans 24");
+  pango_layout_set_font_description (layout, desc);
+  pango_layout_set_text (layout, "Threads and fonts", -1);
+
+  snapshot = gtk_snapshot_new ();
+  gtk_snapshot_append_layout (snapshot, layout, &(GdkRGBA) { 0, 0, 0, 1 });
+
+  pango_font_description_free (desc);
+  g_object_unref (layout);
+  g_object_unref (context);
+
+  return gtk_snapshot_free_to_node (snapshot);
+}
+
+static GskRenderNode *
+create_texture_node (void)
+{
+  GdkTexture *texture;
+  GskRenderNode *node;
+  GBytes *bytes;
+  guint32 *pixels;
+  int x, y;
+
+  pixels = g_new (guint32, 256 * 256);
+  for (y = 0; y < 256; y++)
+    for (x = 0; x < 256; x++)
+      pixels[y * 256 + x] = 0xff000000 | (x << 16) | ((x ^ y) << 8) | y;
+
+  bytes = g_bytes_new_take (pixels, 256 * 256 * 4);
+  texture = gdk_memory_texture_new (256, 256, GDK_MEMORY_DEFAULT, bytes, 256 * 4);
+  g_bytes_unref (bytes);
+
+  /* Drawn at a quarter of its size, so a mipmap is used */
+  node = gsk_texture_node_new (texture, &GRAPHENE_RECT_INIT (200, 100, 64, 64));
+  g_object_unref (texture);
+
+  return node;
+}
+
+static GskRenderNode *
+create_node (PangoFontMap *fontmap)
+{
+  GskRenderNode *children[5];
+  GskRenderNode *node;
+  GskRoundedRect outline;
+  cairo_t *cr;
+  guint i;
+
+  children[0] = gsk_color_node_new (&(GdkRGBA) { 1, 1, 1, 1 }, &GRAPHENE_RECT_INIT (0, 0, 300, 200));
+
+  gsk_rounded_rect_init_from_rect (&outline, &GRAPHENE_RECT_INIT (20, 100, 80, 60), 10);
+  children[1] = gsk_outset_shadow_node_new (&outline, &(GdkRGBA) { 0, 0, 0, 0.5 }, 2, 2, 4, 8);
+
+  children[2] = gsk_cairo_node_new (&GRAPHENE_RECT_INIT (120, 100, 60, 60));
+  cr = gsk_cairo_node_get_draw_context (children[2]);
+  cairo_set_source_rgb (cr, 0, 0.5, 1);
+  cairo_arc (cr, 150, 130, 25, 0, 2 * G_PI);
+  cairo_fill (cr);
+  cairo_destroy (cr);
+
+  children[3] = create_texture_node ();
+  children[4] = create_text_node (fontmap);
+
+  node = gsk_container_node_new (children, G_N_ELEMENTS (children));
+
+  for (i = 0; i < G_N_ELEMENTS (children); i++)
+    gsk_render_node_unref (children[i]);
+
+  return node;
+}
+
+typedef struct {
+  GskRenderNode *node;
+  guchar *expected;
+  int width;
+  int height;
+  int n_failed;
+} RenderData;
+
+static gpointer
+render_thread (gpointer data)
+{
+  RenderData *render = data;
+  guchar *pixels;
+  int i;
+
+  pixels = g_malloc (render->width * render->height * 4);
+
+  for (i = 0; i < N_RENDERS; i++)
+    {
+      GdkTexture *texture;
+
+      texture = gsk_render_node_render_texture (render->node, NULL);
+
+      if (gdk_texture_get_width (texture) != render->width ||
+          gdk_texture_get_height (texture) != render->height)
+        {
+          g_atomic_int_inc (&render->n_failed);
+        }
+      else
+        {
+          gdk_texture_download (texture, pixels, render->width * 4);
+          if (memcmp (pixels, render->expected, render->width * render->height * 4) != 0)
+            g_atomic_int_inc (&render->n_failed);
+        }
+
+      g_object_unref (texture);
+    }
+
+  g_free (pixels);
+
+  return NULL;
+}
+
+static void
+test_render_texture_threads (void)
+{
+  PangoFontMap *fontmap;
+  GdkTexture *texture;
+  GThread *threads[N_THREADS];
+  RenderData render;
+  int i;
+
+  /* Fonts can't be shared with other users in other threads,
+   * so the text uses fonts of its own
+   */
+  fontmap = pango_cairo_font_map_new ();
+
+  render.node = create_node (fontmap);
+  render.n_failed = 0;
+
+  texture = gsk_render_node_render_texture (render.node, NULL);
+  render.width = gdk_texture_get_width (texture);
+  render.height = gdk_texture_get_height (texture);
+  render.expected = g_malloc (render.width * render.height * 4);
+  gdk_texture_download (texture, render.expected, render.width * 4);
+  g_object_unref (texture);
+
+  for (i = 0; i < N_THREADS; i++)
+    threads[i] = g_thread_new ("render", render_thread, &render);
+
+  for (i = 0; i < N_THREADS; i++)
+    g_thread_join (threads[i]);
+
+  g_assert_cmpint (render.n_failed, ==, 0);
+
+  g_free (render.expected);
+  gsk_render_node_unref (render.node);
+  g_object_unref (fontmap);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/rendernode/render-texture/threads", test_render_texture_threads);
+
+  return g_test_run ();
+}
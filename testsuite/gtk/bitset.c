@@ -543,6 +543,117 @@ test_iter (void)
   gtk_bitset_unref (set);
 }
 
+static void
+test_iter_read_values (void)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (bitsets); i++)
+    {
+      GtkBitset *set, *copy;
+      GtkBitsetIter iter;
+      guint values[100];
+      guint j, n, total;
+
+      set = bitsets[i].create ();
+      copy = gtk_bitset_new_empty ();
+
+      total = 0;
+      gtk_bitset_iter_init_first (&iter, set, NULL);
+      do
+        {
+          n = gtk_bitset_iter_read_values (&iter, values, G_N_ELEMENTS (values));
+          for (j = 0; j < n; j++)
+            {
+              if (j > 0)
+                g_assert_cmpuint (values[j - 1], <, values[j]);
+              gtk_bitset_add (copy, values[j]);
+            }
+          total += n;
+        }
+      while (n == G_N_ELEMENTS (values));
+
+      g_assert_false (gtk_bitset_iter_is_valid (&iter));
+      g_assert_cmpuint (total, ==, bitsets[i].n_elements);
+      g_assert_true (gtk_bitset_equals (set, copy));
+
+      gtk_bitset_unref (copy);
+      gtk_bitset_unref (set);
+    }
+}
+
+static void
+test_iter_read_range (void)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (bitsets); i++)
+    {
+      GtkBitset *set, *copy;
+      GtkBitsetIter iter;
+      guint first, last;
+      gboolean have_range;
+      guint64 total;
+
+      set = bitsets[i].create ();
+      copy = gtk_bitset_new_empty ();
+
+      total = 0;
+      have_range = FALSE;
+      for (gtk_bitset_iter_init_first (&iter, set, NULL);
+           gtk_bitset_iter_read_range_closed (&iter, &first, &last);
+           )
+        {
+          g_assert_cmpuint (first, <=, last);
+          /* ranges must not be adjacent or overlapping */
+          if (have_range)
+            g_assert_cmpuint (first, >, gtk_bitset_get_maximum (copy) + 1);
+          g_assert_false (first > 0 && gtk_bitset_contains (set, first - 1));
+          g_assert_false (last < G_MAXUINT && gtk_bitset_contains (set, last + 1));
+
+          gtk_bitset_add_range_closed (copy, first, last);
+          total += last - first + 1;
+          have_range = TRUE;
+        }
+
+      g_assert_false (gtk_bitset_iter_is_valid (&iter));
+      g_assert_cmpuint (total, ==, bitsets[i].n_elements);
+      g_assert_true (gtk_bitset_equals (set, copy));
+
+      gtk_bitset_unref (copy);
+      gtk_bitset_unref (set);
+    }
+}
+
+static void
+test_iter_read_range_split (void)
+{
+  GtkBitset *set;
+  GtkBitsetIter iter;
+  guint first, last;
+
+  /* A range crossing the boundaries of roaring's containers */
+  set = gtk_bitset_new_empty ();
+  gtk_bitset_add (set, 5);
+  gtk_bitset_add_range_closed (set, 60000, 200000);
+  gtk_bitset_add_range_closed (set, G_MAXUINT - 10, G_MAXUINT);
+
+  gtk_bitset_iter_init_at (&iter, set, 100000, NULL);
+  g_assert_true (gtk_bitset_iter_read_range_closed (&iter, &first, &last));
+  g_assert_cmpuint (first, ==, 100000);
+  g_assert_cmpuint (last, ==, 200000);
+  g_assert_cmpuint (gtk_bitset_iter_get_value (&iter), ==, G_MAXUINT - 10);
+
+  g_assert_true (gtk_bitset_iter_read_range_closed (&iter, &first, &last));
+  g_assert_cmpuint (first, ==, G_MAXUINT - 10);
+  g_assert_cmpuint (last, ==, G_MAXUINT);
+  g_assert_false (gtk_bitset_iter_is_valid (&iter));
+
+  g_assert_false (gtk_bitset_iter_read_range_closed (&iter, &first, &last));
+
+  gtk_bitset_unref (set);
+}
+
 static void
 test_splice_overflow (void)
 {
@@ -577,6 +688,9 @@ main (int argc, char *argv[])
   g_test_add_func ("/bitset/slice", test_slice);
   g_test_add_func ("/bitset/rectangle", test_rectangle);
   g_test_add_func ("/bitset/iter", test_iter);
+  g_test_add_func ("/bitset/iter-read-values", test_iter_read_values);
+  g_test_add_func ("/bitset/iter-read-range", test_iter_read_range);
+  g_test_add_func ("/bitset/iter-read-range-split", test_iter_read_range_split);
   g_test_add_func ("/bitset/splice-overflow", test_splice_overflow);
 
   return g_test_run ();
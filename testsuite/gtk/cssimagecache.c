@@ -0,0 +1,236 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib/gstdio.h>
+
+#include <gtk/gtk.h>
+
+#include "gtk/gtkcssimagecacheprivate.h"
+
+static int n_loads;
+
+static GdkTexture *
+counting_load (GFile   *file,
+               GError **error)
+{
+  n_loads++;
+
+  return gdk_texture_new_from_file (file, error);
+}
+
+static GFile *
+create_image_file (const char *name)
+{
+  static const guchar pixels[16] = { 0xff, 0, 0, 0xff, 0, 0xff, 0, 0xff,
+                                     0, 0, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+  GdkTexture *texture;
+  GBytes *bytes;
+  char *path;
+  GFile *file;
+
+  bytes = g_bytes_new_static (pixels, sizeof (pixels));
+  texture = gdk_memory_texture_new (2, 2, GDK_MEMORY_DEFAULT, bytes, 8);
+
+  path = g_build_filename (g_get_tmp_dir (), name, NULL);
+  g_assert_true (gdk_texture_save_to_png (texture, path));
+  file = g_file_new_for_path (path);
+
+  g_free (path);
+  g_object_unref (texture);
+  g_bytes_unref (bytes);
+
+  return file;
+}
+
+static void
+test_cache_hit (void)
+{
+  GdkTexture *first, *second;
+  GError *error = NULL;
+  GFile *file, *other;
+
+  gtk_css_image_cache_clear ();
+  n_loads = 0;
+
+  file = create_image_file ("cssimagecache.png");
+
+  first = gtk_css_image_cache_load (file, GTK_CSS_IMAGE_CACHE_TEXTURE, counting_load, &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (first);
+  g_assert_cmpint (n_loads, ==, 1);
+
+  /* A different GFile for the same file must hit the cache, too */
+  other = g_file_new_for_path (g_file_peek_path (file));
+  second = gtk_css_image_cache_load (other, GTK_CSS_IMAGE_CACHE_TEXTURE, counting_load, &error);
+  g_assert_no_error (error);
+  g_assert_true (first == second);
+  g_assert_cmpint (n_loads, ==, 1);
+  g_object_unref (second);
+
+  /* Symbolic textures are separate entries */
+  second = gtk_css_image_cache_load (file, GTK_CSS_IMAGE_CACHE_SYMBOLIC, counting_load, &error);
+  g_assert_no_error (error);
+  g_assert_true (first != second);
+  g_assert_cmpint (n_loads, ==, 2);
+  g_object_unref (second);
+
+  g_object_unref (first);
+
+  g_file_delete (file, NULL, NULL);
+  g_object_unref (other);
+  g_object_unref (file);
+}
+
+static void
+test_cache_modified (void)
+{
+  GdkTexture *first, *second;
+  GError *error = NULL;
+  GFile *file;
+
+  gtk_css_image_cache_clear ();
+  n_loads = 0;
+
+  file = create_image_file ("cssimagecache.png");
+
+  first = gtk_css_image_cache_load (file, GTK_CSS_IMAGE_CACHE_TEXTURE, counting_load, &error);
+  g_assert_no_error (error);
+  g_assert_cmpint (n_loads, ==, 1);
+
+  g_file_set_attribute_uint64 (file, G_FILE_ATTRIBUTE_TIME_MODIFIED,
+                               g_get_real_time () / G_USEC_PER_SEC + 60,
+                               G_FILE_QUERY_INFO_NONE, NULL, &error);
+  g_assert_no_error (error);
+
+  /* Files are only checked again after a style sheet is loaded */
+  second = gtk_css_image_cache_load (file, GTK_CSS_IMAGE_CACHE_TEXTURE, counting_load, &error);
+  g_assert_no_error (error);
+  g_assert_true (first == second);
+  g_assert_cmpint (n_loads, ==, 1);
+  g_object_unref (second);
+
+  gtk_css_image_cache_revalidate ();
+
+  /* The file changed, so it must be loaded again */
+  second = gtk_css_image_cache_load (file, GTK_CSS_IMAGE_CACHE_TEXTURE, counting_load, &error);
+  g_assert_no_error (error);
+  g_assert_true (first != second);
+  g_assert_cmpint (n_loads, ==, 2);
+
+  g_object_unref (second);
+  g_object_unref (first);
+
+  g_file_delete (file, NULL, NULL);
+  g_object_unref (file);
+}
+
+static void
+load_cached (GFile *file)
+{
+  GdkTexture *texture;
+  GError *error = NULL;
+
+  texture = gtk_css_image_cache_load (file, GTK_CSS_IMAGE_CACHE_TEXTURE, counting_load, &error);
+  g_assert_no_error (error);
+  g_object_unref (texture);
+}
+
+static void
+test_cache_theme_changed (void)
+{
+  GFile *light, *dark, *other;
+
+  gtk_css_image_cache_clear ();
+  n_loads = 0;
+
+  light = create_image_file ("cssimagecache-light.png");
+  dark = create_image_file ("cssimagecache-dark.png");
+  other = create_image_file ("cssimagecache-other.png");
+
+  load_cached (light);
+  gtk_css_image_cache_theme_changed ();
+  load_cached (dark);
+  g_assert_cmpint (n_loads, ==, 2);
+
+  /* Switching back and forth between two themes keeps both */
+  gtk_css_image_cache_theme_changed ();
+  load_cached (light);
+  gtk_css_image_cache_theme_changed ();
+  load_cached (dark);
+  g_assert_cmpint (n_loads, ==, 2);
+
+  /* Images not used by the last two themes are dropped */
+  gtk_css_image_cache_theme_changed ();
+  load_cached (other);
+  gtk_css_image_cache_theme_changed ();
+  load_cached (other);
+  load_cached (light);
+  g_assert_cmpint (n_loads, ==, 4);
+
+  g_file_delete (light, NULL, NULL);
+  g_file_delete (dark, NULL, NULL);
+  g_file_delete (other, NULL, NULL);
+  g_object_unref (light);
+  g_object_unref (dark);
+  g_object_unref (other);
+}
+
+static void
+test_cache_error (void)
+{
+  GdkTexture *texture;
+  GError *error = NULL;
+  char *path;
+  GFile *file;
+
+  gtk_css_image_cache_clear ();
+  n_loads = 0;
+
+  path = g_build_filename (g_get_tmp_dir (), "cssimagecache-broken.png", NULL);
+  g_file_set_contents (path, "not an image", -1, &error);
+  g_assert_no_error (error);
+  file = g_file_new_for_path (path);
+
+  texture = gtk_css_image_cache_load (file, GTK_CSS_IMAGE_CACHE_TEXTURE, counting_load, &error);
+  g_assert_null (texture);
+  g_assert_nonnull (error);
+  g_clear_error (&error);
+
+  /* Failures are not cached */
+  texture = gtk_css_image_cache_load (file, GTK_CSS_IMAGE_CACHE_TEXTURE, counting_load, &error);
+  g_assert_null (texture);
+  g_assert_nonnull (error);
+  g_clear_error (&error);
+  g_assert_cmpint (n_loads, ==, 2);
+
+  g_remove (path);
+  g_object_unref (file);
+  g_free (path);
+}
+
+int
+main (int argc, char *argv[])
+{
+  (g_test_init) (&argc, &argv, G_TEST_OPTION_ISOLATE_DIRS, NULL);
+
+  g_test_add_func ("/cssimagecache/hit", test_cache_hit);
+  g_test_add_func ("/cssimagecache/modified", test_cache_modified);
+  g_test_add_func ("/cssimagecache/theme-changed", test_cache_theme_changed);
+  g_test_add_func ("/cssimagecache/error", test_cache_error);
+
+  return g_test_run ();
+}
@@ -225,6 +225,33 @@ test_label_parse_more (void)
   g_object_unref (label);
 }
 
+static void
+test_label_exported_layout (void)
+{
+  GtkWidget *window, *box, *label1, *label2;
+  PangoLayout *layout;
+
+  window = gtk_window_new ();
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  gtk_window_set_child (GTK_WINDOW (window), box);
+
+  label1 = gtk_label_new ("Shared text");
+  label2 = gtk_label_new ("Shared text");
+  gtk_box_append (GTK_BOX (box), label1);
+  gtk_box_append (GTK_BOX (box), label2);
+
+  /* The layout we get is not used by other labels, so changing it
+   * does not affect them
+   */
+  layout = gtk_label_get_layout (GTK_LABEL (label1));
+  g_assert_true (layout != gtk_label_get_layout (GTK_LABEL (label2)));
+
+  pango_layout_set_text (layout, "Changed text", -1);
+  g_assert_cmpstr (pango_layout_get_text (gtk_label_get_layout (GTK_LABEL (label2))), ==, "Shared text");
+
+  gtk_window_destroy (GTK_WINDOW (window));
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -233,6 +260,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/label/markup-parse", test_label_markup);
   g_test_add_func ("/label/underline-parse", test_label_underline);
   g_test_add_func ("/label/parse-more", test_label_parse_more);
+  g_test_add_func ("/label/exported-layout", test_label_exported_layout);
 
   return g_test_run ();
 }
@@ -0,0 +1,150 @@
+/* Copyright (C) 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+
+#define N 10
+#define SIZE 20
+
+static void
+set_done (gpointer       data,
+          GdkFrameClock *clock)
+{
+  gboolean *done = data;
+
+  *done = TRUE;
+}
+
+static void
+wait_for_frame (GtkWidget *widget)
+{
+  GdkFrameClock *clock;
+  gboolean done = FALSE;
+  gulong id;
+
+  while (!gtk_widget_get_mapped (widget))
+    g_main_context_iteration (NULL, TRUE);
+
+  clock = gtk_widget_get_frame_clock (widget);
+  id = g_signal_connect_swapped (clock, "after-paint", G_CALLBACK (set_done), &done);
+  gtk_widget_queue_draw (widget);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_signal_handler_disconnect (clock, id);
+}
+
+static GtkWidget *
+add_child (GtkFixed *fixed,
+           int       x,
+           int       y,
+           int       size)
+{
+  GtkWidget *child;
+
+  child = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
+  gtk_widget_set_size_request (child, size, size);
+  gtk_fixed_put (fixed, child, x, y);
+
+  return child;
+}
+
+static void
+test_pick_many_children (void)
+{
+  GtkWidget *window, *fixed;
+  GtkWidget *children[N][N];
+  GtkWidget *top, *scaled;
+  GtkWidget *inner, *grandchild;
+  int i, j;
+
+  window = gtk_window_new ();
+  fixed = gtk_fixed_new ();
+  gtk_window_set_child (GTK_WINDOW (window), fixed);
+
+  for (i = 0; i < N; i++)
+    for (j = 0; j < N; j++)
+      children[i][j] = add_child (GTK_FIXED (fixed), i * SIZE, j * SIZE, SIZE);
+
+  /* overlaps the children at (1,1), (1,2), (2,1) and (2,2) */
+  top = add_child (GTK_FIXED (fixed), SIZE + SIZE / 2, SIZE + SIZE / 2, SIZE * 2);
+
+  scaled = add_child (GTK_FIXED (fixed), 0, 0, SIZE);
+  gtk_fixed_set_child_transform (GTK_FIXED (fixed), scaled,
+                                 gsk_transform_scale (gsk_transform_translate (NULL,
+                                                                               &GRAPHENE_POINT_INIT (N * SIZE, N * SIZE)),
+                                                      2, 2));
+
+  gtk_window_present (GTK_WINDOW (window));
+  wait_for_frame (fixed);
+
+  for (i = 0; i < N; i++)
+    for (j = 0; j < N; j++)
+      {
+        GtkWidget *expected;
+
+        if (i >= 1 && i <= 2 && j >= 1 && j <= 2)
+          expected = top;
+        else
+          expected = children[i][j];
+
+        g_assert_true (gtk_widget_pick (fixed, i * SIZE + SIZE / 2 + 3, j * SIZE + SIZE / 2 + 3, GTK_PICK_DEFAULT) == expected);
+      }
+
+  g_assert_true (gtk_widget_pick (fixed, N * SIZE + SIZE * 2 - 5, N * SIZE + SIZE * 2 - 5, GTK_PICK_DEFAULT) == scaled);
+
+  /* moving a child must update the index */
+  gtk_fixed_move (GTK_FIXED (fixed), children[0][0], N * SIZE + SIZE * 3, 0);
+  wait_for_frame (fixed);
+
+  g_assert_true (gtk_widget_pick (fixed, N * SIZE + SIZE * 3 + SIZE / 2, SIZE / 2, GTK_PICK_DEFAULT) == children[0][0]);
+  g_assert_true (gtk_widget_pick (fixed, SIZE / 2, SIZE / 2, GTK_PICK_DEFAULT) == fixed);
+
+  /* so must hiding and removing one */
+  gtk_widget_hide (children[5][5]);
+  g_assert_true (gtk_widget_pick (fixed, 5 * SIZE + SIZE / 2, 5 * SIZE + SIZE / 2, GTK_PICK_DEFAULT) == fixed);
+
+  gtk_fixed_remove (GTK_FIXED (fixed), top);
+  g_assert_true (gtk_widget_pick (fixed, SIZE + SIZE / 2 + 3, SIZE + SIZE / 2 + 3, GTK_PICK_DEFAULT) == children[1][1]);
+
+  /* and moving a descendant outside of its child */
+  inner = gtk_fixed_new ();
+  gtk_fixed_put (GTK_FIXED (fixed), inner, 0, N * SIZE);
+  grandchild = add_child (GTK_FIXED (inner), 0, 0, SIZE);
+  wait_for_frame (fixed);
+
+  g_assert_true (gtk_widget_pick (fixed, SIZE / 2, N * SIZE + SIZE / 2, GTK_PICK_DEFAULT) == grandchild);
+
+  gtk_fixed_move (GTK_FIXED (inner), grandchild, N * SIZE + SIZE * 3, SIZE);
+  wait_for_frame (fixed);
+
+  g_assert_true (gtk_widget_pick (fixed, N * SIZE + SIZE * 3 + SIZE / 2, N * SIZE + SIZE + SIZE / 2, GTK_PICK_DEFAULT) == grandchild);
+  g_assert_true (gtk_widget_pick (fixed, SIZE / 2, N * SIZE + SIZE / 2, GTK_PICK_DEFAULT) == fixed);
+  g_assert_false (gtk_widget_contains (grandchild, - SIZE / 2, SIZE / 2));
+
+  gtk_window_destroy (GTK_WINDOW (window));
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/pick/many-children", test_pick_many_children);
+
+  return g_test_run ();
+}
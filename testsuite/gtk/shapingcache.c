@@ -0,0 +1,132 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+
+#include "gtk/gtklabelprivate.h"
+#include "gtk/gtkshapingcacheprivate.h"
+
+static void
+test_label_shared_layout (void)
+{
+  GtkWidget *window, *box, *label1, *label2, *label3;
+  PangoAttrList *attrs;
+
+  window = gtk_window_new ();
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  gtk_window_set_child (GTK_WINDOW (window), box);
+
+  label1 = gtk_label_new ("Shared text");
+  label2 = gtk_label_new ("Shared text");
+  label3 = gtk_label_new ("Shared text");
+  gtk_label_set_selectable (GTK_LABEL (label3), TRUE);
+  gtk_box_append (GTK_BOX (box), label1);
+  gtk_box_append (GTK_BOX (box), label2);
+  gtk_box_append (GTK_BOX (box), label3);
+
+  g_assert_true (_gtk_label_peek_layout (GTK_LABEL (label1)) == _gtk_label_peek_layout (GTK_LABEL (label2)));
+
+  /* Selectable labels keep their own layout */
+  g_assert_true (_gtk_label_peek_layout (GTK_LABEL (label3)) != _gtk_label_peek_layout (GTK_LABEL (label1)));
+
+  /* Changing one label does not change the others */
+  gtk_label_set_text (GTK_LABEL (label2), "Other text");
+  g_assert_cmpstr (pango_layout_get_text (_gtk_label_peek_layout (GTK_LABEL (label1))), ==, "Shared text");
+  g_assert_cmpstr (pango_layout_get_text (_gtk_label_peek_layout (GTK_LABEL (label2))), ==, "Other text");
+
+  attrs = pango_attr_list_new ();
+  pango_attr_list_insert (attrs, pango_attr_weight_new (PANGO_WEIGHT_BOLD));
+  gtk_label_set_attributes (GTK_LABEL (label2), attrs);
+  gtk_label_set_text (GTK_LABEL (label2), "Shared text");
+  pango_attr_list_unref (attrs);
+
+  g_assert_true (_gtk_label_peek_layout (GTK_LABEL (label1)) != _gtk_label_peek_layout (GTK_LABEL (label2)));
+  g_assert_nonnull (pango_layout_get_attributes (_gtk_label_peek_layout (GTK_LABEL (label2))));
+
+  /* Giving out the layout stops sharing it */
+  gtk_label_set_attributes (GTK_LABEL (label2), NULL);
+  g_assert_true (_gtk_label_peek_layout (GTK_LABEL (label1)) == _gtk_label_peek_layout (GTK_LABEL (label2)));
+  g_assert_true (gtk_label_get_layout (GTK_LABEL (label1)) != _gtk_label_peek_layout (GTK_LABEL (label2)));
+
+  gtk_window_destroy (GTK_WINDOW (window));
+}
+
+static PangoLayout *
+share_layout (PangoContext *context)
+{
+  PangoLayout *layout, *shared;
+
+  layout = pango_layout_new (context);
+  pango_layout_set_text (layout, "Shared text", -1);
+  shared = gtk_shaping_cache_share_layout (layout);
+  g_object_unref (layout);
+
+  g_assert_nonnull (shared);
+
+  return shared;
+}
+
+static void
+test_settings_flush (void)
+{
+  GtkSettings *settings;
+  GtkWidget *label;
+  PangoContext *context;
+  PangoLayout *layout1, *layout2, *layout3;
+  int dpi;
+
+  settings = gtk_settings_get_default ();
+  label = g_object_ref_sink (gtk_label_new (NULL));
+  context = gtk_widget_create_pango_context (label);
+
+  layout1 = share_layout (context);
+  layout2 = share_layout (context);
+  g_assert_true (layout1 == layout2);
+
+  /* The context does not change, but the cache must not hand out
+   * layouts from before the font settings changed
+   */
+  g_object_get (settings, "gtk-xft-dpi", &dpi, NULL);
+  g_object_set (settings, "gtk-xft-dpi", dpi + 1024, NULL);
+
+  layout3 = share_layout (context);
+  g_assert_true (layout3 != layout1);
+
+  g_object_set (settings, "gtk-xft-dpi", dpi, NULL);
+
+  g_object_unref (layout1);
+  g_object_unref (layout2);
+  g_object_unref (layout3);
+  g_object_unref (context);
+  g_object_unref (label);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  /* The tests are about the cache, so make sure it is used
+   * whatever GTK_DEBUG says
+   */
+  gtk_set_debug_flags (gtk_get_debug_flags () & ~GTK_DEBUG_NO_SHAPING_CACHE);
+
+  g_test_add_func ("/shaping-cache/label-shared-layout", test_label_shared_layout);
+  g_test_add_func ("/shaping-cache/settings-flush", test_settings_flush);
+
+  return g_test_run ();
+}
@@ -242,6 +242,143 @@ test_take (void)
   g_object_unref (list);
 }
 
+static void
+test_splice_packed (void)
+{
+  GtkStringList *list;
+  const char packed[] = "x\0\0yy\0zzz";
+
+  list = new_model ((const char *[]){ "a", "b", "c", "d", "e", NULL });
+
+  gtk_string_list_splice_packed (list, 2, 2, packed, sizeof (packed));
+
+  assert_model (list, "a b x  yy zzz e");
+  assert_changes (list, "2-2+4");
+
+  gtk_string_list_splice_packed (list, 1, 3, NULL, 0);
+
+  assert_model (list, "a zzz e");
+  assert_changes (list, "1-3");
+
+  g_object_unref (list);
+}
+
+static void
+test_long_strings (void)
+{
+  GtkStringList *list;
+  char *big;
+  guint i;
+
+  big = g_strnfill (10000, 'x');
+
+  list = new_model ((const char *[]){ NULL });
+
+  for (i = 0; i < 1000; i++)
+    gtk_string_list_take (list, g_strdup_printf ("%u", i));
+  gtk_string_list_append (list, big);
+  assert_changes (list, "");
+
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (list)), ==, 1001);
+  g_assert_cmpstr (gtk_string_list_get_string (list, 0), ==, "0");
+  g_assert_cmpstr (gtk_string_list_get_string (list, 999), ==, "999");
+  g_assert_cmpstr (gtk_string_list_get_string (list, 1000), ==, big);
+
+  g_object_unref (list);
+  g_free (big);
+}
+
+static void
+test_objects (void)
+{
+  GtkStringList *list;
+  GtkStringObject *a, *b, *c;
+
+  list = new_model ((const char *[]){ "a", "b", "c", NULL });
+
+  a = g_list_model_get_item (G_LIST_MODEL (list), 0);
+  c = g_list_model_get_item (G_LIST_MODEL (list), 2);
+  g_assert_cmpstr (gtk_string_object_get_string (a), ==, "a");
+  g_assert_cmpstr (gtk_string_object_get_string (c), ==, "c");
+
+  /* objects are kept while they are alive */
+  b = g_list_model_get_item (G_LIST_MODEL (list), 0);
+  g_assert_true (a == b);
+  g_object_unref (b);
+
+  /* and follow their item around */
+  gtk_string_list_splice (list, 0, 0, (const char *[]){ "x", "y", NULL });
+  assert_changes (list, "0+2");
+  b = g_list_model_get_item (G_LIST_MODEL (list), 4);
+  g_assert_true (c == b);
+  g_object_unref (b);
+
+  /* objects outlive removal of their item and the list */
+  gtk_string_list_remove (list, 2);
+  assert_changes (list, "-2");
+  b = g_list_model_get_item (G_LIST_MODEL (list), 2);
+  g_assert_true (a != b);
+  g_assert_cmpstr (gtk_string_object_get_string (b), ==, "b");
+  g_object_unref (b);
+
+  g_object_unref (list);
+
+  g_assert_cmpstr (gtk_string_object_get_string (a), ==, "a");
+  g_assert_cmpstr (gtk_string_object_get_string (c), ==, "c");
+  g_object_unref (a);
+  g_object_unref (c);
+}
+
+static gpointer
+unref_thread (gpointer data)
+{
+  GAsyncQueue *queue = data;
+  GtkStringObject *object;
+
+  while ((object = g_async_queue_pop (queue)) != (gpointer) queue)
+    g_object_unref (object);
+
+  return NULL;
+}
+
+static void
+test_objects_threads (void)
+{
+  GtkStringList *list;
+  GAsyncQueue *queue;
+  GThread *thread;
+  guint i;
+
+  list = gtk_string_list_new ((const char *[]){ "a", "b", "c", "d", NULL });
+  queue = g_async_queue_new ();
+  thread = g_thread_new ("unref", unref_thread, queue);
+
+  /* The last reference to an object is dropped in another thread
+   * while the list hands out and moves objects in this one.
+   */
+  for (i = 0; i < 100000; i++)
+    {
+      GtkStringObject *object;
+
+      object = g_list_model_get_item (G_LIST_MODEL (list), i % 4);
+      g_assert_cmpstr (gtk_string_object_get_string (object), ==,
+                       gtk_string_list_get_string (list, i % 4));
+      g_async_queue_push (queue, object);
+
+      if (i % 16 == 0)
+        {
+          gtk_string_list_splice (list, 0, 1, NULL);
+          gtk_string_list_append (list, "e");
+        }
+    }
+
+  g_async_queue_push (queue, queue);
+  g_thread_join (thread);
+
+  g_async_queue_unref (queue);
+  g_object_unref (list);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -257,6 +394,10 @@ main (int argc, char *argv[])
   g_test_add_func ("/stringlist/splice", test_splice);
   g_test_add_func ("/stringlist/add_remove", test_add_remove);
   g_test_add_func ("/stringlist/take", test_take);
+  g_test_add_func ("/stringlist/splice_packed", test_splice_packed);
+  g_test_add_func ("/stringlist/long_strings", test_long_strings);
+  g_test_add_func ("/stringlist/objects", test_objects);
+  g_test_add_func ("/stringlist/objects/threads", test_objects_threads);
 
   return g_test_run ();
 }
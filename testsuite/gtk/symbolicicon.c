@@ -0,0 +1,230 @@
+/*
+ * Copyright © 2021 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <glib/gstdio.h>
+#include <sys/types.h>
+#ifdef G_OS_WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+#include <gtk/gtk.h>
+
+#include "gtk/gdkpixbufutilsprivate.h"
+
+/* Four squares: foreground, success, warning and error */
+static const char icon_data[] =
+  "<?xml version=\"1.0\" standalone=\"no\"?>\n"
+  "<svg width=\"16\" height=\"16\" version=\"1.1\" xmlns=\"http://www.w3.org/2000/svg\">\n"
+  "  <rect x=\"0\" y=\"0\" width=\"8\" height=\"8\" fill=\"#bebebe\"/>\n"
+  "  <rect class=\"success\" x=\"8\" y=\"0\" width=\"8\" height=\"8\" fill=\"#bebebe\"/>\n"
+  "  <rect class=\"warning\" x=\"0\" y=\"8\" width=\"8\" height=\"8\" fill=\"#bebebe\"/>\n"
+  "  <rect class=\"error\" x=\"8\" y=\"8\" width=\"8\" height=\"8\" fill=\"#bebebe\"/>\n"
+  "</svg>\n";
+
+static void
+assert_pixel (GdkPixbuf *pixbuf,
+              int        x,
+              int        y,
+              guint32    expected)
+{
+  const guchar *p;
+
+  p = gdk_pixbuf_read_pixels (pixbuf)
+      + y * gdk_pixbuf_get_rowstride (pixbuf)
+      + x * gdk_pixbuf_get_n_channels (pixbuf);
+
+  g_assert_cmphex (p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3], ==, expected);
+}
+
+static void
+assert_pixbufs_equal (GdkPixbuf *a,
+                      GdkPixbuf *b)
+{
+  int width, height, y;
+
+  width = gdk_pixbuf_get_width (a);
+  height = gdk_pixbuf_get_height (a);
+
+  g_assert_cmpint (gdk_pixbuf_get_width (b), ==, width);
+  g_assert_cmpint (gdk_pixbuf_get_height (b), ==, height);
+  g_assert_cmpint (gdk_pixbuf_get_n_channels (a), ==, 4);
+  g_assert_cmpint (gdk_pixbuf_get_n_channels (b), ==, 4);
+
+  for (y = 0; y < height; y++)
+    g_assert_cmpmem (gdk_pixbuf_read_pixels (a) + y * gdk_pixbuf_get_rowstride (a), width * 4,
+                     gdk_pixbuf_read_pixels (b) + y * gdk_pixbuf_get_rowstride (b), width * 4);
+}
+
+static void
+test_symbolic_planes (void)
+{
+  GdkPixbuf *pixbuf;
+  GError *error = NULL;
+
+  pixbuf = gtk_make_symbolic_pixbuf_from_data (icon_data, strlen (icon_data),
+                                               32, 32, 1.0, NULL, &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (pixbuf);
+
+  g_assert_cmpint (gdk_pixbuf_get_width (pixbuf), ==, 32);
+  g_assert_cmpint (gdk_pixbuf_get_height (pixbuf), ==, 32);
+
+  /* The rgb channels hold the amount of success, warning and error color */
+  assert_pixel (pixbuf, 8, 8, 0x000000ff);
+  assert_pixel (pixbuf, 24, 8, 0xff0000ff);
+  assert_pixel (pixbuf, 8, 24, 0x00ff00ff);
+  assert_pixel (pixbuf, 24, 24, 0x0000ffff);
+
+  g_object_unref (pixbuf);
+}
+
+static int
+count_cache_files (void)
+{
+  GDir *dir;
+  char *path;
+  int count = 0;
+
+  path = g_build_filename (g_get_user_cache_dir (), "gtk-4.0", "symbolic", NULL);
+  dir = g_dir_open (path, 0, NULL);
+  if (dir)
+    {
+      while (g_dir_read_name (dir))
+        count++;
+      g_dir_close (dir);
+    }
+
+  g_free (path);
+
+  return count;
+}
+
+static void
+test_symbolic_cache (void)
+{
+  GdkPixbuf *uncached, *first, *second;
+  GError *error = NULL;
+  char *path;
+  int n_files;
+
+  path = g_build_filename (g_get_tmp_dir (), "cached-symbolic.svg", NULL);
+  g_file_set_contents (path, icon_data, -1, &error);
+  g_assert_no_error (error);
+
+  uncached = gtk_make_symbolic_pixbuf_from_data (icon_data, strlen (icon_data),
+                                                 24, 24, 2.0, NULL, &error);
+  g_assert_no_error (error);
+
+  n_files = count_cache_files ();
+
+  first = gtk_make_symbolic_pixbuf_from_path (path, 24, 24, 2.0, &error);
+  g_assert_no_error (error);
+  g_assert_cmpint (count_cache_files (), ==, n_files + 1);
+  assert_pixbufs_equal (uncached, first);
+
+  /* This one comes from the cache */
+  second = gtk_make_symbolic_pixbuf_from_path (path, 24, 24, 2.0, &error);
+  g_assert_no_error (error);
+  g_assert_cmpint (count_cache_files (), ==, n_files + 1);
+  assert_pixbufs_equal (uncached, second);
+
+  g_object_unref (second);
+
+  /* A different size is a different entry */
+  second = gtk_make_symbolic_pixbuf_from_path (path, 16, 16, 1.0, &error);
+  g_assert_no_error (error);
+  g_assert_cmpint (count_cache_files (), ==, n_files + 2);
+  g_assert_cmpint (gdk_pixbuf_get_width (second), ==, 16);
+
+  g_object_unref (second);
+  g_object_unref (first);
+  g_object_unref (uncached);
+
+  g_remove (path);
+  g_free (path);
+}
+
+static void
+test_symbolic_cache_prune (void)
+{
+  GdkPixbuf *pixbuf;
+  GError *error = NULL;
+  struct utimbuf times;
+  char *path;
+  GDir *dir;
+  const char *name;
+  char *dir_path;
+  char *oldest = NULL;
+  int size;
+
+  path = g_build_filename (g_get_tmp_dir (), "pruned-symbolic.svg", NULL);
+  g_file_set_contents (path, icon_data, -1, &error);
+  g_assert_no_error (error);
+
+  for (size = 16; size < 24; size++)
+    {
+      pixbuf = gtk_make_symbolic_pixbuf_from_path (path, size, size, 1.0, &error);
+      g_assert_no_error (error);
+      g_object_unref (pixbuf);
+    }
+
+  g_assert_cmpint (count_cache_files (), >=, 8);
+
+  /* Make one entry a year old */
+  dir_path = g_build_filename (g_get_user_cache_dir (), "gtk-4.0", "symbolic", NULL);
+  dir = g_dir_open (dir_path, 0, &error);
+  g_assert_no_error (error);
+  name = g_dir_read_name (dir);
+  g_assert_nonnull (name);
+  oldest = g_build_filename (dir_path, name, NULL);
+  g_dir_close (dir);
+
+  times.actime = times.modtime = g_get_real_time () / G_USEC_PER_SEC - 365 * 24 * 60 * 60;
+  g_assert_cmpint (g_utime (oldest, &times), ==, 0);
+
+  /* Entries that are too old go. The cache also prunes itself in a
+   * thread when the first entry is added, but with limits that leave
+   * the other entries alone.
+   */
+  gtk_symbolic_cache_prune (24 * 60 * 60, G_MAXSIZE);
+  g_assert_false (g_file_test (oldest, G_FILE_TEST_EXISTS));
+  g_assert_cmpint (count_cache_files (), >=, 7);
+
+  /* and then entries beyond the size limit */
+  gtk_symbolic_cache_prune (G_MAXINT64, 0);
+  g_assert_cmpint (count_cache_files (), ==, 0);
+
+  g_free (oldest);
+  g_free (dir_path);
+  g_remove (path);
+  g_free (path);
+}
+
+int
+main (int argc, char *argv[])
+{
+  (g_test_init) (&argc, &argv, G_TEST_OPTION_ISOLATE_DIRS, NULL);
+
+  g_test_add_func ("/symbolic/planes", test_symbolic_planes);
+  g_test_add_func ("/symbolic/cache", test_symbolic_cache);
+  g_test_add_func ("/symbolic/cache-prune", test_symbolic_cache_prune);
+
+  return g_test_run ();
+}
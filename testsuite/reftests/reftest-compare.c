@@ -24,7 +24,9 @@
 
 /* Compares two GDK_MEMORY_DEFAULT buffers, returning NULL if the
  * buffers are equal or a surface containing a diff between the two
- * surfaces.
+ * surfaces. Channels that differ by no more than @tolerance count
+ * as equal. The number of differing pixels is returned in
+ * @n_differing.
  *
  * This function is originally from cairo:test/buffer-diff.c.
  * Copyright © 2004 Richard D. Worth
@@ -35,13 +37,17 @@ buffer_diff_core (const guchar *buf_a,
         	  const guchar *buf_b,
                   int           stride_b,
         	  int		width,
-        	  int		height)
+        	  int		height,
+                  guint         tolerance,
+                  gsize        *n_differing)
 {
   int x, y;
   guchar *buf_diff = NULL;
   int stride_diff = 0;
   GdkTexture *diff = NULL;
 
+  *n_differing = 0;
+
   for (y = 0; y < height; y++)
     {
       const guint32 *row_a = (const guint32 *) (buf_a + y * stride_a);
@@ -62,6 +68,23 @@ buffer_diff_core (const guchar *buf_a,
           if ((row_a[x] & 0xff000000) == 0 && (row_b[x] & 0xff000000) == 0)
             continue;
 
+          if (tolerance > 0)
+            {
+              for (channel = 0; channel < 4; channel++)
+                {
+                  int value_a = (row_a[x] >> (channel*8)) & 0xff;
+                  int value_b = (row_b[x] >> (channel*8)) & 0xff;
+
+                  if (ABS (value_a - value_b) > tolerance)
+                    break;
+                }
+
+              if (channel == 4)
+                continue;
+            }
+
+          (*n_differing)++;
+
           if (diff == NULL)
             {
               GBytes *bytes;
@@ -111,6 +134,17 @@ buffer_diff_core (const guchar *buf_a,
 GdkTexture *
 reftest_compare_textures (GdkTexture *texture1,
                           GdkTexture *texture2)
+{
+  gsize n_differing;
+
+  return reftest_compare_textures_with_tolerance (texture1, texture2, 0, &n_differing);
+}
+
+GdkTexture *
+reftest_compare_textures_with_tolerance (GdkTexture *texture1,
+                                         GdkTexture *texture2,
+                                         guint       tolerance,
+                                         gsize      *n_differing)
 {
   int w, h;
   guchar *data1, *data2;
@@ -126,7 +160,9 @@ reftest_compare_textures (GdkTexture *texture1,
 
   diff = buffer_diff_core (data1, w * 4,
                            data2, w * 4,
-                           w, h);
+                           w, h,
+                           tolerance,
+                           n_differing);
 
   g_free (data1);
   g_free (data2);
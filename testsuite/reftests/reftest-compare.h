@@ -25,6 +25,12 @@ G_BEGIN_DECLS
 G_MODULE_EXPORT
 GdkTexture *            reftest_compare_textures        (GdkTexture             *texture1,
                                                          GdkTexture             *texture2);
+G_MODULE_EXPORT
+GdkTexture *            reftest_compare_textures_with_tolerance
+                                                        (GdkTexture             *texture1,
+                                                         GdkTexture             *texture2,
+                                                         guint                   tolerance,
+                                                         gsize                  *n_differing);
 
 G_END_DECLS
 